@@ -1023,6 +1023,9 @@ void CaptureContext::SetEventID(const rdcarray<ICaptureViewer *> &exclude, uint3
   uint32_t prevEventID = m_EventID;
   m_EventID = eventId;
 
+  // a prefetch for the event we were moving towards is no longer useful if it hasn't started
+  m_Renderer.CancelInvoke(lit("Prefetch"));
+
   m_Renderer.BlockInvoke([this, eventId, force](IReplayController *r) {
     r->SetFrameEvent(eventId, force);
     m_CurD3D11PipelineState = &r->GetD3D11PipelineState();
@@ -1037,6 +1040,23 @@ void CaptureContext::SetEventID(const rdcarray<ICaptureViewer *> &exclude, uint3
   bool updateEvent = force || prevEventID != eventId;
 
   RefreshUIStatus(exclude, updateSelectedEvent, updateEvent);
+
+  // when stepping forward, move the replay on to the next drawcall while the user is idle. This
+  // runs after any work the viewers queued for the new event.
+  if(eventId > prevEventID)
+  {
+    const DrawcallDescription *draw = GetDrawcall(eventId);
+
+    if(draw && draw->next > 0)
+    {
+      uint32_t nextEventID = (uint32_t)draw->next;
+
+      m_Renderer.AsyncInvoke(lit("Prefetch"), InvokePriority::Background,
+                             [nextEventID](IReplayController *r) {
+                               r->PrefetchEvent(nextEventID);
+                             });
+    }
+  }
 }
 
 void CaptureContext::RefreshUIStatus(const rdcarray<ICaptureViewer *> &exclude,
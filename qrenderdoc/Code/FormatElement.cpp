@@ -772,6 +772,88 @@ QVariantList FormatElement::GetVariants(const byte *&data, const byte *end) cons
   return ret;
 }
 
+QVariant FormatElement::GetVariant(const byte *data, const byte *end, int index) const
+{
+  uint32_t width = format.compByteWidth;
+
+  // packed formats and unusual widths go through the full decode
+  bool simple = (format.type == ResourceFormatType::Regular);
+
+  if(format.compType == CompType::Float)
+    simple &= (width == 8 || width == 4 || width == 2);
+  else if(format.compType == CompType::Depth)
+    simple &= (width == 4 || width == 2);
+  else if(format.compType == CompType::Double)
+    simple &= (width == 8);
+  else
+    simple &= (width == 4 || width == 2 || width == 1);
+
+  if(!simple)
+  {
+    QVariantList list = GetVariants(data, end);
+    return index < list.count() ? list[index] : QVariant();
+  }
+
+  int dim = (int)(qMax(matrixdim, 1U) * format.compCount);
+
+  // like GetVariants, fail if any of the element is off the end - not just this component
+  if(index < 0 || index >= dim || data + dim * width > end)
+    return QVariant();
+
+  if(format.bgraOrder && (index == 0 || index == 2))
+    index = 2 - index;
+
+  data += index * width;
+
+  bool ok = true;
+
+  switch(format.compType)
+  {
+    case CompType::Float:
+      if(width == 8)
+        return readObj<double>(data, end, ok);
+      else if(width == 4)
+        return readObj<float>(data, end, ok);
+      return RENDERDOC_HalfToFloat(readObj<uint16_t>(data, end, ok));
+    case CompType::SInt:
+      if(width == 4)
+        return (int)readObj<int32_t>(data, end, ok);
+      else if(width == 2)
+        return (int)readObj<int16_t>(data, end, ok);
+      return (int)readObj<int8_t>(data, end, ok);
+    case CompType::UInt:
+      if(width == 4)
+        return (uint32_t)readObj<uint32_t>(data, end, ok);
+      else if(width == 2)
+        return (uint32_t)readObj<uint16_t>(data, end, ok);
+      return (uint32_t)readObj<uint8_t>(data, end, ok);
+    case CompType::UScaled:
+      if(width == 4)
+        return (float)readObj<uint32_t>(data, end, ok);
+      else if(width == 2)
+        return (float)readObj<uint16_t>(data, end, ok);
+      return (float)readObj<uint8_t>(data, end, ok);
+    case CompType::SScaled:
+      if(width == 4)
+        return (float)readObj<int32_t>(data, end, ok);
+      else if(width == 2)
+        return (float)readObj<int16_t>(data, end, ok);
+      return (float)readObj<int8_t>(data, end, ok);
+    case CompType::Depth:
+      if(width == 4)
+        return readObj<float>(data, end, ok);
+      return (float)readObj<uint16_t>(data, end, ok) / (float)0x0000ffff;
+    case CompType::Double: return readObj<double>(data, end, ok);
+    default:
+      // unorm/snorm
+      if(width == 4)
+        return (float)readObj<uint32_t>(data, end, ok) / (float)0xffffffff;
+      else if(width == 2)
+        return interpret(format, readObj<uint16_t>(data, end, ok));
+      return interpret(format, readObj<uint8_t>(data, end, ok));
+  }
+}
+
 ShaderVariable FormatElement::GetShaderVar(const byte *&data, const byte *end) const
 {
   QVariantList objs = GetVariants(data, end);
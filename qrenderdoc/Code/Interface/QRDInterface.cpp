@@ -105,6 +105,7 @@ CaptureSettings::operator QVariant() const
   opts[lit("saveAllInitials")] = options.saveAllInitials;
   opts[lit("captureAllCmdLists")] = options.captureAllCmdLists;
   opts[lit("debugOutputMute")] = options.debugOutputMute;
+  opts[lit("deferDescriptorTracking")] = options.deferDescriptorTracking;
   ret[lit("options")] = opts;
 
   return ret;
@@ -142,6 +143,7 @@ CaptureSettings::CaptureSettings(const QVariant &v)
   options.saveAllInitials = opts[lit("saveAllInitials")].toBool();
   options.captureAllCmdLists = opts[lit("captureAllCmdLists")].toBool();
   options.debugOutputMute = opts[lit("debugOutputMute")].toBool();
+  options.deferDescriptorTracking = opts[lit("deferDescriptorTracking")].toBool();
 }
 
 rdcstr configFilePath(const rdcstr &filename)
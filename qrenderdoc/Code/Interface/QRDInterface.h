@@ -640,6 +640,24 @@ protected:
 DECLARE_REFLECTION_STRUCT(ICaptureViewer);
 DECLARE_REFLECTION_STRUCT(ICaptureViewer *);
 
+DOCUMENT(R"(Specifies how urgently a non-blocking invoke onto the replay thread should be processed.
+
+.. data:: Normal
+
+  The default priority. Normal priority invokes are processed in the order they were made.
+
+.. data:: Background
+
+  Slow work whose result isn't needed immediately, such as pixel history or a histogram. Background
+  invokes are processed in order, but only when no normal priority invoke is waiting, so that
+  interactive requests don't queue up behind them.
+)");
+enum class InvokePriority : int
+{
+  Normal,
+  Background,
+};
+
 DOCUMENT(R"(A manager for accessing the underlying replay information that isn't already abstracted
 in UI side structures. This manager controls and serialises access to the underlying
 :class:`~renderdoc.ReplayController`, as well as handling remote server connections.
@@ -787,6 +805,39 @@ This can be used to identify if a command is long-running to display a progress
 )");
   virtual float GetCurrentProcessingTime() = 0;
 
+  DOCUMENT(R"(Make a tagged non-blocking invoke call onto the replay thread, with a given priority.
+
+As with the tagged :meth:`AsyncInvoke`, any requests with the same tag that are still waiting in
+the queue are removed, and if one is currently running it is marked as cancelled - see
+:meth:`IsInvokeCancelled`.
+
+:param str tag: The tag to identify this callback.
+:param InvokePriority priority: How urgently this callback should be processed.
+:param InvokeCallback method: The function to callback on the replay thread.
+)");
+  virtual void AsyncInvoke(const rdcstr &tag, InvokePriority priority, InvokeCallback method) = 0;
+
+  DOCUMENT(R"(Cancel any pending work with the given tag.
+
+Requests with this tag that are waiting in the queue are removed without being called, and if one is
+currently running it is marked as cancelled - see :meth:`IsInvokeCancelled`.
+
+:param str tag: The tag to cancel.
+)");
+  virtual void CancelInvoke(const rdcstr &tag) = 0;
+
+  DOCUMENT(R"(Checks whether the callback currently running on the replay thread has been cancelled,
+either explicitly with :meth:`CancelInvoke` or by a newer request with the same tag.
+
+Long-running callbacks should check this between steps and return early if it is set, since their
+results are no longer wanted.
+
+:return: ``True`` if the current callback has been cancelled. Always ``False`` if called from
+  anywhere other than a callback on the replay thread.
+:rtype: ``bool``
+)");
+  virtual bool IsInvokeCancelled() = 0;
+
   DOCUMENT(R"(Make a tagged non-blocking invoke call onto the replay thread.
 
 This tagged function is for cases when we might send a request - e.g. to pick a vertex or pixel -
@@ -795,7 +846,8 @@ other work is taking a while or because we're sending requests faster than they
 processed.
 
 The manager processes only the request on the top of the queue, so when a new tagged invoke
-comes in, we remove any other requests in the queue before it that have the same tag.
+comes in, we remove any other requests in the queue before it that have the same tag. If a request
+with the same tag is currently running, it is marked as cancelled - see :meth:`IsInvokeCancelled`.
 
 :param str tag: The tag to identify this callback.
 :param InvokeCallback method: The function to callback on the replay thread.
@@ -64,8 +64,7 @@ void RemoteHost::CheckStatus()
     return;
   }
 
-  IRemoteServer *rend = NULL;
-  ReplayStatus status = RENDERDOC_CreateRemoteServerConnection(hostname.c_str(), 0, &rend);
+  ReplayStatus status = RENDERDOC_CheckRemoteServerStatus(hostname.c_str(), 0);
 
   if(status == ReplayStatus::Succeeded)
   {
@@ -90,9 +89,6 @@ void RemoteHost::CheckStatus()
     versionMismatch = busy = false;
   }
 
-  if(rend)
-    rend->ShutdownConnection();
-
   // since we can only have one active client at once on a remote server, we need
   // to avoid DDOS'ing by doing multiple CheckStatus() one after the other so fast
   // that the active client can't be properly shut down. Sleeping here for a short
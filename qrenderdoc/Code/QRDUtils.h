@@ -84,6 +84,9 @@ public:
                                                 bool tightPacking, QString &errors);
 
   QVariantList GetVariants(const byte *&data, const byte *end) const;
+  // decodes a single component, as would be at GetVariants()[index], without building the list.
+  // Returns an invalid QVariant if the element can't be read.
+  QVariant GetVariant(const byte *data, const byte *end, int index) const;
   ShaderVariable GetShaderVar(const byte *&data, const byte *end) const;
 
   uint32_t byteSize() const;
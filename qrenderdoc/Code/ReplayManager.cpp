@@ -237,30 +237,70 @@ float ReplayManager::GetCurrentProcessingTime()
 }
 
 void ReplayManager::AsyncInvoke(const rdcstr &tag, ReplayManager::InvokeCallback m)
+{
+  AsyncInvoke(tag, InvokePriority::Normal, m);
+}
+
+void ReplayManager::AsyncInvoke(const rdcstr &tag, InvokePriority priority,
+                                ReplayManager::InvokeCallback m)
 {
   QString qtag(tag);
 
+  CancelInvokes(qtag);
+
+  InvokeHandle *cmd = new InvokeHandle(m, qtag, priority);
+  cmd->selfdelete = true;
+
+  PushInvoke(cmd);
+}
+
+void ReplayManager::CancelInvoke(const rdcstr &tag)
+{
+  CancelInvokes(QString(tag));
+}
+
+bool ReplayManager::IsInvokeCancelled()
+{
+  QMutexLocker autolock(&m_RenderLock);
+
+  // m_CurrentInvoke is only set while a callback is running on the replay thread
+  if(m_CurrentInvoke == NULL || m_Thread == NULL || !m_Thread->isCurrentThread())
+    return false;
+
+  return m_CurrentInvoke->cancelled;
+}
+
+void ReplayManager::RemoveInvokes(QQueue<InvokeHandle *> &queue, const QString &tag)
+{
+  for(int i = 0; i < queue.count();)
   {
-    QMutexLocker autolock(&m_RenderLock);
-    for(int i = 0; i < m_RenderQueue.count();)
+    if(queue[i]->tag == tag)
     {
-      if(m_RenderQueue[i]->tag == qtag)
-      {
-        InvokeHandle *cmd = m_RenderQueue.takeAt(i);
-        if(cmd->selfdelete)
-          delete cmd;
-      }
+      InvokeHandle *cmd = queue.takeAt(i);
+      if(cmd->selfdelete)
+        delete cmd;
       else
-      {
-        i++;
-      }
+        cmd->processed.release();
+    }
+    else
+    {
+      i++;
     }
   }
+}
 
-  InvokeHandle *cmd = new InvokeHandle(m, qtag);
-  cmd->selfdelete = true;
+void ReplayManager::CancelInvokes(const QString &tag)
+{
+  if(tag.isEmpty())
+    return;
 
-  PushInvoke(cmd);
+  QMutexLocker autolock(&m_RenderLock);
+
+  RemoveInvokes(m_RenderQueue, tag);
+  RemoveInvokes(m_BackgroundQueue, tag);
+
+  if(m_CurrentInvoke && m_CurrentInvoke->tag == tag)
+    m_CurrentInvoke->cancelled = true;
 }
 
 void ReplayManager::AsyncInvoke(ReplayManager::InvokeCallback m)
@@ -411,7 +451,10 @@ void ReplayManager::PushInvoke(ReplayManager::InvokeHandle *cmd)
   }
 
   QMutexLocker autolock(&m_RenderLock);
-  m_RenderQueue.enqueue(cmd);
+  if(cmd->priority == InvokePriority::Background)
+    m_BackgroundQueue.enqueue(cmd);
+  else
+    m_RenderQueue.enqueue(cmd);
   m_RenderCondition.wakeAll();
 }
 
@@ -457,11 +500,16 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile,
     // unlock again.
     {
       QMutexLocker autolock(&m_RenderLock);
-      if(m_RenderQueue.isEmpty())
+      if(m_RenderQueue.isEmpty() && m_BackgroundQueue.isEmpty())
         m_RenderCondition.wait(&m_RenderLock, 10);
 
+      // background work only runs when nothing else is waiting
       if(!m_RenderQueue.isEmpty())
         cmd = m_RenderQueue.dequeue();
+      else if(!m_BackgroundQueue.isEmpty())
+        cmd = m_BackgroundQueue.dequeue();
+
+      m_CurrentInvoke = cmd;
     }
 
     if(cmd == NULL)
@@ -482,6 +530,11 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile,
       }
     }
 
+    {
+      QMutexLocker autolock(&m_RenderLock);
+      m_CurrentInvoke = NULL;
+    }
+
     // if it's a throwaway command, delete it
     if(cmd->selfdelete)
       delete cmd;
@@ -496,6 +549,8 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile,
     {
       QMutexLocker autolock(&m_RenderLock);
       m_RenderQueue.swap(queue);
+      queue.append(m_BackgroundQueue);
+      m_BackgroundQueue.clear();
     }
 
     for(InvokeHandle *cmd : queue)
@@ -59,8 +59,12 @@ public:
   // other work is taking a while or because we're sending requests faster than they can be
   // processed.
   // the manager processes only the request on the top of the queue, so when a new tagged invoke
-  // comes in, we remove any other requests in the queue before it that have the same tag
+  // comes in, we remove any other requests in the queue before it that have the same tag, and flag
+  // a running request with the same tag as cancelled
   void AsyncInvoke(const rdcstr &tag, InvokeCallback m);
+  void AsyncInvoke(const rdcstr &tag, InvokePriority priority, InvokeCallback m);
+  void CancelInvoke(const rdcstr &tag);
+  bool IsInvokeCancelled();
   void AsyncInvoke(InvokeCallback m);
   void BlockInvoke(InvokeCallback m);
 
@@ -100,17 +104,23 @@ public:
 private:
   struct InvokeHandle
   {
-    InvokeHandle(InvokeCallback m, const QString &t = QString())
+    InvokeHandle(InvokeCallback m, const QString &t = QString(),
+                 InvokePriority p = InvokePriority::Normal)
     {
       tag = t;
+      priority = p;
       method = m;
       selfdelete = false;
+      cancelled = false;
     }
 
     QString tag;
+    InvokePriority priority;
     InvokeCallback method;
     QSemaphore processed;
     bool selfdelete;
+    // only modified with m_RenderLock held
+    bool cancelled;
   };
 
   void run(int proxyRenderer, const QString &capturefile, RENDERDOC_ProgressCallback progress);
@@ -120,12 +130,17 @@ private:
 
   QMutex m_RenderLock;
   QQueue<InvokeHandle *> m_RenderQueue;
+  // only processed when m_RenderQueue is empty
+  QQueue<InvokeHandle *> m_BackgroundQueue;
+  InvokeHandle *m_CurrentInvoke = NULL;
   QWaitCondition m_RenderCondition;
 
   ICaptureFile *m_CaptureFile = NULL;
   IReplayController *m_Renderer = NULL;
 
   void PushInvoke(InvokeHandle *cmd);
+  void RemoveInvokes(QQueue<InvokeHandle *> &queue, const QString &tag);
+  void CancelInvokes(const QString &tag);
 
   QMutex m_RemoteLock;
   RemoteHost *m_RemoteHost = NULL;
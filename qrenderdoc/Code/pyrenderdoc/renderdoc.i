@@ -212,6 +212,7 @@ TEMPLATE_ARRAY_INSTANTIATE(rdcarray, APIEvent)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, Bindpoint)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, BufferDescription)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, CaptureFileFormat)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ChunkLoadStats)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ConstantBlock)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, DebugMessage)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, EnvironmentModification)
@@ -219,6 +220,7 @@ TEMPLATE_ARRAY_INSTANTIATE(rdcarray, EventUsage)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, PathEntry)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, PixelModification)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ResourceDescription)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ResourceLoadStats)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ResourceId)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderCompileFlag)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderConstant)
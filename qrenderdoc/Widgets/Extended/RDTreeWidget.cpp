@@ -85,6 +85,12 @@ public:
     beginInsertRows(index, item->childCount(), item->childCount());
   }
 
+  void beginAddChildren(RDTreeWidgetItem *item, int count)
+  {
+    QModelIndex index = indexForItem(item, 0);
+    beginInsertRows(index, item->childCount(), item->childCount() + count - 1);
+  }
+
   void endAddChild(RDTreeWidgetItem *item) { endInsertRows(); }
   void beginRemoveChildren(RDTreeWidgetItem *parent, int first, int last)
   {
@@ -150,9 +156,24 @@ public:
     RDTreeWidgetItem *parentItem = itemForIndex(parent);
 
     if(parentItem)
-      return parentItem->childCount() > 0;
+      return parentItem->childCount() > 0 || parentItem->m_lazyChildren;
     return false;
   }
+
+  bool canFetchMore(const QModelIndex &parent) const override
+  {
+    RDTreeWidgetItem *parentItem = itemForIndex(parent);
+
+    return parentItem && parentItem->m_lazyChildren && widget->m_lazyPopulate;
+  }
+
+  void fetchMore(const QModelIndex &parent) override
+  {
+    RDTreeWidgetItem *parentItem = itemForIndex(parent);
+
+    if(parentItem && parentItem->m_lazyChildren && widget->m_lazyPopulate)
+      widget->m_lazyPopulate(parentItem);
+  }
   Qt::ItemFlags flags(const QModelIndex &index) const override
   {
     if(!index.isValid())
@@ -454,6 +475,45 @@ void RDTreeWidgetItem::addChild(RDTreeWidgetItem *item)
     m_widget->endAddChild(this);
 }
 
+void RDTreeWidgetItem::addChildren(const QVector<RDTreeWidgetItem *> &items)
+{
+  // queued updates can only track one added child, and there's no point batching a single item
+  if(items.count() <= 1 || (m_widget && m_widget->m_queueUpdates))
+  {
+    for(RDTreeWidgetItem *item : items)
+      addChild(item);
+    return;
+  }
+
+  for(RDTreeWidgetItem *item : items)
+  {
+    int colCount = item->m_text.count();
+
+    if(m_widget && colCount < m_widget->m_headers.count())
+      qCritical() << "Item added with insufficient column data";
+
+    if(item->m_parent)
+      item->m_parent->removeChild(item);
+
+    item->m_parent = this;
+    item->setWidget(m_widget);
+
+    item->m_text.resize(colCount);
+    item->m_icons.resize(colCount);
+
+    if(item->m_data)
+      item->m_data->resize(qMax(item->m_data->count(), colCount));
+  }
+
+  if(m_widget)
+    m_widget->m_model->beginAddChildren(this, items.count());
+
+  m_children.append(items);
+
+  if(m_widget)
+    m_widget->m_model->endAddChild(this);
+}
+
 void RDTreeWidgetItem::setWidget(RDTreeWidget *widget)
 {
   if(widget == m_widget)
@@ -860,8 +920,23 @@ void RDTreeWidget::expandItem(RDTreeWidgetItem *item)
 {
   expand(m_model->indexForItem(item, 0));
 }
+void RDTreeWidget::populateItem(RDTreeWidgetItem *item)
+{
+  while(item->m_lazyChildren && m_lazyPopulate)
+  {
+    int count = item->childCount();
+
+    m_lazyPopulate(item);
+
+    // guard against a callback that neither adds anything nor clears the flag
+    if(item->childCount() == count)
+      break;
+  }
+}
+
 void RDTreeWidget::expandAllItems(RDTreeWidgetItem *item)
 {
+  populateItem(item);
   expandItem(item);
 
   for(int c = 0; c < item->childCount(); c++)
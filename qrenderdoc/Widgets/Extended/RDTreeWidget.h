@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <functional>
 #include "RDTreeView.h"
 
 class RDTreeWidget;
@@ -41,6 +42,8 @@ public:
   void setData(int column, int role, const QVariant &value);
 
   void addChild(RDTreeWidgetItem *item);
+  // adds several children at once, with a single notification to the view
+  void addChildren(const QVector<RDTreeWidgetItem *> &items);
 
   // the data above requires allocating a bunch of vectors since it's stored per-column. Where
   // possible, just use this single per-item tag
@@ -64,6 +67,11 @@ public:
   void removeChild(RDTreeWidgetItem *child);
   void clear();
   inline int childCount() const { return m_children.count(); }
+  // an item with lazy children is displayed as expandable even if it has no children yet. When
+  // the view needs them, the widget's lazy populate callback is invoked to add them, which must
+  // call setLazyChildren(false) once there are no more children to add.
+  inline bool lazyChildren() const { return m_lazyChildren; }
+  inline void setLazyChildren(bool lazy) { m_lazyChildren = lazy; }
   inline RDTreeWidgetItem *parent() const { return m_parent; }
   inline RDTreeWidget *treeWidget() const { return m_widget; }
   inline void setBold(bool bold)
@@ -158,6 +166,7 @@ private:
   QString m_tooltip;
   bool m_bold = false;
   bool m_italic = false;
+  bool m_lazyChildren = false;
   QColor m_treeCol;
   float m_treeColWidth = 0.0f;
   QBrush m_back;
@@ -239,6 +248,12 @@ public:
   void setInstantTooltips(bool instant) { m_instantTooltips = instant; }
   bool customCopyPasteHandler() { return m_customCopyPaste; }
   void setCustomCopyPasteHandler(bool custom) { m_customCopyPaste = custom; }
+  void setLazyPopulate(std::function<void(RDTreeWidgetItem *)> populate)
+  {
+    m_lazyPopulate = populate;
+  }
+  // adds all of an item's lazy children now, rather than waiting for the view to need them
+  void populateItem(RDTreeWidgetItem *item);
   RDTreeWidgetItem *invisibleRootItem() { return m_root; }
   void addTopLevelItem(RDTreeWidgetItem *item) { m_root->addChild(item); }
   RDTreeWidgetItem *topLevelItem(int index) const { return m_root->child(index); }
@@ -332,4 +347,6 @@ private:
   bool m_hoverHandCursor = false;
   bool m_clearSelectionOnFocusLoss = false;
   bool m_activateOnClick = false;
+
+  std::function<void(RDTreeWidgetItem *)> m_lazyPopulate;
 };
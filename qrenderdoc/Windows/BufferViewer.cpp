@@ -24,6 +24,7 @@
 
 #include "BufferViewer.h"
 #include <float.h>
+#include <limits.h>
 #include <QDoubleSpinBox>
 #include <QFontDatabase>
 #include <QItemSelection>
@@ -31,6 +32,7 @@
 #include <QMouseEvent>
 #include <QMutexLocker>
 #include <QScrollBar>
+#include <QSet>
 #include <QTimer>
 #include <QtMath>
 #include "Code/QRDUtils.h"
@@ -360,6 +362,192 @@ uint32_t CalcIndex(BufferData *data, uint32_t vertID, int32_t baseVertex)
   return idx;
 }
 
+// fetches a raw buffer in fixed-size pages as rows are displayed, rather than transferring the
+// whole buffer up front. Only a bounded number of pages are kept, evicting the least recently used.
+class BufferPager : public QEnableSharedFromThis<BufferPager>
+{
+public:
+  BufferPager(ICaptureContext &ctx, QObject *owner, ResourceId id, uint64_t offset, uint64_t size,
+              size_t stride)
+      : m_Ctx(ctx), m_Owner(owner), m_ID(id), m_Offset(offset), m_Size(size), m_Stride(stride)
+  {
+    m_RowsPerPage = uint32_t(qMax((size_t)1, PageSize / m_Stride));
+  }
+
+  ~BufferPager()
+  {
+    for(BufferData *page : m_Pages)
+      page->deref();
+  }
+
+  uint32_t rowCount() const
+  {
+    return uint32_t(qMin<uint64_t>((m_Size + m_Stride - 1) / m_Stride, INT_MAX));
+  }
+  uint32_t rowsPerPage() const { return m_RowsPerPage; }
+  // called on the UI thread when a range of rows has arrived
+  std::function<void(uint32_t firstRow, uint32_t lastRow)> loaded;
+
+  // returns the page containing row, with a reference added that the caller must release, and
+  // sets rowOffset to the row's byte offset within it. If the page isn't available it's requested
+  // along with its neighbours and NULL is returned, unless block is set in which case the page is
+  // fetched immediately. The UI thread must never block.
+  BufferData *acquireRow(uint32_t row, size_t &rowOffset, bool block)
+  {
+    uint32_t page = row / m_RowsPerPage;
+    rowOffset = (row % m_RowsPerPage) * m_Stride;
+
+    {
+      QMutexLocker autolock(&m_Lock);
+
+      auto it = m_Pages.find(page);
+      if(it != m_Pages.end())
+      {
+        m_LRU.removeOne(page);
+        m_LRU.push_back(page);
+
+        it.value()->ref();
+        return it.value();
+      }
+
+      if(!block)
+      {
+        queuePage(page);
+
+        // prefetch either side, for scrolling
+        if(page > 0)
+          queuePage(page - 1);
+        if(uint64_t(page + 1) * m_RowsPerPage < rowCount())
+          queuePage(page + 1);
+
+        if(!m_FetchQueued && !m_Queue.isEmpty())
+        {
+          m_FetchQueued = true;
+
+          QSharedPointer<BufferPager> self = sharedFromThis();
+          m_Ctx.Replay().AsyncInvoke([self](IReplayController *r) { self->fetchQueued(r); });
+        }
+
+        return NULL;
+      }
+    }
+
+    BufferData *ret = NULL;
+
+    m_Ctx.Replay().BlockInvoke([this, page, &ret](IReplayController *r) {
+      fetchPages(r, page, page);
+
+      QMutexLocker autolock(&m_Lock);
+      ret = m_Pages.value(page);
+      if(ret)
+        ret->ref();
+    });
+
+    return ret;
+  }
+
+private:
+  static const size_t PageSize = 64 * 1024;
+  static const int MaxPages = 64;
+
+  void queuePage(uint32_t page)
+  {
+    if(m_Pages.contains(page) || m_Pending.contains(page))
+      return;
+
+    m_Pending.insert(page);
+    m_Queue.push_back(page);
+  }
+
+  void fetchQueued(IReplayController *r)
+  {
+    QList<uint32_t> queue;
+
+    {
+      QMutexLocker autolock(&m_Lock);
+      queue.swap(m_Queue);
+      m_FetchQueued = false;
+    }
+
+    std::sort(queue.begin(), queue.end());
+
+    // fetch each contiguous run of pages in one go
+    for(int i = 0; i < queue.count();)
+    {
+      int j = i + 1;
+      while(j < queue.count() && queue[j] == queue[j - 1] + 1)
+        j++;
+
+      uint32_t first = queue[i], last = queue[j - 1];
+
+      fetchPages(r, first, last);
+
+      QSharedPointer<BufferPager> self = sharedFromThis();
+      uint32_t firstRow = first * m_RowsPerPage;
+      uint32_t lastRow = qMin((last + 1) * m_RowsPerPage, rowCount()) - 1;
+
+      GUIInvoke::call(m_Owner, [self, firstRow, lastRow]() {
+        if(self->loaded)
+          self->loaded(firstRow, lastRow);
+      });
+
+      i = j;
+    }
+  }
+
+  void fetchPages(IReplayController *r, uint32_t first, uint32_t last)
+  {
+    uint64_t pageBytes = uint64_t(m_RowsPerPage) * m_Stride;
+    uint64_t start = first * pageBytes;
+
+    bytebuf data;
+    if(start < m_Size)
+      data = r->GetBufferData(m_ID, m_Offset + start,
+                              qMin((last - first + 1) * pageBytes, m_Size - start));
+
+    QMutexLocker autolock(&m_Lock);
+
+    for(uint32_t page = first; page <= last; page++)
+    {
+      m_Pending.remove(page);
+
+      if(m_Pages.contains(page))
+        continue;
+
+      // if the fetch came back short, store an empty page so we don't keep asking for it
+      uint64_t pageStart = qMin((page - first) * pageBytes, (uint64_t)data.size());
+      size_t len = (size_t)qMin(pageBytes, (uint64_t)data.size() - pageStart);
+
+      BufferData *buf = new BufferData;
+      buf->data = new byte[len];
+      memcpy(buf->data, data.data() + pageStart, len);
+      buf->end = buf->data + len;
+      buf->stride = m_Stride;
+
+      m_Pages[page] = buf;
+      m_LRU.push_back(page);
+    }
+
+    while(m_LRU.count() > MaxPages)
+      m_Pages.take(m_LRU.takeFirst())->deref();
+  }
+
+  ICaptureContext &m_Ctx;
+  QObject *m_Owner;
+
+  ResourceId m_ID;
+  uint64_t m_Offset, m_Size;
+  size_t m_Stride;
+  uint32_t m_RowsPerPage;
+
+  QMutex m_Lock;
+  QMap<uint32_t, BufferData *> m_Pages;
+  QList<uint32_t> m_LRU;
+  QSet<uint32_t> m_Pending;
+  QList<uint32_t> m_Queue;
+  bool m_FetchQueued = false;
+};
+
 static int columnGroupRole = Qt::UserRole + 10000;
 
 class BufferItemModel : public QAbstractItemModel
@@ -516,18 +704,20 @@ public:
         {
           const FormatElement &el = elementForColumn(col);
 
-          if(el.rgb && el.buffer < buffers.size())
-          {
-            const byte *data = buffers[el.buffer]->data;
-            const byte *end = buffers[el.buffer]->end;
-
-            data += buffers[el.buffer]->stride * row;
-            data += el.offset;
+          bool pending = false;
+          BufferData *page = NULL;
+          const byte *end = NULL;
+          const byte *data = el.rgb ? elementData(el, row, end, page, pending) : NULL;
 
+          if(data)
+          {
             // only slightly wasteful, we need to fetch all variants together
             // since some formats are packed and can't be read individually
             QVariantList list = el.GetVariants(data, end);
 
+            if(page)
+              page->deref();
+
             if(!list.isEmpty())
             {
               QMetaType::Type vt = GetVariantMetatype(list[0]);
@@ -625,44 +815,46 @@ public:
           if(el.instancerate > 0)
             instIdx = curInstance / el.instancerate;
 
-          if(el.buffer < buffers.size())
-          {
-            const byte *data = buffers[el.buffer]->data;
-            const byte *end = buffers[el.buffer]->end;
+          bool pending = false;
+          BufferData *page = NULL;
+          const byte *end = NULL;
+          const byte *data = elementData(el, el.perinstance ? instIdx : idx, end, page, pending);
 
-            if(!el.perinstance)
-              data += buffers[el.buffer]->stride * idx;
-            else
-              data += buffers[el.buffer]->stride * instIdx;
+          if(pending)
+            return loading();
 
-            data += el.offset;
+          if(data)
+          {
+            int comp = componentForIndex(col);
 
-            // only slightly wasteful, we need to fetch all variants together
-            // since some formats are packed and can't be read individually
-            QVariantList list = el.GetVariants(data, end);
+            uint32_t rowdim = el.matrixdim;
+            uint32_t coldim = el.format.compCount;
 
-            int comp = componentForIndex(col);
+            // decode just the components we're displaying, not the whole element
+            QVariant first = el.GetVariant(data, end, el.rowmajor ? comp : comp * rowdim);
 
-            if(comp < list.count())
-            {
-              QString ret;
+            QString ret;
 
-              uint32_t rowdim = el.matrixdim;
-              uint32_t coldim = el.format.compCount;
+            if(first.isValid())
+            {
+              ret = interpretVariant(first, el);
 
-              for(uint32_t r = 0; r < rowdim; r++)
+              for(uint32_t r = 1; r < rowdim; r++)
               {
-                if(r > 0)
-                  ret += lit("\n");
+                ret += lit("\n");
 
                 if(el.rowmajor)
-                  ret += interpretVariant(list[comp + r * coldim], el);
+                  ret += interpretVariant(el.GetVariant(data, end, comp + r * coldim), el);
                 else
-                  ret += interpretVariant(list[r + comp * rowdim], el);
+                  ret += interpretVariant(el.GetVariant(data, end, r + comp * rowdim), el);
               }
+            }
 
+            if(page)
+              page->deref();
+
+            if(first.isValid())
               return ret;
-            }
           }
 
           return outOfBounds();
@@ -694,6 +886,24 @@ public:
   QList<BufferData *> buffers;
   uint32_t primRestart = 0;
 
+  // for raw buffer views, the data is paged in as it's displayed instead of being in buffers
+  QSharedPointer<BufferPager> pager;
+
+  void setPager(QSharedPointer<BufferPager> p)
+  {
+    pager = p;
+
+    if(pager)
+    {
+      BufferPager *ptr = pager.data();
+      pager->loaded = [this, ptr](uint32_t firstRow, uint32_t lastRow) {
+        // ignore any data that arrives after we've moved on to something else
+        if(pager.data() == ptr && lastRow < numRows)
+          emit dataChanged(index(firstRow, 0), index(lastRow, columnCount() - 1));
+      };
+    }
+  }
+
   void setPosColumn(int pos)
   {
     QVector<int> roles = {Qt::BackgroundRole, Qt::ForegroundRole};
@@ -858,6 +1068,41 @@ private:
   }
 
   QString outOfBounds() const { return lit("---"); }
+  QString loading() const { return lit("..."); }
+  // returns the data for element el at vertex/instance idx, or NULL if there's none. If the buffer
+  // is paged the page used is returned in page and must be released, or pending is set if the data
+  // hasn't arrived yet.
+  const byte *elementData(const FormatElement &el, uint32_t idx, const byte *&end,
+                          BufferData *&page, bool &pending) const
+  {
+    if(pager)
+    {
+      // anything other than the UI thread, such as exporting, waits for the data
+      bool uiThread = GUIInvoke::onUIThread();
+
+      size_t rowOffset = 0;
+      page = pager->acquireRow(idx, rowOffset, !uiThread);
+
+      if(!page)
+      {
+        pending = uiThread;
+        return NULL;
+      }
+
+      end = page->end;
+      return page->data + rowOffset + el.offset;
+    }
+
+    if(el.buffer >= buffers.size())
+      return NULL;
+
+    const byte *data = buffers[el.buffer]->data;
+    end = buffers[el.buffer]->end;
+
+    data += buffers[el.buffer]->stride * idx;
+
+    return data + el.offset;
+  }
   QString interpretGeneric(int col, const FormatElement &el) const
   {
     int comp = componentForIndex(col);
@@ -1485,11 +1730,14 @@ void BufferViewer::OnEventChanged(uint32_t eventId)
 
     BufferData *buf = NULL;
 
+    // raw buffers are paged in as they're displayed, as long as we know how big they are
+    bool paged = !m_MeshView && m_IsBuffer && m_ObjectByteSize != UINT64_MAX;
+
     if(m_MeshView)
     {
       RT_FetchMeshData(r);
     }
-    else
+    else if(!paged)
     {
       buf = new BufferData;
       bytebuf data;
@@ -1511,9 +1759,29 @@ void BufferViewer::OnEventChanged(uint32_t eventId)
       buf->end = buf->data + data.size();
     }
 
-    GUIInvoke::call(this, [this, buf, vsinHoriz, vsoutHoriz, gsoutHoriz] {
+    GUIInvoke::call(this, [this, buf, paged, vsinHoriz, vsoutHoriz, gsoutHoriz] {
 
-      if(buf)
+      if(paged)
+      {
+        // calculate tight stride
+        size_t stride = 0;
+        for(const FormatElement &el : m_ModelVSIn->columns)
+          stride += el.byteSize();
+
+        stride = qMax((size_t)1, stride);
+
+        uint64_t size = 0;
+        if(m_ByteOffset < m_ObjectByteSize)
+          size = qMin(m_ByteSize, m_ObjectByteSize - m_ByteOffset);
+
+        QSharedPointer<BufferPager> pager(
+            new BufferPager(m_Ctx, m_ModelVSIn, m_BufferID, m_ByteOffset, size, stride));
+
+        m_ModelVSIn->setPager(pager);
+        m_ModelVSIn->numRows = pager->rowCount();
+        m_ModelVSIn->unclampedNumRows = 0;
+      }
+      else if(buf)
       {
         // calculate tight stride
         buf->stride = 0;
@@ -2907,6 +3175,7 @@ void BufferViewer::ClearModels()
       vb->deref();
 
     m->buffers.clear();
+    m->setPager(QSharedPointer<BufferPager>());
     m->columns.clear();
     m->generics.clear();
     m->genericsEnabled.clear();
@@ -2962,6 +3231,7 @@ void BufferViewer::CalcColumnWidth(int maxNumRows)
   indices[1] = 1000000;
 
   m_ModelVSIn->buffers.clear();
+  m_ModelVSIn->setPager(QSharedPointer<BufferPager>());
 
   struct TestData
   {
@@ -3194,7 +3464,23 @@ void BufferViewer::exportData(const BufferExport &params)
   LambdaThread *exportThread = new LambdaThread([this, params, model, f]() {
     if(params.format == BufferExport::RawBytes)
     {
-      if(!m_MeshView)
+      if(!m_MeshView && model->pager)
+      {
+        // the buffer is tightly packed, so write out each page in turn. Pages are fetched as needed
+        // since we're not on the UI thread
+        for(uint32_t row = 0; row < model->pager->rowCount(); row += model->pager->rowsPerPage())
+        {
+          size_t rowOffset = 0;
+          BufferData *page = model->pager->acquireRow(row, rowOffset, true);
+
+          if(page)
+          {
+            f->write((const char *)page->data, int(page->end - page->data));
+            page->deref();
+          }
+        }
+      }
+      else if(!m_MeshView)
       {
         // this is the simplest possible case, we just dump the contents of the first buffer, as
         // it's tightly packed
@@ -51,6 +51,8 @@ struct EventItemTag
   bool current = false;
   bool find = false;
   bool bookmark = false;
+  // the drawcall this item is for, if any, so its children can be created on demand
+  const DrawcallDescription *draw = NULL;
 };
 
 Q_DECLARE_METATYPE(EventItemTag);
@@ -64,6 +66,34 @@ enum
   COL_COUNT,
 };
 
+// returns the last EID and drawcall ID covered by draws[idx], including any children. Set markers
+// without children cover up to the next event.
+static QPair<uint32_t, uint32_t> LastEIDDraw(const rdcarray<DrawcallDescription> &draws, int idx)
+{
+  const DrawcallDescription &d = draws[idx];
+
+  if(!d.children.empty())
+  {
+    QPair<uint32_t, uint32_t> last = LastEIDDraw(d.children, d.children.count() - 1);
+
+    if(last.first != 0)
+      return last;
+  }
+
+  uint32_t lastEID = d.eventId;
+
+  if((d.flags & DrawFlags::SetMarker) && idx + 1 < draws.count())
+    lastEID = draws[idx + 1].eventId;
+
+  return qMakePair(lastEID, d.drawcallId);
+}
+
+static quint64 Trigram(const QString &str, int idx)
+{
+  return (quint64(str[idx].unicode()) << 32) | (quint64(str[idx + 1].unicode()) << 16) |
+         quint64(str[idx + 2].unicode());
+}
+
 static bool textEditControl(QWidget *sender)
 {
   if(qobject_cast<QLineEdit *>(sender) || qobject_cast<QTextEdit *>(sender) ||
@@ -189,6 +219,10 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
   QObject::connect(ui->events->header(), &QHeaderView::customContextMenuRequested, this,
                    &EventBrowser::events_contextMenu);
 
+  // children of each event are only created once they're needed, since a capture can have far too
+  // many events to create them all up front
+  ui->events->setLazyPopulate([this](RDTreeWidgetItem *item) { PopulateChildren(item); });
+
   OnCaptureClosed();
 
   m_redPalette = palette();
@@ -235,8 +269,16 @@ void EventBrowser::OnCaptureLoaded()
 
   frame->addChild(framestart);
 
-  QPair<uint32_t, uint32_t> lastEIDDraw = AddDrawcalls(frame, m_Ctx.CurDrawcalls());
+  const rdcarray<DrawcallDescription> &draws = m_Ctx.CurDrawcalls();
+
+  QPair<uint32_t, uint32_t> lastEIDDraw(0, 0);
+  if(!draws.empty())
+    lastEIDDraw = LastEIDDraw(draws, draws.count() - 1);
+
   frame->setTag(QVariant::fromValue(EventItemTag(0, lastEIDDraw.first)));
+  frame->setLazyChildren(!draws.empty());
+
+  BuildSearchIndex();
 
   ui->events->addTopLevelItem(frame);
 
@@ -262,6 +304,16 @@ void EventBrowser::OnCaptureClosed()
 
   ui->events->clear();
 
+  m_Times.clear();
+  m_DrawTimes.clear();
+  m_FrameTime = 0.0;
+
+  m_SearchEntries.clear();
+  m_SearchTrigrams.clear();
+  m_SearchFilter.clear();
+  m_SearchResults.clear();
+  m_FindEIDs.clear();
+
   ui->find->setEnabled(false);
   ui->gotoEID->setEnabled(false);
   ui->timeDraws->setEnabled(false);
@@ -278,117 +330,135 @@ void EventBrowser::OnEventChanged(uint32_t eventId)
   highlightBookmarks();
 }
 
-QPair<uint32_t, uint32_t> EventBrowser::AddDrawcalls(RDTreeWidgetItem *parent,
-                                                     const rdcarray<DrawcallDescription> &draws)
+RDTreeWidgetItem *EventBrowser::CreateDrawcallItem(const rdcarray<DrawcallDescription> &draws,
+                                                    int idx)
 {
-  uint lastEID = 0, lastDraw = 0;
+  const DrawcallDescription &d = draws[idx];
 
-  for(int32_t i = 0; i < draws.count(); i++)
-  {
-    const DrawcallDescription &d = draws[i];
+  QVariant name = QString(d.name);
 
-    QVariant name = QString(d.name);
+  RichResourceTextInitialise(name);
 
-    RichResourceTextInitialise(name);
+  RDTreeWidgetItem *child = new RDTreeWidgetItem(
+      {name, QString::number(d.eventId), QString::number(d.drawcallId), lit("---")});
 
-    RDTreeWidgetItem *child = new RDTreeWidgetItem(
-        {name, QString::number(d.eventId), QString::number(d.drawcallId), lit("---")});
+  QPair<uint32_t, uint32_t> last = LastEIDDraw(draws, idx);
 
-    QPair<uint32_t, uint32_t> last = AddDrawcalls(child, d.children);
-    lastEID = last.first;
-    lastDraw = last.second;
+  if(last.first > d.eventId && !d.children.empty())
+  {
+    child->setText(COL_EID, QFormatStr("%1-%2").arg(d.eventId).arg(last.first));
+    child->setText(COL_DRAW, QFormatStr("%1-%2").arg(d.drawcallId).arg(last.second));
+  }
 
-    if(lastEID > d.eventId)
-    {
-      child->setText(COL_EID, QFormatStr("%1-%2").arg(d.eventId).arg(lastEID));
-      child->setText(COL_DRAW, QFormatStr("%1-%2").arg(d.drawcallId).arg(lastDraw));
-    }
+  EventItemTag tag(d.eventId, last.first);
+  tag.draw = &d;
+  tag.find = m_FindEIDs.contains(d.eventId);
+  child->setTag(QVariant::fromValue(tag));
 
-    if(lastEID == 0)
-    {
-      lastEID = d.eventId;
-      lastDraw = d.drawcallId;
+  if(tag.find)
+    RefreshIcon(child, tag);
 
-      if((draws[i].flags & DrawFlags::SetMarker) && i + 1 < draws.count())
-        lastEID = draws[i + 1].eventId;
-    }
+  child->setLazyChildren(!d.children.empty());
 
-    child->setTag(QVariant::fromValue(EventItemTag(draws[i].eventId, lastEID)));
+  if(!m_Times.empty())
+    SetDrawcallTime(child, m_DrawTimes.value(d.eventId, -1.0));
 
-    if(m_Ctx.Config().EventBrowser_ApplyColors)
+  if(m_Ctx.Config().EventBrowser_ApplyColors)
+  {
+    // if alpha isn't 0, assume the colour is valid
+    if((d.flags & (DrawFlags::PushMarker | DrawFlags::SetMarker)) && d.markerColor[3] > 0.0f)
     {
-      // if alpha isn't 0, assume the colour is valid
-      if((d.flags & (DrawFlags::PushMarker | DrawFlags::SetMarker)) && d.markerColor[3] > 0.0f)
-      {
-        QColor col = QColor::fromRgb(
-            qRgb(d.markerColor[0] * 255.0f, d.markerColor[1] * 255.0f, d.markerColor[2] * 255.0f));
+      QColor col = QColor::fromRgb(
+          qRgb(d.markerColor[0] * 255.0f, d.markerColor[1] * 255.0f, d.markerColor[2] * 255.0f));
 
-        child->setTreeColor(col, 3.0f);
+      child->setTreeColor(col, 3.0f);
 
-        if(m_Ctx.Config().EventBrowser_ColorEventRow)
-        {
-          QColor textCol = ui->events->palette().color(QPalette::Text);
+      if(m_Ctx.Config().EventBrowser_ColorEventRow)
+      {
+        QColor textCol = ui->events->palette().color(QPalette::Text);
 
-          child->setBackgroundColor(col);
-          child->setForegroundColor(contrastingColor(col, textCol));
-        }
+        child->setBackgroundColor(col);
+        child->setForegroundColor(contrastingColor(col, textCol));
       }
     }
-
-    parent->addChild(child);
   }
 
-  return qMakePair(lastEID, lastDraw);
+  return child;
 }
 
-void EventBrowser::SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<CounterResult> &results)
+void EventBrowser::PopulateChildren(RDTreeWidgetItem *item)
 {
-  if(node == NULL)
+  if(!item->lazyChildren())
     return;
 
-  // parent nodes take the value of the sum of their children
-  double duration = 0.0;
+  item->setLazyChildren(false);
 
-  // look up leaf nodes in the dictionary
-  if(node->childCount() == 0)
-  {
-    uint32_t eid = node->tag().value<EventItemTag>().EID;
+  // the frame item has no drawcall, its children are the top-level drawcalls
+  const DrawcallDescription *draw = item->tag().value<EventItemTag>().draw;
+  const rdcarray<DrawcallDescription> &draws = draw ? draw->children : m_Ctx.CurDrawcalls();
 
-    duration = -1.0;
+  QVector<RDTreeWidgetItem *> children;
+  children.reserve(draws.count());
 
-    for(const CounterResult &r : results)
-    {
-      if(r.eventId == eid)
-        duration = r.value.d;
-    }
+  for(int32_t i = 0; i < draws.count(); i++)
+    children.push_back(CreateDrawcallItem(draws, i));
 
-    double secs = duration;
+  item->addChildren(children);
+}
 
-    if(m_TimeUnit == TimeUnit::Milliseconds)
-      secs *= 1000.0;
-    else if(m_TimeUnit == TimeUnit::Microseconds)
-      secs *= 1000000.0;
-    else if(m_TimeUnit == TimeUnit::Nanoseconds)
-      secs *= 1000000000.0;
+void EventBrowser::CalcDrawTimes()
+{
+  m_DrawTimes.clear();
 
-    node->setText(COL_DURATION, duration < 0.0f ? QString() : Formatter::Format(secs));
-    EventItemTag tag = node->tag().value<EventItemTag>();
-    tag.duration = duration;
-    node->setTag(QVariant::fromValue(tag));
+  QHash<uint32_t, double> times;
+  times.reserve(m_Times.count());
 
-    return;
-  }
+  for(const CounterResult &r : m_Times)
+    times[r.eventId] = r.value.d;
 
-  for(int i = 0; i < node->childCount(); i++)
+  // the frame start shares EID 0 with the frame, so store the frame's total separately
+  double start = times.value(0, -1.0);
+  m_DrawTimes[0] = start;
+
+  m_FrameTime = start > 0.0 ? start : 0.0;
+
+  for(const DrawcallDescription &d : m_Ctx.CurDrawcalls())
   {
-    SetDrawcallTimes(node->child(i), results);
+    double duration = CalcDrawTime(d, times);
 
-    double nd = node->child(i)->tag().value<EventItemTag>().duration;
+    if(duration > 0.0)
+      m_FrameTime += duration;
+  }
+}
+
+double EventBrowser::CalcDrawTime(const DrawcallDescription &drawcall,
+                                  const QHash<uint32_t, double> &times)
+{
+  // parent nodes take the value of the sum of their children
+  double duration = 0.0;
+
+  if(drawcall.children.empty())
+  {
+    duration = times.value(drawcall.eventId, -1.0);
+  }
+  else
+  {
+    for(const DrawcallDescription &d : drawcall.children)
+    {
+      double nd = CalcDrawTime(d, times);
 
-    if(nd > 0.0)
-      duration += nd;
+      if(nd > 0.0)
+        duration += nd;
+    }
   }
 
+  m_DrawTimes[drawcall.eventId] = duration;
+
+  return duration;
+}
+
+void EventBrowser::SetDrawcallTime(RDTreeWidgetItem *node, double duration)
+{
   double secs = duration;
 
   if(m_TimeUnit == TimeUnit::Milliseconds)
@@ -404,6 +474,21 @@ void EventBrowser::SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<Count
   node->setTag(QVariant::fromValue(tag));
 }
 
+void EventBrowser::SetDrawcallTimes(RDTreeWidgetItem *node)
+{
+  if(node == NULL)
+    return;
+
+  // only items that exist need updating, any others pick up their time when they're created
+  if(node->parent() == ui->events->invisibleRootItem())
+    SetDrawcallTime(node, m_FrameTime);
+  else
+    SetDrawcallTime(node, m_DrawTimes.value(node->tag().value<EventItemTag>().EID, -1.0));
+
+  for(int i = 0; i < node->childCount(); i++)
+    SetDrawcallTimes(node->child(i));
+}
+
 void EventBrowser::on_find_clicked()
 {
   ui->jumpStrip->hide();
@@ -437,7 +522,8 @@ void EventBrowser::on_timeDraws_clicked()
     m_Times = r->FetchCounters({GPUCounter::EventGPUDuration});
 
     GUIInvoke::call(this, [this]() {
-      SetDrawcallTimes(ui->events->topLevelItem(0), m_Times);
+      CalcDrawTimes();
+      SetDrawcallTimes(ui->events->topLevelItem(0));
       ui->events->update();
     });
   });
@@ -737,27 +823,7 @@ QString EventBrowser::GetExportDrawcallString(int indent, bool firstchild,
 
 double EventBrowser::GetDrawTime(const DrawcallDescription &drawcall)
 {
-  if(!drawcall.children.empty())
-  {
-    double total = 0.0;
-
-    for(const DrawcallDescription &d : drawcall.children)
-    {
-      double f = GetDrawTime(d);
-      if(f >= 0)
-        total += f;
-    }
-
-    return total;
-  }
-
-  for(const CounterResult &r : m_Times)
-  {
-    if(r.eventId == drawcall.eventId)
-      return r.value.d;
-  }
-
-  return -1.0;
+  return m_DrawTimes.value(drawcall.eventId, -1.0);
 }
 
 void EventBrowser::GetMaxNameLength(int &maxNameLength, int indent, bool firstchild,
@@ -938,7 +1004,7 @@ void EventBrowser::events_contextMenu(const QPoint &pos)
   collapseAll.setIcon(Icons::arrow_in());
   selectCols.setIcon(Icons::timeline_marker());
 
-  expandAll.setEnabled(item && item->childCount() > 0);
+  expandAll.setEnabled(item && (item->childCount() > 0 || item->lazyChildren()));
   collapseAll.setEnabled(item && item->childCount() > 0);
 
   QObject::connect(&expandAll, &QAction::triggered,
@@ -1096,21 +1162,28 @@ void EventBrowser::RefreshIcon(RDTreeWidgetItem *item, EventItemTag tag)
 
 bool EventBrowser::FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *parent, uint32_t eventId)
 {
+  PopulateChildren(parent);
+
   // do a reverse search to find the last match (in case of 'set' markers that
   // inherit the event of the next real draw).
   for(int i = parent->childCount() - 1; i >= 0; i--)
   {
     RDTreeWidgetItem *n = parent->child(i);
 
-    uint nEID = n->tag().value<EventItemTag>().lastEID;
+    EventItemTag tag = n->tag().value<EventItemTag>();
+    uint nEID = tag.lastEID;
     uint fEID = found ? found->tag().value<EventItemTag>().lastEID : 0;
 
     if(nEID >= eventId && (found == NULL || nEID <= fEID))
       found = n;
 
-    if(nEID == eventId && n->childCount() == 0)
+    if(nEID == eventId && n->childCount() == 0 && !n->lazyChildren())
       return true;
 
+    // only create children of nodes that could contain the event
+    if(n->lazyChildren() && eventId >= tag.EID && eventId <= nEID)
+      PopulateChildren(n);
+
     if(n->childCount() > 0)
     {
       bool exact = FindEventNode(found, n, eventId);
@@ -1161,9 +1234,12 @@ void EventBrowser::ClearFindIcons(RDTreeWidgetItem *parent)
     RDTreeWidgetItem *n = parent->child(i);
 
     EventItemTag tag = n->tag().value<EventItemTag>();
-    tag.find = false;
-    n->setTag(QVariant::fromValue(tag));
-    RefreshIcon(n, tag);
+    if(tag.find)
+    {
+      tag.find = false;
+      n->setTag(QVariant::fromValue(tag));
+      RefreshIcon(n, tag);
+    }
 
     if(n->childCount() > 0)
       ClearFindIcons(n);
@@ -1172,34 +1248,30 @@ void EventBrowser::ClearFindIcons(RDTreeWidgetItem *parent)
 
 void EventBrowser::ClearFindIcons()
 {
+  m_FindEIDs.clear();
+
   if(m_Ctx.IsCaptureLoaded())
     ClearFindIcons(ui->events->topLevelItem(0));
 }
 
-int EventBrowser::SetFindIcons(RDTreeWidgetItem *parent, QString filter)
+void EventBrowser::SetFindIcons(RDTreeWidgetItem *parent)
 {
-  int results = 0;
-
   for(int i = 0; i < parent->childCount(); i++)
   {
     RDTreeWidgetItem *n = parent->child(i);
 
-    if(n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
+    EventItemTag tag = n->tag().value<EventItemTag>();
+
+    if(m_FindEIDs.contains(tag.EID))
     {
-      EventItemTag tag = n->tag().value<EventItemTag>();
       tag.find = true;
       n->setTag(QVariant::fromValue(tag));
       RefreshIcon(n, tag);
-      results++;
     }
 
     if(n->childCount() > 0)
-    {
-      results += SetFindIcons(n, filter);
-    }
+      SetFindIcons(n);
   }
-
-  return results;
 }
 
 int EventBrowser::SetFindIcons(QString filter)
@@ -1207,63 +1279,131 @@ int EventBrowser::SetFindIcons(QString filter)
   if(filter.isEmpty())
     return 0;
 
-  return SetFindIcons(ui->events->topLevelItem(0), filter);
+  const QVector<int> &results = SearchEvents(filter);
+
+  m_FindEIDs.clear();
+  for(int idx : results)
+    m_FindEIDs.insert(m_SearchEntries[idx].EID);
+
+  // items that haven't been created yet check m_FindEIDs when they are
+  SetFindIcons(ui->events->topLevelItem(0));
+
+  return results.count();
 }
 
-RDTreeWidgetItem *EventBrowser::FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after)
+void EventBrowser::BuildSearchIndex()
 {
-  for(int i = 0; i < parent->childCount(); i++)
-  {
-    RDTreeWidgetItem *n = parent->child(i);
+  m_SearchEntries.clear();
+  m_SearchTrigrams.clear();
+  m_SearchFilter.clear();
+  m_SearchResults.clear();
 
-    uint eid = n->tag().value<EventItemTag>().lastEID;
+  // the frame start is searched like any other event
+  EventSearchEntry start;
+  start.next = 1;
+  start.name = tr("Frame Start").toLower();
+  m_SearchEntries.push_back(start);
 
-    if(eid > after && n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
-      return n;
+  AddSearchEntries(m_Ctx.CurDrawcalls());
 
-    if(n->childCount() > 0)
+  int rank = 0;
+  RankSearchEntries(0, m_SearchEntries.count(), rank);
+
+  for(int idx = 0; idx < m_SearchEntries.count(); idx++)
+  {
+    const QString &name = m_SearchEntries[idx].name;
+
+    for(int c = 0; c + 3 <= name.length(); c++)
     {
-      RDTreeWidgetItem *found = FindNode(n, filter, after);
+      QVector<int> &postings = m_SearchTrigrams[Trigram(name, c)];
 
-      if(found != NULL)
-        return found;
+      if(postings.isEmpty() || postings.back() != idx)
+        postings.push_back(idx);
     }
   }
+}
+
+void EventBrowser::AddSearchEntries(const rdcarray<DrawcallDescription> &draws)
+{
+  for(int32_t i = 0; i < draws.count(); i++)
+  {
+    int idx = m_SearchEntries.count();
+
+    EventSearchEntry entry;
+    entry.EID = draws[i].eventId;
+    entry.lastEID = LastEIDDraw(draws, i).first;
+    entry.name = QString(draws[i].name).toLower();
+    m_SearchEntries.push_back(entry);
 
-  return NULL;
+    AddSearchEntries(draws[i].children);
+
+    m_SearchEntries[idx].next = m_SearchEntries.count();
+  }
 }
 
-int EventBrowser::FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward)
+void EventBrowser::RankSearchEntries(int first, int end, int &rank)
 {
-  if(parent == NULL)
-    return -1;
+  // searching backwards visits siblings in reverse order, each before its own children
+  QVector<int> siblings;
+  for(int idx = first; idx < end; idx = m_SearchEntries[idx].next)
+    siblings.push_back(idx);
 
-  for(int i = forward ? 0 : parent->childCount() - 1; i >= 0 && i < parent->childCount();
-      i += forward ? 1 : -1)
+  for(int i = siblings.count() - 1; i >= 0; i--)
   {
-    auto n = parent->child(i);
+    EventSearchEntry &entry = m_SearchEntries[siblings[i]];
 
-    uint eid = n->tag().value<EventItemTag>().lastEID;
+    entry.backwardRank = rank++;
+    RankSearchEntries(siblings[i] + 1, entry.next, rank);
+  }
+}
+
+const QVector<int> &EventBrowser::SearchEvents(QString filter)
+{
+  filter = filter.toLower();
 
-    bool matchesAfter = (forward && eid > after) || (!forward && eid < after);
+  if(filter == m_SearchFilter)
+    return m_SearchResults;
 
-    if(matchesAfter)
+  m_SearchFilter = filter;
+  m_SearchResults.clear();
+
+  if(filter.isEmpty())
+    return m_SearchResults;
+
+  if(filter.length() < 3)
+  {
+    // too short to use the index
+    for(int idx = 0; idx < m_SearchEntries.count(); idx++)
     {
-      QString name = n->text(COL_NAME);
-      if(name.contains(filter, Qt::CaseInsensitive))
-        return (int)eid;
+      if(m_SearchEntries[idx].name.contains(filter))
+        m_SearchResults.push_back(idx);
     }
 
-    if(n->childCount() > 0)
-    {
-      int found = FindEvent(n, filter, after, forward);
+    return m_SearchResults;
+  }
 
-      if(found > 0)
-        return found;
-    }
+  // every trigram in the filter must be in a match, so only the entries in the shortest posting
+  // list need to be checked
+  const QVector<int> *candidates = NULL;
+
+  for(int c = 0; c + 3 <= filter.length(); c++)
+  {
+    auto it = m_SearchTrigrams.constFind(Trigram(filter, c));
+
+    if(it == m_SearchTrigrams.constEnd())
+      return m_SearchResults;
+
+    if(candidates == NULL || it->count() < candidates->count())
+      candidates = &it.value();
+  }
+
+  for(int idx : *candidates)
+  {
+    if(m_SearchEntries[idx].name.contains(filter))
+      m_SearchResults.push_back(idx);
   }
 
-  return -1;
+  return m_SearchResults;
 }
 
 int EventBrowser::FindEvent(QString filter, uint32_t after, bool forward)
@@ -1271,7 +1411,31 @@ int EventBrowser::FindEvent(QString filter, uint32_t after, bool forward)
   if(!m_Ctx.IsCaptureLoaded())
     return 0;
 
-  return FindEvent(ui->events->topLevelItem(0), filter, after, forward);
+  const QVector<int> &results = SearchEvents(filter);
+
+  // results are in tree order, so going forward the first match after the event is the one
+  if(forward)
+  {
+    for(int idx : results)
+    {
+      if(m_SearchEntries[idx].lastEID > after)
+        return (int)m_SearchEntries[idx].lastEID;
+    }
+
+    return -1;
+  }
+
+  const EventSearchEntry *best = NULL;
+
+  for(int idx : results)
+  {
+    const EventSearchEntry &entry = m_SearchEntries[idx];
+
+    if(entry.lastEID < after && (best == NULL || entry.backwardRank < best->backwardRank))
+      best = &entry;
+  }
+
+  return best ? (int)best->lastEID : -1;
 }
 
 void EventBrowser::Find(bool forward)
@@ -1316,5 +1480,5 @@ void EventBrowser::UpdateDurationColumn()
   ui->events->setHeaderText(COL_DURATION, tr("Duration (%1)").arg(UnitSuffix(m_TimeUnit)));
 
   if(!m_Times.empty())
-    SetDrawcallTimes(ui->events->topLevelItem(0), m_Times);
+    SetDrawcallTimes(ui->events->topLevelItem(0));
 }
@@ -25,7 +25,9 @@
 #pragma once
 
 #include <QFrame>
+#include <QHash>
 #include <QIcon>
+#include <QSet>
 #include "Code/Interface/QRDInterface.h"
 
 namespace Ui
@@ -41,6 +43,19 @@ class QTextStream;
 class FlowLayout;
 struct EventItemTag;
 
+// an event in the flattened list used for searching, in the same order as the tree
+struct EventSearchEntry
+{
+  uint32_t EID = 0;
+  uint32_t lastEID = 0;
+  // the index of the next entry that isn't a child of this one
+  int next = 0;
+  // the position of this entry when searching backwards through the tree
+  int backwardRank = 0;
+  // lower-cased name
+  QString name;
+};
+
 class EventBrowser : public QFrame, public IEventBrowser, public ICaptureViewer
 {
 private:
@@ -95,9 +110,13 @@ public slots:
   void jumpToBookmark(int idx);
 
 private:
-  QPair<uint32_t, uint32_t> AddDrawcalls(RDTreeWidgetItem *parent,
-                                         const rdcarray<DrawcallDescription> &draws);
-  void SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<CounterResult> &results);
+  RDTreeWidgetItem *CreateDrawcallItem(const rdcarray<DrawcallDescription> &draws, int idx);
+  void PopulateChildren(RDTreeWidgetItem *item);
+
+  void CalcDrawTimes();
+  double CalcDrawTime(const DrawcallDescription &drawcall, const QHash<uint32_t, double> &times);
+  void SetDrawcallTime(RDTreeWidgetItem *node, double duration);
+  void SetDrawcallTimes(RDTreeWidgetItem *node);
 
   void ExpandNode(RDTreeWidgetItem *node);
 
@@ -107,15 +126,18 @@ private:
   void ClearFindIcons(RDTreeWidgetItem *parent);
   void ClearFindIcons();
 
-  int SetFindIcons(RDTreeWidgetItem *parent, QString filter);
+  void SetFindIcons(RDTreeWidgetItem *parent);
   int SetFindIcons(QString filter);
 
   void repopulateBookmarks();
   void highlightBookmarks();
   bool hasBookmark(RDTreeWidgetItem *node);
 
-  RDTreeWidgetItem *FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after);
-  int FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward);
+  void BuildSearchIndex();
+  void AddSearchEntries(const rdcarray<DrawcallDescription> &draws);
+  void RankSearchEntries(int first, int end, int &rank);
+  const QVector<int> &SearchEvents(QString filter);
+
   int FindEvent(QString filter, uint32_t after, bool forward);
   void Find(bool forward);
 
@@ -131,6 +153,17 @@ private:
   TimeUnit m_TimeUnit = TimeUnit::Count;
 
   rdcarray<CounterResult> m_Times;
+  // durations of every drawcall by EID, with parents summing their children
+  QHash<uint32_t, double> m_DrawTimes;
+  double m_FrameTime = 0.0;
+
+  QVector<EventSearchEntry> m_SearchEntries;
+  // posting lists of entries containing each trigram of lower-cased characters
+  QHash<quint64, QVector<int>> m_SearchTrigrams;
+  QString m_SearchFilter;
+  QVector<int> m_SearchResults;
+  // EIDs of the events matching the current find, including ones with no tree item yet
+  QSet<uint32_t> m_FindEIDs;
 
   QTimer *m_FindHighlight;
 
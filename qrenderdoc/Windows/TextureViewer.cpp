@@ -778,6 +778,10 @@ void TextureViewer::RT_UpdateVisualRange(IReplayController *)
   rdcarray<uint32_t> histogram = m_Output->GetHistogram(ui->rangeHistogram->rangeMin(),
                                                         ui->rangeHistogram->rangeMax(), channels);
 
+  // if a newer range has been requested while we were calculating, don't flash this one up
+  if(m_Ctx.Replay().IsInvokeCancelled())
+    return;
+
   if(!histogram.empty())
   {
     QVector<uint32_t> histogramVec(histogram.count());
@@ -792,6 +796,14 @@ void TextureViewer::RT_UpdateVisualRange(IReplayController *)
   }
 }
 
+void TextureViewer::UpdateVisualRange()
+{
+  // the histogram is slow to calculate and only informational, so don't let it hold up anything
+  // interactive. Any older request that hasn't run yet is out of date.
+  m_Ctx.Replay().AsyncInvoke(lit("VisualRange"), InvokePriority::Background,
+                             [this](IReplayController *r) { RT_UpdateVisualRange(r); });
+}
+
 void TextureViewer::UI_UpdateStatusText()
 {
   TextureDescription *texptr = GetCurrentTexture();
@@ -1350,14 +1362,14 @@ void TextureViewer::UI_OnTextureSelectionChanged(bool newdraw)
     AutoFitRange();
 
   m_Ctx.Replay().AsyncInvoke([this](IReplayController *r) {
-    RT_UpdateVisualRange(r);
-
     RT_UpdateAndDisplay(r);
 
     if(m_Output != NULL)
       RT_PickPixelsAndUpdate(r);
   });
 
+  UpdateVisualRange();
+
   HighlightUsage();
 }
 
@@ -1571,7 +1583,7 @@ void TextureViewer::UI_UpdateChannels()
   m_TexDisplay.flipY = ui->flip_y->isChecked();
 
   INVOKE_MEMFN(RT_UpdateAndDisplay);
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UpdateVisualRange();
 }
 
 void TextureViewer::SetupTextureTabs()
@@ -2989,7 +3001,7 @@ void TextureViewer::rangePoint_Update()
 
   ui->rangeHistogram->setRange(black, white);
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UpdateVisualRange();
 }
 
 void TextureViewer::rangePoint_leave()
@@ -3025,7 +3037,7 @@ void TextureViewer::on_zoomRange_clicked()
 
   ui->rangeHistogram->setRange(black, white);
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UpdateVisualRange();
 }
 
 void TextureViewer::on_autoFit_clicked()
@@ -3046,7 +3058,7 @@ void TextureViewer::on_reset01_clicked()
 
   ui->autoFit->setChecked(false);
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UpdateVisualRange();
 }
 
 void TextureViewer::on_visualiseRange_clicked()
@@ -3056,7 +3068,7 @@ void TextureViewer::on_visualiseRange_clicked()
     ui->rangeHistogram->setMinimumSize(QSize(300, 90));
 
     m_Visualise = true;
-    INVOKE_MEMFN(RT_UpdateVisualRange);
+    UpdateVisualRange();
   }
   else
   {
@@ -3133,7 +3145,7 @@ void TextureViewer::AutoFitRange()
       {
         GUIInvoke::call(this, [this, minval, maxval]() {
           ui->rangeHistogram->setRange(minval, maxval);
-          INVOKE_MEMFN(RT_UpdateVisualRange);
+          UpdateVisualRange();
         });
       }
     }
@@ -3227,7 +3239,7 @@ void TextureViewer::on_mipLevel_currentIndexChanged(int index)
     return;
   }
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UpdateVisualRange();
 
   if(m_Output != NULL && m_PickedPoint.x() >= 0 && m_PickedPoint.y() >= 0)
   {
@@ -3249,7 +3261,7 @@ void TextureViewer::on_sliceFace_currentIndexChanged(int index)
   if(tex.depth > 1)
     m_TexDisplay.sliceFace = (uint32_t)(qMax(0, index) << (int)m_TexDisplay.mip);
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UpdateVisualRange();
 
   if(m_Output != NULL && m_PickedPoint.x() >= 0 && m_PickedPoint.y() >= 0)
   {
@@ -3526,23 +3538,28 @@ void TextureViewer::on_pixelHistory_clicked()
   // by the time we want to set the results.
   QPointer<QWidget> histWidget = hist->Widget();
 
-  // add a short delay so that controls repainting after a new panel appears can get at the
-  // render thread before we insert the long blocking pixel history task
-  LambdaThread *thread = new LambdaThread([this, texptr, x, y, hist, histWidget]() {
-    QThread::msleep(150);
-    m_Ctx.Replay().AsyncInvoke([this, texptr, x, y, hist, histWidget](IReplayController *r) {
-      rdcarray<PixelModification> history =
-          r->PixelHistory(texptr->resourceId, (uint32_t)x, (int32_t)y, m_TexDisplay.sliceFace,
-                          m_TexDisplay.mip, m_TexDisplay.sampleIdx, m_TexDisplay.typeHint);
-
-      GUIInvoke::call(this, [hist, histWidget, history] {
-        if(histWidget)
-          hist->SetHistory(history);
-      });
+  // the history is for the current event, so this runs in order with other normal priority work
+  // rather than letting a later event change overtake it. The display settings are captured now
+  // for the same reason. Each history window gets its own tag so that opening another doesn't
+  // cancel this one.
+  QString tag = QFormatStr("PixelHistory%1").arg((quintptr)hist);
+
+  ResourceId id = texptr->resourceId;
+  uint32_t slice = m_TexDisplay.sliceFace;
+  uint32_t mip = m_TexDisplay.mip;
+  uint32_t sample = m_TexDisplay.sampleIdx;
+  CompType typeHint = m_TexDisplay.typeHint;
+
+  m_Ctx.Replay().AsyncInvoke(tag, [this, id, x, y, slice, mip, sample, typeHint, hist,
+                                   histWidget](IReplayController *r) {
+    rdcarray<PixelModification> history =
+        r->PixelHistory(id, (uint32_t)x, (int32_t)y, slice, mip, sample, typeHint);
+
+    GUIInvoke::call(this, [hist, histWidget, history] {
+      if(histWidget)
+        hist->SetHistory(history);
     });
   });
-  thread->selfDelete(true);
-  thread->start();
 }
 
 void TextureViewer::on_texListShow_clicked()
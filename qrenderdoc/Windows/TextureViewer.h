@@ -250,6 +250,7 @@ private:
   void OpenResourceContextMenu(ResourceId id, const rdcarray<EventUsage> &usage);
 
   void AutoFitRange();
+  void UpdateVisualRange();
   void rangePoint_Update();
 
   void updateBackgroundColors();
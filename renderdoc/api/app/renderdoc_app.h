@@ -191,6 +191,18 @@ typedef enum {
   // 0 - API debugging is displayed as normal
   eRENDERDOC_Option_DebugOutputMute = 11,
 
+  // Defer tracking of descriptor contents while not capturing, and reconstruct it when a capture
+  // starts. This reduces overhead in applications that update many descriptors every frame, at
+  // the cost of a slower capture start.
+  //
+  // Note this currently only affects Vulkan.
+  //
+  // Default - disabled
+  //
+  // 1 - Descriptor tracking is deferred until a capture begins
+  // 0 - Descriptor tracking is kept up to date at all times
+  eRENDERDOC_Option_DeferDescriptorTracking = 12,
+
 } RENDERDOC_CaptureOption;
 
 // Sets an option that controls how RenderDoc behaves on capture.
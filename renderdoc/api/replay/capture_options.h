@@ -207,6 +207,22 @@ Default - enabled
 ``False`` - API debugging is displayed as normal.
 )");
   bool debugOutputMute;
+
+  DOCUMENT(R"(Defer tracking of descriptor contents while not capturing, and reconstruct it when
+a capture begins.
+
+.. note:: This currently only affects Vulkan, where tracking is deferred for descriptors that are
+  only read from.
+
+Default - disabled
+
+``True`` - Descriptor updates outside of a capture only store the new descriptors, and the
+bookkeeping of which resources they reference is rebuilt at capture start. This reduces overhead
+in applications that update many descriptors every frame, at the cost of a slower capture start.
+
+``False`` - Descriptor tracking is kept fully up to date at all times.
+)");
+  bool deferDescriptorTracking;
 };
 
 DECLARE_REFLECTION_STRUCT(CaptureOptions);
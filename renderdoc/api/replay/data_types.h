@@ -853,6 +853,91 @@ struct FrameStatistics
 
 DECLARE_REFLECTION_STRUCT(FrameStatistics);
 
+DOCUMENT("The CPU cost of processing all chunks of one type while a capture was loaded.");
+struct ChunkLoadStats
+{
+  DOCUMENT("");
+  bool operator==(const ChunkLoadStats &o) const { return chunkID == o.chunkID; }
+  bool operator<(const ChunkLoadStats &o) const { return chunkID < o.chunkID; }
+  DOCUMENT("The ID of this type of chunk, as in :data:`SDChunkMetaData.chunkID`.");
+  uint32_t chunkID;
+
+  DOCUMENT("The name of this type of chunk.");
+  rdcstr name;
+
+  DOCUMENT("How many chunks of this type were processed.");
+  uint32_t count;
+
+  DOCUMENT("The total size in bytes of all chunks of this type.");
+  uint64_t totalBytes;
+
+  DOCUMENT("The total time in seconds taken to process all chunks of this type.");
+  double totalTime;
+
+  DOCUMENT("The median time in seconds taken to process one chunk of this type.");
+  double medianTime;
+
+  DOCUMENT("The 90th percentile time in seconds taken to process one chunk of this type.");
+  double p90Time;
+
+  DOCUMENT("The 99th percentile time in seconds taken to process one chunk of this type.");
+  double p99Time;
+
+  DOCUMENT("The longest time in seconds taken to process one chunk of this type.");
+  double maxTime;
+};
+
+DECLARE_REFLECTION_STRUCT(ChunkLoadStats);
+
+DOCUMENT(R"(The CPU cost of processing all chunks that referred to one resource while a capture was
+loaded.
+
+A chunk is attributed to the last resource among its parameters, which for creation and initial
+contents chunks is the resource being created or initialised.
+)");
+struct ResourceLoadStats
+{
+  DOCUMENT("");
+  bool operator==(const ResourceLoadStats &o) const { return resourceId == o.resourceId; }
+  bool operator<(const ResourceLoadStats &o) const { return resourceId < o.resourceId; }
+  DOCUMENT("The :class:`ResourceId` of the resource.");
+  ResourceId resourceId;
+
+  DOCUMENT("How many chunks were attributed to this resource.");
+  uint32_t count;
+
+  DOCUMENT("The total time in seconds taken to process the chunks attributed to this resource.");
+  double totalTime;
+};
+
+DECLARE_REFLECTION_STRUCT(ResourceLoadStats);
+
+DOCUMENT(R"(Statistics about where CPU time was spent while the capture was loaded, covering the
+chunks before the frame and the first replay of the frame itself.
+
+Currently this information is only available on OpenGL and Vulkan.
+)");
+struct LoadStatistics
+{
+  DOCUMENT("");
+  LoadStatistics() : recorded(false), totalTime(0.0) {}
+  DOCUMENT("``True`` if the statistics in this structure are valid.");
+  bool recorded;
+
+  DOCUMENT("The total time in seconds taken to load the capture.");
+  double totalTime;
+
+  DOCUMENT("A list of :class:`ChunkLoadStats`, one for each type of chunk that was processed.");
+  rdcarray<ChunkLoadStats> chunks;
+
+  DOCUMENT(R"(A list of :class:`ResourceLoadStats`, one for each resource that had any chunks
+attributed to it.
+)");
+  rdcarray<ResourceLoadStats> resources;
+};
+
+DECLARE_REFLECTION_STRUCT(LoadStatistics);
+
 DOCUMENT("Contains frame-level global information");
 struct FrameDescription
 {
@@ -900,6 +985,9 @@ this counts the frame number when the capture was made.
   DOCUMENT("The :class:`frame statistics <FrameStatistics>`.");
   FrameStatistics stats;
 
+  DOCUMENT("The :class:`load statistics <LoadStatistics>`.");
+  LoadStatistics loadStats;
+
   DOCUMENT("A list of debug messages that are not associated with any particular event.");
   rdcarray<DebugMessage> debugMessages;
 };
@@ -770,6 +770,19 @@ function must be called from another thread.
 )");
   virtual void SetFrameEvent(uint32_t eventId, bool force) = 0;
 
+  DOCUMENT(R"(Speculatively move the replay forward to a later :data:`eventId <APIEvent.eventId>`
+and cache its pipeline state and the contents of its bound constant buffers, so that a following
+:meth:`SetFrameEvent` to it doesn't need to replay. This is intended to be called while the user is
+idle, for the event they are likely to step to next.
+
+Only events after the current one are prefetched, since moving forward can continue on from the
+current replay position. The current event and its pipeline state are unchanged. If anything needs
+the replay at the current event before moving on, the current event is replayed again.
+
+:param int eventId: The :data:`eventId <APIEvent.eventId>` to prefetch.
+)");
+  virtual void PrefetchEvent(uint32_t eventId) = 0;
+
   DOCUMENT(R"(Retrieve the current :class:`D3D11State` pipeline state.
 
 This pipeline state will be filled with default values if the capture is not using the D3D11 API.
@@ -1906,6 +1919,22 @@ This function will block until the capture is fully loaded and ready.
 extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
 RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, IRemoteServer **rend);
 
+DOCUMENT(R"(Check whether a remote server on the given hostname and port would accept a connection,
+without creating one.
+
+Unlike :func:`CreateRemoteServerConnection` this does not occupy the server, so it is suitable for
+polling.
+
+:param str host: The hostname to connect to, if blank then localhost is used.
+:param int port: The port to connect to, or the default port if 0.
+:return: :data:`ReplayStatus.Succeeded` if a connection would be accepted,
+  :data:`ReplayStatus.NetworkRemoteBusy` if the server is busy, or another error if the server
+  couldn't be reached.
+:rtype: ReplayStatus
+)");
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
+RENDERDOC_CheckRemoteServerStatus(const char *host, uint32_t port);
+
 DOCUMENT(R"(This launches a remote server which will continually run in a loop to server requests
 from external sources.
 
@@ -154,7 +154,11 @@ void SaveShaderCache(const char *filename, uint32_t magicNumber, uint32_t versio
 {
   string shadercache = FileIO::GetAppFolderFilename(filename);
 
-  FILE *f = FileIO::fopen(shadercache.c_str(), "wb");
+  // other processes could be writing the same cache, so write it out to a file of our own and move
+  // it into place once complete. Whichever finishes last wins, but the file is never torn.
+  string tmpcache = StringFormat::Fmt("%s.%u.tmp", shadercache.c_str(), Process::GetCurrentPID());
+
+  FILE *f = FileIO::fopen(tmpcache.c_str(), "wb");
 
   if(!f)
   {
@@ -181,5 +185,12 @@ void SaveShaderCache(const char *filename, uint32_t magicNumber, uint32_t versio
 
   FileIO::fclose(f);
 
+  if(!FileIO::Move(tmpcache.c_str(), shadercache.c_str(), true))
+  {
+    RDCERR("Error moving shader cache into place");
+    FileIO::Delete(tmpcache.c_str());
+    return;
+  }
+
   RDCDEBUG("Successfully wrote %u shaders to shader cache", numentries);
 }
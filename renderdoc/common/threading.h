@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <vector>
 #include "os/os_specific.h"
 
 namespace Threading
@@ -53,6 +54,94 @@ private:
   CriticalSection *m_CS;
   bool m_Owned;
 };
+
+// a lightweight lock for very short critical sections, cheap enough to embed one in many small
+// objects. Copying a SpinLock gives a new unlocked lock, so it can be a member of copyable structs.
+class SpinLock
+{
+public:
+  SpinLock() : m_Val(0) {}
+  SpinLock(const SpinLock &) : m_Val(0) {}
+  SpinLock &operator=(const SpinLock &) { return *this; }
+  bool Trylock() { return Atomic::CmpExch32(&m_Val, 0, 1) == 0; }
+  void Lock()
+  {
+    for(uint32_t spins = 0; !Trylock(); spins++)
+    {
+      // back off and let the holder run if we've been spinning a while
+      if(spins >= 1000)
+        Sleep(0);
+    }
+  }
+  void Unlock() { Atomic::CmpExch32(&m_Val, 1, 0); }
+private:
+  volatile int32_t m_Val;
+};
+
+class ScopedSpinLock
+{
+public:
+  ScopedSpinLock(SpinLock &sl) : m_SL(&sl) { m_SL->Lock(); }
+  ~ScopedSpinLock() { m_SL->Unlock(); }
+private:
+  SpinLock *m_SL;
+};
+
+// runs jobFunc(jobIndex) for every jobIndex in [0, numJobs) concurrently. Job 0 runs on the
+// calling thread (so it can safely do things like report progress) and this only returns once
+// every job has finished.
+inline void RunParallelJobs(uint32_t numJobs, const std::function<void(uint32_t)> &jobFunc)
+{
+  if(numJobs == 0)
+    return;
+
+  std::vector<ThreadHandle> threads;
+  threads.reserve(numJobs - 1);
+
+  for(uint32_t i = 1; i < numJobs; i++)
+  {
+    ThreadHandle th = CreateThread([&jobFunc, i]() { jobFunc(i); });
+
+    // if we couldn't create a thread, just run the job inline
+    if(th == 0)
+      jobFunc(i);
+    else
+      threads.push_back(th);
+  }
+
+  jobFunc(0);
+
+  for(ThreadHandle th : threads)
+  {
+    JoinThread(th);
+    CloseThread(th);
+  }
+}
+
+// runs func(i) for every i in [0, count). Indices are handed out one at a time to up to maxJobs
+// parallel jobs (by default one per core), so uneven work per index still balances out.
+inline void ParallelFor(uint32_t count, const std::function<void(uint32_t)> &func,
+                        uint32_t maxJobs = 0)
+{
+  if(maxJobs == 0)
+    maxJobs = GetCoreCount();
+  if(maxJobs == 0)
+    maxJobs = 1;
+
+  volatile int32_t next = -1;
+
+  RunParallelJobs(count < maxJobs ? count : maxJobs, [&next, count, &func](uint32_t) {
+    for(;;)
+    {
+      int32_t idx = Atomic::Inc32(&next);
+      if(idx >= (int32_t)count)
+        break;
+
+      func((uint32_t)idx);
+    }
+  });
+}
 };
 
 #define SCOPED_LOCK(cs) Threading::ScopedLock CONCAT(scopedlock, __LINE__)(cs);
+#define SCOPED_SPINLOCK(sl) Threading::ScopedSpinLock CONCAT(scopedspinlock, __LINE__)(sl);
@@ -0,0 +1,455 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "thumbnail.h"
+#include <math.h>
+#include <vector>
+#include "common/common.h"
+#include "maths/half_convert.h"
+
+// Each format has a row decoder which converts one row of source pixels to RGB8. The decoders are
+// kept free of per-pixel branches so that the compiler can vectorise them, and the box filter then
+// works on plain bytes regardless of the source format.
+typedef void (*RowDecoder)(const byte *src, uint32_t width, byte *rgb);
+
+template <uint32_t stride, uint32_t r, uint32_t g, uint32_t b>
+static void DecodeBytes(const byte *src, uint32_t width, byte *rgb)
+{
+  for(uint32_t x = 0; x < width; x++)
+  {
+    rgb[0] = src[r];
+    rgb[1] = src[g];
+    rgb[2] = src[b];
+    src += stride;
+    rgb += 3;
+  }
+}
+
+template <uint32_t stride>
+static void DecodeUNorm16(const byte *src, uint32_t width, byte *rgb)
+{
+  for(uint32_t x = 0; x < width; x++)
+  {
+    uint16_t data[3];
+    memcpy(data, src, sizeof(data));
+
+    // rescale to 8 bits with rounding
+    rgb[0] = byte((uint32_t(data[0]) * 255 + 32767) / 65535);
+    rgb[1] = byte((uint32_t(data[1]) * 255 + 32767) / 65535);
+    rgb[2] = byte((uint32_t(data[2]) * 255 + 32767) / 65535);
+    src += stride;
+    rgb += 3;
+  }
+}
+
+template <bool bgra>
+static void Decode1010102(const byte *src, uint32_t width, byte *rgb)
+{
+  for(uint32_t x = 0; x < width; x++)
+  {
+    uint32_t data;
+    memcpy(&data, src, sizeof(data));
+
+    // take the top 8 bits of each 10-bit component
+    byte c0 = byte((data >> 2) & 0xff);
+    byte c1 = byte((data >> 12) & 0xff);
+    byte c2 = byte((data >> 22) & 0xff);
+
+    rgb[0] = bgra ? c2 : c0;
+    rgb[1] = c1;
+    rgb[2] = bgra ? c0 : c2;
+    src += 4;
+    rgb += 3;
+  }
+}
+
+// expand 5 or 6 bit values to 8 bits by replicating the top bits into the bottom
+static inline byte Expand5(uint32_t v)
+{
+  return byte((v << 3) | (v >> 2));
+}
+
+static inline byte Expand6(uint32_t v)
+{
+  return byte((v << 2) | (v >> 4));
+}
+
+static void Decode565(const byte *src, uint32_t width, byte *rgb)
+{
+  for(uint32_t x = 0; x < width; x++)
+  {
+    uint16_t data;
+    memcpy(&data, src, sizeof(data));
+
+    rgb[0] = Expand5((data >> 11) & 0x1f);
+    rgb[1] = Expand6((data >> 5) & 0x3f);
+    rgb[2] = Expand5((data >> 0) & 0x1f);
+    src += 2;
+    rgb += 3;
+  }
+}
+
+static void Decode5551(const byte *src, uint32_t width, byte *rgb)
+{
+  for(uint32_t x = 0; x < width; x++)
+  {
+    uint16_t data;
+    memcpy(&data, src, sizeof(data));
+
+    rgb[0] = Expand5((data >> 10) & 0x1f);
+    rgb[1] = Expand5((data >> 5) & 0x1f);
+    rgb[2] = Expand5((data >> 0) & 0x1f);
+    src += 2;
+    rgb += 3;
+  }
+}
+
+// lookup table from every possible half-float bit pattern to an sRGB-encoded byte, clamping the
+// linear value to [0, 1]. Negative values and NaNs map to 0.
+static const byte *GetHalfToSRGB8Table()
+{
+  static const std::vector<byte> table = []() {
+    std::vector<byte> ret(0x10000);
+
+    for(uint32_t i = 0; i < 0x10000; i++)
+    {
+      float linear = ConvertFromHalf(uint16_t(i));
+
+      // written so that NaN fails the comparison and is treated as 0
+      if(!(linear > 0.0f))
+        linear = 0.0f;
+      else if(linear > 1.0f)
+        linear = 1.0f;
+
+      float srgb;
+      if(linear < 0.0031308f)
+        srgb = 12.92f * linear;
+      else
+        srgb = 1.055f * powf(linear, 1.0f / 2.4f) - 0.055f;
+
+      ret[i] = byte(RDCCLAMP(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+    }
+
+    return ret;
+  }();
+
+  return table.data();
+}
+
+template <uint32_t stride>
+static void DecodeHalf(const byte *src, uint32_t width, byte *rgb)
+{
+  const byte *table = GetHalfToSRGB8Table();
+
+  for(uint32_t x = 0; x < width; x++)
+  {
+    uint16_t data[3];
+    memcpy(data, src, sizeof(data));
+
+    rgb[0] = table[data[0]];
+    rgb[1] = table[data[1]];
+    rgb[2] = table[data[2]];
+    src += stride;
+    rgb += 3;
+  }
+}
+
+static RowDecoder GetRowDecoder(const ResourceFormat &fmt)
+{
+  switch(fmt.type)
+  {
+    case ResourceFormatType::R10G10B10A2:
+      return fmt.bgraOrder ? &Decode1010102<true> : &Decode1010102<false>;
+    case ResourceFormatType::R5G6B5: return &Decode565;
+    case ResourceFormatType::R5G5B5A1: return &Decode5551;
+    case ResourceFormatType::Regular: break;
+    default: return NULL;
+  }
+
+  if(fmt.compByteWidth == 1 && fmt.compCount == 4)
+    return fmt.bgraOrder ? &DecodeBytes<4, 2, 1, 0> : &DecodeBytes<4, 0, 1, 2>;
+  if(fmt.compByteWidth == 1 && fmt.compCount == 3)
+    return fmt.bgraOrder ? &DecodeBytes<3, 2, 1, 0> : &DecodeBytes<3, 0, 1, 2>;
+  if(fmt.compByteWidth == 2 && fmt.compType == CompType::Float && fmt.compCount == 4)
+    return &DecodeHalf<8>;
+  if(fmt.compByteWidth == 2 && fmt.compType == CompType::Float && fmt.compCount == 3)
+    return &DecodeHalf<6>;
+  if(fmt.compByteWidth == 2 && fmt.compType == CompType::UNorm && fmt.compCount == 4)
+    return &DecodeUNorm16<8>;
+  if(fmt.compByteWidth == 2 && fmt.compType == CompType::UNorm && fmt.compCount == 3)
+    return &DecodeUNorm16<6>;
+
+  return NULL;
+}
+
+void CalcThumbnailSize(uint32_t srcWidth, uint32_t srcHeight, uint32_t maxWidth, uint16_t &width,
+                       uint16_t &height)
+{
+  width = height = 0;
+
+  if(srcWidth == 0 || srcHeight == 0)
+    return;
+
+  width = (uint16_t)RDCMIN(maxWidth, srcWidth);
+  width &= ~0x7;    // align down to multiple of 8
+  height = uint16_t(float(width) * float(srcHeight) / float(srcWidth));
+}
+
+bool IsThumbnailFormatSupported(const ResourceFormat &fmt)
+{
+  return GetRowDecoder(fmt) != NULL;
+}
+
+bool DownscaleToRGB8(const byte *src, uint32_t srcWidth, uint32_t srcHeight, uint32_t rowPitch,
+                     const ResourceFormat &fmt, bool flipY, byte *dst, uint32_t dstWidth,
+                     uint32_t dstHeight)
+{
+  RowDecoder decode = GetRowDecoder(fmt);
+
+  if(decode == NULL)
+  {
+    RDCERR("Unsupported format for thumbnail: %s", ToStr(fmt.type).c_str());
+    return false;
+  }
+
+  if(srcWidth == 0 || srcHeight == 0 || dstWidth == 0 || dstHeight == 0)
+    return true;
+
+  // the range of source columns that contribute to each destination column. Destination column x
+  // covers [colStart[x], colEnd[x]) which is always at least one column wide.
+  std::vector<uint32_t> colStart(dstWidth), colEnd(dstWidth);
+  for(uint32_t x = 0; x < dstWidth; x++)
+  {
+    colStart[x] = uint32_t(uint64_t(x) * srcWidth / dstWidth);
+    colEnd[x] = RDCMAX(uint32_t(uint64_t(x + 1) * srcWidth / dstWidth), colStart[x] + 1);
+  }
+
+  std::vector<byte> decoded(srcWidth * 3);
+
+  // per source column, the sum over all the source rows that land in the current destination row.
+  std::vector<uint32_t> colSums(srcWidth * 3);
+
+  for(uint32_t y = 0; y < dstHeight; y++)
+  {
+    uint32_t rowStart = uint32_t(uint64_t(y) * srcHeight / dstHeight);
+    uint32_t rowEnd = RDCMAX(uint32_t(uint64_t(y + 1) * srcHeight / dstHeight), rowStart + 1);
+
+    memset(colSums.data(), 0, colSums.size() * sizeof(uint32_t));
+
+    for(uint32_t sy = rowStart; sy < rowEnd; sy++)
+    {
+      const byte *row = src + size_t(rowPitch) * (flipY ? srcHeight - 1 - sy : sy);
+
+      decode(row, srcWidth, decoded.data());
+
+      uint32_t *sums = colSums.data();
+      const byte *rgb = decoded.data();
+      for(size_t i = 0; i < colSums.size(); i++)
+        sums[i] += rgb[i];
+    }
+
+    const uint32_t numRows = rowEnd - rowStart;
+
+    for(uint32_t x = 0; x < dstWidth; x++)
+    {
+      // these can overflow 32-bits when shrinking very large images down to tiny thumbnails
+      uint64_t r = 0, g = 0, b = 0;
+
+      for(uint32_t sx = colStart[x]; sx < colEnd[x]; sx++)
+      {
+        r += colSums[sx * 3 + 0];
+        g += colSums[sx * 3 + 1];
+        b += colSums[sx * 3 + 2];
+      }
+
+      const uint32_t count = numRows * (colEnd[x] - colStart[x]);
+
+      dst[0] = byte((r + count / 2) / count);
+      dst[1] = byte((g + count / 2) / count);
+      dst[2] = byte((b + count / 2) / count);
+      dst += 3;
+    }
+  }
+
+  return true;
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Thumbnail downscaling", "[thumbnail]")
+{
+  ResourceFormat rgba8;
+  rgba8.type = ResourceFormatType::Regular;
+  rgba8.compType = CompType::UNorm;
+  rgba8.compCount = 4;
+  rgba8.compByteWidth = 1;
+
+  SECTION("Thumbnail size")
+  {
+    uint16_t w = 0, h = 0;
+
+    CalcThumbnailSize(3840, 2160, 2048, w, h);
+    CHECK(w == 2048);
+    CHECK(h == 1152);
+
+    CalcThumbnailSize(1366, 768, 2048, w, h);
+    CHECK(w == 1360);
+    CHECK(h == 764);
+
+    CalcThumbnailSize(0, 0, 2048, w, h);
+    CHECK(w == 0);
+    CHECK(h == 0);
+  };
+
+  SECTION("Box filter averages covered pixels")
+  {
+    // 4x2 image, each 2x2 block should average to one output pixel
+    const byte src[] = {
+        0,   0,   0,   255, 10,  20,  30,  255, 100, 100, 100, 255, 200, 200, 200, 255,
+        20,  40,  60,  255, 30,  60,  90,  255, 100, 100, 100, 255, 201, 201, 201, 255,
+    };
+
+    byte dst[6] = {};
+    REQUIRE(DownscaleToRGB8(src, 4, 2, 16, rgba8, false, dst, 2, 1));
+
+    CHECK(dst[0] == 15);
+    CHECK(dst[1] == 30);
+    CHECK(dst[2] == 45);
+    CHECK(dst[3] == 150);
+    CHECK(dst[4] == 150);
+    CHECK(dst[5] == 150);
+  };
+
+  SECTION("Swizzle, flip and replication")
+  {
+    const byte src[] = {
+        1, 2, 3, 255, 4, 5, 6, 255,
+    };
+
+    ResourceFormat bgra8 = rgba8;
+    bgra8.bgraOrder = true;
+
+    // 1x2 image, flipped and with BGRA order
+    byte dst[6] = {};
+    REQUIRE(DownscaleToRGB8(src, 1, 2, 4, bgra8, true, dst, 1, 2));
+
+    CHECK(dst[0] == 6);
+    CHECK(dst[1] == 5);
+    CHECK(dst[2] == 4);
+    CHECK(dst[3] == 3);
+    CHECK(dst[4] == 2);
+    CHECK(dst[5] == 1);
+
+    // upscaling a single pixel replicates it
+    byte up[12] = {};
+    REQUIRE(DownscaleToRGB8(src, 1, 1, 4, rgba8, false, up, 2, 2));
+
+    for(int i = 0; i < 4; i++)
+    {
+      CHECK(up[i * 3 + 0] == 1);
+      CHECK(up[i * 3 + 1] == 2);
+      CHECK(up[i * 3 + 2] == 3);
+    }
+  };
+
+  SECTION("Packed formats")
+  {
+    ResourceFormat fmt;
+    byte dst[3] = {};
+
+    fmt.type = ResourceFormatType::R5G6B5;
+    uint16_t red565 = 0xf800;
+    REQUIRE(DownscaleToRGB8((const byte *)&red565, 1, 1, 2, fmt, false, dst, 1, 1));
+    CHECK(dst[0] == 255);
+    CHECK(dst[1] == 0);
+    CHECK(dst[2] == 0);
+
+    fmt.type = ResourceFormatType::R5G5B5A1;
+    uint16_t green5551 = 0x03e0;
+    REQUIRE(DownscaleToRGB8((const byte *)&green5551, 1, 1, 2, fmt, false, dst, 1, 1));
+    CHECK(dst[0] == 0);
+    CHECK(dst[1] == 255);
+    CHECK(dst[2] == 0);
+
+    fmt.type = ResourceFormatType::R10G10B10A2;
+    uint32_t red1010102 = 0x3ff;
+    REQUIRE(DownscaleToRGB8((const byte *)&red1010102, 1, 1, 4, fmt, false, dst, 1, 1));
+    CHECK(dst[0] == 255);
+    CHECK(dst[1] == 0);
+    CHECK(dst[2] == 0);
+
+    fmt.bgraOrder = true;
+    REQUIRE(DownscaleToRGB8((const byte *)&red1010102, 1, 1, 4, fmt, false, dst, 1, 1));
+    CHECK(dst[0] == 0);
+    CHECK(dst[1] == 0);
+    CHECK(dst[2] == 255);
+
+    fmt.type = ResourceFormatType::BC1;
+    CHECK_FALSE(IsThumbnailFormatSupported(fmt));
+    CHECK_FALSE(DownscaleToRGB8((const byte *)&red1010102, 1, 1, 4, fmt, false, dst, 1, 1));
+  };
+
+  SECTION("Linear half-float converts to sRGB")
+  {
+    ResourceFormat fmt;
+    fmt.type = ResourceFormatType::Regular;
+    fmt.compType = CompType::Float;
+    fmt.compCount = 4;
+    fmt.compByteWidth = 2;
+
+    uint16_t src[4] = {ConvertToHalf(0.5f), ConvertToHalf(-1.0f), ConvertToHalf(4.0f),
+                       ConvertToHalf(1.0f)};
+
+    byte dst[3] = {};
+    REQUIRE(DownscaleToRGB8((const byte *)src, 1, 1, 8, fmt, false, dst, 1, 1));
+
+    CHECK(dst[0] == 188);
+    CHECK(dst[1] == 0);
+    CHECK(dst[2] == 255);
+  };
+
+  SECTION("16-bit UNorm is rescaled to 8 bits")
+  {
+    ResourceFormat fmt;
+    fmt.type = ResourceFormatType::Regular;
+    fmt.compType = CompType::UNorm;
+    fmt.compCount = 4;
+    fmt.compByteWidth = 2;
+
+    uint16_t src[4] = {0xffff, 0x8080, 0x0000, 0xffff};
+
+    byte dst[3] = {};
+    REQUIRE(IsThumbnailFormatSupported(fmt));
+    REQUIRE(DownscaleToRGB8((const byte *)src, 1, 1, 8, fmt, false, dst, 1, 1));
+
+    CHECK(dst[0] == 255);
+    CHECK(dst[1] == 128);
+    CHECK(dst[2] == 0);
+  };
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
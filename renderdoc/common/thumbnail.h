@@ -0,0 +1,47 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "api/replay/renderdoc_replay.h"
+
+// picks the size of a capture thumbnail for a source image - at most maxWidth wide while preserving
+// the aspect ratio, and with the width aligned down to a multiple of 8 as the JPEG encoder needs.
+void CalcThumbnailSize(uint32_t srcWidth, uint32_t srcHeight, uint32_t maxWidth, uint16_t &width,
+                       uint16_t &height);
+
+// returns true if DownscaleToRGB8 can convert from this format.
+bool IsThumbnailFormatSupported(const ResourceFormat &fmt);
+
+// box-filters an image down to a tightly packed RGB8 image of dstWidth x dstHeight, averaging all
+// the source pixels that land in each destination pixel. If the destination is larger than the
+// source in either dimension, pixels are replicated instead.
+//
+// 8-bit and 16-bit UNorm formats are treated as already being in display space, 16-bit float
+// formats are treated as linear and converted to sRGB. If flipY is set, the source rows are read
+// bottom-up. Returns false if the format isn't supported.
+bool DownscaleToRGB8(const byte *src, uint32_t srcWidth, uint32_t srcHeight, uint32_t rowPitch,
+                     const ResourceFormat &fmt, bool flipY, byte *dst, uint32_t dstWidth,
+                     uint32_t dstHeight);
@@ -406,6 +406,10 @@ void RenderDoc::ProcessGlobalEnvironment(GlobalEnvironment env, const std::vecto
     for(size_t i = 0; i < args.size(); i++)
       RDCDEBUG("[%u]: %s", (uint32_t)i, args[i].c_str());
   }
+
+  for(const std::string &a : args)
+    if(a == "--remote-server-worker")
+      m_RemoteServerWorker = true;
 }
 
 bool RenderDoc::MatchClosestWindow(void *&dev, void *&wnd)
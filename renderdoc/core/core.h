@@ -387,6 +387,9 @@ public:
   void SetConfigSetting(string name, string value) { m_ConfigSettings[name] = value; }
   void BecomeRemoteServer(const char *listenhost, uint16_t port, RENDERDOC_KillCallback killReplay,
                           RENDERDOC_PreviewWindowCallback previewWindow);
+  // set by the --remote-server-worker argument, which a dispatching remote server passes to the
+  // worker processes it launches
+  bool IsRemoteServerWorker() const { return m_RemoteServerWorker; }
 
   void SetCaptureOptions(const CaptureOptions &opts);
   const CaptureOptions &GetCaptureOptions() const { return m_Options; }
@@ -552,6 +555,7 @@ private:
   vector<RENDERDOC_InputButton> m_CaptureKeys;
 
   GlobalEnvironment m_GlobalEnv;
+  bool m_RemoteServerWorker = false;
 
   FrameTimer m_FrameTimer;
 
@@ -35,7 +35,10 @@
 #include "strings/string_utils.h"
 #include "replay_proxy.h"
 
-static const uint32_t RemoteServerProtocolVersion = 3;
+#define XXH_STATIC_LINKING_ONLY
+#include "3rdparty/zstd/xxhash.h"
+
+static const uint32_t RemoteServerProtocolVersion = 6;
 
 enum RemoteServerPacket
 {
@@ -67,6 +70,9 @@ enum RemoteServerPacket
   eRemoteServer_GetSectionProperties,
   eRemoteServer_GetSectionContents,
   eRemoteServer_WriteSection,
+  eRemoteServer_CaptureChunk,
+  eRemoteServer_Redirect,
+  eRemoteServer_StatusHandshake,
   eRemoteServer_RemoteServerCount,
 };
 
@@ -92,21 +98,359 @@ struct ClientThread
   Threading::ThreadHandle thread;
 };
 
-static void InactiveRemoteClientThread(ClientThread *threadData)
+// how long a worker waits for its redirected client to connect before giving up
+static const uint32_t RemoteWorkerIdleTimeoutMS = 30 * 1000;
+
+// when 'workers' is configured, the listening server doesn't replay anything itself. Each client
+// that connects is handed off to its own worker process listening on a port after the server's,
+// so that clients are isolated from each other and don't queue behind one busy replay.
+struct RemoteWorkerPool
+{
+  RemoteWorkerPool(const std::string &workerExe, const char *listenhost, uint16_t port,
+                   uint32_t maxWorkers)
+      : exe(workerExe), host(listenhost ? listenhost : ""), basePort(port), pids(maxWorkers, 0)
+  {
+  }
+
+  // workers are launched with renderdoccmd's remoteserver command. The server could be hosted in
+  // some other program like the UI or python, in which case renderdoccmd is found alongside the UI
+  // instead. Returns an empty string if it can't be found.
+  static std::string FindWorkerExecutable()
+  {
+    std::string exe;
+    FileIO::GetExecutableFilename(exe);
+
+    std::string name = strlower(basename(exe));
+    if(name == "renderdoccmd" || name == "renderdoccmd.exe")
+      return exe;
+
+#if ENABLED(RDOC_WIN32)
+    exe = dirname(FileIO::GetReplayAppFilename()) + "/renderdoccmd.exe";
+#else
+    exe = dirname(FileIO::GetReplayAppFilename()) + "/renderdoccmd";
+#endif
+
+    if(FileIO::exists(exe.c_str()))
+      return exe;
+
+    return "";
+  }
+
+  // whether a client connecting now could be given a worker, without launching one
+  bool HasFreeSlot()
+  {
+    SCOPED_LOCK(lock);
+
+    for(uint32_t pid : pids)
+      if(pid == 0 || !Process::IsProcessRunning(pid))
+        return true;
+
+    return false;
+  }
+
+  // launches a worker into a free slot and returns the port it will listen on, or 0 if all
+  // workers are busy.
+  uint16_t Launch()
+  {
+    SCOPED_LOCK(lock);
+
+    for(size_t i = 0; i < pids.size(); i++)
+    {
+      if(pids[i] != 0 && Process::IsProcessRunning(pids[i]))
+        continue;
+
+      uint16_t port = uint16_t(basePort + 1 + i);
+
+      // --worker tells the worker to serve a single client and then exit
+      std::string cmdLine = StringFormat::Fmt("remoteserver --worker --port %u", port);
+      if(!host.empty())
+        cmdLine += " --host " + host;
+
+      pids[i] = Process::LaunchProcess(exe.c_str(), "", cmdLine.c_str(), true);
+
+      if(pids[i] == 0)
+      {
+        RDCERR("Couldn't launch replay worker '%s %s'", exe.c_str(), cmdLine.c_str());
+        return 0;
+      }
+
+      RDCLOG("Launched replay worker %u on port %u", pids[i], port);
+
+      return port;
+    }
+
+    return 0;
+  }
+
+  Threading::CriticalSection lock;
+  std::string exe;
+  std::string host;
+  uint16_t basePort;
+  std::vector<uint32_t> pids;
+};
+
+// captures are copied to the server in content-defined chunks, so that chunks the server already
+// has from a previous copy - of the same capture, or a different one with some of the same data -
+// don't need to be sent again. Boundaries are found with a gear hash so they move with the
+// content if data is inserted or removed earlier in the file.
+static const uint64_t MinCaptureChunkSize = 256 * 1024;
+static const uint64_t MaxCaptureChunkSize = 4 * 1024 * 1024;
+// 20 bits gives an average chunk size of around 1MB
+static const uint64_t CaptureChunkMask = 0xFFFFFULL << 44;
+
+// budget for the server's chunk cache, in MB, if the RemoteServer_ChunkCacheMB config setting
+// doesn't override it
+static const uint64_t DefaultChunkCacheMB = 8 * 1024;
+
+struct GearTable
+{
+  GearTable()
+  {
+    // any fixed pseudo-random values will do, but they must not change between versions
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for(size_t i = 0; i < 256; i++)
+    {
+      state += 0x9E3779B97F4A7C15ULL;
+      uint64_t z = state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      values[i] = z ^ (z >> 31);
+    }
+  }
+
+  uint64_t values[256];
+};
+
+// each chunk is identified by two 64-bit hashes with different seeds
+struct ChunkHasher
+{
+  ChunkHasher() { Reset(); }
+  void Reset()
+  {
+    XXH64_reset(&state[0], 0);
+    XXH64_reset(&state[1], 0x52444F43ULL);
+  }
+  void Update(const byte *data, size_t length)
+  {
+    XXH64_update(&state[0], data, length);
+    XXH64_update(&state[1], data, length);
+  }
+  void Finish(std::vector<uint64_t> &hashes)
+  {
+    hashes.push_back(XXH64_digest(&state[0]));
+    hashes.push_back(XXH64_digest(&state[1]));
+  }
+
+  XXH64_state_t state[2];
+};
+
+static bool ComputeCaptureChunks(const char *filename, std::vector<uint64_t> &lengths,
+                                 std::vector<uint64_t> &hashes)
+{
+  static const GearTable gear;
+
+  FILE *f = FileIO::fopen(filename, "rb");
+
+  if(!f)
+    return false;
+
+  std::vector<byte> buf(1024 * 1024);
+
+  ChunkHasher hasher;
+  uint64_t rolling = 0;
+  uint64_t chunkLength = 0;
+
+  for(;;)
+  {
+    size_t numRead = FileIO::fread(buf.data(), 1, buf.size(), f);
+
+    if(numRead == 0)
+      break;
+
+    size_t start = 0;
+
+    for(size_t i = 0; i < numRead; i++)
+    {
+      rolling = (rolling << 1) + gear.values[buf[i]];
+      chunkLength++;
+
+      if((chunkLength >= MinCaptureChunkSize && (rolling & CaptureChunkMask) == 0) ||
+         chunkLength >= MaxCaptureChunkSize)
+      {
+        hasher.Update(buf.data() + start, i + 1 - start);
+        hasher.Finish(hashes);
+        lengths.push_back(chunkLength);
+
+        hasher.Reset();
+        rolling = 0;
+        chunkLength = 0;
+        start = i + 1;
+      }
+    }
+
+    hasher.Update(buf.data() + start, numRead - start);
+  }
+
+  if(chunkLength > 0)
+  {
+    hasher.Finish(hashes);
+    lengths.push_back(chunkLength);
+  }
+
+  FileIO::fclose(f);
+
+  return true;
+}
+
+static std::string GetChunkCacheFolder()
+{
+  return FileIO::GetAppFolderFilename("remote_chunks");
+}
+
+static std::string GetCachedChunkName(const uint64_t *hash)
+{
+  return StringFormat::Fmt("%016llx%016llx.chunk", hash[0], hash[1]);
+}
+
+static bool VerifyCachedChunk(const std::string &path, uint64_t length, const uint64_t *hash)
+{
+  FILE *f = FileIO::fopen(path.c_str(), "rb");
+
+  if(!f)
+    return false;
+
+  std::vector<byte> buf(1024 * 1024);
+  ChunkHasher hasher;
+  uint64_t total = 0;
+
+  for(;;)
+  {
+    size_t numRead = FileIO::fread(buf.data(), 1, buf.size(), f);
+
+    if(numRead == 0)
+      break;
+
+    hasher.Update(buf.data(), numRead);
+    total += numRead;
+  }
+
+  FileIO::fclose(f);
+
+  std::vector<uint64_t> received;
+  hasher.Finish(received);
+
+  return total == length && received[0] == hash[0] && received[1] == hash[1];
+}
+
+// every copy into the chunk cache holds a shared lock on this file for as long as it needs its
+// chunks, and trimming takes an exclusive lock. That serialises trimming between worker processes
+// and stops it deleting anything a copy in progress is writing or about to assemble from.
+static FILE *LockChunkCache(bool exclusive, bool wait)
+{
+  std::string path = GetChunkCacheFolder() + "/cache.lock";
+
+  FileIO::CreateParentDirectory(path);
+
+  FILE *f = FileIO::fopen(path.c_str(), "ab");
+
+  if(f && !FileIO::lockfile(f, exclusive, wait))
+  {
+    FileIO::fclose(f);
+    f = NULL;
+  }
+
+  return f;
+}
+
+static void UnlockChunkCache(FILE *lock)
+{
+  if(lock)
+  {
+    FileIO::unlockfile(lock);
+    FileIO::fclose(lock);
+  }
+}
+
+// delete the least recently used chunks until the cache is within budget. Chunks are touched
+// whenever a copy reuses them, so their modified time is when they were last used.
+static void TrimChunkCache()
+{
+  // if any copy is still in progress, it will trim when it's done instead
+  FILE *lock = LockChunkCache(true, false);
+
+  if(!lock)
+    return;
+
+  uint64_t budget = DefaultChunkCacheMB;
+
+  const std::string &setting = RenderDoc::Inst().GetConfigSetting("RemoteServer_ChunkCacheMB");
+  if(!setting.empty())
+    budget = strtoull(setting.c_str(), NULL, 10);
+
+  budget *= 1024 * 1024;
+
+  std::string folder = GetChunkCacheFolder();
+
+  std::vector<PathEntry> files;
+
+  uint64_t total = 0;
+  for(const PathEntry &f : FileIO::GetFilesInDirectory(folder.c_str()))
+  {
+    if(f.flags & (PathProperty::Directory | PathProperty::ErrorUnknown |
+                  PathProperty::ErrorAccessDenied | PathProperty::ErrorInvalidPath))
+      continue;
+
+    std::string filename = f.filename.c_str();
+
+    // with no copy in progress, any partially received chunk is left over from one that was killed
+    if(endswith(filename, ".tmp"))
+    {
+      FileIO::Delete((folder + "/" + filename).c_str());
+      continue;
+    }
+
+    if(!endswith(filename, ".chunk"))
+      continue;
+
+    files.push_back(f);
+    total += f.size;
+  }
+
+  if(total > budget)
+  {
+    std::sort(files.begin(), files.end(),
+              [](const PathEntry &a, const PathEntry &b) { return a.lastmod < b.lastmod; });
+
+    for(const PathEntry &f : files)
+    {
+      if(total <= budget)
+        break;
+
+      FileIO::Delete((folder + "/" + std::string(f.filename.c_str())).c_str());
+      total -= f.size;
+    }
+  }
+
+  UnlockChunkCache(lock);
+}
+
+static void InactiveRemoteClientThread(ClientThread *threadData, RemoteWorkerPool *workers)
 {
   uint32_t ip = threadData->socket->GetRemoteIP();
 
   {
     uint32_t version = 0;
+    RemoteServerPacket type = eRemoteServer_Noop;
 
     {
       ReadSerialiser ser(new StreamReader(threadData->socket, Ownership::Nothing), Ownership::Stream);
 
-      // this thread just handles receiving the handshake and sending a busy signal without blocking
-      // the server thread
-      RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+      // this thread just handles receiving the handshake and sending a busy signal or a worker
+      // to redirect to, without blocking the server thread
+      type = ser.ReadChunk<RemoteServerPacket>();
 
-      if(ser.IsErrored() || type != eRemoteServer_Handshake)
+      if(ser.IsErrored() ||
+         (type != eRemoteServer_Handshake && type != eRemoteServer_StatusHandshake))
       {
         RDCWARN("Didn't receive proper handshake");
         SAFE_DELETE(threadData->socket);
@@ -133,9 +477,32 @@ static void InactiveRemoteClientThread(ClientThread *threadData)
           SCOPED_SERIALISE_CHUNK(eRemoteServer_VersionMismatch);
         }
       }
+      else if(type == eRemoteServer_StatusHandshake)
+      {
+        // status queries only want to know if a connection would succeed, so don't launch a
+        // worker for them
+        if(workers && workers->HasFreeSlot())
+        {
+          SCOPED_SERIALISE_CHUNK(eRemoteServer_Handshake);
+        }
+        else
+        {
+          SCOPED_SERIALISE_CHUNK(eRemoteServer_Busy);
+        }
+      }
       else
       {
-        SCOPED_SERIALISE_CHUNK(eRemoteServer_Busy);
+        uint16_t port = workers ? workers->Launch() : 0;
+
+        if(port != 0)
+        {
+          SCOPED_SERIALISE_CHUNK(eRemoteServer_Redirect);
+          SERIALISE_ELEMENT(port);
+        }
+        else
+        {
+          SCOPED_SERIALISE_CHUNK(eRemoteServer_Busy);
+        }
       }
     }
 
@@ -154,15 +521,17 @@ static void ActiveRemoteClientThread(ClientThread *threadData,
   uint32_t ip = client->GetRemoteIP();
 
   uint32_t version = 0;
+  RemoteServerPacket type = eRemoteServer_Noop;
 
   {
     ReadSerialiser ser(new StreamReader(client, Ownership::Nothing), Ownership::Stream);
 
     // this thread just handles receiving the handshake and sending a busy signal without blocking
     // the server thread
-    RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+    type = ser.ReadChunk<RemoteServerPacket>();
 
-    if(ser.IsErrored() || type != eRemoteServer_Handshake)
+    if(ser.IsErrored() ||
+       (type != eRemoteServer_Handshake && type != eRemoteServer_StatusHandshake))
     {
       RDCWARN("Didn't receive proper handshake");
       SAFE_DELETE(client);
@@ -197,6 +566,13 @@ static void ActiveRemoteClientThread(ClientThread *threadData,
     }
   }
 
+  // a status query is answered by the handshake alone
+  if(type == eRemoteServer_StatusHandshake)
+  {
+    SAFE_DELETE(client);
+    return;
+  }
+
   std::vector<std::string> tempFiles;
   IRemoteDriver *remoteDriver = NULL;
   IReplayDriver *replayDriver = NULL;
@@ -309,35 +685,180 @@ static void ActiveRemoteClientThread(ClientThread *threadData,
     }
     else if(type == eRemoteServer_CopyCaptureToRemote)
     {
-      std::string path;
-      std::string dummy, dummy2;
-      FileIO::GetDefaultFiles("remotecopy", path, dummy, dummy2);
+      std::vector<uint64_t> chunkLengths;
+      std::vector<uint64_t> chunkHashes;
 
-      RDCLOG("Copying file to local path '%s'.", path.c_str());
+      {
+        READ_DATA_SCOPE();
+        SERIALISE_ELEMENT(chunkLengths);
+        SERIALISE_ELEMENT(chunkHashes);
+      }
 
-      FileIO::CreateParentDirectory(path);
+      reader.EndChunk();
 
+      if(reader.IsErrored() || chunkHashes.size() != chunkLengths.size() * 2)
       {
-        READ_DATA_SCOPE();
+        RDCERR("Invalid capture chunk list");
+        break;
+      }
+
+      std::string cacheFolder = GetChunkCacheFolder();
+
+      // held until the file is assembled, so none of the chunks are trimmed underneath us
+      FILE *cacheLock = LockChunkCache(false, true);
+
+      if(!cacheLock)
+        RDCWARN("Couldn't lock the capture chunk cache");
+
+      std::map<std::string, uint64_t> cached;
 
-        StreamWriter streamWriter(FileIO::fopen(path.c_str(), "wb"), Ownership::Stream);
+      for(const PathEntry &f : FileIO::GetFilesInDirectory(cacheFolder.c_str()))
+        cached[f.filename.c_str()] = f.size;
 
-        ser.SerialiseStream(path.c_str(), streamWriter, NULL);
+      // chunks left over from an earlier interrupted copy are found here too, so only what's still
+      // missing gets sent.
+      std::vector<uint32_t> missing;
+
+      for(uint32_t i = 0; i < (uint32_t)chunkLengths.size(); i++)
+      {
+        std::string name = GetCachedChunkName(&chunkHashes[i * 2]);
+
+        auto it = cached.find(name);
+        if(it == cached.end() || it->second != chunkLengths[i])
+          missing.push_back(i);
+        else
+          FileIO::Touch((cacheFolder + "/" + name).c_str());
       }
 
-      reader.EndChunk();
+      RDCLOG("Receiving %zu of %zu capture chunks.", missing.size(), chunkLengths.size());
 
-      if(reader.IsErrored())
       {
-        FileIO::Delete(path.c_str());
+        WRITE_DATA_SCOPE();
+        SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureToRemote);
+        SERIALISE_ELEMENT(missing);
+      }
+
+      bool success = true;
+      bool aborted = false;
+
+      // each chunk goes into the cache as soon as it arrives, so a disconnect loses at most one
+      for(size_t m = 0; m < missing.size() && success; m++)
+      {
+        type = reader.ReadChunk<RemoteServerPacket>();
+
+        uint32_t idx = ~0U;
 
+        if(type == eRemoteServer_CaptureChunk)
+        {
+          READ_DATA_SCOPE();
+          SERIALISE_ELEMENT(idx);
+        }
+
+        // the client sends an invalid index with no data if it can't send the rest of the file
+        if(!reader.IsErrored() && type == eRemoteServer_CaptureChunk && idx == ~0U)
+        {
+          reader.EndChunk();
+          aborted = true;
+          break;
+        }
+
+        if(reader.IsErrored() || idx != missing[m])
+        {
+          RDCERR("Unexpected capture chunk");
+          success = false;
+          break;
+        }
+
+        std::string chunkPath = cacheFolder + "/" + GetCachedChunkName(&chunkHashes[idx * 2]);
+
+        // another connection could be receiving the same chunk, so write somewhere unique first
+        std::string tmpPath = StringFormat::Fmt("%s.%llu.tmp", chunkPath.c_str(),
+                                                (uint64_t)Threading::GetCurrentID());
+
+        FileIO::CreateParentDirectory(tmpPath);
+
+        {
+          READ_DATA_SCOPE();
+
+          StreamWriter streamWriter(FileIO::fopen(tmpPath.c_str(), "wb"), Ownership::Stream);
+
+          ser.SerialiseStream(tmpPath.c_str(), streamWriter, NULL);
+        }
+
+        reader.EndChunk();
+
+        if(reader.IsErrored() ||
+           !VerifyCachedChunk(tmpPath, chunkLengths[idx], &chunkHashes[idx * 2]))
+        {
+          RDCERR("Error receiving capture chunk %u", idx);
+          FileIO::Delete(tmpPath.c_str());
+          success = false;
+          break;
+        }
+
+        FileIO::Move(tmpPath.c_str(), chunkPath.c_str(), true);
+      }
+
+      if(!success)
+      {
+        UnlockChunkCache(cacheLock);
         RDCERR("Network error receiving file");
         break;
       }
 
-      RDCLOG("File received.");
+      std::string path;
 
-      tempFiles.push_back(path);
+      if(aborted)
+      {
+        RDCWARN("Client aborted capture copy");
+        success = false;
+      }
+      else
+      {
+        std::string dummy, dummy2;
+        FileIO::GetDefaultFiles("remotecopy", path, dummy, dummy2);
+
+        RDCLOG("Assembling file at local path '%s'.", path.c_str());
+
+        FileIO::CreateParentDirectory(path);
+
+        StreamWriter fileWriter(FileIO::fopen(path.c_str(), "wb"), Ownership::Stream);
+
+        for(size_t i = 0; i < chunkLengths.size() && !fileWriter.IsErrored(); i++)
+        {
+          std::string chunkPath = cacheFolder + "/" + GetCachedChunkName(&chunkHashes[i * 2]);
+
+          StreamReader chunkReader(FileIO::fopen(chunkPath.c_str(), "rb"));
+
+          if(chunkReader.IsErrored() || chunkReader.GetSize() != chunkLengths[i])
+          {
+            RDCERR("Capture chunk %zu missing from cache", i);
+            success = false;
+            break;
+          }
+
+          StreamTransfer(&fileWriter, &chunkReader, NULL);
+        }
+
+        success &= !fileWriter.IsErrored();
+      }
+
+      if(!success)
+      {
+        if(!path.empty())
+          FileIO::Delete(path.c_str());
+        path = "";
+      }
+      else
+      {
+        RDCLOG("File received.");
+
+        tempFiles.push_back(path);
+      }
+
+      UnlockChunkCache(cacheLock);
+
+      TrimChunkCache();
 
       {
         WRITE_DATA_SCOPE();
@@ -809,6 +1330,8 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
 
   std::vector<std::pair<uint32_t, uint32_t> > listenRanges;
   bool allowExecution = true;
+  uint32_t maxWorkers = 0;
+  uint64_t workerMemoryMB = 0;
 
   FILE *f = FileIO::fopen(FileIO::GetAppFolderFilename("remoteserver.conf").c_str(), "r");
 
@@ -848,6 +1371,18 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
 
       continue;
     }
+    else if(line.substr(0, sizeof("workers") - 1) == "workers")
+    {
+      maxWorkers = (uint32_t)atoi(line.c_str() + sizeof("workers"));
+
+      continue;
+    }
+    else if(line.substr(0, sizeof("workermemory") - 1) == "workermemory")
+    {
+      workerMemoryMB = (uint64_t)atoll(line.c_str() + sizeof("workermemory"));
+
+      continue;
+    }
 
     RDCLOG("Malformed line '%s'. See documentation for file format.", line.c_str());
   }
@@ -885,12 +1420,45 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
   else
     RDCLOG("Blocking execution commands");
 
+  // workers serve exactly one client, redirected to them by the dispatching server
+  const bool isWorker = IsRemoteServerWorker();
+
+  RemoteWorkerPool *workers = NULL;
+
+  if(isWorker)
+  {
+    RDCLOG("Running as a replay worker for a single client");
+
+    // the GPU memory used by the replay can't be limited here, only CPU memory
+    if(workerMemoryMB > 0)
+      Process::LimitProcessMemory(workerMemoryMB * 1024 * 1024);
+  }
+  else if(maxWorkers > 0)
+  {
+    std::string workerExe = RemoteWorkerPool::FindWorkerExecutable();
+
+    if(workerExe.empty())
+    {
+      RDCWARN("Couldn't find renderdoccmd to launch replay workers, serving clients in-process");
+    }
+    else
+    {
+      RDCLOG("Dispatching clients to up to %u replay workers on ports %u to %u", maxWorkers,
+             port + 1, port + maxWorkers);
+
+      workers = new RemoteWorkerPool(workerExe, listenhost, port, maxWorkers);
+    }
+  }
+
   RDCLOG("Replay host ready for requests...");
 
   ClientThread *activeClientData = NULL;
 
   std::vector<ClientThread *> inactives;
 
+  bool servedClient = false;
+  PerformanceTimer idleTimer;
+
   while(!killReplay())
   {
     Network::Socket *client = sock->AcceptClient(false);
@@ -919,10 +1487,23 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
 
       delete activeClientData;
       activeClientData = NULL;
+
+      // a worker has done its job once its client disconnects
+      if(isWorker)
+      {
+        SAFE_DELETE(client);
+        break;
+      }
     }
 
     if(client == NULL)
     {
+      if(isWorker && !servedClient && idleTimer.GetMilliseconds() > RemoteWorkerIdleTimeoutMS)
+      {
+        RDCWARN("No client connected to replay worker, shutting down");
+        break;
+      }
+
       if(!sock->Connected())
       {
         RDCERR("Error in accept - shutting down server");
@@ -962,8 +1543,10 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
       continue;
     }
 
-    if(activeClientData == NULL)
+    if(activeClientData == NULL && workers == NULL && !servedClient)
     {
+      servedClient = isWorker;
+
       activeClientData = new ClientThread();
       activeClientData->socket = client;
       activeClientData->allowExecution = allowExecution;
@@ -980,12 +1563,15 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
       inactive->socket = client;
       inactive->allowExecution = false;
 
-      inactive->thread =
-          Threading::CreateThread([inactive]() { InactiveRemoteClientThread(inactive); });
+      inactive->thread = Threading::CreateThread(
+          [inactive, workers]() { InactiveRemoteClientThread(inactive, workers); });
 
       inactives.push_back(inactive);
 
-      RDCLOG("Refusing inactive connection");
+      if(workers)
+        RDCLOG("Dispatching connection to a replay worker");
+      else
+        RDCLOG("Refusing inactive connection");
     }
   }
 
@@ -1007,6 +1593,9 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
     delete inactives[i];
   }
 
+  // any workers still running are left to finish serving their clients
+  SAFE_DELETE(workers);
+
   SAFE_DELETE(sock);
 }
 
@@ -1329,14 +1918,104 @@ public:
 
   rdcstr CopyCaptureToRemote(const char *filename, RENDERDOC_ProgressCallback progress)
   {
+    std::vector<uint64_t> chunkLengths;
+    std::vector<uint64_t> chunkHashes;
+
+    if(!ComputeCaptureChunks(filename, chunkLengths, chunkHashes))
+    {
+      RDCERR("Couldn't open '%s' to copy to remote", filename);
+      return "";
+    }
+
     {
       WRITE_DATA_SCOPE();
       SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureToRemote);
+      SERIALISE_ELEMENT(chunkLengths);
+      SERIALISE_ELEMENT(chunkHashes);
+    }
+
+    std::vector<uint32_t> missing;
+
+    {
+      READ_DATA_SCOPE();
+      RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+
+      if(type == eRemoteServer_CopyCaptureToRemote)
+      {
+        SERIALISE_ELEMENT(missing);
+      }
+      else
+      {
+        RDCERR("Unexpected response to capture copy request");
+        ser.EndChunk();
+        return "";
+      }
+
+      ser.EndChunk();
+    }
+
+    // only send the chunks the server doesn't already have
+    std::vector<uint64_t> chunkOffsets(chunkLengths.size());
+    for(size_t i = 1; i < chunkLengths.size(); i++)
+      chunkOffsets[i] = chunkOffsets[i - 1] + chunkLengths[i - 1];
+
+    uint64_t totalSize = 0, sentSize = 0;
+    for(uint32_t idx : missing)
+      totalSize += chunkLengths[idx];
+
+    if(progress)
+      progress(0.0001f);
+
+    FILE *f = FileIO::fopen(filename, "rb");
 
-      StreamReader fileStream(FileIO::fopen(filename, "rb"));
-      ser.SerialiseStream(filename, fileStream, progress);
+    bool aborted = false;
+
+    for(uint32_t idx : missing)
+    {
+      if(idx >= chunkLengths.size() || f == NULL)
+      {
+        aborted = true;
+        break;
+      }
+
+      FileIO::fseek64(f, chunkOffsets[idx], SEEK_SET);
+
+      {
+        WRITE_DATA_SCOPE();
+        SCOPED_SERIALISE_CHUNK(eRemoteServer_CaptureChunk);
+        SERIALISE_ELEMENT(idx);
+
+        StreamReader chunkStream(f, chunkLengths[idx], Ownership::Nothing);
+        ser.SerialiseStream(filename, chunkStream, NULL);
+      }
+
+      if(writer.IsErrored())
+        break;
+
+      sentSize += chunkLengths[idx];
+
+      if(progress)
+        progress(float(sentSize) / float(totalSize));
     }
 
+    if(f)
+      FileIO::fclose(f);
+
+    // the server is still waiting for chunks, so tell it we're giving up rather than leaving it
+    // mid-copy. It still replies, with no path.
+    if(aborted)
+    {
+      RDCERR("Couldn't send '%s' to remote, aborting copy", filename);
+
+      WRITE_DATA_SCOPE();
+      SCOPED_SERIALISE_CHUNK(eRemoteServer_CaptureChunk);
+      uint32_t idx = ~0U;
+      SERIALISE_ELEMENT(idx);
+    }
+
+    if(progress)
+      progress(1.0f);
+
     std::string path;
 
     {
@@ -1802,12 +2481,10 @@ private:
   std::vector<std::pair<RDCDriver, std::string> > m_Proxies;
 };
 
-extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
-RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, IRemoteServer **rend)
+// returns the address to connect to for a remote server on host, and adjusts port for the default
+// and for android devices
+static std::string GetRemoteServerAddress(const char *host, uint32_t &port)
 {
-  if(rend == NULL)
-    return ReplayStatus::InternalError;
-
   string s = "localhost";
   if(host != NULL && host[0] != '\0')
     s = host;
@@ -1830,6 +2507,14 @@ RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, IRemoteS
       port += RenderDoc_AndroidPortOffset * (index + 1);
   }
 
+  return s;
+}
+
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
+RENDERDOC_CheckRemoteServerStatus(const char *host, uint32_t port)
+{
+  string s = GetRemoteServerAddress(host, port);
+
   Network::Socket *sock = Network::CreateClientSocket(s.c_str(), (uint16_t)port, 750);
 
   if(sock == NULL)
@@ -1842,40 +2527,137 @@ RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, IRemoteS
 
     ser.SetStreamingMode(true);
 
-    SCOPED_SERIALISE_CHUNK(eRemoteServer_Handshake);
+    SCOPED_SERIALISE_CHUNK(eRemoteServer_StatusHandshake);
     SERIALISE_ELEMENT(version);
   }
 
   if(!sock->Connected())
+  {
+    SAFE_DELETE(sock);
     return ReplayStatus::NetworkIOFailed;
+  }
+
+  RemoteServerPacket type = eRemoteServer_Noop;
+  bool errored = false;
 
   {
     ReadSerialiser ser(new StreamReader(sock, Ownership::Nothing), Ownership::Stream);
 
-    RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+    type = ser.ReadChunk<RemoteServerPacket>();
 
     ser.EndChunk();
 
-    if(type == eRemoteServer_Busy)
+    errored = ser.IsErrored();
+  }
+
+  SAFE_DELETE(sock);
+
+  if(type == eRemoteServer_Busy)
+    return ReplayStatus::NetworkRemoteBusy;
+
+  if(type == eRemoteServer_VersionMismatch)
+    return ReplayStatus::NetworkVersionMismatch;
+
+  if(errored || type != eRemoteServer_Handshake)
+  {
+    RDCWARN("Didn't get proper handshake");
+    return ReplayStatus::NetworkIOFailed;
+  }
+
+  return ReplayStatus::Succeeded;
+}
+
+extern "C" RENDERDOC_API ReplayStatus RENDERDOC_CC
+RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, IRemoteServer **rend)
+{
+  if(rend == NULL)
+    return ReplayStatus::InternalError;
+
+  string s = GetRemoteServerAddress(host, port);
+
+  Network::Socket *sock = Network::CreateClientSocket(s.c_str(), (uint16_t)port, 750);
+
+  if(sock == NULL)
+    return ReplayStatus::NetworkIOFailed;
+
+  uint32_t version = RemoteServerProtocolVersion;
+
+  RemoteServerPacket type = eRemoteServer_Noop;
+  bool errored = false;
+
+  // a dispatching server may redirect us to a worker, at most once
+  for(int attempt = 0; attempt < 2; attempt++)
+  {
     {
-      SAFE_DELETE(sock);
-      return ReplayStatus::NetworkRemoteBusy;
+      WriteSerialiser ser(new StreamWriter(sock, Ownership::Nothing), Ownership::Stream);
+
+      ser.SetStreamingMode(true);
+
+      SCOPED_SERIALISE_CHUNK(eRemoteServer_Handshake);
+      SERIALISE_ELEMENT(version);
     }
 
-    if(type == eRemoteServer_VersionMismatch)
+    if(!sock->Connected())
     {
       SAFE_DELETE(sock);
-      return ReplayStatus::NetworkVersionMismatch;
+      return ReplayStatus::NetworkIOFailed;
     }
 
-    if(ser.IsErrored() || type != eRemoteServer_Handshake)
+    uint16_t workerPort = 0;
+
     {
-      RDCWARN("Didn't get proper handshake");
-      SAFE_DELETE(sock);
+      ReadSerialiser ser(new StreamReader(sock, Ownership::Nothing), Ownership::Stream);
+
+      type = ser.ReadChunk<RemoteServerPacket>();
+
+      if(type == eRemoteServer_Redirect && attempt == 0)
+        SERIALISE_ELEMENT(workerPort);
+
+      ser.EndChunk();
+
+      errored = ser.IsErrored();
+    }
+
+    if(workerPort == 0)
+      break;
+
+    SAFE_DELETE(sock);
+
+    // the worker has only just been launched, so give it some time to start listening
+    for(int retry = 0; retry < 20 && sock == NULL; retry++)
+    {
+      sock = Network::CreateClientSocket(s.c_str(), workerPort, 750);
+
+      if(sock == NULL)
+        Threading::Sleep(250);
+    }
+
+    if(sock == NULL)
+    {
+      RDCERR("Couldn't connect to replay worker on port %u", workerPort);
       return ReplayStatus::NetworkIOFailed;
     }
   }
 
+  if(type == eRemoteServer_Busy)
+  {
+    SAFE_DELETE(sock);
+    return ReplayStatus::NetworkRemoteBusy;
+  }
+
+  if(type == eRemoteServer_VersionMismatch)
+  {
+    SAFE_DELETE(sock);
+    return ReplayStatus::NetworkVersionMismatch;
+  }
+
+  if(errored || type != eRemoteServer_Handshake)
+  {
+    RDCWARN("Didn't get proper handshake");
+    SAFE_DELETE(sock);
+    return ReplayStatus::NetworkIOFailed;
+  }
+
   *rend = new RemoteServer(sock, host);
 
   return ReplayStatus::Succeeded;
@@ -24,6 +24,8 @@
  ******************************************************************************/
 
 #include "resource_manager.h"
+#include <algorithm>
+#include <queue>
 
 namespace ResourceIDGen
 {
@@ -51,6 +53,97 @@ void SetReplayResourceIDs()
 
 INSTANTIATE_SERIALISE_TYPE(ResourceManagerInternal::WrittenRecord);
 
+void SortChunks(RecordChunkList &chunks)
+{
+  std::sort(chunks.begin(), chunks.end(),
+            [](const std::pair<int32_t, Chunk *> &a, const std::pair<int32_t, Chunk *> &b) {
+              return a.first < b.first;
+            });
+}
+
+void MergeSortedChunks(std::vector<RecordChunkList> &lists, RecordChunkList &sorted)
+{
+  sorted.clear();
+
+  if(lists.size() == 1)
+  {
+    sorted.swap(lists[0]);
+    return;
+  }
+
+  size_t total = 0;
+  for(const RecordChunkList &list : lists)
+    total += list.size();
+
+  sorted.reserve(total);
+
+  // min-heap of the next chunk ID in each list, and which list it came from. There's only one list
+  // per worker thread so this stays tiny.
+  typedef std::pair<int32_t, size_t> HeapEntry;
+  std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+  std::vector<size_t> cursors(lists.size(), 0);
+
+  for(size_t i = 0; i < lists.size(); i++)
+    if(!lists[i].empty())
+      heap.push(HeapEntry(lists[i][0].first, i));
+
+  while(!heap.empty())
+  {
+    size_t l = heap.top().second;
+    heap.pop();
+
+    sorted.push_back(lists[l][cursors[l]]);
+    cursors[l]++;
+
+    if(cursors[l] < lists[l].size())
+      heap.push(HeapEntry(lists[l][cursors[l]].first, l));
+  }
+
+  for(RecordChunkList &list : lists)
+    list.clear();
+}
+
+void GatherSortedChunks(size_t numRecords,
+                        const std::function<void(size_t, RecordChunkList &)> &insertFunc,
+                        const std::function<void(float)> &progressFunc, RecordChunkList &sorted)
+{
+  // below this many records per thread it's not worth spinning up workers
+  const size_t minRecordsPerJob = 512;
+
+  uint32_t numJobs = (uint32_t)RDCCLAMP(numRecords / minRecordsPerJob, (size_t)1,
+                                        (size_t)Threading::GetCoreCount());
+
+  std::vector<RecordChunkList> lists(numJobs);
+
+  // records are handed out one at a time rather than in fixed ranges, since the number of chunks
+  // per record varies wildly.
+  volatile int32_t nextRecord = 0;
+  volatile int32_t processed = 0;
+
+  Threading::RunParallelJobs(numJobs, [&](uint32_t job) {
+    RecordChunkList &list = lists[job];
+
+    for(;;)
+    {
+      size_t idx = (size_t)Atomic::Inc32(&nextRecord) - 1;
+
+      if(idx >= numRecords)
+        break;
+
+      insertFunc(idx, list);
+
+      int32_t done = Atomic::Inc32(&processed);
+
+      if(job == 0 && progressFunc)
+        progressFunc(float(done) / float(numRecords));
+    }
+
+    SortChunks(list);
+  });
+
+  MergeSortedChunks(lists, sorted);
+}
+
 bool MarkReferenced(std::map<ResourceId, FrameRefType> &refs, ResourceId id, FrameRefType refType)
 {
   if(refs.find(id) == refs.end())
@@ -141,3 +234,121 @@ void ResourceRecord::Delete(ResourceRecordHandler *mgr)
     mgr->DestroyResourceRecord(this);
   }
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+#include "common/timing.h"
+
+// chunks are never dereferenced when gathering, so tests use fake pointers that encode their ID.
+static Chunk *FakeChunk(int32_t id)
+{
+  return (Chunk *)(uintptr_t)(id * 16);
+}
+
+struct TestResourceRecord : public ResourceRecord
+{
+  TestResourceRecord() : ResourceRecord(ResourceId(), false) {}
+  void AddTestChunk(int32_t id) { m_Chunks[id] = FakeChunk(id); }
+};
+
+TEST_CASE("Gather and sort referenced chunks", "[resourcemanager]")
+{
+  SECTION("Merge sorted lists")
+  {
+    std::vector<RecordChunkList> lists(3);
+
+    for(int32_t i = 0; i < 30; i++)
+      lists[i % 3].push_back(std::make_pair(i, FakeChunk(i)));
+
+    lists[1].clear();
+
+    RecordChunkList sorted;
+    MergeSortedChunks(lists, sorted);
+
+    REQUIRE(sorted.size() == 20);
+    for(size_t i = 1; i < sorted.size(); i++)
+      CHECK(sorted[i - 1].first < sorted[i].first);
+
+    for(const RecordChunkList &list : lists)
+      CHECK(list.empty());
+  };
+
+  SECTION("Shared parents are only inserted once")
+  {
+    const int32_t numRecords = 5000;
+
+    TestResourceRecord parent;
+    parent.AddTestChunk(1);
+    parent.AddTestChunk(2);
+
+    std::vector<TestResourceRecord> records(numRecords);
+
+    int32_t id = 10;
+    for(TestResourceRecord &r : records)
+    {
+      r.AddTestChunk(id++);
+      r.AddTestChunk(id++);
+    }
+
+    for(size_t i = 0; i < records.size(); i += 7)
+      records[i].AddParent(&parent);
+
+    // insert each record twice to check duplicates are skipped
+    RecordChunkList sorted;
+    GatherSortedChunks(records.size() * 2,
+                       [&records](size_t i, RecordChunkList &list) {
+                         records[i % records.size()].Insert(list);
+                       },
+                       std::function<void(float)>(), sorted);
+
+    REQUIRE(sorted.size() == size_t(numRecords * 2 + 2));
+
+    CHECK(sorted[0].first == 1);
+    CHECK(sorted[1].first == 2);
+    for(size_t i = 2; i < sorted.size(); i++)
+    {
+      CHECK(sorted[i].first == int32_t(i + 8));
+      CHECK(sorted[i].second == FakeChunk(int32_t(i + 8)));
+    }
+
+    CHECK(parent.DataWritten != 0);
+    for(TestResourceRecord &r : records)
+      CHECK(r.DataWritten != 0);
+  };
+};
+
+TEST_CASE("Benchmark gathering 1M referenced chunks", "[.][benchmark][resourcemanager]")
+{
+  const int32_t numRecords = 100000;
+  const int32_t chunksPerRecord = 10;
+
+  std::vector<TestResourceRecord> records(numRecords);
+
+  // interleave IDs between records, the way chunks from different resources interleave in time
+  for(int32_t c = 0; c < chunksPerRecord; c++)
+    for(int32_t r = 0; r < numRecords; r++)
+      records[r].AddTestChunk(10 + c * numRecords + r);
+
+  RecordChunkList sorted;
+
+  PerformanceTimer timer;
+
+  GatherSortedChunks(records.size(),
+                     [&records](size_t i, RecordChunkList &list) { records[i].Insert(list); },
+                     std::function<void(float)>(), sorted);
+
+  double ms = timer.GetMilliseconds();
+
+  bool ordered = true;
+  for(size_t i = 1; i < sorted.size(); i++)
+    ordered &= (sorted[i - 1].first < sorted[i].first);
+
+  CHECK(sorted.size() == size_t(numRecords * chunksPerRecord));
+  CHECK(ordered);
+
+  RDCLOG("Gathered and sorted %u chunks from %d records on %u cores in %.2f ms",
+         (uint32_t)sorted.size(), numRecords, Threading::GetCoreCount(), ms);
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -27,6 +27,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 #include "api/replay/renderdoc_replay.h"
 #include "common/threading.h"
 #include "core/core.h"
@@ -68,6 +69,24 @@ void SetReplayResourceIDs();
 
 struct ResourceRecord;
 
+// chunks gathered from resource records, paired with their chunk ID. Chunk IDs are allocated
+// globally in recording order, so sorting by ID gives the order the chunks must be written in.
+typedef std::vector<std::pair<int32_t, Chunk *>> RecordChunkList;
+
+// sort a gathered chunk list by chunk ID
+void SortChunks(RecordChunkList &chunks);
+
+// merges several lists, each already sorted by chunk ID, into one sorted list. The input lists
+// are cleared.
+void MergeSortedChunks(std::vector<RecordChunkList> &lists, RecordChunkList &sorted);
+
+// gathers the chunks for records (and their unwritten parents) across multiple threads, then
+// returns them all sorted by chunk ID. insertFunc is called once per record on a worker thread and
+// must insert it into the given list, progressFunc is called periodically on the calling thread.
+void GatherSortedChunks(size_t numRecords,
+                        const std::function<void(size_t, RecordChunkList &)> &insertFunc,
+                        const std::function<void(float)> &progressFunc, RecordChunkList &sorted);
+
 class ResourceRecordHandler
 {
 public:
@@ -96,7 +115,7 @@ struct ResourceRecord
         DataPtr(NULL),
         DataOffset(0),
         Length(0),
-        DataWritten(false),
+        DataWritten(0),
         SpecialResource(false)
   {
     m_ChunkLock = NULL;
@@ -135,12 +154,13 @@ struct ResourceRecord
     Parents.clear();
   }
 
-  void MarkDataUnwritten() { DataWritten = false; }
-  void Insert(map<int32_t, Chunk *> &recordlist)
+  void MarkDataUnwritten() { DataWritten = 0; }
+  // atomically mark this record's data as written, returns true if this call was the one to do it.
+  // This lets records be inserted from several threads at once without duplicating chunks.
+  bool ClaimDataWritten() { return Atomic::CmpExch32(&DataWritten, 0, 1) == 0; }
+  void Insert(RecordChunkList &recordlist)
   {
-    bool dataWritten = DataWritten;
-
-    DataWritten = true;
+    bool claimed = ClaimDataWritten();
 
     for(auto it = Parents.begin(); it != Parents.end(); ++it)
     {
@@ -150,8 +170,8 @@ struct ResourceRecord
       }
     }
 
-    if(!dataWritten)
-      recordlist.insert(m_Chunks.begin(), m_Chunks.end());
+    if(claimed)
+      recordlist.insert(recordlist.end(), m_Chunks.begin(), m_Chunks.end());
   }
 
   void AddRef() { Atomic::Inc32(&RefCount); }
@@ -259,7 +279,7 @@ struct ResourceRecord
   int UpdateCount;
   bool DataInSerialiser;
   bool SpecialResource;    // like the swap chain back buffers
-  bool DataWritten;
+  volatile int32_t DataWritten;
 
 protected:
   volatile int32_t RefCount;
@@ -798,44 +818,46 @@ void ResourceManager<Configuration>::MarkUnwrittenResources()
 template <typename Configuration>
 void ResourceManager<Configuration>::InsertReferencedChunks(WriteSerialiser &ser)
 {
-  map<int32_t, Chunk *> sortedChunks;
+  RecordChunkList sortedChunks;
 
   SCOPED_LOCK(m_Lock);
 
   RDCDEBUG("%u frame resource records", (uint32_t)m_FrameReferencedResources.size());
 
+  std::vector<RecordType *> records;
+
   if(RenderDoc::Inst().GetCaptureOptions().refAllResources)
   {
-    float num = float(m_ResourceRecords.size());
-    float idx = 0.0f;
+    records.reserve(m_ResourceRecords.size());
 
     for(auto it = m_ResourceRecords.begin(); it != m_ResourceRecords.end(); ++it)
     {
-      RenderDoc::Inst().SetProgress(CaptureProgress::AddReferencedResources, idx / num);
-      idx += 1.0f;
-
       if(!SerialisableResource(it->first, it->second))
         continue;
 
-      it->second->Insert(sortedChunks);
+      records.push_back(it->second);
     }
   }
   else
   {
-    float num = float(m_FrameReferencedResources.size());
-    float idx = 0.0f;
+    records.reserve(m_FrameReferencedResources.size());
 
     for(auto it = m_FrameReferencedResources.begin(); it != m_FrameReferencedResources.end(); ++it)
     {
-      RenderDoc::Inst().SetProgress(CaptureProgress::AddReferencedResources, idx / num);
-      idx += 1.0f;
-
       RecordType *record = GetResourceRecord(it->first);
       if(record)
-        record->Insert(sortedChunks);
+        records.push_back(record);
     }
   }
 
+  GatherSortedChunks(records.size(),
+                     [&records](size_t i, RecordChunkList &list) { records[i]->Insert(list); },
+                     [](float progress) {
+                       RenderDoc::Inst().SetProgress(CaptureProgress::AddReferencedResources,
+                                                     progress);
+                     },
+                     sortedChunks);
+
   RDCDEBUG("%u frame resource chunks", (uint32_t)sortedChunks.size());
 
   for(auto it = sortedChunks.begin(); it != sortedChunks.end(); it++)
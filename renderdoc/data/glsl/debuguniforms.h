@@ -159,25 +159,6 @@ BINDING(0) uniform FontUBOData
 }
 INST_NAME(general);
 
-BINDING(0) uniform MeshPickUBOData
-{
-  vec3 rayPos;
-  uint use_indices;
-
-  vec3 rayDir;
-  uint numVerts;
-
-  vec2 coords;
-  vec2 viewport;
-
-  uint meshMode;    // triangles, triangle strip, fan, etc...
-  uint unproject;
-  vec2 padding;
-
-  mat4 mvp;
-}
-INST_NAME(meshpick);
-
 // the ARM driver is buggy and crashes if we declare UBOs that don't correspond to descriptors,
 // even if they are completely unused. So we need to #define out these global UBOs
 
@@ -293,13 +274,6 @@ INST_NAME(histogram_minmax);
 
 #define HGRAM_NUM_BUCKETS 256u
 
-#define MESH_OTHER 0u    // this covers points and lines, logic is the same
-#define MESH_TRIANGLE_LIST 1u
-#define MESH_TRIANGLE_STRIP 2u
-#define MESH_TRIANGLE_FAN 3u
-#define MESH_TRIANGLE_LIST_ADJ 4u
-#define MESH_TRIANGLE_STRIP_ADJ 5u
-
 #if !defined(__cplusplus)
 
 vec3 CalcCubeCoord(vec2 uv, int face)
@@ -153,6 +153,11 @@ bool WrappedID3D11DeviceContext::Serialise_UpdateSubresource1(
     {
       RecordUpdateStats(pDstResource, SourceDataLength, true);
 
+      // this isn't a drawcall, but it still needs to show up as a write in the resource's usage
+      if(IsLoading(m_State) && m_CurEventID > 0)
+        m_ResourceUses[GetIDForResource(pDstResource)].push_back(
+            EventUsage(m_CurEventID, ResourceUsage::CopyDst));
+
       if(CopyFlags == ~0U)
       {
         // don't need to apply update subresource workaround here because we never replay on
@@ -269,6 +274,10 @@ bool WrappedID3D11DeviceContext::Serialise_UpdateSubresource1(
         RecordUpdateStats(pDstResource,
                           SourceRowPitch * subHeight + SourceDepthPitch * subWidth * subHeight, true);
 
+      if(IsLoading(m_State) && m_CurEventID > 0)
+        m_ResourceUses[GetIDForResource(pDstResource)].push_back(
+            EventUsage(m_CurEventID, ResourceUsage::CopyDst));
+
       // flags set specially to indicate we're serialising UpdateSubresource not UpdateSubresource1.
       // We specify no box, since the contents contain the entire updated resource (as updated
       // idly to the record's data pointer).
@@ -7566,8 +7566,14 @@ bool WrappedID3D11DeviceContext::Serialise_Unmap(SerialiserType &ser, ID3D11Reso
     MapWrittenData = (byte *)intercept.app.pData;
 
     if(IsLoading(m_State) && m_CurEventID > 0 && (diffStart < diffEnd))
+    {
       RecordUpdateStats(pResource, diffEnd - diffStart, false);
 
+      // like UpdateSubresource, record the write so the resource's usage covers it
+      m_ResourceUses[GetIDForResource(pResource)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
+    }
+
     if(diffStart >= diffEnd)
     {
       // do nothing
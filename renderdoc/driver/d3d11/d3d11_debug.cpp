@@ -1114,60 +1114,6 @@ void D3D11Replay::MeshRendering::Release()
   SAFE_RELEASE(TriHighlightHelper);
 }
 
-void D3D11Replay::VertexPicking::Init(WrappedID3D11Device *device)
-{
-  D3D11ShaderCache *shaderCache = device->GetShaderCache();
-
-  HRESULT hr = S_OK;
-
-  std::string meshhlsl = GetEmbeddedResource(debugcbuffers_h) + GetEmbeddedResource(mesh_hlsl);
-
-  MeshPickCS = shaderCache->MakeCShader(meshhlsl.c_str(), "RENDERDOC_MeshPickCS", "cs_5_0");
-
-  D3D11_BUFFER_DESC bDesc;
-
-  bDesc.ByteWidth = sizeof(Vec4f) * MaxMeshPicks;
-  bDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
-  bDesc.CPUAccessFlags = 0;
-  bDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
-  bDesc.StructureByteStride = sizeof(Vec4f);
-  bDesc.Usage = D3D11_USAGE_DEFAULT;
-
-  hr = device->CreateBuffer(&bDesc, NULL, &PickResultBuf);
-
-  if(FAILED(hr))
-    RDCERR("Failed to create mesh pick result buff HRESULT: %s", ToStr(hr).c_str());
-
-  D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc;
-
-  uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
-  uavDesc.Format = DXGI_FORMAT_UNKNOWN;
-  uavDesc.Buffer.FirstElement = 0;
-  uavDesc.Buffer.NumElements = MaxMeshPicks;
-  uavDesc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_APPEND;
-
-  hr = device->CreateUnorderedAccessView(PickResultBuf, &uavDesc, &PickResultUAV);
-
-  if(FAILED(hr))
-    RDCERR("Failed to create mesh pick result UAV HRESULT: %s", ToStr(hr).c_str());
-
-  // created/sized on demand
-  PickIBBuf = PickVBBuf = NULL;
-  PickIBSRV = PickVBSRV = NULL;
-  PickIBSize = PickVBSize = 0;
-}
-
-void D3D11Replay::VertexPicking::Release()
-{
-  SAFE_RELEASE(MeshPickCS);
-  SAFE_RELEASE(PickIBBuf);
-  SAFE_RELEASE(PickVBBuf);
-  SAFE_RELEASE(PickIBSRV);
-  SAFE_RELEASE(PickVBSRV);
-  SAFE_RELEASE(PickResultBuf);
-  SAFE_RELEASE(PickResultUAV);
-}
-
 void D3D11Replay::PixelPicking::Init(WrappedID3D11Device *device)
 {
   HRESULT hr = S_OK;
@@ -24,10 +24,10 @@
  ******************************************************************************/
 
 #include "d3d11_device.h"
+#include "common/thumbnail.h"
 #include "core/core.h"
 #include "driver/dxgi/dxgi_wrapped.h"
 #include "jpeg-compressor/jpge.h"
-#include "maths/formatpacking.h"
 #include "serialise/rdcfile.h"
 #include "strings/string_utils.h"
 #include "d3d11_context.h"
@@ -164,6 +164,7 @@ WrappedID3D11Device::WrappedID3D11Device(ID3D11Device *realDevice, D3D11InitPara
 
   // useful for marking regions during replay for self-captures
   m_RealAnnotations = NULL;
+  m_ReplayedEventID = 0;
   if(context)
     context->QueryInterface(__uuidof(ID3DUserDefinedAnnotation), (void **)&m_RealAnnotations);
 
@@ -1100,6 +1101,10 @@ ReplayStatus WrappedID3D11Device::ReadLogInitialisation(RDCFile *rdc, bool store
 void WrappedID3D11Device::ReplayLog(uint32_t startEventID, uint32_t endEventID,
                                     ReplayLogType replayType)
 {
+  // callers other than ReplayLogIncremental may have changed state around this replay, so we can't
+  // continue on from it.
+  m_ReplayedEventID = 0;
+
   bool partial = true;
 
   if(startEventID == 0 && (replayType == eReplay_WithoutDraw || replayType == eReplay_Full))
@@ -1142,6 +1147,39 @@ void WrappedID3D11Device::ReplayLog(uint32_t startEventID, uint32_t endEventID,
   D3D11MarkerRegion::Set("!!!!RenderDoc Internal: Done replay");
 }
 
+void WrappedID3D11Device::ReplayLogIncremental(uint32_t endEventID, ReplayLogType replayType)
+{
+  uint32_t prevEventID = m_ReplayedEventID;
+
+  if(replayType == eReplay_OnlyDraw)
+  {
+    ReplayLog(0, endEventID, replayType);
+
+    // replaying just the draw only keeps us in order if we were right before it
+    if(prevEventID != 0 && prevEventID + 1 == endEventID)
+      m_ReplayedEventID = endEventID;
+
+    return;
+  }
+
+  uint32_t targetEventID = endEventID;
+  if(replayType == eReplay_WithoutDraw)
+    targetEventID = RDCMAX(1U, endEventID) - 1;
+
+  if(prevEventID != 0 && prevEventID <= targetEventID)
+  {
+    // we're moving forward from a known good state, so only replay the events in between
+    if(prevEventID < targetEventID)
+      ReplayLog(prevEventID + 1, endEventID, replayType);
+  }
+  else
+  {
+    ReplayLog(0, endEventID, replayType);
+  }
+
+  m_ReplayedEventID = targetEventID;
+}
+
 void WrappedID3D11Device::ReleaseSwapchainResources(WrappedIDXGISwapChain4 *swap, UINT QueueCount,
                                                     IUnknown *const *ppPresentQueue,
                                                     IUnknown **unwrappedQueues)
@@ -1550,89 +1588,13 @@ bool WrappedID3D11Device::EndFrameCapture(void *dev, void *wnd)
           }
           else
           {
-            byte *data = (byte *)mapped.pData;
-
-            float aspect = float(desc.Width) / float(desc.Height);
-
-            thwidth = (uint16_t)RDCMIN(maxSize, desc.Width);
-            thwidth &= ~0x7;    // align down to multiple of 8
-            thheight = uint16_t(float(thwidth) / aspect);
+            CalcThumbnailSize(desc.Width, desc.Height, maxSize, thwidth, thheight);
 
             thpixels = new byte[3U * thwidth * thheight];
 
-            float widthf = float(desc.Width);
-            float heightf = float(desc.Height);
-
-            uint32_t stride = fmt.compByteWidth * fmt.compCount;
-
-            bool buf1010102 = false;
-            bool bufBGRA = (fmt.bgraOrder != false);
-
-            if(fmt.type == ResourceFormatType::R10G10B10A2)
-            {
-              stride = 4;
-              buf1010102 = true;
-            }
-
-            byte *dst = thpixels;
-
-            for(uint32_t y = 0; y < thheight; y++)
-            {
-              for(uint32_t x = 0; x < thwidth; x++)
-              {
-                float xf = float(x) / float(thwidth);
-                float yf = float(y) / float(thheight);
-
-                byte *src =
-                    &data[stride * uint32_t(xf * widthf) + mapped.RowPitch * uint32_t(yf * heightf)];
-
-                if(buf1010102)
-                {
-                  uint32_t *src1010102 = (uint32_t *)src;
-                  Vec4f unorm = ConvertFromR10G10B10A2(*src1010102);
-                  dst[0] = (byte)(unorm.x * 255.0f);
-                  dst[1] = (byte)(unorm.y * 255.0f);
-                  dst[2] = (byte)(unorm.z * 255.0f);
-                }
-                else if(bufBGRA)
-                {
-                  dst[0] = src[2];
-                  dst[1] = src[1];
-                  dst[2] = src[0];
-                }
-                else if(fmt.compByteWidth == 2)    // R16G16B16A16 backbuffer
-                {
-                  uint16_t *src16 = (uint16_t *)src;
-
-                  float linearR = RDCCLAMP(ConvertFromHalf(src16[0]), 0.0f, 1.0f);
-                  float linearG = RDCCLAMP(ConvertFromHalf(src16[1]), 0.0f, 1.0f);
-                  float linearB = RDCCLAMP(ConvertFromHalf(src16[2]), 0.0f, 1.0f);
-
-                  if(linearR < 0.0031308f)
-                    dst[0] = byte(255.0f * (12.92f * linearR));
-                  else
-                    dst[0] = byte(255.0f * (1.055f * powf(linearR, 1.0f / 2.4f) - 0.055f));
-
-                  if(linearG < 0.0031308f)
-                    dst[1] = byte(255.0f * (12.92f * linearG));
-                  else
-                    dst[1] = byte(255.0f * (1.055f * powf(linearG, 1.0f / 2.4f) - 0.055f));
-
-                  if(linearB < 0.0031308f)
-                    dst[2] = byte(255.0f * (12.92f * linearB));
-                  else
-                    dst[2] = byte(255.0f * (1.055f * powf(linearB, 1.0f / 2.4f) - 0.055f));
-                }
-                else
-                {
-                  dst[0] = src[0];
-                  dst[1] = src[1];
-                  dst[2] = src[2];
-                }
-
-                dst += 3;
-              }
-            }
+            if(!DownscaleToRGB8((const byte *)mapped.pData, desc.Width, desc.Height,
+                                mapped.RowPitch, fmt, false, thpixels, thwidth, thheight))
+              memset(thpixels, 0, 3U * thwidth * thheight);
 
             m_pImmediateContext->GetReal()->Unmap(stagingTex, 0);
           }
@@ -1738,9 +1700,11 @@ bool WrappedID3D11Device::EndFrameCapture(void *dev, void *wnd)
 
         RDCDEBUG("Accumulating context resource list");
 
-        std::map<int32_t, Chunk *> recordlist;
+        RecordChunkList recordlist;
         record->Insert(recordlist);
 
+        SortChunks(recordlist);
+
         RDCDEBUG("Flushing %u records to file serialiser", (uint32_t)recordlist.size());
 
         float num = float(recordlist.size());
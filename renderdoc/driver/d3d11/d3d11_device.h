@@ -324,6 +324,10 @@ private:
   ID3DUserDefinedAnnotation *m_RealAnnotations;
   int m_ReplayEventCount;
 
+  // the last event replayed in order by ReplayLogIncremental, with nothing else replayed since, or
+  // 0 if the current replay state isn't known to match the capture
+  uint32_t m_ReplayedEventID;
+
   unsigned int m_InternalRefcount;
   RefCounter m_RefCounter;
   RefCounter m_SoftRefCounter;
@@ -524,6 +528,8 @@ public:
   ReplayStatus ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers);
   bool ProcessChunk(ReadSerialiser &ser, D3D11Chunk context);
   void ReplayLog(uint32_t startEventID, uint32_t endEventID, ReplayLogType replayType);
+  void ReplayLogIncremental(uint32_t endEventID, ReplayLogType replayType);
+  void InvalidateReplayPosition() { m_ReplayedEventID = 0; }
 
   ////////////////////////////////////////////////////////////////
   // 'fake' interfaces
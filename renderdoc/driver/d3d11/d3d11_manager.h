@@ -161,11 +161,9 @@ struct D3D11ResourceRecord : public ResourceRecord
       SubResources[i]->SetDataPtr(ptr);
   }
 
-  void Insert(map<int32_t, Chunk *> &recordlist)
+  void Insert(RecordChunkList &recordlist)
   {
-    bool dataWritten = DataWritten;
-
-    DataWritten = true;
+    bool claimed = ClaimDataWritten();
 
     for(auto it = Parents.begin(); it != Parents.end(); ++it)
     {
@@ -175,9 +173,9 @@ struct D3D11ResourceRecord : public ResourceRecord
       }
     }
 
-    if(!dataWritten)
+    if(claimed)
     {
-      recordlist.insert(m_Chunks.begin(), m_Chunks.end());
+      recordlist.insert(recordlist.end(), m_Chunks.begin(), m_Chunks.end());
 
       for(int i = 0; i < NumSubResources; i++)
         SubResources[i]->Insert(recordlist);
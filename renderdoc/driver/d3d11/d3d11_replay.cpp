@@ -139,10 +139,6 @@ void D3D11Replay::CreateResources()
 
   m_MeshRender.Init(m_pDevice);
 
-  RenderDoc::Inst().SetProgress(LoadProgress::DebugManagerInit, 0.5f);
-
-  m_VertexPick.Init(m_pDevice);
-
   RenderDoc::Inst().SetProgress(LoadProgress::DebugManagerInit, 0.6f);
 
   m_PixelPick.Init(m_pDevice);
@@ -207,7 +203,6 @@ void D3D11Replay::DestroyResources()
   m_TexRender.Release();
   m_Overlay.Release();
   m_MeshRender.Release();
-  m_VertexPick.Release();
   m_PixelPick.Release();
   m_Histogram.Release();
   m_PixelHistory.Release();
@@ -1441,7 +1436,7 @@ ReplayStatus D3D11Replay::ReadLogInitialisation(RDCFile *rdc, bool storeStructur
 
 void D3D11Replay::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
 {
-  m_pDevice->ReplayLog(0, endEventID, replayType);
+  m_pDevice->ReplayLogIncremental(endEventID, replayType);
 }
 
 const SDFile &D3D11Replay::GetStructuredFile()
@@ -2197,12 +2192,14 @@ void D3D11Replay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip
 void D3D11Replay::ReplaceResource(ResourceId from, ResourceId to)
 {
   m_pDevice->GetResourceManager()->ReplaceResource(from, to);
+  m_pDevice->InvalidateReplayPosition();
   ClearPostVSCache();
 }
 
 void D3D11Replay::RemoveReplacement(ResourceId id)
 {
   m_pDevice->GetResourceManager()->RemoveReplacement(id);
+  m_pDevice->InvalidateReplayPosition();
   ClearPostVSCache();
 }
 
@@ -2501,449 +2498,11 @@ void D3D11Replay::FillCBufferVariables(ResourceId shader, string entryPoint, uin
 uint32_t D3D11Replay::PickVertex(uint32_t eventId, int32_t width, int32_t height,
                                  const MeshDisplay &cfg, uint32_t x, uint32_t y)
 {
-  if(cfg.position.numIndices == 0)
-    return ~0U;
-
-  D3D11RenderStateTracker tracker(m_pImmediateContext);
-
-  struct MeshPickData
-  {
-    Vec3f RayPos;
-    uint32_t PickIdx;
-
-    Vec3f RayDir;
-    uint32_t PickNumVerts;
-
-    Vec2f PickCoords;
-    Vec2f PickViewport;
-
-    uint32_t MeshMode;
-    uint32_t PickUnproject;
-    Vec2f Padding;
-
-    Matrix4f PickMVP;
-
-  } cbuf;
-
-  cbuf.PickCoords = Vec2f((float)x, (float)y);
-  cbuf.PickViewport = Vec2f((float)width, (float)height);
-  cbuf.PickIdx = cfg.position.indexByteStride ? 1 : 0;
-  cbuf.PickNumVerts = cfg.position.numIndices;
-  cbuf.PickUnproject = cfg.position.unproject ? 1 : 0;
-
-  Matrix4f projMat = Matrix4f::Perspective(90.0f, 0.1f, 100000.0f, float(width) / float(height));
-
-  Matrix4f camMat = cfg.cam ? ((Camera *)cfg.cam)->GetMatrix() : Matrix4f::Identity();
-
-  Matrix4f pickMVP = projMat.Mul(camMat);
-
-  Matrix4f pickMVPProj;
-  if(cfg.position.unproject)
-  {
-    // the derivation of the projection matrix might not be right (hell, it could be an
-    // orthographic projection). But it'll be close enough likely.
-    Matrix4f guessProj =
-        cfg.position.farPlane != FLT_MAX
-            ? Matrix4f::Perspective(cfg.fov, cfg.position.nearPlane, cfg.position.farPlane, cfg.aspect)
-            : Matrix4f::ReversePerspective(cfg.fov, cfg.position.nearPlane, cfg.aspect);
-
-    if(cfg.ortho)
-      guessProj = Matrix4f::Orthographic(cfg.position.nearPlane, cfg.position.farPlane);
-
-    pickMVPProj = projMat.Mul(camMat.Mul(guessProj.Inverse()));
-  }
-
-  Vec3f rayPos;
-  Vec3f rayDir;
-  // convert mouse pos to world space ray
-  {
-    Matrix4f inversePickMVP = pickMVP.Inverse();
-
-    float pickX = ((float)x) / ((float)width);
-    float pickXCanonical = RDCLERP(-1.0f, 1.0f, pickX);
-
-    float pickY = ((float)y) / ((float)height);
-    // flip the Y axis
-    float pickYCanonical = RDCLERP(1.0f, -1.0f, pickY);
-
-    Vec3f cameraToWorldNearPosition =
-        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
-
-    Vec3f cameraToWorldFarPosition =
-        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
-
-    Vec3f testDir = (cameraToWorldFarPosition - cameraToWorldNearPosition);
-    testDir.Normalise();
-
-    // Calculate the ray direction first in the regular way (above), so we can use the
-    // the output for testing if the ray we are picking is negative or not. This is similar
-    // to checking against the forward direction of the camera, but more robust
-    if(cfg.position.unproject)
-    {
-      Matrix4f inversePickMVPGuess = pickMVPProj.Inverse();
-
-      Vec3f nearPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
-
-      Vec3f farPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
-
-      rayDir = (farPosProj - nearPosProj);
-      rayDir.Normalise();
-
-      if(testDir.z < 0)
-      {
-        rayDir = -rayDir;
-      }
-      rayPos = nearPosProj;
-    }
-    else
-    {
-      rayDir = testDir;
-      rayPos = cameraToWorldNearPosition;
-    }
-  }
-
-  cbuf.RayPos = rayPos;
-  cbuf.RayDir = rayDir;
-
-  cbuf.PickMVP = cfg.position.unproject ? pickMVPProj : pickMVP;
-
-  bool isTriangleMesh = true;
-  switch(cfg.position.topology)
-  {
-    case Topology::TriangleList:
-    {
-      cbuf.MeshMode = MESH_TRIANGLE_LIST;
-      break;
-    }
-    case Topology::TriangleStrip:
-    {
-      cbuf.MeshMode = MESH_TRIANGLE_STRIP;
-      break;
-    }
-    case Topology::TriangleList_Adj:
-    {
-      cbuf.MeshMode = MESH_TRIANGLE_LIST_ADJ;
-      break;
-    }
-    case Topology::TriangleStrip_Adj:
-    {
-      cbuf.MeshMode = MESH_TRIANGLE_STRIP_ADJ;
-      break;
-    }
-    default:    // points, lines, patchlists, unknown
-    {
-      cbuf.MeshMode = MESH_OTHER;
-      isTriangleMesh = false;
-    }
-  }
-
-  ID3D11Buffer *vb = NULL, *ib = NULL;
-
-  {
-    auto it = WrappedID3D11Buffer::m_BufferList.find(cfg.position.vertexResourceId);
-
-    if(it != WrappedID3D11Buffer::m_BufferList.end())
-      vb = it->second.m_Buffer;
-
-    it = WrappedID3D11Buffer::m_BufferList.find(cfg.position.indexResourceId);
-
-    if(it != WrappedID3D11Buffer::m_BufferList.end())
-      ib = it->second.m_Buffer;
-  }
-
-  HRESULT hr = S_OK;
-
-  // most IB/VBs will not be available as SRVs. So, we copy into our own buffers. In the case of VB
-  // we also tightly pack and unpack the data. IB is upcast to R32 so it we can apply baseVertex
-  // without risking overflow.
-
-  uint32_t minIndex = 0;
-  uint32_t maxIndex = cfg.position.numIndices;
-
-  uint32_t idxclamp = 0;
-  if(cfg.position.baseVertex < 0)
-    idxclamp = uint32_t(-cfg.position.baseVertex);
-
-  if(cfg.position.indexByteStride)
-  {
-    // resize up on demand
-    if(m_VertexPick.PickIBBuf == NULL ||
-       m_VertexPick.PickIBSize < cfg.position.numIndices * sizeof(uint32_t))
-    {
-      SAFE_RELEASE(m_VertexPick.PickIBBuf);
-      SAFE_RELEASE(m_VertexPick.PickIBSRV);
-
-      D3D11_BUFFER_DESC desc = {cfg.position.numIndices * sizeof(uint32_t),
-                                D3D11_USAGE_DEFAULT,
-                                D3D11_BIND_SHADER_RESOURCE,
-                                0,
-                                0,
-                                0};
-
-      m_VertexPick.PickIBSize = cfg.position.numIndices * sizeof(uint32_t);
-
-      hr = m_pDevice->CreateBuffer(&desc, NULL, &m_VertexPick.PickIBBuf);
-
-      if(FAILED(hr))
-      {
-        RDCERR("Failed to create PickIBBuf HRESULT: %s", ToStr(hr).c_str());
-        return ~0U;
-      }
-
-      D3D11_SHADER_RESOURCE_VIEW_DESC sdesc;
-      sdesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
-      sdesc.Format = DXGI_FORMAT_R32_UINT;
-      sdesc.Buffer.FirstElement = 0;
-      sdesc.Buffer.NumElements = cfg.position.numIndices;
-
-      hr = m_pDevice->CreateShaderResourceView(m_VertexPick.PickIBBuf, &sdesc,
-                                               &m_VertexPick.PickIBSRV);
-
-      if(FAILED(hr))
-      {
-        SAFE_RELEASE(m_VertexPick.PickIBBuf);
-        RDCERR("Failed to create PickIBSRV HRESULT: %s", ToStr(hr).c_str());
-        return ~0U;
-      }
-    }
-
-    RDCASSERT(cfg.position.indexByteOffset < 0xffffffff);
-
-    if(ib)
-    {
-      bytebuf idxs;
-      GetBufferData(cfg.position.indexResourceId, cfg.position.indexByteOffset, 0, idxs);
-
-      std::vector<uint32_t> outidxs;
-      outidxs.resize(cfg.position.numIndices);
-
-      uint16_t *idxs16 = (uint16_t *)&idxs[0];
-      uint32_t *idxs32 = (uint32_t *)&idxs[0];
-
-      if(cfg.position.indexByteStride == 2)
-      {
-        size_t bufsize = idxs.size() / 2;
-
-        for(uint32_t i = 0; i < bufsize && i < cfg.position.numIndices; i++)
-        {
-          uint32_t idx = idxs16[i];
-
-          if(idx < idxclamp)
-            idx = 0;
-          else if(cfg.position.baseVertex < 0)
-            idx -= idxclamp;
-          else if(cfg.position.baseVertex > 0)
-            idx += cfg.position.baseVertex;
-
-          if(i == 0)
-          {
-            minIndex = maxIndex = idx;
-          }
-          else
-          {
-            minIndex = RDCMIN(idx, minIndex);
-            maxIndex = RDCMAX(idx, maxIndex);
-          }
-
-          outidxs[i] = idx;
-        }
-      }
-      else
-      {
-        uint32_t bufsize = uint32_t(idxs.size() / 4);
-
-        minIndex = maxIndex = idxs32[0];
-
-        for(uint32_t i = 0; i < RDCMIN(bufsize, cfg.position.numIndices); i++)
-        {
-          uint32_t idx = idxs32[i];
-
-          if(idx < idxclamp)
-            idx = 0;
-          else if(cfg.position.baseVertex < 0)
-            idx -= idxclamp;
-          else if(cfg.position.baseVertex > 0)
-            idx += cfg.position.baseVertex;
-
-          minIndex = RDCMIN(idx, minIndex);
-          maxIndex = RDCMAX(idx, maxIndex);
-
-          outidxs[i] = idx;
-        }
-      }
-
-      D3D11_BOX box;
-      box.top = 0;
-      box.bottom = 1;
-      box.front = 0;
-      box.back = 1;
-      box.left = 0;
-      box.right = UINT(outidxs.size() * sizeof(uint32_t));
-
-      m_pImmediateContext->UpdateSubresource(m_VertexPick.PickIBBuf, 0, &box, outidxs.data(), 0, 0);
-    }
-  }
-
-  // unpack and linearise the data
-  if(vb)
-  {
-    bytebuf oldData;
-    GetDebugManager()->GetBufferData(vb, cfg.position.vertexByteOffset, 0, oldData);
-
-    // clamp maxIndex to upper bound in case we got invalid indices or primitive restart indices
-    maxIndex = RDCMIN(maxIndex, uint32_t(oldData.size() / cfg.position.vertexByteStride));
-
-    if(m_VertexPick.PickVBBuf == NULL || m_VertexPick.PickVBSize < (maxIndex + 1) * sizeof(Vec4f))
-    {
-      SAFE_RELEASE(m_VertexPick.PickVBBuf);
-      SAFE_RELEASE(m_VertexPick.PickVBSRV);
-
-      D3D11_BUFFER_DESC desc = {
-          (maxIndex + 1) * sizeof(Vec4f), D3D11_USAGE_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0, 0, 0};
-
-      m_VertexPick.PickVBSize = (maxIndex + 1) * sizeof(Vec4f);
-
-      hr = m_pDevice->CreateBuffer(&desc, NULL, &m_VertexPick.PickVBBuf);
-
-      if(FAILED(hr))
-      {
-        RDCERR("Failed to create PickVBBuf HRESULT: %s", ToStr(hr).c_str());
-        return ~0U;
-      }
-
-      D3D11_SHADER_RESOURCE_VIEW_DESC sdesc;
-      sdesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
-      sdesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-      sdesc.Buffer.FirstElement = 0;
-      sdesc.Buffer.NumElements = (maxIndex + 1);
-
-      hr = m_pDevice->CreateShaderResourceView(m_VertexPick.PickVBBuf, &sdesc,
-                                               &m_VertexPick.PickVBSRV);
-
-      if(FAILED(hr))
-      {
-        SAFE_RELEASE(m_VertexPick.PickVBBuf);
-        RDCERR("Failed to create PickVBSRV HRESULT: %s", ToStr(hr).c_str());
-        return ~0U;
-      }
-    }
-
-    std::vector<FloatVector> vbData;
-    vbData.resize(maxIndex + 1);
-
-    byte *data = &oldData[0];
-    byte *dataEnd = data + oldData.size();
-
-    bool valid;
-
-    // the index buffer may refer to vertices past the start of the vertex buffer, so we can't just
-    // conver the first N vertices we'll need.
-    // Instead we grab min and max above, and convert every vertex in that range. This might
-    // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg.position.vertexByteStride,
-                                                    cfg.position.format, dataEnd, valid);
-
-    D3D11_BOX box;
-    box.top = 0;
-    box.bottom = 1;
-    box.front = 0;
-    box.back = 1;
-    box.left = 0;
-    box.right = (maxIndex + 1) * sizeof(Vec4f);
-
-    m_pImmediateContext->UpdateSubresource(m_VertexPick.PickVBBuf, 0, &box, vbData.data(),
-                                           sizeof(Vec4f), sizeof(Vec4f));
-  }
-
-  ID3D11ShaderResourceView *srvs[2] = {m_VertexPick.PickIBSRV, m_VertexPick.PickVBSRV};
-
-  ID3D11Buffer *buf = GetDebugManager()->MakeCBuffer(&cbuf, sizeof(cbuf));
-
-  m_pImmediateContext->CSSetConstantBuffers(0, 1, &buf);
-
-  m_pImmediateContext->CSSetShaderResources(0, 2, srvs);
-
-  UINT reset = 0;
-  m_pImmediateContext->CSSetUnorderedAccessViews(0, 1, &m_VertexPick.PickResultUAV, &reset);
-
-  m_pImmediateContext->CSSetShader(m_VertexPick.MeshPickCS, NULL, 0);
-
-  m_pImmediateContext->Dispatch(cfg.position.numIndices / 1024 + 1, 1, 1);
-
-  uint32_t numResults = GetDebugManager()->GetStructCount(m_VertexPick.PickResultUAV);
-
-  if(numResults > 0)
-  {
-    bytebuf results;
-
-    if(isTriangleMesh)
-    {
-      struct PickResult
-      {
-        uint32_t vertid;
-        Vec3f intersectionPoint;
-      };
-
-      GetDebugManager()->GetBufferData(m_VertexPick.PickResultBuf, 0, 0, results);
-
-      PickResult *pickResults = (PickResult *)&results[0];
-
-      PickResult *closest = pickResults;
-
-      // distance from raycast hit to nearest worldspace position of the mouse
-      float closestPickDistance = (closest->intersectionPoint - rayPos).Length();
-
-      // min with size of results buffer to protect against overflows
-      for(uint32_t i = 1; i < RDCMIN((uint32_t)VertexPicking::MaxMeshPicks, numResults); i++)
-      {
-        float pickDistance = (pickResults[i].intersectionPoint - rayPos).Length();
-        if(pickDistance < closestPickDistance)
-        {
-          closest = pickResults + i;
-        }
-      }
-
-      return closest->vertid;
-    }
-    else
-    {
-      struct PickResult
-      {
-        uint32_t vertid;
-        uint32_t idx;
-        float len;
-        float depth;
-      };
-
-      GetDebugManager()->GetBufferData(m_VertexPick.PickResultBuf, 0, 0, results);
-
-      PickResult *pickResults = (PickResult *)&results[0];
-
-      PickResult *closest = pickResults;
-
-      // min with size of results buffer to protect against overflows
-      for(uint32_t i = 1; i < RDCMIN((uint32_t)VertexPicking::MaxMeshPicks, numResults); i++)
-      {
-        // We need to keep the picking order consistent in the face
-        // of random buffer appends, when multiple vertices have the
-        // identical position (e.g. if UVs or normals are different).
-        //
-        // We could do something to try and disambiguate, but it's
-        // never going to be intuitive, it's just going to flicker
-        // confusingly.
-        if(pickResults[i].len < closest->len ||
-           (pickResults[i].len == closest->len && pickResults[i].depth < closest->depth) ||
-           (pickResults[i].len == closest->len && pickResults[i].depth == closest->depth &&
-            pickResults[i].vertid < closest->vertid))
-          closest = pickResults + i;
-      }
-
-      return closest->vertid;
-    }
-  }
+  // picking is done on the CPU against a BVH built from the same data we cache for highlighting,
+  // see VulkanReplay::PickVertex. D3D clip space has Y up so unprojected positions aren't flipped.
+  m_HighlightCache.CacheHighlightingData(eventId, cfg);
 
-  return ~0U;
+  return m_HighlightCache.PickVertex(width, height, cfg, x, y, false);
 }
 
 void D3D11Replay::PickPixel(ResourceId texture, uint32_t x, uint32_t y, uint32_t sliceFace,
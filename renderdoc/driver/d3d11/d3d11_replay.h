@@ -389,23 +389,6 @@ private:
     ResourceFormat PrevSecondaryFormat;
   } m_MeshRender;
 
-  struct VertexPicking
-  {
-    void Init(WrappedID3D11Device *device);
-    void Release();
-
-    static const uint32_t MaxMeshPicks = 500;
-
-    ID3D11ComputeShader *MeshPickCS = NULL;
-    uint32_t PickIBSize = 0, PickVBSize = 0;
-    ID3D11Buffer *PickIBBuf = NULL;
-    ID3D11Buffer *PickVBBuf = NULL;
-    ID3D11ShaderResourceView *PickIBSRV = NULL;
-    ID3D11ShaderResourceView *PickVBSRV = NULL;
-    ID3D11Buffer *PickResultBuf = NULL;
-    ID3D11UnorderedAccessView *PickResultUAV = NULL;
-  } m_VertexPick;
-
   struct PixelPicking
   {
     void Init(WrappedID3D11Device *device);
@@ -323,30 +323,7 @@ vector<CounterResult> D3D12Replay::FetchCountersAMD(const vector<GPUCounter> &co
   vector<CounterResult> ret =
       m_pAMDCounters->GetCounterData(sessionID, sampleIndex, eventIDs, counters);
 
-  for(size_t i = 0; i < m_pAMDDrawCallback->m_AliasEvents.size(); i++)
-  {
-    for(size_t c = 0; c < counters.size(); c++)
-    {
-      CounterResult search;
-      search.counter = counters[c];
-      search.eventId = m_pAMDDrawCallback->m_AliasEvents[i].first;
-
-      // find the result we're aliasing
-      auto it = std::find(ret.begin(), ret.end(), search);
-      if(it != ret.end())
-      {
-        // duplicate the result and append
-        CounterResult aliased = *it;
-        aliased.eventId = m_pAMDDrawCallback->m_AliasEvents[i].second;
-        ret.push_back(aliased);
-      }
-      else
-      {
-        RDCERR("Expected to find alias-target result for EID %u counter %u, but didn't",
-               search.eventId, search.counter);
-      }
-    }
-  }
+  AddAliasedCounterResults(ret, m_pAMDDrawCallback->m_AliasEvents, counters);
 
   SAFE_DELETE(m_pAMDDrawCallback);
 
@@ -650,33 +627,7 @@ vector<CounterResult> D3D12Replay::FetchCounters(const vector<GPUCounter> &count
     }
   }
 
-  for(size_t i = 0; i < cb.m_AliasEvents.size(); i++)
-  {
-    for(size_t c = 0; c < counters.size(); c++)
-    {
-      CounterResult search;
-      search.counter = counters[c];
-      search.eventId = cb.m_AliasEvents[i].first;
-
-      // find the result we're aliasing
-      auto it = std::find(ret.begin(), ret.end(), search);
-      if(it != ret.end())
-      {
-        // duplicate the result and append
-        CounterResult aliased = *it;
-        aliased.eventId = cb.m_AliasEvents[i].second;
-        ret.push_back(aliased);
-      }
-      else
-      {
-        RDCERR("Expected to find alias-target result for EID %u counter %u, but didn't",
-               search.eventId, search.counter);
-      }
-    }
-  }
-
-  // sort so that the alias results appear in the right places
-  std::sort(ret.begin(), ret.end());
+  AddAliasedCounterResults(ret, cb.m_AliasEvents, counters);
 
   SAFE_RELEASE(readbackBuf);
   SAFE_RELEASE(timerQueryHeap);
@@ -1349,130 +1349,6 @@ void D3D12Replay::OverlayRendering::Release()
   SAFE_RELEASE(Texture);
 }
 
-void D3D12Replay::VertexPicking::Init(WrappedID3D12Device *device, D3D12DebugManager *debug)
-{
-  HRESULT hr = S_OK;
-
-  D3D12ShaderCache *shaderCache = device->GetShaderCache();
-
-  shaderCache->SetCaching(true);
-
-  VB = NULL;
-  VBSize = 0;
-
-  {
-    ID3DBlob *root = shaderCache->MakeRootSig({
-        cbvParam(D3D12_SHADER_VISIBILITY_ALL, 0, 0),
-        tableParam(D3D12_SHADER_VISIBILITY_ALL, D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 0, 2),
-        tableParam(D3D12_SHADER_VISIBILITY_ALL, D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 0, 0, 1),
-    });
-
-    RDCASSERT(root);
-
-    hr = device->CreateRootSignature(0, root->GetBufferPointer(), root->GetBufferSize(),
-                                     __uuidof(ID3D12RootSignature), (void **)&RootSig);
-
-    SAFE_RELEASE(root);
-  }
-
-  {
-    std::string meshhlsl = GetEmbeddedResource(debugcbuffers_h) + GetEmbeddedResource(mesh_hlsl);
-
-    ID3DBlob *meshPickCS;
-
-    shaderCache->GetShaderBlob(meshhlsl.c_str(), "RENDERDOC_MeshPickCS",
-                               D3DCOMPILE_WARNINGS_ARE_ERRORS, "cs_5_0", &meshPickCS);
-
-    RDCASSERT(meshPickCS);
-
-    D3D12_COMPUTE_PIPELINE_STATE_DESC compPipeDesc = {};
-    compPipeDesc.pRootSignature = RootSig;
-    compPipeDesc.CS.BytecodeLength = meshPickCS->GetBufferSize();
-    compPipeDesc.CS.pShaderBytecode = meshPickCS->GetBufferPointer();
-
-    hr = device->CreateComputePipelineState(&compPipeDesc, __uuidof(ID3D12PipelineState),
-                                            (void **)&Pipe);
-
-    if(FAILED(hr))
-    {
-      RDCERR("Couldn't create m_MeshPickPipe! HRESULT: %s", ToStr(hr).c_str());
-    }
-
-    SAFE_RELEASE(meshPickCS);
-  }
-
-  {
-    D3D12_RESOURCE_DESC pickResultDesc = {};
-    pickResultDesc.Alignment = 0;
-    pickResultDesc.DepthOrArraySize = 1;
-    pickResultDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    pickResultDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-    pickResultDesc.Format = DXGI_FORMAT_UNKNOWN;
-    pickResultDesc.Height = 1;
-    pickResultDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    pickResultDesc.MipLevels = 1;
-    pickResultDesc.SampleDesc.Count = 1;
-    pickResultDesc.SampleDesc.Quality = 0;
-    // add an extra 64 bytes for the counter at the start
-    pickResultDesc.Width = MaxMeshPicks * sizeof(Vec4f) + 64;
-
-    D3D12_HEAP_PROPERTIES heapProps;
-    heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
-    heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-    heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-    heapProps.CreationNodeMask = 1;
-    heapProps.VisibleNodeMask = 1;
-
-    hr = device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &pickResultDesc,
-                                         D3D12_RESOURCE_STATE_UNORDERED_ACCESS, NULL,
-                                         __uuidof(ID3D12Resource), (void **)&ResultBuf);
-
-    ResultBuf->SetName(L"m_PickResultBuf");
-
-    if(FAILED(hr))
-    {
-      RDCERR("Failed to create tile buffer for min/max, HRESULT: %s", ToStr(hr).c_str());
-    }
-
-    D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
-    uavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
-    uavDesc.Format = DXGI_FORMAT_UNKNOWN;
-    uavDesc.Buffer.CounterOffsetInBytes = 0;
-    // start with elements after the counter
-    uavDesc.Buffer.FirstElement = 64 / sizeof(Vec4f);
-    uavDesc.Buffer.NumElements = MaxMeshPicks;
-    uavDesc.Buffer.StructureByteStride = sizeof(Vec4f);
-
-    device->CreateUnorderedAccessView(ResultBuf, ResultBuf, &uavDesc,
-                                      debug->GetCPUHandle(PICK_RESULT_UAV));
-    device->CreateUnorderedAccessView(ResultBuf, ResultBuf, &uavDesc,
-                                      debug->GetUAVClearHandle(PICK_RESULT_UAV));
-
-    // this UAV is used for clearing everything back to 0
-
-    uavDesc.Format = DXGI_FORMAT_R32G32B32A32_UINT;
-    uavDesc.Buffer.FirstElement = 0;
-    uavDesc.Buffer.NumElements = MaxMeshPicks + 64 / sizeof(Vec4f);
-    uavDesc.Buffer.StructureByteStride = 0;
-
-    device->CreateUnorderedAccessView(ResultBuf, NULL, &uavDesc,
-                                      debug->GetCPUHandle(PICK_RESULT_CLEAR_UAV));
-    device->CreateUnorderedAccessView(ResultBuf, NULL, &uavDesc,
-                                      debug->GetUAVClearHandle(PICK_RESULT_CLEAR_UAV));
-  }
-
-  shaderCache->SetCaching(false);
-}
-
-void D3D12Replay::VertexPicking::Release()
-{
-  SAFE_RELEASE(IB);
-  SAFE_RELEASE(VB);
-  SAFE_RELEASE(ResultBuf);
-  SAFE_RELEASE(RootSig);
-  SAFE_RELEASE(Pipe);
-}
-
 void D3D12Replay::PixelPicking::Init(WrappedID3D12Device *device, D3D12DebugManager *debug)
 {
   HRESULT hr = S_OK;
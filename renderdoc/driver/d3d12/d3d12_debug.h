@@ -50,11 +50,6 @@ enum CBVUAVSRVSlot
   OVERDRAW_UAV,
   STREAM_OUT_UAV,
 
-  PICK_IB_SRV,
-  PICK_VB_SRV,
-  PICK_RESULT_UAV,
-  PICK_RESULT_CLEAR_UAV,
-
   TMP_UAV,
 };
 
@@ -23,13 +23,13 @@
  ******************************************************************************/
 
 #include "d3d12_device.h"
+#include "common/thumbnail.h"
 #include "core/core.h"
 #include "driver/dxgi/dxgi_common.h"
 #include "driver/dxgi/dxgi_wrapped.h"
 #include "driver/ihv/amd/amd_rgp.h"
 #include "driver/ihv/amd/official/DXExt/AmdExtD3D.h"
 #include "jpeg-compressor/jpge.h"
-#include "maths/formatpacking.h"
 #include "serialise/rdcfile.h"
 #include "strings/string_utils.h"
 #include "d3d12_command_list.h"
@@ -1471,87 +1471,13 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
         {
           ResourceFormat fmt = MakeResourceFormat(desc.Format);
 
-          float aspect = float(desc.Width) / float(desc.Height);
-
-          thwidth = (uint16_t)RDCMIN(maxSize, (uint32_t)desc.Width);
-          thwidth &= ~0x7;    // align down to multiple of 8
-          thheight = uint16_t(float(thwidth) / aspect);
+          CalcThumbnailSize((uint32_t)desc.Width, desc.Height, maxSize, thwidth, thheight);
 
           thpixels = new byte[3U * thwidth * thheight];
 
-          float widthf = float(desc.Width);
-          float heightf = float(desc.Height);
-
-          uint32_t stride = fmt.compByteWidth * fmt.compCount;
-
-          bool buf1010102 = false;
-          bool bufBGRA = (fmt.bgraOrder != false);
-
-          if(fmt.type == ResourceFormatType::R10G10B10A2)
-          {
-            stride = 4;
-            buf1010102 = true;
-          }
-
-          byte *dstPixels = thpixels;
-
-          for(uint32_t y = 0; y < thheight; y++)
-          {
-            for(uint32_t x = 0; x < thwidth; x++)
-            {
-              float xf = float(x) / float(thwidth);
-              float yf = float(y) / float(thheight);
-
-              byte *srcPixels = &data[stride * uint32_t(xf * widthf) +
-                                      layout.Footprint.RowPitch * uint32_t(yf * heightf)];
-
-              if(buf1010102)
-              {
-                uint32_t *src1010102 = (uint32_t *)srcPixels;
-                Vec4f unorm = ConvertFromR10G10B10A2(*src1010102);
-                dstPixels[0] = (byte)(unorm.x * 255.0f);
-                dstPixels[1] = (byte)(unorm.y * 255.0f);
-                dstPixels[2] = (byte)(unorm.z * 255.0f);
-              }
-              else if(bufBGRA)
-              {
-                dstPixels[0] = srcPixels[2];
-                dstPixels[1] = srcPixels[1];
-                dstPixels[2] = srcPixels[0];
-              }
-              else if(fmt.compByteWidth == 2)    // R16G16B16A16 backbuffer
-              {
-                uint16_t *src16 = (uint16_t *)srcPixels;
-
-                float linearR = RDCCLAMP(ConvertFromHalf(src16[0]), 0.0f, 1.0f);
-                float linearG = RDCCLAMP(ConvertFromHalf(src16[1]), 0.0f, 1.0f);
-                float linearB = RDCCLAMP(ConvertFromHalf(src16[2]), 0.0f, 1.0f);
-
-                if(linearR < 0.0031308f)
-                  dstPixels[0] = byte(255.0f * (12.92f * linearR));
-                else
-                  dstPixels[0] = byte(255.0f * (1.055f * powf(linearR, 1.0f / 2.4f) - 0.055f));
-
-                if(linearG < 0.0031308f)
-                  dstPixels[1] = byte(255.0f * (12.92f * linearG));
-                else
-                  dstPixels[1] = byte(255.0f * (1.055f * powf(linearG, 1.0f / 2.4f) - 0.055f));
-
-                if(linearB < 0.0031308f)
-                  dstPixels[2] = byte(255.0f * (12.92f * linearB));
-                else
-                  dstPixels[2] = byte(255.0f * (1.055f * powf(linearB, 1.0f / 2.4f) - 0.055f));
-              }
-              else
-              {
-                dstPixels[0] = srcPixels[0];
-                dstPixels[1] = srcPixels[1];
-                dstPixels[2] = srcPixels[2];
-              }
-
-              dstPixels += 3;
-            }
-          }
+          if(!DownscaleToRGB8(data, (uint32_t)desc.Width, desc.Height, layout.Footprint.RowPitch,
+                              fmt, false, thpixels, thwidth, thheight))
+            memset(thpixels, 0, 3U * thwidth * thheight);
 
           copyDst->Unmap(0, NULL);
         }
@@ -1656,7 +1582,7 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
     // in capframe (the transition is thread-protected) so nothing will be
     // pushed to the vector
 
-    map<int32_t, Chunk *> recordlist;
+    RecordChunkList recordlist;
 
     for(auto it = queues.begin(); it != queues.end(); ++it)
     {
@@ -1684,6 +1610,8 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
 
     m_FrameCaptureRecord->Insert(recordlist);
 
+    SortChunks(recordlist);
+
     RDCDEBUG("Flushing %u chunks to file serialiser from context record",
              (uint32_t)recordlist.size());
 
@@ -409,11 +409,9 @@ struct D3D12ResourceRecord : public ResourceRecord
     cmdInfo->bundles.swap(bakedCommands->cmdInfo->bundles);
   }
 
-  void Insert(map<int32_t, Chunk *> &recordlist)
+  void Insert(RecordChunkList &recordlist)
   {
-    bool dataWritten = DataWritten;
-
-    DataWritten = true;
+    bool claimed = ClaimDataWritten();
 
     for(auto it = Parents.begin(); it != Parents.end(); ++it)
     {
@@ -423,8 +421,8 @@ struct D3D12ResourceRecord : public ResourceRecord
       }
     }
 
-    if(!dataWritten)
-      recordlist.insert(m_Chunks.begin(), m_Chunks.end());
+    if(claimed)
+      recordlist.insert(recordlist.end(), m_Chunks.begin(), m_Chunks.end());
   }
 
   D3D12ResourceType type;
@@ -116,7 +116,6 @@ void D3D12Replay::CreateResources()
     m_General.Init(m_pDevice, m_DebugManager);
     m_TexRender.Init(m_pDevice, m_DebugManager);
     m_Overlay.Init(m_pDevice, m_DebugManager);
-    m_VertexPick.Init(m_pDevice, m_DebugManager);
     m_PixelPick.Init(m_pDevice, m_DebugManager);
     m_Histogram.Init(m_pDevice, m_DebugManager);
   }
@@ -160,7 +159,6 @@ void D3D12Replay::DestroyResources()
   m_General.Release();
   m_TexRender.Release();
   m_Overlay.Release();
-  m_VertexPick.Release();
   m_PixelPick.Release();
   m_Histogram.Release();
 
@@ -1671,475 +1669,11 @@ void D3D12Replay::PickPixel(ResourceId texture, uint32_t x, uint32_t y, uint32_t
 uint32_t D3D12Replay::PickVertex(uint32_t eventId, int32_t width, int32_t height,
                                  const MeshDisplay &cfg, uint32_t x, uint32_t y)
 {
-  if(cfg.position.numIndices == 0)
-    return ~0U;
+  // picking is done on the CPU against a BVH built from the same data we cache for highlighting,
+  // see VulkanReplay::PickVertex. D3D clip space has Y up so unprojected positions aren't flipped.
+  m_HighlightCache.CacheHighlightingData(eventId, cfg);
 
-  struct MeshPickData
-  {
-    Vec3f RayPos;
-    uint32_t PickIdx;
-
-    Vec3f RayDir;
-    uint32_t PickNumVerts;
-
-    Vec2f PickCoords;
-    Vec2f PickViewport;
-
-    uint32_t MeshMode;
-    uint32_t PickUnproject;
-    Vec2f Padding;
-
-    Matrix4f PickMVP;
-
-  } cbuf;
-
-  cbuf.PickCoords = Vec2f((float)x, (float)y);
-  cbuf.PickViewport = Vec2f((float)width, (float)height);
-  cbuf.PickIdx = cfg.position.indexByteStride ? 1 : 0;
-  cbuf.PickNumVerts = cfg.position.numIndices;
-  cbuf.PickUnproject = cfg.position.unproject ? 1 : 0;
-
-  Matrix4f projMat = Matrix4f::Perspective(90.0f, 0.1f, 100000.0f, float(width) / float(height));
-
-  Matrix4f camMat = cfg.cam ? ((Camera *)cfg.cam)->GetMatrix() : Matrix4f::Identity();
-
-  Matrix4f pickMVP = projMat.Mul(camMat);
-
-  Matrix4f pickMVPProj;
-  if(cfg.position.unproject)
-  {
-    // the derivation of the projection matrix might not be right (hell, it could be an
-    // orthographic projection). But it'll be close enough likely.
-    Matrix4f guessProj =
-        cfg.position.farPlane != FLT_MAX
-            ? Matrix4f::Perspective(cfg.fov, cfg.position.nearPlane, cfg.position.farPlane, cfg.aspect)
-            : Matrix4f::ReversePerspective(cfg.fov, cfg.position.nearPlane, cfg.aspect);
-
-    if(cfg.ortho)
-      guessProj = Matrix4f::Orthographic(cfg.position.nearPlane, cfg.position.farPlane);
-
-    pickMVPProj = projMat.Mul(camMat.Mul(guessProj.Inverse()));
-  }
-
-  Vec3f rayPos;
-  Vec3f rayDir;
-  // convert mouse pos to world space ray
-  {
-    Matrix4f inversePickMVP = pickMVP.Inverse();
-
-    float pickX = ((float)x) / ((float)width);
-    float pickXCanonical = RDCLERP(-1.0f, 1.0f, pickX);
-
-    float pickY = ((float)y) / ((float)height);
-    // flip the Y axis
-    float pickYCanonical = RDCLERP(1.0f, -1.0f, pickY);
-
-    Vec3f cameraToWorldNearPosition =
-        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
-
-    Vec3f cameraToWorldFarPosition =
-        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
-
-    Vec3f testDir = (cameraToWorldFarPosition - cameraToWorldNearPosition);
-    testDir.Normalise();
-
-    // Calculate the ray direction first in the regular way (above), so we can use the
-    // the output for testing if the ray we are picking is negative or not. This is similar
-    // to checking against the forward direction of the camera, but more robust
-    if(cfg.position.unproject)
-    {
-      Matrix4f inversePickMVPGuess = pickMVPProj.Inverse();
-
-      Vec3f nearPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
-
-      Vec3f farPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
-
-      rayDir = (farPosProj - nearPosProj);
-      rayDir.Normalise();
-
-      if(testDir.z < 0)
-      {
-        rayDir = -rayDir;
-      }
-      rayPos = nearPosProj;
-    }
-    else
-    {
-      rayDir = testDir;
-      rayPos = cameraToWorldNearPosition;
-    }
-  }
-
-  cbuf.RayPos = rayPos;
-  cbuf.RayDir = rayDir;
-
-  cbuf.PickMVP = cfg.position.unproject ? pickMVPProj : pickMVP;
-
-  bool isTriangleMesh = true;
-  switch(cfg.position.topology)
-  {
-    case Topology::TriangleList:
-    {
-      cbuf.MeshMode = MESH_TRIANGLE_LIST;
-      break;
-    }
-    case Topology::TriangleStrip:
-    {
-      cbuf.MeshMode = MESH_TRIANGLE_STRIP;
-      break;
-    }
-    case Topology::TriangleList_Adj:
-    {
-      cbuf.MeshMode = MESH_TRIANGLE_LIST_ADJ;
-      break;
-    }
-    case Topology::TriangleStrip_Adj:
-    {
-      cbuf.MeshMode = MESH_TRIANGLE_STRIP_ADJ;
-      break;
-    }
-    default:    // points, lines, patchlists, unknown
-    {
-      cbuf.MeshMode = MESH_OTHER;
-      isTriangleMesh = false;
-    }
-  }
-
-  ID3D12Resource *vb = NULL, *ib = NULL;
-
-  if(cfg.position.vertexResourceId != ResourceId())
-    vb = m_pDevice->GetResourceManager()->GetCurrentAs<ID3D12Resource>(cfg.position.vertexResourceId);
-
-  if(cfg.position.indexResourceId != ResourceId())
-    ib = m_pDevice->GetResourceManager()->GetCurrentAs<ID3D12Resource>(cfg.position.indexResourceId);
-
-  HRESULT hr = S_OK;
-
-  // most IB/VBs will not be available as SRVs. So, we copy into our own buffers. In the case of VB
-  // we also tightly pack and unpack the data. IB is upcast to R32 so it we can apply baseVertex
-  // without risking overflow.
-
-  uint32_t minIndex = 0;
-  uint32_t maxIndex = cfg.position.numIndices;
-
-  uint32_t idxclamp = 0;
-  if(cfg.position.baseVertex < 0)
-    idxclamp = uint32_t(-cfg.position.baseVertex);
-
-  D3D12_SHADER_RESOURCE_VIEW_DESC sdesc = {};
-  sdesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
-  sdesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-  sdesc.Format = DXGI_FORMAT_R32_UINT;
-
-  if(cfg.position.indexByteStride && ib)
-  {
-    // resize up on demand
-    if(m_VertexPick.IB == NULL || m_VertexPick.IBSize < cfg.position.numIndices * sizeof(uint32_t))
-    {
-      SAFE_RELEASE(m_VertexPick.IB);
-
-      m_VertexPick.IBSize = cfg.position.numIndices * sizeof(uint32_t);
-
-      D3D12_HEAP_PROPERTIES heapProps;
-      heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-      heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-      heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-      heapProps.CreationNodeMask = 1;
-      heapProps.VisibleNodeMask = 1;
-
-      D3D12_RESOURCE_DESC ibDesc;
-      ibDesc.Alignment = 0;
-      ibDesc.DepthOrArraySize = 1;
-      ibDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-      ibDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-      ibDesc.Format = DXGI_FORMAT_UNKNOWN;
-      ibDesc.Height = 1;
-      ibDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-      ibDesc.MipLevels = 1;
-      ibDesc.SampleDesc.Count = 1;
-      ibDesc.SampleDesc.Quality = 0;
-      ibDesc.Width = m_VertexPick.IBSize;
-
-      hr = m_pDevice->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &ibDesc,
-                                              D3D12_RESOURCE_STATE_GENERIC_READ, NULL,
-                                              __uuidof(ID3D12Resource), (void **)&m_VertexPick.IB);
-
-      if(FAILED(hr))
-      {
-        RDCERR("Couldn't create pick index buffer: HRESULT: %s", ToStr(hr).c_str());
-        return ~0U;
-      }
-
-      m_VertexPick.IB->SetName(L"m_PickIB");
-
-      sdesc.Buffer.FirstElement = 0;
-      sdesc.Buffer.NumElements = cfg.position.numIndices;
-      m_pDevice->CreateShaderResourceView(m_VertexPick.IB, &sdesc,
-                                          GetDebugManager()->GetCPUHandle(PICK_IB_SRV));
-    }
-
-    RDCASSERT(cfg.position.indexByteOffset < 0xffffffff);
-
-    if(m_VertexPick.IB)
-    {
-      bytebuf idxs;
-      GetBufferData(cfg.position.indexResourceId, cfg.position.indexByteOffset, 0, idxs);
-
-      std::vector<uint32_t> outidxs;
-      outidxs.resize(cfg.position.numIndices);
-
-      uint16_t *idxs16 = (uint16_t *)&idxs[0];
-      uint32_t *idxs32 = (uint32_t *)&idxs[0];
-
-      if(cfg.position.indexByteStride == 2)
-      {
-        size_t bufsize = idxs.size() / 2;
-
-        for(uint32_t i = 0; i < bufsize && i < cfg.position.numIndices; i++)
-        {
-          uint32_t idx = idxs16[i];
-
-          if(idx < idxclamp)
-            idx = 0;
-          else if(cfg.position.baseVertex < 0)
-            idx -= idxclamp;
-          else if(cfg.position.baseVertex > 0)
-            idx += cfg.position.baseVertex;
-
-          if(i == 0)
-          {
-            minIndex = maxIndex = idx;
-          }
-          else
-          {
-            minIndex = RDCMIN(idx, minIndex);
-            maxIndex = RDCMAX(idx, maxIndex);
-          }
-
-          outidxs[i] = idx;
-        }
-      }
-      else
-      {
-        uint32_t bufsize = uint32_t(idxs.size() / 4);
-
-        minIndex = maxIndex = idxs32[0];
-
-        for(uint32_t i = 0; i < RDCMIN(bufsize, cfg.position.numIndices); i++)
-        {
-          uint32_t idx = idxs32[i];
-
-          if(idx < idxclamp)
-            idx = 0;
-          else if(cfg.position.baseVertex < 0)
-            idx -= idxclamp;
-          else if(cfg.position.baseVertex > 0)
-            idx += cfg.position.baseVertex;
-
-          minIndex = RDCMIN(idx, minIndex);
-          maxIndex = RDCMAX(idx, maxIndex);
-
-          outidxs[i] = idx;
-        }
-      }
-
-      D3D11_BOX box;
-      box.top = 0;
-      box.bottom = 1;
-      box.front = 0;
-      box.back = 1;
-      box.left = 0;
-      box.right = UINT(outidxs.size() * sizeof(uint32_t));
-
-      GetDebugManager()->FillBuffer(m_VertexPick.IB, 0, outidxs.data(),
-                                    sizeof(uint32_t) * outidxs.size());
-    }
-  }
-  else
-  {
-    sdesc.Buffer.NumElements = 4;
-    m_pDevice->CreateShaderResourceView(NULL, &sdesc, GetDebugManager()->GetCPUHandle(PICK_IB_SRV));
-  }
-
-  sdesc.Buffer.FirstElement = 0;
-  sdesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
-
-  // unpack and linearise the data
-  {
-    bytebuf oldData;
-    GetDebugManager()->GetBufferData(vb, cfg.position.vertexByteOffset, 0, oldData);
-
-    // clamp maxIndex to upper bound in case we got invalid indices or primitive restart indices
-    maxIndex = RDCMIN(maxIndex, uint32_t(oldData.size() / cfg.position.vertexByteStride));
-
-    if(vb)
-    {
-      if(m_VertexPick.VB == NULL || m_VertexPick.VBSize < (maxIndex + 1) * sizeof(Vec4f))
-      {
-        SAFE_RELEASE(m_VertexPick.VB);
-
-        m_VertexPick.VBSize = (maxIndex + 1) * sizeof(Vec4f);
-
-        D3D12_HEAP_PROPERTIES heapProps;
-        heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-        heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-        heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-        heapProps.CreationNodeMask = 1;
-        heapProps.VisibleNodeMask = 1;
-
-        D3D12_RESOURCE_DESC vbDesc;
-        vbDesc.Alignment = 0;
-        vbDesc.DepthOrArraySize = 1;
-        vbDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        vbDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-        vbDesc.Format = DXGI_FORMAT_UNKNOWN;
-        vbDesc.Height = 1;
-        vbDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-        vbDesc.MipLevels = 1;
-        vbDesc.SampleDesc.Count = 1;
-        vbDesc.SampleDesc.Quality = 0;
-        vbDesc.Width = m_VertexPick.VBSize;
-
-        hr = m_pDevice->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &vbDesc,
-                                                D3D12_RESOURCE_STATE_GENERIC_READ, NULL,
-                                                __uuidof(ID3D12Resource), (void **)&m_VertexPick.VB);
-
-        if(FAILED(hr))
-        {
-          RDCERR("Couldn't create pick vertex buffer: HRESULT: %s", ToStr(hr).c_str());
-          return ~0U;
-        }
-
-        m_VertexPick.VB->SetName(L"m_PickVB");
-
-        sdesc.Buffer.NumElements = (maxIndex + 1);
-        m_pDevice->CreateShaderResourceView(m_VertexPick.VB, &sdesc,
-                                            GetDebugManager()->GetCPUHandle(PICK_VB_SRV));
-      }
-    }
-    else
-    {
-      sdesc.Buffer.NumElements = 4;
-      m_pDevice->CreateShaderResourceView(NULL, &sdesc, GetDebugManager()->GetCPUHandle(PICK_VB_SRV));
-    }
-
-    std::vector<FloatVector> vbData;
-    vbData.resize(maxIndex + 1);
-
-    byte *data = &oldData[0];
-    byte *dataEnd = data + oldData.size();
-
-    bool valid = true;
-
-    // the index buffer may refer to vertices past the start of the vertex buffer, so we can't just
-    // conver the first N vertices we'll need.
-    // Instead we grab min and max above, and convert every vertex in that range. This might
-    // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg.position.vertexByteStride,
-                                                    cfg.position.format, dataEnd, valid);
-
-    GetDebugManager()->FillBuffer(m_VertexPick.VB, 0, vbData.data(), sizeof(Vec4f) * (maxIndex + 1));
-  }
-
-  ID3D12GraphicsCommandList *list = m_pDevice->GetNewList();
-
-  list->SetPipelineState(m_VertexPick.Pipe);
-
-  list->SetComputeRootSignature(m_VertexPick.RootSig);
-
-  GetDebugManager()->SetDescriptorHeaps(list, true, false);
-
-  list->SetComputeRootConstantBufferView(0, GetDebugManager()->UploadConstants(&cbuf, sizeof(cbuf)));
-  list->SetComputeRootDescriptorTable(1, GetDebugManager()->GetGPUHandle(PICK_IB_SRV));
-  list->SetComputeRootDescriptorTable(2, GetDebugManager()->GetGPUHandle(PICK_RESULT_UAV));
-
-  list->Dispatch(cfg.position.numIndices / 1024 + 1, 1, 1);
-
-  list->Close();
-  m_pDevice->ExecuteLists();
-
-  bytebuf results;
-  GetDebugManager()->GetBufferData(m_VertexPick.ResultBuf, 0, 0, results);
-
-  list = m_pDevice->GetNewList();
-
-  UINT zeroes[4] = {0, 0, 0, 0};
-  list->ClearUnorderedAccessViewUint(GetDebugManager()->GetGPUHandle(PICK_RESULT_CLEAR_UAV),
-                                     GetDebugManager()->GetUAVClearHandle(PICK_RESULT_CLEAR_UAV),
-                                     m_VertexPick.ResultBuf, zeroes, 0, NULL);
-
-  list->Close();
-
-  byte *data = &results[0];
-
-  uint32_t numResults = *(uint32_t *)data;
-
-  if(numResults > 0)
-  {
-    if(isTriangleMesh)
-    {
-      struct PickResult
-      {
-        uint32_t vertid;
-        Vec3f intersectionPoint;
-      };
-
-      PickResult *pickResults = (PickResult *)(data + 64);
-
-      PickResult *closest = pickResults;
-
-      // distance from raycast hit to nearest worldspace position of the mouse
-      float closestPickDistance = (closest->intersectionPoint - rayPos).Length();
-
-      // min with size of results buffer to protect against overflows
-      for(uint32_t i = 1; i < RDCMIN(VertexPicking::MaxMeshPicks, numResults); i++)
-      {
-        float pickDistance = (pickResults[i].intersectionPoint - rayPos).Length();
-        if(pickDistance < closestPickDistance)
-        {
-          closest = pickResults + i;
-        }
-      }
-
-      return closest->vertid;
-    }
-    else
-    {
-      struct PickResult
-      {
-        uint32_t vertid;
-        uint32_t idx;
-        float len;
-        float depth;
-      };
-
-      PickResult *pickResults = (PickResult *)(data + 64);
-
-      PickResult *closest = pickResults;
-
-      // min with size of results buffer to protect against overflows
-      for(uint32_t i = 1; i < RDCMIN(VertexPicking::MaxMeshPicks, numResults); i++)
-      {
-        // We need to keep the picking order consistent in the face
-        // of random buffer appends, when multiple vertices have the
-        // identical position (e.g. if UVs or normals are different).
-        //
-        // We could do something to try and disambiguate, but it's
-        // never going to be intuitive, it's just going to flicker
-        // confusingly.
-        if(pickResults[i].len < closest->len ||
-           (pickResults[i].len == closest->len && pickResults[i].depth < closest->depth) ||
-           (pickResults[i].len == closest->len && pickResults[i].depth == closest->depth &&
-            pickResults[i].vertid < closest->vertid))
-          closest = pickResults + i;
-      }
-
-      return closest->vertid;
-    }
-  }
-
-  return ~0U;
+  return m_HighlightCache.PickVertex(width, height, cfg, x, y, false);
 }
 
 bool D3D12Replay::GetMinMax(ResourceId texid, uint32_t sliceFace, uint32_t mip, uint32_t sample,
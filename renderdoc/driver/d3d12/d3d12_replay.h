@@ -347,21 +347,6 @@ private:
     ResourceId resourceId;
   } m_Overlay;
 
-  struct VertexPicking
-  {
-    void Init(WrappedID3D12Device *device, D3D12DebugManager *debug);
-    void Release();
-
-    static const uint32_t MaxMeshPicks = 500;
-    ID3D12Resource *VB = NULL;
-    ID3D12Resource *IB = NULL;
-    uint32_t VBSize = 0;
-    uint32_t IBSize = 0;
-    ID3D12Resource *ResultBuf = NULL;
-    ID3D12RootSignature *RootSig = NULL;
-    ID3D12PipelineState *Pipe = NULL;
-  } m_VertexPick;
-
   struct PixelPicking
   {
     void Init(WrappedID3D12Device *device, D3D12DebugManager *debug);
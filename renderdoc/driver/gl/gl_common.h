@@ -532,10 +532,83 @@ void EmulateRequiredExtensions(GLHookSet *hooks);
 
 struct ShaderReflection;
 
-void CopyProgramUniforms(const GLHookSet &gl, GLuint progSrc, GLuint progDst);
+struct ProgramUniformValue
+{
+  ProgramUniformValue()
+  {
+    Type = eGL_NONE;
+    Location = 0;
+    RDCEraseEl(data);
+  }
+  GLenum Type;
+  int32_t Location;
+
+  union
+  {
+    double dval[16];
+    float fval[16];
+    int32_t ival[16];
+    uint32_t uval[16];
+  } data;
+};
+
+DECLARE_REFLECTION_STRUCT(ProgramUniformValue);
+
+struct ProgramUniform
+{
+  std::string Basename;
+  bool IsArray = false;
+
+  std::vector<ProgramUniformValue> Values;
+};
+
+DECLARE_REFLECTION_STRUCT(ProgramUniform);
+
+struct ProgramBinding
+{
+  ProgramBinding() = default;
+  ProgramBinding(const char *n, int32_t b) : Name(n), Binding(b) {}
+  std::string Name;
+  int32_t Binding = -1;
+};
+
+DECLARE_REFLECTION_STRUCT(ProgramBinding);
+
+// the loose uniform values and block bindings of a program, as serialised in its initial state
+struct ProgramUniforms
+{
+  std::vector<ProgramUniform> ValueUniforms;
+  std::vector<ProgramBinding> UBOBindings;
+  std::vector<ProgramBinding> SSBOBindings;
+};
+
+DECLARE_REFLECTION_STRUCT(ProgramUniforms);
+
+// while capturing, a copy of each linked program's ProgramUniforms is fetched once at link time and
+// then kept up to date by the glUniform* and block binding wrappers. That way a program's initial
+// state can be serialised without going back to the driver for every uniform.
+struct ProgramUniformShadow
+{
+  ProgramUniforms uniforms;
+
+  // location -> {index in uniforms.ValueUniforms, array element}
+  std::map<GLint, std::pair<uint32_t, uint32_t> > locations;
+
+  void Fetch(const GLHookSet &gl, GLuint prog);
+  void Update(GLint location, GLsizei count, const void *value, UniformType type, bool transpose);
+};
+
+// lists a program's loose uniforms, with every array element's location, and its blocks. The
+// values and bindings are left empty, since they change without the program being relinked.
+void FetchProgramUniformLayout(const GLHookSet &gl, GLuint progSrc, ProgramUniforms &layout);
+// if srcLayout is set it must be progSrc's layout, and only the values are fetched from progSrc
+void CopyProgramUniforms(const GLHookSet &gl, GLuint progSrc, GLuint progDst,
+                         const ProgramUniforms *srcLayout = NULL);
+// if cachedUniforms is set when writing, it's serialised as-is instead of being fetched from prog
 template <typename SerialiserType>
 void SerialiseProgramUniforms(SerialiserType &ser, CaptureState state, const GLHookSet &gl,
-                              GLuint prog, map<GLint, GLint> *locTranslate);
+                              GLuint prog, map<GLint, GLint> *locTranslate,
+                              const ProgramUniforms *cachedUniforms = NULL);
 void CopyProgramAttribBindings(const GLHookSet &gl, GLuint progsrc, GLuint progdst,
                                ShaderReflection *refl);
 void CopyProgramFragDataBindings(const GLHookSet &gl, GLuint progsrc, GLuint progdst,
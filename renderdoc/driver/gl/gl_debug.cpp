@@ -527,40 +527,8 @@ void GLReplay::InitDebugData()
                                "GL_ARB_compute_shader not supported, disabling 2DMS save/load.");
   }
 
-  if(glesShadersAreComplete && HasExt[ARB_compute_shader])
-  {
-    string defines =
-        "#extension GL_ARB_compute_shader : require\n"
-        "#extension GL_ARB_shader_storage_buffer_object : require";
-    GenerateGLSLShader(cs, shaderType, defines, GetEmbeddedResource(glsl_mesh_comp), glslCSVer);
-    DebugData.meshPickProgram = CreateCShaderProgram(cs);
-  }
-  else
-  {
-    DebugData.meshPickProgram = 0;
-    RDCWARN("GL_ARB_compute_shader not supported, disabling mesh picking.");
-    m_pDriver->AddDebugMessage(MessageCategory::Portability, MessageSeverity::Medium,
-                               MessageSource::RuntimeWarning,
-                               "GL_ARB_compute_shader not supported, disabling mesh picking.");
-  }
-
   RenderDoc::Inst().SetProgress(LoadProgress::DebugManagerInit, 0.8f);
 
-  DebugData.pickResultBuf = 0;
-
-  if(DebugData.meshPickProgram)
-  {
-    gl.glGenBuffers(1, &DebugData.pickResultBuf);
-    gl.glBindBuffer(eGL_SHADER_STORAGE_BUFFER, DebugData.pickResultBuf);
-    gl.glNamedBufferDataEXT(DebugData.pickResultBuf,
-                            sizeof(Vec4f) * DebugRenderData::maxMeshPicks + sizeof(uint32_t) * 4,
-                            NULL, eGL_DYNAMIC_READ);
-
-    // sized/created on demand
-    DebugData.pickVBBuf = DebugData.pickIBBuf = 0;
-    DebugData.pickVBSize = DebugData.pickIBSize = 0;
-  }
-
   gl.glGenVertexArrays(1, &DebugData.meshVAO);
   gl.glBindVertexArray(DebugData.meshVAO);
 
@@ -803,11 +771,6 @@ void GLReplay::DeleteDebugData()
     }
   }
 
-  gl.glDeleteProgram(DebugData.meshPickProgram);
-  gl.glDeleteBuffers(1, &DebugData.pickIBBuf);
-  gl.glDeleteBuffers(1, &DebugData.pickVBBuf);
-  gl.glDeleteBuffers(1, &DebugData.pickResultBuf);
-
   gl.glDeleteProgram(DebugData.Array2MS);
   gl.glDeleteProgram(DebugData.MS2Array);
 
@@ -1182,411 +1145,11 @@ bool GLReplay::GetHistogram(ResourceId texid, uint32_t sliceFace, uint32_t mip,
 uint32_t GLReplay::PickVertex(uint32_t eventId, int32_t width, int32_t height,
                               const MeshDisplay &cfg, uint32_t x, uint32_t y)
 {
-  WrappedOpenGL &gl = *m_pDriver;
-
-  if(!HasExt[ARB_compute_shader])
-    return ~0U;
-
-  MakeCurrentReplayContext(m_DebugCtx);
-
-  gl.glUseProgram(DebugData.meshPickProgram);
-
-  Matrix4f projMat = Matrix4f::Perspective(90.0f, 0.1f, 100000.0f, float(width) / float(height));
-
-  Matrix4f camMat = cfg.cam ? ((Camera *)cfg.cam)->GetMatrix() : Matrix4f::Identity();
-  Matrix4f pickMVP = projMat.Mul(camMat);
-
-  Matrix4f pickMVPProj;
-  if(cfg.position.unproject)
-  {
-    // the derivation of the projection matrix might not be right (hell, it could be an
-    // orthographic projection). But it'll be close enough likely.
-    Matrix4f guessProj =
-        cfg.position.farPlane != FLT_MAX
-            ? Matrix4f::Perspective(cfg.fov, cfg.position.nearPlane, cfg.position.farPlane, cfg.aspect)
-            : Matrix4f::ReversePerspective(cfg.fov, cfg.position.nearPlane, cfg.aspect);
-
-    if(cfg.ortho)
-      guessProj = Matrix4f::Orthographic(cfg.position.nearPlane, cfg.position.farPlane);
-
-    pickMVPProj = projMat.Mul(camMat.Mul(guessProj.Inverse()));
-  }
-
-  vec3 rayPos;
-  vec3 rayDir;
-  // convert mouse pos to world space ray
-  {
-    Matrix4f inversePickMVP = pickMVP.Inverse();
-
-    float pickX = ((float)x) / ((float)width);
-    float pickXCanonical = RDCLERP(-1.0f, 1.0f, pickX);
-
-    float pickY = ((float)y) / ((float)height);
-    // flip the Y axis
-    float pickYCanonical = RDCLERP(1.0f, -1.0f, pickY);
-
-    vec3 cameraToWorldNearPosition =
-        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
-
-    vec3 cameraToWorldFarPosition =
-        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
-
-    vec3 testDir = (cameraToWorldFarPosition - cameraToWorldNearPosition);
-    testDir.Normalise();
-
-    // Calculate the ray direction first in the regular way (above), so we can use the
-    // the output for testing if the ray we are picking is negative or not. This is similar
-    // to checking against the forward direction of the camera, but more robust
-    if(cfg.position.unproject)
-    {
-      Matrix4f inversePickMVPGuess = pickMVPProj.Inverse();
-
-      vec3 nearPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
-
-      vec3 farPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
-
-      rayDir = (farPosProj - nearPosProj);
-      rayDir.Normalise();
-
-      if(testDir.z < 0)
-      {
-        rayDir = -rayDir;
-      }
-      rayPos = nearPosProj;
-    }
-    else
-    {
-      rayDir = testDir;
-      rayPos = cameraToWorldNearPosition;
-    }
-  }
-
-  gl.glBindBufferBase(eGL_UNIFORM_BUFFER, 0, DebugData.UBOs[0]);
-  MeshPickUBOData *cdata =
-      (MeshPickUBOData *)gl.glMapBufferRange(eGL_UNIFORM_BUFFER, 0, sizeof(MeshPickUBOData),
-                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
-
-  cdata->rayPos = rayPos;
-  cdata->rayDir = rayDir;
-  cdata->use_indices = cfg.position.indexByteStride ? 1U : 0U;
-  cdata->numVerts = cfg.position.numIndices;
-  bool isTriangleMesh = true;
-  switch(cfg.position.topology)
-  {
-    case Topology::TriangleList:
-    {
-      cdata->meshMode = MESH_TRIANGLE_LIST;
-      break;
-    }
-    case Topology::TriangleStrip:
-    {
-      cdata->meshMode = MESH_TRIANGLE_STRIP;
-      break;
-    }
-    case Topology::TriangleFan:
-    {
-      cdata->meshMode = MESH_TRIANGLE_FAN;
-      break;
-    }
-    case Topology::TriangleList_Adj:
-    {
-      cdata->meshMode = MESH_TRIANGLE_LIST_ADJ;
-      break;
-    }
-    case Topology::TriangleStrip_Adj:
-    {
-      cdata->meshMode = MESH_TRIANGLE_STRIP_ADJ;
-      break;
-    }
-    default:    // points, lines, patchlists, unknown
-    {
-      cdata->meshMode = MESH_OTHER;
-      isTriangleMesh = false;
-    }
-  }
-
-  // line/point data
-  cdata->unproject = cfg.position.unproject;
-  cdata->mvp = cfg.position.unproject ? pickMVPProj : pickMVP;
-  cdata->coords = Vec2f((float)x, (float)y);
-  cdata->viewport = Vec2f((float)width, (float)height);
-
-  gl.glUnmapBuffer(eGL_UNIFORM_BUFFER);
-
-  GLuint ib = 0;
-
-  uint32_t minIndex = 0;
-  uint32_t maxIndex = cfg.position.numIndices;
-
-  uint32_t idxclamp = 0;
-  if(cfg.position.baseVertex < 0)
-    idxclamp = uint32_t(-cfg.position.baseVertex);
-
-  if(cfg.position.indexByteStride && cfg.position.indexResourceId != ResourceId())
-    ib = m_pDriver->GetResourceManager()->GetCurrentResource(cfg.position.indexResourceId).name;
-
-  // We copy into our own buffers to promote to the target type (uint32) that the shader expects.
-  // Most IBs will be 16-bit indices, most VBs will not be float4. We also apply baseVertex here
-
-  if(ib)
-  {
-    // resize up on demand
-    if(DebugData.pickIBBuf == 0 || DebugData.pickIBSize < cfg.position.numIndices * sizeof(uint32_t))
-    {
-      gl.glDeleteBuffers(1, &DebugData.pickIBBuf);
-
-      gl.glGenBuffers(1, &DebugData.pickIBBuf);
-      gl.glBindBuffer(eGL_SHADER_STORAGE_BUFFER, DebugData.pickIBBuf);
-      gl.glNamedBufferDataEXT(DebugData.pickIBBuf, cfg.position.numIndices * sizeof(uint32_t), NULL,
-                              eGL_STREAM_DRAW);
-
-      DebugData.pickIBSize = cfg.position.numIndices * sizeof(uint32_t);
-    }
-
-    byte *idxs = new byte[cfg.position.numIndices * cfg.position.indexByteStride];
-    memset(idxs, 0, cfg.position.numIndices * cfg.position.indexByteStride);
-
-    std::vector<uint32_t> outidxs;
-    outidxs.resize(cfg.position.numIndices);
-
-    gl.glBindBuffer(eGL_COPY_READ_BUFFER, ib);
-
-    GLint bufsize = 0;
-    gl.glGetBufferParameteriv(eGL_COPY_READ_BUFFER, eGL_BUFFER_SIZE, &bufsize);
-
-    gl.glGetBufferSubData(eGL_COPY_READ_BUFFER, (GLintptr)cfg.position.indexByteOffset,
-                          RDCMIN(uint32_t(bufsize) - uint32_t(cfg.position.indexByteOffset),
-                                 cfg.position.numIndices * cfg.position.indexByteStride),
-                          idxs);
-
-    uint8_t *idxs8 = (uint8_t *)idxs;
-    uint16_t *idxs16 = (uint16_t *)idxs;
-
-    if(cfg.position.indexByteStride == 1)
-    {
-      for(uint32_t i = 0; i < cfg.position.numIndices; i++)
-      {
-        uint32_t idx = idxs8[i];
-
-        if(idx < idxclamp)
-          idx = 0;
-        else if(cfg.position.baseVertex < 0)
-          idx -= idxclamp;
-        else if(cfg.position.baseVertex > 0)
-          idx += cfg.position.baseVertex;
-
-        if(i == 0)
-        {
-          minIndex = maxIndex = idx;
-        }
-        else
-        {
-          minIndex = RDCMIN(idx, minIndex);
-          maxIndex = RDCMAX(idx, maxIndex);
-        }
-
-        outidxs[i] = idx;
-      }
-
-      gl.glBindBuffer(eGL_SHADER_STORAGE_BUFFER, DebugData.pickIBBuf);
-      gl.glBufferSubData(eGL_SHADER_STORAGE_BUFFER, 0, cfg.position.numIndices * sizeof(uint32_t),
-                         outidxs.data());
-    }
-    else if(cfg.position.indexByteStride == 2)
-    {
-      for(uint32_t i = 0; i < cfg.position.numIndices; i++)
-      {
-        uint32_t idx = idxs16[i];
-
-        if(idx < idxclamp)
-          idx = 0;
-        else if(cfg.position.baseVertex < 0)
-          idx -= idxclamp;
-        else if(cfg.position.baseVertex > 0)
-          idx += cfg.position.baseVertex;
-
-        if(i == 0)
-        {
-          minIndex = maxIndex = idx;
-        }
-        else
-        {
-          minIndex = RDCMIN(idx, minIndex);
-          maxIndex = RDCMAX(idx, maxIndex);
-        }
-
-        outidxs[i] = idx;
-      }
-
-      gl.glBindBuffer(eGL_SHADER_STORAGE_BUFFER, DebugData.pickIBBuf);
-      gl.glBufferSubData(eGL_SHADER_STORAGE_BUFFER, 0, cfg.position.numIndices * sizeof(uint32_t),
-                         outidxs.data());
-    }
-    else
-    {
-      for(uint32_t i = 0; i < cfg.position.numIndices; i++)
-      {
-        uint32_t idx = idxs[i];
-
-        if(idx < idxclamp)
-          idx = 0;
-        else if(cfg.position.baseVertex < 0)
-          idx -= idxclamp;
-        else if(cfg.position.baseVertex > 0)
-          idx += cfg.position.baseVertex;
-
-        if(i == 0)
-        {
-          minIndex = maxIndex = idx;
-        }
-        else
-        {
-          minIndex = RDCMIN(idx, minIndex);
-          maxIndex = RDCMAX(idx, maxIndex);
-        }
-
-        outidxs[i] = idx;
-      }
-
-      gl.glBindBuffer(eGL_SHADER_STORAGE_BUFFER, DebugData.pickIBBuf);
-      gl.glBufferSubData(eGL_SHADER_STORAGE_BUFFER, 0, cfg.position.numIndices * sizeof(uint32_t),
-                         outidxs.data());
-    }
-  }
-
-  // unpack and linearise the data
-  {
-    bytebuf oldData;
-    GetBufferData(cfg.position.vertexResourceId, cfg.position.vertexByteOffset, 0, oldData);
-
-    // clamp maxIndex to upper bound in case we got invalid indices or primitive restart indices
-    maxIndex = RDCMIN(maxIndex, uint32_t(oldData.size() / cfg.position.vertexByteStride));
-
-    if(DebugData.pickVBBuf == 0 || DebugData.pickVBSize < (maxIndex + 1) * sizeof(Vec4f))
-    {
-      gl.glDeleteBuffers(1, &DebugData.pickVBBuf);
-
-      gl.glGenBuffers(1, &DebugData.pickVBBuf);
-      gl.glBindBuffer(eGL_SHADER_STORAGE_BUFFER, DebugData.pickVBBuf);
-      gl.glNamedBufferDataEXT(DebugData.pickVBBuf, (maxIndex + 1) * sizeof(Vec4f), NULL,
-                              eGL_DYNAMIC_DRAW);
-
-      DebugData.pickVBSize = (maxIndex + 1) * sizeof(Vec4f);
-    }
-
-    std::vector<FloatVector> vbData;
-    vbData.resize(maxIndex + 1);
-
-    byte *data = &oldData[0];
-    byte *dataEnd = data + oldData.size();
-
-    bool valid;
-
-    // the index buffer may refer to vertices past the start of the vertex buffer, so we can't just
-    // conver the first N vertices we'll need.
-    // Instead we grab min and max above, and convert every vertex in that range. This might
-    // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg.position.vertexByteStride,
-                                                    cfg.position.format, dataEnd, valid);
-
-    gl.glBindBuffer(eGL_SHADER_STORAGE_BUFFER, DebugData.pickVBBuf);
-    gl.glBufferSubData(eGL_SHADER_STORAGE_BUFFER, 0, (maxIndex + 1) * sizeof(Vec4f), vbData.data());
-  }
-
-  uint32_t reset[4] = {};
-  gl.glBindBufferBase(eGL_SHADER_STORAGE_BUFFER, 0, DebugData.pickResultBuf);
-  gl.glBufferSubData(eGL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32_t) * 4, &reset);
-
-  gl.glBindBufferBase(eGL_SHADER_STORAGE_BUFFER, 1, DebugData.pickVBBuf);
-  gl.glBindBufferRange(eGL_SHADER_STORAGE_BUFFER, 2, DebugData.pickIBBuf, (GLintptr)0,
-                       (GLsizeiptr)(sizeof(uint32_t) * cfg.position.numIndices));
-  gl.glBindBufferBase(eGL_SHADER_STORAGE_BUFFER, 3, DebugData.pickResultBuf);
-
-  gl.glDispatchCompute(GLuint((cfg.position.numIndices) / 128 + 1), 1, 1);
-  gl.glMemoryBarrier(GL_ATOMIC_COUNTER_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
-
-  uint32_t numResults = 0;
-
-  gl.glBindBuffer(eGL_COPY_READ_BUFFER, DebugData.pickResultBuf);
-  gl.glGetBufferSubData(eGL_COPY_READ_BUFFER, 0, sizeof(uint32_t), &numResults);
-
-  if(numResults > 0)
-  {
-    if(isTriangleMesh)
-    {
-      struct PickResult
-      {
-        uint32_t vertid;
-        vec3 intersectionPoint;
-      };
-
-      byte *mapped = (byte *)gl.glMapNamedBufferEXT(DebugData.pickResultBuf, eGL_READ_ONLY);
-
-      mapped += sizeof(uint32_t) * 4;
-
-      PickResult *pickResults = (PickResult *)mapped;
-
-      PickResult *closest = pickResults;
-      // distance from raycast hit to nearest worldspace position of the mouse
-      float closestPickDistance = (closest->intersectionPoint - rayPos).Length();
-
-      // min with size of results buffer to protect against overflows
-      for(uint32_t i = 1; i < RDCMIN((uint32_t)DebugRenderData::maxMeshPicks, numResults); i++)
-      {
-        float pickDistance = (pickResults[i].intersectionPoint - rayPos).Length();
-        if(pickDistance < closestPickDistance)
-        {
-          closest = pickResults + i;
-        }
-      }
-
-      gl.glUnmapNamedBufferEXT(DebugData.pickResultBuf);
-
-      return closest->vertid;
-    }
-    else
-    {
-      struct PickResult
-      {
-        uint32_t vertid;
-        uint32_t idx;
-        float len;
-        float depth;
-      };
-
-      byte *mapped = (byte *)gl.glMapNamedBufferEXT(DebugData.pickResultBuf, eGL_READ_ONLY);
-
-      mapped += sizeof(uint32_t) * 4;
-
-      PickResult *pickResults = (PickResult *)mapped;
-
-      PickResult *closest = pickResults;
-
-      // min with size of results buffer to protect against overflows
-      for(uint32_t i = 1; i < RDCMIN((uint32_t)DebugRenderData::maxMeshPicks, numResults); i++)
-      {
-        // We need to keep the picking order consistent in the face
-        // of random buffer appends, when multiple vertices have the
-        // identical position (e.g. if UVs or normals are different).
-        //
-        // We could do something to try and disambiguate, but it's
-        // never going to be intuitive, it's just going to flicker
-        // confusingly.
-        if(pickResults[i].len < closest->len ||
-           (pickResults[i].len == closest->len && pickResults[i].depth < closest->depth) ||
-           (pickResults[i].len == closest->len && pickResults[i].depth == closest->depth &&
-            pickResults[i].vertid < closest->vertid))
-          closest = pickResults + i;
-      }
-
-      gl.glUnmapNamedBufferEXT(DebugData.pickResultBuf);
-
-      return closest->vertid;
-    }
-  }
+  // picking is done on the CPU against a BVH built from the same data we cache for highlighting,
+  // see VulkanReplay::PickVertex. GL's clip space has Y up so unprojected positions aren't flipped.
+  m_HighlightCache.CacheHighlightingData(eventId, cfg);
 
-  return ~0U;
+  return m_HighlightCache.PickVertex(width, height, cfg, x, y, false);
 }
 
 void GLReplay::PickPixel(ResourceId texture, uint32_t x, uint32_t y, uint32_t sliceFace,
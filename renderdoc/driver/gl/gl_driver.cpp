@@ -26,6 +26,7 @@
 #include "gl_driver.h"
 #include <algorithm>
 #include "common/common.h"
+#include "common/thumbnail.h"
 #include "driver/shaders/spirv/spirv_common.h"
 #include "jpeg-compressor/jpge.h"
 #include "serialise/rdcfile.h"
@@ -1217,6 +1218,16 @@ struct ReplacementSearch
   bool operator()(const pair<ResourceId, Replacement> &a, ResourceId b) { return a.first < b; }
 };
 
+const ProgramUniforms *WrappedOpenGL::GetProgramUniformLayout(GLuint prog)
+{
+  auto it = m_Programs.find(GetResourceManager()->GetID(ProgramRes(GetCtx(), prog)));
+
+  if(it == m_Programs.end() || !it->second.linked)
+    return NULL;
+
+  return &it->second.uniformLayout;
+}
+
 void WrappedOpenGL::ReplaceResource(ResourceId from, ResourceId to)
 {
   RemoveReplacement(from);
@@ -1297,7 +1308,7 @@ void WrappedOpenGL::ReplaceResource(ResourceId from, ResourceId to)
             else
             {
               // copy uniforms
-              CopyProgramUniforms(m_Real, progsrc, progdst);
+              CopyProgramUniforms(m_Real, progsrc, progdst, GetProgramUniformLayout(progsrc));
 
               ResourceId origsrcid = GetResourceManager()->GetOriginalID(progsrcid);
 
@@ -1854,9 +1865,11 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
 
         RDCDEBUG("Accumulating context resource list");
 
-        map<int32_t, Chunk *> recordlist;
+        RecordChunkList recordlist;
         record->Insert(recordlist);
 
+        SortChunks(recordlist);
+
         RDCDEBUG("Flushing %u records to file serialiser", (uint32_t)recordlist.size());
 
         float num = float(recordlist.size());
@@ -2009,46 +2022,13 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
     m_Real.glPixelStorei(eGL_PACK_SKIP_PIXELS, 0);
     m_Real.glPixelStorei(eGL_PACK_ALIGNMENT, 1);
 
-    thwidth = (uint16_t)m_InitParams.width;
-    thheight = (uint16_t)m_InitParams.height;
+    uint32_t width = m_InitParams.width;
+    uint32_t height = m_InitParams.height;
 
-    thpixels = new byte[thwidth * thheight * 4];
+    byte *readback = new byte[width * height * 4];
 
     // GLES only supports GL_RGBA
-    m_Real.glReadPixels(0, 0, thwidth, thheight, eGL_RGBA, eGL_UNSIGNED_BYTE, thpixels);
-
-    // RGBA -> RGB
-    for(uint32_t y = 0; y < thheight; y++)
-    {
-      for(uint32_t x = 0; x < thwidth; x++)
-      {
-        thpixels[(y * thwidth + x) * 3 + 0] = thpixels[(y * thwidth + x) * 4 + 0];
-        thpixels[(y * thwidth + x) * 3 + 1] = thpixels[(y * thwidth + x) * 4 + 1];
-        thpixels[(y * thwidth + x) * 3 + 2] = thpixels[(y * thwidth + x) * 4 + 2];
-      }
-    }
-
-    // flip the image in-place
-    for(uint16_t y = 0; y <= thheight / 2; y++)
-    {
-      uint16_t flipY = (thheight - 1 - y);
-
-      for(uint16_t x = 0; x < thwidth; x++)
-      {
-        byte save[3];
-        save[0] = thpixels[(y * thwidth + x) * 3 + 0];
-        save[1] = thpixels[(y * thwidth + x) * 3 + 1];
-        save[2] = thpixels[(y * thwidth + x) * 3 + 2];
-
-        thpixels[(y * thwidth + x) * 3 + 0] = thpixels[(flipY * thwidth + x) * 3 + 0];
-        thpixels[(y * thwidth + x) * 3 + 1] = thpixels[(flipY * thwidth + x) * 3 + 1];
-        thpixels[(y * thwidth + x) * 3 + 2] = thpixels[(flipY * thwidth + x) * 3 + 2];
-
-        thpixels[(flipY * thwidth + x) * 3 + 0] = save[0];
-        thpixels[(flipY * thwidth + x) * 3 + 1] = save[1];
-        thpixels[(flipY * thwidth + x) * 3 + 2] = save[2];
-      }
-    }
+    m_Real.glReadPixels(0, 0, width, height, eGL_RGBA, eGL_UNSIGNED_BYTE, readback);
 
     m_Real.glBindBuffer(eGL_PIXEL_PACK_BUFFER, packBufBind);
     m_Real.glBindFramebuffer(eGL_READ_FRAMEBUFFER, prevBuf);
@@ -2058,42 +2038,20 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
     m_Real.glPixelStorei(eGL_PACK_SKIP_PIXELS, prevPackSkipPixels);
     m_Real.glPixelStorei(eGL_PACK_ALIGNMENT, prevPackAlignment);
 
-    // scale down if necessary using simple point sampling
-    uint16_t resample_width = RDCMIN(maxSize, thwidth);
-    resample_width &= ~3;    // JPEG encoder gives shear distortion if width is not divisible by 4.
-    if(thwidth != resample_width)
-    {
-      float widthf = float(thwidth);
-      float heightf = float(thheight);
-
-      float aspect = widthf / heightf;
-
-      // clamp dimensions to a width of resample_width
-      thwidth = resample_width;
-      thheight = uint16_t(float(thwidth) / aspect);
-
-      byte *src = thpixels;
-      byte *dst = thpixels = new byte[3U * thwidth * thheight];
-
-      for(uint32_t y = 0; y < thheight; y++)
-      {
-        for(uint32_t x = 0; x < thwidth; x++)
-        {
-          float xf = float(x) / float(thwidth);
-          float yf = float(y) / float(thheight);
+    ResourceFormat fmt;
+    fmt.type = ResourceFormatType::Regular;
+    fmt.compType = CompType::UNorm;
+    fmt.compCount = 4;
+    fmt.compByteWidth = 1;
 
-          byte *pixelsrc =
-              &src[3 * uint32_t(xf * widthf) + m_InitParams.width * 3 * uint32_t(yf * heightf)];
+    CalcThumbnailSize(width, height, maxSize, thwidth, thheight);
 
-          memcpy(dst, pixelsrc, 3);
+    thpixels = new byte[3U * thwidth * thheight];
 
-          dst += 3;
-        }
-      }
+    // downscale and flip the image, since GL reads back bottom-up
+    DownscaleToRGB8(readback, width, height, width * 4, fmt, true, thpixels, thwidth, thheight);
 
-      // src is the raw unscaled pixels, which is no longer needed
-      SAFE_DELETE_ARRAY(src);
-    }
+    SAFE_DELETE_ARRAY(readback);
   }
 
   byte *jpgbuf = NULL;
@@ -2548,26 +2506,19 @@ ReplayStatus WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
   int chunkIdx = 0;
 
-  struct chunkinfo
-  {
-    chunkinfo() : count(0), totalsize(0), total(0.0) {}
-    int count;
-    uint64_t totalsize;
-    double total;
-  };
-
-  std::map<GLChunk, chunkinfo> chunkInfos;
-
   SCOPED_TIMER("chunk initialisation");
 
   uint64_t frameDataSize = 0;
+  uint64_t initDataSize = 0;
+
+  m_LoadProfiler.Begin();
 
   for(;;)
   {
-    PerformanceTimer timer;
-
     uint64_t offsetStart = reader->GetOffset();
 
+    m_LoadProfiler.BeginChunk(m_StructuredFile->chunks.size());
+
     GLChunk context = ser.ReadChunk<GLChunk>();
 
     chunkIdx++;
@@ -2589,6 +2540,9 @@ ReplayStatus WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
     uint64_t offsetEnd = reader->GetOffset();
 
+    if((SystemChunk)context != SystemChunk::CaptureScope)
+      m_LoadProfiler.EndChunk((uint32_t)context, offsetEnd - offsetStart);
+
     RenderDoc::Inst().SetProgress(LoadProgress::FileInitialRead,
                                   float(offsetEnd) / float(reader->GetSize()));
 
@@ -2603,45 +2557,37 @@ ReplayStatus WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
       GetResourceManager()->ApplyInitialContents();
 
+      // the time to apply initial contents is attributed to the capture scope chunk, the frame
+      // itself is profiled chunk by chunk in ContextReplayLog
+      m_LoadProfiler.EndChunk((uint32_t)context, offsetEnd - offsetStart);
+
       ReplayStatus status = ContextReplayLog(m_State, 0, 0, false);
 
       if(status != ReplayStatus::Succeeded)
         return status;
     }
 
-    chunkInfos[context].total += timer.GetMilliseconds();
-    chunkInfos[context].totalsize += offsetEnd - offsetStart;
-    chunkInfos[context].count++;
+    if((SystemChunk)context == SystemChunk::InitialContents)
+      initDataSize += offsetEnd - offsetStart;
 
     if((SystemChunk)context == SystemChunk::CaptureScope || reader->IsErrored() || reader->AtEnd())
       break;
   }
 
-#if ENABLED(RDOC_DEVEL)
-  for(auto it = chunkInfos.begin(); it != chunkInfos.end(); ++it)
-  {
-    double dcount = double(it->second.count);
-
-    RDCDEBUG(
-        "% 5d chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
-        it->second.count, it->second.total, it->second.total / dcount,
-        double(it->second.totalsize) / (1024.0 * 1024.0),
-        double(it->second.totalsize) / (dcount * 1024.0 * 1024.0),
-        GetChunkName((uint32_t)it->first).c_str(), uint32_t(it->first));
-  }
-#endif
-
   // steal the structured data for ourselves
   m_StructuredFile->Swap(m_StoredStructuredData);
 
   // and in future use this file.
   m_StructuredFile = &m_StoredStructuredData;
 
+  if(!IsStructuredExporting(m_State))
+    m_FrameRecord.frameInfo.loadStats = m_LoadProfiler.Finish(m_StoredStructuredData);
+
   m_FrameRecord.frameInfo.uncompressedFileSize =
       rdc->GetSectionProperties(sectionIdx).uncompressedSize;
   m_FrameRecord.frameInfo.compressedFileSize = rdc->GetSectionProperties(sectionIdx).compressedSize;
   m_FrameRecord.frameInfo.persistentSize = frameDataSize;
-  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(GLChunk)SystemChunk::InitialContents].totalsize;
+  m_FrameRecord.frameInfo.initDataSize = initDataSize;
 
   RDCDEBUG("Allocating %llu persistant bytes of memory for the log.",
            m_FrameRecord.frameInfo.persistentSize);
@@ -4197,7 +4143,7 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
 
   if(IsActiveReplaying(m_State))
   {
-    APIEvent ev = GetEvent(startEventID);
+    const APIEvent &ev = GetEvent(startEventID);
     m_CurEventID = ev.eventId;
     if(partial)
       ser.GetReader()->SetOffset(ev.fileOffset);
@@ -4224,6 +4170,9 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
 
     m_CurChunkOffset = ser.GetReader()->GetOffset();
 
+    if(IsLoading(m_State))
+      m_LoadProfiler.BeginChunk(m_StructuredFile->chunks.size());
+
     GLChunk chunktype = ser.ReadChunk<GLChunk>();
 
     if(ser.GetReader()->IsErrored())
@@ -4243,6 +4192,10 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
     if(!success)
       return m_FailedReplayStatus;
 
+    if(IsLoading(m_State))
+      m_LoadProfiler.EndChunk((uint32_t)chunktype,
+                              ser.GetReader()->GetOffset() - m_CurChunkOffset);
+
     RenderDoc::Inst().SetProgress(
         LoadProgress::FrameEventsRead,
         float(m_CurChunkOffset - startOffset) / float(ser.GetReader()->GetSize()));
@@ -4267,6 +4220,8 @@ ReplayStatus WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t sta
     DrawcallDescription *previous = NULL;
     SetupDrawcallPointers(&m_Drawcalls, GetFrameRecord().drawcallList, NULL, previous);
 
+    m_EventIndex.Build(m_Events);
+
     // it's easier to remove duplicate usages here than check it as we go.
     // this means if textures are bound in multiple places in the same draw
     // we don't have duplicate uses
@@ -4672,13 +4627,7 @@ void WrappedOpenGL::AddEvent()
 
 const APIEvent &WrappedOpenGL::GetEvent(uint32_t eventId)
 {
-  for(const APIEvent &e : m_Events)
-  {
-    if(e.eventId >= eventId)
-      return e;
-  }
-
-  return m_Events.back();
+  return m_Events[m_EventIndex.Find(eventId)];
 }
 
 const DrawcallDescription *WrappedOpenGL::GetDrawcall(uint32_t eventId)
@@ -4691,6 +4640,10 @@ const DrawcallDescription *WrappedOpenGL::GetDrawcall(uint32_t eventId)
 
 void WrappedOpenGL::ReplayLog(uint32_t startEventID, uint32_t endEventID, ReplayLogType replayType)
 {
+  // callers other than ReplayLogIncremental may have changed state around this replay, so we can't
+  // continue on from it.
+  m_ReplayedEventID = 0;
+
   bool partial = true;
 
   if(startEventID == 0 && (replayType == eReplay_WithoutDraw || replayType == eReplay_Full))
@@ -4733,3 +4686,36 @@ void WrappedOpenGL::ReplayLog(uint32_t startEventID, uint32_t endEventID, Replay
 
   GLMarkerRegion::Set("!!!!RenderDoc Internal: Done replay");
 }
+
+void WrappedOpenGL::ReplayLogIncremental(uint32_t endEventID, ReplayLogType replayType)
+{
+  uint32_t prevEventID = m_ReplayedEventID;
+
+  if(replayType == eReplay_OnlyDraw)
+  {
+    ReplayLog(0, endEventID, replayType);
+
+    // replaying just the draw only keeps us in order if we were right before it
+    if(prevEventID != 0 && prevEventID + 1 == endEventID)
+      m_ReplayedEventID = endEventID;
+
+    return;
+  }
+
+  uint32_t targetEventID = endEventID;
+  if(replayType == eReplay_WithoutDraw)
+    targetEventID = RDCMAX(1U, endEventID) - 1;
+
+  if(prevEventID != 0 && prevEventID <= targetEventID)
+  {
+    // we're moving forward from a known good state, so only replay the events in between
+    if(prevEventID < targetEventID)
+      ReplayLog(prevEventID + 1, endEventID, replayType);
+  }
+  else
+  {
+    ReplayLog(0, endEventID, replayType);
+  }
+
+  m_ReplayedEventID = targetEventID;
+}
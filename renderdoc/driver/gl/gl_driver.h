@@ -128,6 +128,8 @@ private:
 
   StreamReader *m_FrameReader = NULL;
 
+  ChunkLoadProfiler m_LoadProfiler;
+
   static std::map<uint64_t, GLWindowingData> m_ActiveContexts;
 
   ContextPair m_EmptyPair;
@@ -184,6 +186,10 @@ private:
 
   int m_ReplayEventCount = 0;
 
+  // the last event replayed in order by ReplayLogIncremental, with nothing else replayed since, or
+  // 0 if the current replay state isn't known to match the capture
+  uint32_t m_ReplayedEventID = 0;
+
   // we store two separate sets of maps, since for an explicit glMemoryBarrier
   // we need to flush both types of maps, but for implicit sync points we only
   // want to consider coherent maps, and since that happens often we want it to
@@ -218,6 +224,7 @@ private:
   // replay
 
   vector<APIEvent> m_CurEvents, m_Events;
+  EventIndex m_EventIndex;
   bool m_AddedDrawcall;
 
   uint64_t m_CurChunkOffset;
@@ -323,6 +330,10 @@ private:
     bool shaderProgramUnlinkable = false;
     bool linked;
     ResourceId stageShaders[6];
+
+    // on replay, the loose uniforms and blocks of the linked program (without values), fetched when
+    // it's linked so copying its uniforms to overlay or post-VS programs only needs the values.
+    ProgramUniforms uniformLayout;
   };
 
   struct PipelineData
@@ -346,6 +357,11 @@ private:
 
   map<ResourceId, ShaderData> m_Shaders;
   map<ResourceId, ProgramData> m_Programs;
+
+  // only used while capturing, see ProgramUniformShadow
+  map<ResourceId, ProgramUniformShadow> m_ProgramUniformShadows;
+  void ShadowProgramUniform(GLuint program, GLint location, GLsizei count, const void *value,
+                            UniformType type, bool transpose);
   map<ResourceId, PipelineData> m_Pipelines;
   vector<pair<ResourceId, Replacement> > m_DependentReplacements;
 
@@ -580,6 +596,7 @@ public:
   SDFile &GetStructuredFile() { return *m_StructuredFile; }
   void SetFetchCounters(bool in) { m_FetchCounters = in; };
   const GLHookSet &GetHookset() { return m_Real; }
+  const ProgramUniforms *GetProgramUniformLayout(GLuint prog);
   void SetDebugMsgContext(const char *context) { m_DebugMsgContext = context; }
   void AddDebugMessage(DebugMessage msg)
   {
@@ -594,6 +611,8 @@ public:
   // replay interface
   void Initialise(GLInitParams &params, uint64_t sectionVersion);
   void ReplayLog(uint32_t startEventID, uint32_t endEventID, ReplayLogType replayType);
+  void ReplayLogIncremental(uint32_t endEventID, ReplayLogType replayType);
+  void InvalidateReplayPosition() { m_ReplayedEventID = 0; }
   ReplayStatus ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers);
 
   GLuint GetFakeBBFBO() { return m_FakeBB_FBO; }
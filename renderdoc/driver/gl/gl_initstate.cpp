@@ -376,8 +376,14 @@ bool GLResourceManager::Prepare_InitialState(GLResource res)
     SERIALISE_ELEMENT(Id).TypedAs("GLResource");
     SERIALISE_ELEMENT(res.Namespace);
 
+    // if the program is being shadowed we can serialise its uniforms without any queries
+    auto shadow = m_GL->m_ProgramUniformShadows.find(Id);
+    const ProgramUniforms *cachedUniforms =
+        shadow != m_GL->m_ProgramUniformShadows.end() ? &shadow->second.uniforms : NULL;
+
     SerialiseProgramBindings(ser, CaptureState::ActiveCapturing, gl, res.name);
-    SerialiseProgramUniforms(ser, CaptureState::ActiveCapturing, gl, res.name, NULL);
+    SerialiseProgramUniforms(ser, CaptureState::ActiveCapturing, gl, res.name, NULL,
+                             cachedUniforms);
 
     SetInitialChunk(Id, scope.Get());
   }
@@ -915,8 +921,13 @@ uint32_t GLResourceManager::GetSize_InitialState(ResourceId resid, GLResource re
     SERIALISE_ELEMENT(resid).TypedAs("GLResource");
     SERIALISE_ELEMENT(res.Namespace);
 
+    auto shadow = m_GL->m_ProgramUniformShadows.find(resid);
+    const ProgramUniforms *cachedUniforms =
+        shadow != m_GL->m_ProgramUniformShadows.end() ? &shadow->second.uniforms : NULL;
+
     SerialiseProgramBindings(ser, CaptureState::ActiveCapturing, m_GL->GetHookset(), res.name);
-    SerialiseProgramUniforms(ser, CaptureState::ActiveCapturing, m_GL->GetHookset(), res.name, NULL);
+    SerialiseProgramUniforms(ser, CaptureState::ActiveCapturing, m_GL->GetHookset(), res.name, NULL,
+                             cachedUniforms);
 
     return (uint32_t)ser.GetWriter()->GetOffset() + 256;
   }
@@ -1899,7 +1910,8 @@ void GLResourceManager::Apply_InitialState(GLResource live, GLInitialContents in
                                   &m_GL->m_Shaders[prog.stageShaders[4]].reflection);
 
     // we need to re-link the program to apply the bindings, as long as it's linkable.
-    // See the comment on shaderProgramUnlinkable for more information.
+    // See the comment on shaderProgramUnlinkable for more information. The attached shaders are
+    // the same, so the uniform layout fetched when the program was linked is still valid.
     if(!prog.shaderProgramUnlinkable)
       gl.glLinkProgram(live.name);
 
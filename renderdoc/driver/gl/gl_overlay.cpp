@@ -139,7 +139,8 @@ void GLReplay::CreateOverlayProgram(GLuint Program, GLuint Pipeline, GLuint frag
   // same program is bound to multiple stages. It's just inefficient
   for(size_t i = 0; i < 4; i++)
     if(programs[i])
-      CopyProgramUniforms(gl.GetHookset(), programs[i], DebugData.overlayProg);
+      CopyProgramUniforms(gl.GetHookset(), programs[i], DebugData.overlayProg,
+                          gl.GetProgramUniformLayout(programs[i]));
 }
 
 ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOverlay overlay,
@@ -341,7 +342,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
     float colVal[] = {0.8f, 0.1f, 0.8f, 1.0f};
     gl.glProgramUniform4fv(DebugData.overlayProg, colLoc, 1, colVal);
 
-    ReplayLog(eventId, eReplay_OnlyDraw);
+    m_pDriver->ReplayLog(0, eventId, eReplay_OnlyDraw);
   }
   else if(overlay == DebugOverlay::Wireframe)
   {
@@ -357,7 +358,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
       // desktop GL is simple
       gl.glPolygonMode(eGL_FRONT_AND_BACK, eGL_LINE);
 
-      ReplayLog(eventId, eReplay_OnlyDraw);
+      m_pDriver->ReplayLog(0, eventId, eReplay_OnlyDraw);
     }
     else
     {
@@ -485,7 +486,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
     float red[] = {1.0f, 0.0f, 0.0f, 1.0f};
     gl.glProgramUniform4fv(DebugData.overlayProg, colLoc, 1, red);
 
-    ReplayLog(eventId, eReplay_OnlyDraw);
+    m_pDriver->ReplayLog(0, eventId, eReplay_OnlyDraw);
 
     GLuint curDepth = 0, curStencil = 0;
 
@@ -693,7 +694,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
                          DebugData.overlayTexWidth, DebugData.overlayTexHeight,
                          GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, eGL_NEAREST);
 
-    ReplayLog(eventId, eReplay_OnlyDraw);
+    m_pDriver->ReplayLog(0, eventId, eReplay_OnlyDraw);
 
     // unset depth/stencil textures from overlay FBO and delete temp depth/stencil
     if(curDepth != 0 && curDepth == curStencil)
@@ -718,7 +719,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
     GLint colLoc = gl.glGetUniformLocation(DebugData.overlayProg, "RENDERDOC_Fixed_Color");
     gl.glProgramUniform4fv(DebugData.overlayProg, colLoc, 1, col);
 
-    ReplayLog(eventId, eReplay_OnlyDraw);
+    m_pDriver->ReplayLog(0, eventId, eReplay_OnlyDraw);
 
     // only enable cull face if it was enabled originally (otherwise
     // we just render green over the exact same area, so it shows up "passing")
@@ -730,7 +731,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
 
     gl.glProgramUniform4fv(DebugData.overlayProg, colLoc, 1, col);
 
-    ReplayLog(eventId, eReplay_OnlyDraw);
+    m_pDriver->ReplayLog(0, eventId, eReplay_OnlyDraw);
   }
   else if(overlay == DebugOverlay::ClearBeforeDraw || overlay == DebugOverlay::ClearBeforePass)
   {
@@ -811,7 +812,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
     if(!events.empty() && DebugData.trisizeProg)
     {
       if(overlay == DebugOverlay::TriangleSizePass)
-        ReplayLog(events[0], eReplay_WithoutDraw);
+        m_pDriver->ReplayLog(0, events[0], eReplay_WithoutDraw);
       else
         rs.ApplyState(m_pDriver);
 
@@ -1145,7 +1146,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
       gl.glDeleteVertexArrays(1, &tempVAO);
 
       if(overlay == DebugOverlay::TriangleSizePass)
-        ReplayLog(eventId, eReplay_WithoutDraw);
+        m_pDriver->ReplayLog(0, eventId, eReplay_WithoutDraw);
     }
   }
   else if(overlay == DebugOverlay::QuadOverdrawDraw || overlay == DebugOverlay::QuadOverdrawPass)
@@ -1245,7 +1246,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
         gl.glFramebufferTexture(eGL_FRAMEBUFFER, dsAttach, quadtexs[1], 0);
 
         if(overlay == DebugOverlay::QuadOverdrawPass)
-          ReplayLog(events[0], eReplay_WithoutDraw);
+          m_pDriver->ReplayLog(0, events[0], eReplay_WithoutDraw);
         else
           rs.ApplyState(m_pDriver);
 
@@ -1383,7 +1384,7 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, CompType typeHint, DebugOve
         gl.glDeleteTextures(3, quadtexs);
 
         if(overlay == DebugOverlay::QuadOverdrawPass)
-          ReplayLog(eventId, eReplay_WithoutDraw);
+          m_pDriver->ReplayLog(0, eventId, eReplay_WithoutDraw);
       }
     }
   }
@@ -354,7 +354,7 @@ void GLReplay::InitPostVSBuffers(uint32_t eventId)
 
   // copy across any uniform values, bindings etc from the real program containing
   // the vertex stage
-  CopyProgramUniforms(gl.GetHookset(), vsProgSrc, vsProg);
+  CopyProgramUniforms(gl.GetHookset(), vsProgSrc, vsProg, gl.GetProgramUniformLayout(vsProgSrc));
 
   // bind our program and do the feedback draw
   gl.glUseProgram(vsProg);
@@ -434,22 +434,19 @@ void GLReplay::InitPostVSBuffers(uint32_t eventId)
         RDCMIN(uint32_t(idxdata.size() / drawcall->indexByteWidth), drawcall->numIndices);
 
     // grab all unique vertex indices referenced
-    for(uint32_t i = 0; i < numIndices; i++)
+    if(drawcall->indexByteWidth == 4)
     {
-      uint32_t i32 = 0;
-      if(drawcall->indexByteWidth == 1)
-        i32 = uint32_t(idx8[i]);
-      else if(drawcall->indexByteWidth == 2)
-        i32 = uint32_t(idx16[i]);
-      else if(drawcall->indexByteWidth == 4)
-        i32 = idx32[i];
-
-      auto it = std::lower_bound(indices.begin(), indices.end(), i32);
+      GetUniqueIndices(idx32, numIndices, indices);
+    }
+    else
+    {
+      vector<uint32_t> idxdata32;
+      idxdata32.resize(numIndices);
 
-      if(it != indices.end() && *it == i32)
-        continue;
+      for(uint32_t i = 0; i < numIndices; i++)
+        idxdata32[i] = drawcall->indexByteWidth == 1 ? uint32_t(idx8[i]) : uint32_t(idx16[i]);
 
-      indices.insert(it, i32);
+      GetUniqueIndices(idxdata32.data(), idxdata32.size(), indices);
     }
 
     // if we read out of bounds, we'll also have a 0 index being referenced
@@ -468,14 +465,9 @@ void GLReplay::InitPostVSBuffers(uint32_t eventId)
     // so that what did point to 500 points to 0 (accounting for rebasing), and what did point
     // to 510 now points to 3 (accounting for the unique sort).
 
-    // we use a map here since the indices may be sparse. Especially considering if an index
-    // is 'invalid' like 0xcccccccc then we don't want an array of 3.4 billion entries.
-    map<uint32_t, size_t> indexRemap;
-    for(size_t i = 0; i < indices.size(); i++)
-    {
-      // by definition, this index will only appear once in indices[]
-      indexRemap[indices[i]] = i;
-    }
+    // the remap only uses a flat table when the indices are dense enough. Especially considering
+    // if an index is 'invalid' like 0xcccccccc then we don't want an array of 3.4 billion entries.
+    UniqueIndexRemap indexRemap(indices);
 
     // generate a temporary index buffer with our 'unique index set' indices,
     // so we can transform feedback each referenced vertex once
@@ -561,7 +553,7 @@ void GLReplay::InitPostVSBuffers(uint32_t eventId)
         if(stripRestartValue && idx8[i] == stripRestartValue)
           continue;
 
-        idx8[i] = uint8_t(indexRemap[idx8[i]]);
+        idx8[i] = uint8_t(indexRemap.Remap(idx8[i]));
       }
     }
     else if(drawcall->indexByteWidth == 2)
@@ -574,7 +566,7 @@ void GLReplay::InitPostVSBuffers(uint32_t eventId)
         if(stripRestartValue && idx16[i] == stripRestartValue)
           continue;
 
-        idx16[i] = uint16_t(indexRemap[idx16[i]]);
+        idx16[i] = uint16_t(indexRemap.Remap(idx16[i]));
       }
     }
     else
@@ -587,7 +579,7 @@ void GLReplay::InitPostVSBuffers(uint32_t eventId)
         if(stripRestartValue && idx32[i] == stripRestartValue)
           continue;
 
-        idx32[i] = uint32_t(indexRemap[idx32[i]]);
+        idx32[i] = uint32_t(indexRemap.Remap(idx32[i]));
       }
     }
 
@@ -906,18 +898,22 @@ void GLReplay::InitPostVSBuffers(uint32_t eventId)
     {
       // copy across any uniform values, bindings etc from the real program containing
       // the vertex stage
-      CopyProgramUniforms(gl.GetHookset(), vsProgSrc, lastFeedbackProg);
+      CopyProgramUniforms(gl.GetHookset(), vsProgSrc, lastFeedbackProg,
+                          gl.GetProgramUniformLayout(vsProgSrc));
 
       // if tessellation is enabled, bind & copy uniforms. Note, control shader is optional
       // independent of eval shader (default values are used for the tessellation levels).
       if(tcsProgSrc)
-        CopyProgramUniforms(gl.GetHookset(), tcsProgSrc, lastFeedbackProg);
+        CopyProgramUniforms(gl.GetHookset(), tcsProgSrc, lastFeedbackProg,
+                            gl.GetProgramUniformLayout(tcsProgSrc));
       if(tesProgSrc)
-        CopyProgramUniforms(gl.GetHookset(), tesProgSrc, lastFeedbackProg);
+        CopyProgramUniforms(gl.GetHookset(), tesProgSrc, lastFeedbackProg,
+                            gl.GetProgramUniformLayout(tesProgSrc));
 
       // if we have a geometry shader, bind & copy uniforms
       if(gsProgSrc)
-        CopyProgramUniforms(gl.GetHookset(), gsProgSrc, lastFeedbackProg);
+        CopyProgramUniforms(gl.GetHookset(), gsProgSrc, lastFeedbackProg,
+                            gl.GetProgramUniformLayout(gsProgSrc));
 
       // bind our program and do the feedback draw
       gl.glUseProgram(lastFeedbackProg);
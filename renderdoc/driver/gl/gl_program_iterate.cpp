@@ -27,57 +27,6 @@
 #include "gl_common.h"
 #include "gl_driver.h"
 
-struct ProgramUniformValue
-{
-  ProgramUniformValue()
-  {
-    Type = eGL_NONE;
-    Location = 0;
-    RDCEraseEl(data);
-  }
-  GLenum Type;
-  int32_t Location;
-
-  union
-  {
-    double dval[16];
-    float fval[16];
-    int32_t ival[16];
-    uint32_t uval[16];
-  } data;
-};
-
-DECLARE_REFLECTION_STRUCT(ProgramUniformValue);
-
-struct ProgramUniform
-{
-  std::string Basename;
-  bool IsArray = false;
-
-  std::vector<ProgramUniformValue> Values;
-};
-
-DECLARE_REFLECTION_STRUCT(ProgramUniform);
-
-struct ProgramBinding
-{
-  ProgramBinding() = default;
-  ProgramBinding(const char *n, int32_t b) : Name(n), Binding(b) {}
-  std::string Name;
-  int32_t Binding = -1;
-};
-
-DECLARE_REFLECTION_STRUCT(ProgramBinding);
-
-struct ProgramUniforms
-{
-  std::vector<ProgramUniform> ValueUniforms;
-  std::vector<ProgramBinding> UBOBindings;
-  std::vector<ProgramBinding> SSBOBindings;
-};
-
-DECLARE_REFLECTION_STRUCT(ProgramUniforms);
-
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, ProgramUniformValue &el)
 {
@@ -278,279 +227,338 @@ void DoSerialise(SerialiserType &ser, ProgramUniforms &el)
   SERIALISE_MEMBER(SSBOBindings);
 }
 
-// bit of a hack, to work around C4127: conditional expression is constant
-// on template parameters
-template <typename T>
-T CheckConstParam(T t);
-template <>
-bool CheckConstParam(bool t)
+enum class UniformStorage
 {
-  return t;
+  Unknown,
+  Float,
+  Double,
+  Int,
+  UInt,
+  Boolean,
+};
+
+// how the value of a uniform of the given type is stored in ProgramUniformValue::data
+static UniformStorage GetUniformStorage(GLenum type)
+{
+  switch(type)
+  {
+    case eGL_FLOAT_MAT4:
+    case eGL_FLOAT_MAT4x3:
+    case eGL_FLOAT_MAT4x2:
+    case eGL_FLOAT_MAT3:
+    case eGL_FLOAT_MAT3x4:
+    case eGL_FLOAT_MAT3x2:
+    case eGL_FLOAT_MAT2:
+    case eGL_FLOAT_MAT2x4:
+    case eGL_FLOAT_MAT2x3:
+    case eGL_FLOAT:
+    case eGL_FLOAT_VEC2:
+    case eGL_FLOAT_VEC3:
+    case eGL_FLOAT_VEC4: return UniformStorage::Float;
+    case eGL_DOUBLE_MAT4:
+    case eGL_DOUBLE_MAT4x3:
+    case eGL_DOUBLE_MAT4x2:
+    case eGL_DOUBLE_MAT3:
+    case eGL_DOUBLE_MAT3x4:
+    case eGL_DOUBLE_MAT3x2:
+    case eGL_DOUBLE_MAT2:
+    case eGL_DOUBLE_MAT2x4:
+    case eGL_DOUBLE_MAT2x3:
+    case eGL_DOUBLE:
+    case eGL_DOUBLE_VEC2:
+    case eGL_DOUBLE_VEC3:
+    case eGL_DOUBLE_VEC4: return UniformStorage::Double;
+    // treat all samplers and images as just an int (since they just store their binding value)
+    case eGL_SAMPLER_1D:
+    case eGL_SAMPLER_2D:
+    case eGL_SAMPLER_3D:
+    case eGL_SAMPLER_CUBE:
+    case eGL_SAMPLER_CUBE_MAP_ARRAY:
+    case eGL_SAMPLER_1D_SHADOW:
+    case eGL_SAMPLER_2D_SHADOW:
+    case eGL_SAMPLER_1D_ARRAY:
+    case eGL_SAMPLER_2D_ARRAY:
+    case eGL_SAMPLER_1D_ARRAY_SHADOW:
+    case eGL_SAMPLER_2D_ARRAY_SHADOW:
+    case eGL_SAMPLER_2D_MULTISAMPLE:
+    case eGL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case eGL_SAMPLER_CUBE_SHADOW:
+    case eGL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+    case eGL_SAMPLER_BUFFER:
+    case eGL_SAMPLER_2D_RECT:
+    case eGL_SAMPLER_2D_RECT_SHADOW:
+    case eGL_INT_SAMPLER_1D:
+    case eGL_INT_SAMPLER_2D:
+    case eGL_INT_SAMPLER_3D:
+    case eGL_INT_SAMPLER_CUBE:
+    case eGL_INT_SAMPLER_CUBE_MAP_ARRAY:
+    case eGL_INT_SAMPLER_1D_ARRAY:
+    case eGL_INT_SAMPLER_2D_ARRAY:
+    case eGL_INT_SAMPLER_2D_MULTISAMPLE:
+    case eGL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case eGL_INT_SAMPLER_BUFFER:
+    case eGL_INT_SAMPLER_2D_RECT:
+    case eGL_UNSIGNED_INT_SAMPLER_1D:
+    case eGL_UNSIGNED_INT_SAMPLER_2D:
+    case eGL_UNSIGNED_INT_SAMPLER_3D:
+    case eGL_UNSIGNED_INT_SAMPLER_CUBE:
+    case eGL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+    case eGL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+    case eGL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+    case eGL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case eGL_UNSIGNED_INT_SAMPLER_BUFFER:
+    case eGL_UNSIGNED_INT_SAMPLER_2D_RECT:
+    case eGL_IMAGE_1D:
+    case eGL_IMAGE_2D:
+    case eGL_IMAGE_3D:
+    case eGL_IMAGE_2D_RECT:
+    case eGL_IMAGE_CUBE:
+    case eGL_IMAGE_BUFFER:
+    case eGL_IMAGE_1D_ARRAY:
+    case eGL_IMAGE_2D_ARRAY:
+    case eGL_IMAGE_CUBE_MAP_ARRAY:
+    case eGL_IMAGE_2D_MULTISAMPLE:
+    case eGL_IMAGE_2D_MULTISAMPLE_ARRAY:
+    case eGL_INT_IMAGE_1D:
+    case eGL_INT_IMAGE_2D:
+    case eGL_INT_IMAGE_3D:
+    case eGL_INT_IMAGE_2D_RECT:
+    case eGL_INT_IMAGE_CUBE:
+    case eGL_INT_IMAGE_BUFFER:
+    case eGL_INT_IMAGE_1D_ARRAY:
+    case eGL_INT_IMAGE_2D_ARRAY:
+    case eGL_INT_IMAGE_2D_MULTISAMPLE:
+    case eGL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+    case eGL_UNSIGNED_INT_IMAGE_1D:
+    case eGL_UNSIGNED_INT_IMAGE_2D:
+    case eGL_UNSIGNED_INT_IMAGE_3D:
+    case eGL_UNSIGNED_INT_IMAGE_2D_RECT:
+    case eGL_UNSIGNED_INT_IMAGE_CUBE:
+    case eGL_UNSIGNED_INT_IMAGE_BUFFER:
+    case eGL_UNSIGNED_INT_IMAGE_1D_ARRAY:
+    case eGL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+    case eGL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY:
+    case eGL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE:
+    case eGL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+    case eGL_UNSIGNED_INT_ATOMIC_COUNTER:
+    case eGL_INT:
+    case eGL_INT_VEC2:
+    case eGL_INT_VEC3:
+    case eGL_INT_VEC4: return UniformStorage::Int;
+    case eGL_UNSIGNED_INT:
+    case eGL_UNSIGNED_INT_VEC2:
+    case eGL_UNSIGNED_INT_VEC3:
+    case eGL_UNSIGNED_INT_VEC4: return UniformStorage::UInt;
+    case eGL_BOOL:
+    case eGL_BOOL_VEC2:
+    case eGL_BOOL_VEC3:
+    case eGL_BOOL_VEC4: return UniformStorage::Boolean;
+    default: break;
+  }
+
+  return UniformStorage::Unknown;
 }
 
-template <const bool CopyUniforms, const bool SerialiseUniforms, typename SerialiserType>
-static void ForAllProgramUniforms(SerialiserType *ser, CaptureState state, const GLHookSet &gl,
-                                  GLuint progSrc, GLuint progDst, map<GLint, GLint> *locTranslate)
+void FetchProgramUniformLayout(const GLHookSet &gl, GLuint progSrc, ProgramUniforms &layout)
 {
-  const bool ReadSourceProgram = CopyUniforms || (SerialiseUniforms && ser && ser->IsWriting());
-  const bool WriteDestProgram = CopyUniforms || (SerialiseUniforms && ser && ser->IsReading());
+  const size_t numProps = 5;
+  GLenum resProps[numProps] = {
+      eGL_BLOCK_INDEX, eGL_TYPE, eGL_NAME_LENGTH, eGL_ARRAY_SIZE, eGL_LOCATION,
+  };
+  GLint values[numProps];
 
-  RDCCOMPILE_ASSERT((CopyUniforms && !SerialiseUniforms) || (!CopyUniforms && SerialiseUniforms),
-                    "Invalid call to ForAllProgramUniforms");
+  GLint NumUniforms = 0;
+  gl.glGetProgramInterfaceiv(progSrc, eGL_UNIFORM, eGL_ACTIVE_RESOURCES, &NumUniforms);
 
-  // this struct will be serialised with the uniform binding data, or if we're just copying it will
-  // be used to store the data fetched from the source program, before being applied to the
-  // destination program. It's slightly redundant since we could unify the loops (as the code used
-  // to do) but it's much better for code organisation and clarity to have a single path whether
-  // serialising or not.
-  ProgramUniforms serialisedUniforms;
+  // this is a very conservative figure - many uniforms will be in UBOs and so will be ignored
+  layout.ValueUniforms.reserve(NumUniforms);
 
-  // if we're reading the source program, iterate over the interfaces and fetch the data.
-  if(CheckConstParam(ReadSourceProgram))
+  for(GLint i = 0; i < NumUniforms; i++)
   {
-    const size_t numProps = 5;
-    GLenum resProps[numProps] = {
-        eGL_BLOCK_INDEX, eGL_TYPE, eGL_NAME_LENGTH, eGL_ARRAY_SIZE, eGL_LOCATION,
-    };
-    GLint values[numProps];
+    GLenum type = eGL_NONE;
+    int32_t arraySize = 0;
+    int32_t srcLocation = 0;
+    string basename;
+    bool isArray = false;
 
-    GLint NumUniforms = 0;
-    gl.glGetProgramInterfaceiv(progSrc, eGL_UNIFORM, eGL_ACTIVE_RESOURCES, &NumUniforms);
+    gl.glGetProgramResourceiv(progSrc, eGL_UNIFORM, i, numProps, resProps, numProps, NULL, values);
 
-    // this is a very conservative figure - many uniforms will be in UBOs and so will be ignored
-    serialisedUniforms.ValueUniforms.reserve(NumUniforms);
+    // we don't need to consider uniforms within UBOs
+    if(values[0] >= 0)
+      continue;
 
-    for(GLint i = 0; i < NumUniforms; i++)
+    // get the metadata we need for fetching the data
+    type = (GLenum)values[1];
+    arraySize = values[3];
+    srcLocation = values[4];
+
+    char n[1024] = {0};
+    gl.glGetProgramResourceName(progSrc, eGL_UNIFORM, i, values[2], NULL, n);
+
+    if(arraySize > 1)
     {
-      GLenum type = eGL_NONE;
-      int32_t arraySize = 0;
-      int32_t srcLocation = 0;
-      string basename;
-      bool isArray = false;
+      isArray = true;
 
-      gl.glGetProgramResourceiv(progSrc, eGL_UNIFORM, i, numProps, resProps, numProps, NULL, values);
+      size_t len = strlen(n);
 
-      // we don't need to consider uniforms within UBOs
-      if(values[0] >= 0)
-        continue;
+      if(n[len - 3] == '[' && n[len - 2] == '0' && n[len - 1] == ']')
+        n[len - 3] = 0;
+    }
+    else
+    {
+      arraySize = 1;
+    }
 
-      // get the metadata we need for fetching the data
-      type = (GLenum)values[1];
-      arraySize = values[3];
-      srcLocation = values[4];
+    basename = n;
 
-      char n[1024] = {0};
-      gl.glGetProgramResourceName(progSrc, eGL_UNIFORM, i, values[2], NULL, n);
+    // push it onto the list
+    layout.ValueUniforms.push_back(ProgramUniform());
+    ProgramUniform &uniform = layout.ValueUniforms.back();
 
-      if(arraySize > 1)
-      {
-        isArray = true;
+    uniform.Basename = basename;
+    uniform.IsArray = isArray;
+    uniform.Values.resize(arraySize);
 
-        size_t len = strlen(n);
+    // loop over every element in the array (arraySize = 1 for non arrays)
+    for(GLint arr = 0; arr < arraySize; arr++)
+    {
+      ProgramUniformValue &uniformVal = uniform.Values[arr];
+      uniformVal.Type = type;
+      uniformVal.Location = srcLocation;
 
-        if(n[len - 3] == '[' && n[len - 2] == '0' && n[len - 1] == ']')
-          n[len - 3] = 0;
-      }
-      else
+      // append the subscript if this item is an array.
+      if(isArray)
       {
-        arraySize = 1;
+        std::string name = basename + StringFormat::Fmt("[%d]", arr);
+
+        uniformVal.Location = gl.glGetUniformLocation(progSrc, name.c_str());
       }
+    }
+  }
 
-      basename = n;
+  // now find how many UBOs we have. The blocks are listed in index order, so the bindings can be
+  // fetched again later by position
+  GLint numUBOs = 0;
+  gl.glGetProgramInterfaceiv(progSrc, eGL_UNIFORM_BLOCK, eGL_ACTIVE_RESOURCES, &numUBOs);
 
-      // push it onto the list
-      serialisedUniforms.ValueUniforms.push_back(ProgramUniform());
-      ProgramUniform &uniform = serialisedUniforms.ValueUniforms.back();
+  layout.UBOBindings.reserve(numUBOs);
 
-      uniform.Basename = basename;
-      uniform.IsArray = isArray;
-      uniform.Values.resize(arraySize);
+  for(GLint i = 0; i < numUBOs; i++)
+  {
+    char n[1024] = {0};
+    gl.glGetProgramResourceName(progSrc, eGL_UNIFORM_BLOCK, i, 1023, NULL, n);
 
-      // loop over every element in the array (arraySize = 1 for non arrays)
-      for(GLint arr = 0; arr < arraySize; arr++)
-      {
-        ProgramUniformValue &uniformVal = uniform.Values[arr];
-        uniformVal.Type = type;
-        uniformVal.Location = srcLocation;
+    layout.UBOBindings.push_back(ProgramBinding(n, -1));
+  }
 
-        std::string name = basename;
+  // finally, if SSBOs are supported on this implementation, list them too
+  GLint numSSBOs = 0;
+  if(HasExt[ARB_shader_storage_buffer_object])
+    gl.glGetProgramInterfaceiv(progSrc, eGL_SHADER_STORAGE_BLOCK, eGL_ACTIVE_RESOURCES, &numSSBOs);
 
-        // append the subscript if this item is an array.
-        if(isArray)
-        {
-          name += StringFormat::Fmt("[%d]", arr);
+  layout.SSBOBindings.reserve(numSSBOs);
 
-          uniformVal.Location = srcLocation = gl.glGetUniformLocation(progSrc, name.c_str());
-        }
+  for(GLint i = 0; i < numSSBOs; i++)
+  {
+    char n[1024] = {0};
+    gl.glGetProgramResourceName(progSrc, eGL_SHADER_STORAGE_BLOCK, i, 1023, NULL, n);
 
-        // fetch the data into the ProgramUniformValue, with the appropriate method for its type
-        double *dv = uniformVal.data.dval;
-        float *fv = uniformVal.data.fval;
-        int32_t *iv = uniformVal.data.ival;
-        uint32_t *uiv = uniformVal.data.uval;
+    layout.SSBOBindings.push_back(ProgramBinding(n, -1));
+  }
+}
 
-        switch(type)
-        {
-          case eGL_FLOAT_MAT4:
-          case eGL_FLOAT_MAT4x3:
-          case eGL_FLOAT_MAT4x2:
-          case eGL_FLOAT_MAT3:
-          case eGL_FLOAT_MAT3x4:
-          case eGL_FLOAT_MAT3x2:
-          case eGL_FLOAT_MAT2:
-          case eGL_FLOAT_MAT2x4:
-          case eGL_FLOAT_MAT2x3:
-          case eGL_FLOAT:
-          case eGL_FLOAT_VEC2:
-          case eGL_FLOAT_VEC3:
-          case eGL_FLOAT_VEC4: gl.glGetUniformfv(progSrc, srcLocation, fv); break;
-          case eGL_DOUBLE_MAT4:
-          case eGL_DOUBLE_MAT4x3:
-          case eGL_DOUBLE_MAT4x2:
-          case eGL_DOUBLE_MAT3:
-          case eGL_DOUBLE_MAT3x4:
-          case eGL_DOUBLE_MAT3x2:
-          case eGL_DOUBLE_MAT2:
-          case eGL_DOUBLE_MAT2x4:
-          case eGL_DOUBLE_MAT2x3:
-          case eGL_DOUBLE:
-          case eGL_DOUBLE_VEC2:
-          case eGL_DOUBLE_VEC3:
-          case eGL_DOUBLE_VEC4:
-            gl.glGetUniformdv(progSrc, srcLocation, dv);
-            break;
+// fills in the current values and block bindings for a layout from FetchProgramUniformLayout
+static void FetchProgramUniformValues(const GLHookSet &gl, GLuint progSrc,
+                                      ProgramUniforms &serialisedUniforms)
+{
+  for(ProgramUniform &uniform : serialisedUniforms.ValueUniforms)
+  {
+    for(ProgramUniformValue &uniformVal : uniform.Values)
+    {
+      GLint srcLocation = uniformVal.Location;
 
-          // treat all samplers as just an int (since they just store their binding value)
-          case eGL_SAMPLER_1D:
-          case eGL_SAMPLER_2D:
-          case eGL_SAMPLER_3D:
-          case eGL_SAMPLER_CUBE:
-          case eGL_SAMPLER_CUBE_MAP_ARRAY:
-          case eGL_SAMPLER_1D_SHADOW:
-          case eGL_SAMPLER_2D_SHADOW:
-          case eGL_SAMPLER_1D_ARRAY:
-          case eGL_SAMPLER_2D_ARRAY:
-          case eGL_SAMPLER_1D_ARRAY_SHADOW:
-          case eGL_SAMPLER_2D_ARRAY_SHADOW:
-          case eGL_SAMPLER_2D_MULTISAMPLE:
-          case eGL_SAMPLER_2D_MULTISAMPLE_ARRAY:
-          case eGL_SAMPLER_CUBE_SHADOW:
-          case eGL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
-          case eGL_SAMPLER_BUFFER:
-          case eGL_SAMPLER_2D_RECT:
-          case eGL_SAMPLER_2D_RECT_SHADOW:
-          case eGL_INT_SAMPLER_1D:
-          case eGL_INT_SAMPLER_2D:
-          case eGL_INT_SAMPLER_3D:
-          case eGL_INT_SAMPLER_CUBE:
-          case eGL_INT_SAMPLER_CUBE_MAP_ARRAY:
-          case eGL_INT_SAMPLER_1D_ARRAY:
-          case eGL_INT_SAMPLER_2D_ARRAY:
-          case eGL_INT_SAMPLER_2D_MULTISAMPLE:
-          case eGL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
-          case eGL_INT_SAMPLER_BUFFER:
-          case eGL_INT_SAMPLER_2D_RECT:
-          case eGL_UNSIGNED_INT_SAMPLER_1D:
-          case eGL_UNSIGNED_INT_SAMPLER_2D:
-          case eGL_UNSIGNED_INT_SAMPLER_3D:
-          case eGL_UNSIGNED_INT_SAMPLER_CUBE:
-          case eGL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
-          case eGL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
-          case eGL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
-          case eGL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
-          case eGL_UNSIGNED_INT_SAMPLER_BUFFER:
-          case eGL_UNSIGNED_INT_SAMPLER_2D_RECT:
-          case eGL_IMAGE_1D:
-          case eGL_IMAGE_2D:
-          case eGL_IMAGE_3D:
-          case eGL_IMAGE_2D_RECT:
-          case eGL_IMAGE_CUBE:
-          case eGL_IMAGE_BUFFER:
-          case eGL_IMAGE_1D_ARRAY:
-          case eGL_IMAGE_2D_ARRAY:
-          case eGL_IMAGE_CUBE_MAP_ARRAY:
-          case eGL_IMAGE_2D_MULTISAMPLE:
-          case eGL_IMAGE_2D_MULTISAMPLE_ARRAY:
-          case eGL_INT_IMAGE_1D:
-          case eGL_INT_IMAGE_2D:
-          case eGL_INT_IMAGE_3D:
-          case eGL_INT_IMAGE_2D_RECT:
-          case eGL_INT_IMAGE_CUBE:
-          case eGL_INT_IMAGE_BUFFER:
-          case eGL_INT_IMAGE_1D_ARRAY:
-          case eGL_INT_IMAGE_2D_ARRAY:
-          case eGL_INT_IMAGE_2D_MULTISAMPLE:
-          case eGL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
-          case eGL_UNSIGNED_INT_IMAGE_1D:
-          case eGL_UNSIGNED_INT_IMAGE_2D:
-          case eGL_UNSIGNED_INT_IMAGE_3D:
-          case eGL_UNSIGNED_INT_IMAGE_2D_RECT:
-          case eGL_UNSIGNED_INT_IMAGE_CUBE:
-          case eGL_UNSIGNED_INT_IMAGE_BUFFER:
-          case eGL_UNSIGNED_INT_IMAGE_1D_ARRAY:
-          case eGL_UNSIGNED_INT_IMAGE_2D_ARRAY:
-          case eGL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY:
-          case eGL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE:
-          case eGL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
-          case eGL_UNSIGNED_INT_ATOMIC_COUNTER:
-          case eGL_INT:
-          case eGL_INT_VEC2:
-          case eGL_INT_VEC3:
-          case eGL_INT_VEC4:
-            gl.glGetUniformiv(progSrc, srcLocation, iv);
-            break;
-          // bools are unsigned integers
-          case eGL_UNSIGNED_INT:
-          case eGL_BOOL:
-          case eGL_UNSIGNED_INT_VEC2:
-          case eGL_BOOL_VEC2:
-          case eGL_UNSIGNED_INT_VEC3:
-          case eGL_BOOL_VEC3:
-          case eGL_UNSIGNED_INT_VEC4:
-          case eGL_BOOL_VEC4: gl.glGetUniformuiv(progSrc, srcLocation, uiv); break;
-          default: RDCERR("Unhandled uniform type '%s'", ToStr(type).c_str());
-        }
+      // fetch the data into the ProgramUniformValue, with the appropriate method for its type
+      double *dv = uniformVal.data.dval;
+      float *fv = uniformVal.data.fval;
+      int32_t *iv = uniformVal.data.ival;
+      uint32_t *uiv = uniformVal.data.uval;
+
+      switch(GetUniformStorage(uniformVal.Type))
+      {
+        case UniformStorage::Float: gl.glGetUniformfv(progSrc, srcLocation, fv); break;
+        case UniformStorage::Double: gl.glGetUniformdv(progSrc, srcLocation, dv); break;
+        case UniformStorage::Int: gl.glGetUniformiv(progSrc, srcLocation, iv); break;
+        // bools are unsigned integers
+        case UniformStorage::UInt:
+        case UniformStorage::Boolean: gl.glGetUniformuiv(progSrc, srcLocation, uiv); break;
+        default: RDCERR("Unhandled uniform type '%s'", ToStr(uniformVal.Type).c_str());
       }
     }
+  }
 
-    // now find how many UBOs we have, and store their binding indices
-    GLint numUBOs = 0;
-    gl.glGetProgramInterfaceiv(progSrc, eGL_UNIFORM_BLOCK, eGL_ACTIVE_RESOURCES, &numUBOs);
+  GLenum prop = eGL_BUFFER_BINDING;
 
-    serialisedUniforms.UBOBindings.reserve(numUBOs);
+  for(size_t i = 0; i < serialisedUniforms.UBOBindings.size(); i++)
+    gl.glGetProgramResourceiv(progSrc, eGL_UNIFORM_BLOCK, (GLuint)i, 1, &prop, 1, NULL,
+                              &serialisedUniforms.UBOBindings[i].Binding);
 
-    for(GLint i = 0; i < numUBOs; i++)
-    {
-      GLenum prop = eGL_BUFFER_BINDING;
-      uint32_t bind = 0;
+  for(size_t i = 0; i < serialisedUniforms.SSBOBindings.size(); i++)
+    gl.glGetProgramResourceiv(progSrc, eGL_SHADER_STORAGE_BLOCK, (GLuint)i, 1, &prop, 1, NULL,
+                              &serialisedUniforms.SSBOBindings[i].Binding);
+}
 
-      gl.glGetProgramResourceiv(progSrc, eGL_UNIFORM_BLOCK, i, 1, &prop, 1, NULL, (GLint *)&bind);
+static void FetchProgramUniforms(const GLHookSet &gl, GLuint progSrc,
+                                 ProgramUniforms &serialisedUniforms)
+{
+  FetchProgramUniformLayout(gl, progSrc, serialisedUniforms);
+  FetchProgramUniformValues(gl, progSrc, serialisedUniforms);
+}
 
-      char n[1024] = {0};
-      gl.glGetProgramResourceName(progSrc, eGL_UNIFORM_BLOCK, i, 1023, NULL, n);
+// bit of a hack, to work around C4127: conditional expression is constant
+// on template parameters
+template <typename T>
+T CheckConstParam(T t);
+template <>
+bool CheckConstParam(bool t)
+{
+  return t;
+}
 
-      serialisedUniforms.UBOBindings.push_back(ProgramBinding(n, bind));
-    }
+template <const bool CopyUniforms, const bool SerialiseUniforms, typename SerialiserType>
+static void ForAllProgramUniforms(SerialiserType *ser, CaptureState state, const GLHookSet &gl,
+                                  GLuint progSrc, GLuint progDst, map<GLint, GLint> *locTranslate,
+                                  const ProgramUniforms *cachedUniforms,
+                                  const ProgramUniforms *srcLayout)
+{
+  const bool ReadSourceProgram = CopyUniforms || (SerialiseUniforms && ser && ser->IsWriting());
+  const bool WriteDestProgram = CopyUniforms || (SerialiseUniforms && ser && ser->IsReading());
 
-    // finally, if SSBOs are supported on this implementation, fetch their bindings
-    GLint numSSBOs = 0;
-    if(HasExt[ARB_shader_storage_buffer_object])
-      gl.glGetProgramInterfaceiv(progSrc, eGL_SHADER_STORAGE_BLOCK, eGL_ACTIVE_RESOURCES, &numSSBOs);
+  RDCCOMPILE_ASSERT((CopyUniforms && !SerialiseUniforms) || (!CopyUniforms && SerialiseUniforms),
+                    "Invalid call to ForAllProgramUniforms");
 
-    serialisedUniforms.SSBOBindings.reserve(numSSBOs);
+  // this struct will be serialised with the uniform binding data, or if we're just copying it will
+  // be used to store the data fetched from the source program, before being applied to the
+  // destination program. It's slightly redundant since we could unify the loops (as the code used
+  // to do) but it's much better for code organisation and clarity to have a single path whether
+  // serialising or not.
+  ProgramUniforms serialisedUniforms;
 
-    for(GLint i = 0; i < numSSBOs; i++)
+  // if we're reading the source program, use the cached copy if we have one. Otherwise fetch the
+  // values, iterating over the interfaces first unless we already know the program's layout.
+  if(CheckConstParam(ReadSourceProgram))
+  {
+    if(cachedUniforms)
     {
-      GLenum prop = eGL_BUFFER_BINDING;
-      uint32_t bind = 0;
-
-      gl.glGetProgramResourceiv(progSrc, eGL_SHADER_STORAGE_BLOCK, i, 1, &prop, 1, NULL,
-                                (GLint *)&bind);
-
-      char n[1024] = {0};
-      gl.glGetProgramResourceName(progSrc, eGL_SHADER_STORAGE_BLOCK, i, 1023, NULL, n);
-
-      serialisedUniforms.SSBOBindings.push_back(ProgramBinding(n, bind));
+      serialisedUniforms = *cachedUniforms;
+    }
+    else if(srcLayout)
+    {
+      serialisedUniforms = *srcLayout;
+      FetchProgramUniformValues(gl, progSrc, serialisedUniforms);
+    }
+    else
+    {
+      FetchProgramUniforms(gl, progSrc, serialisedUniforms);
     }
   }
 
@@ -777,27 +785,195 @@ static void ForAllProgramUniforms(SerialiserType *ser, CaptureState state, const
   }
 }
 
-void CopyProgramUniforms(const GLHookSet &gl, GLuint progSrc, GLuint progDst)
+void CopyProgramUniforms(const GLHookSet &gl, GLuint progSrc, GLuint progDst,
+                         const ProgramUniforms *srcLayout)
 {
   const bool CopyUniforms = true;
   const bool SerialiseUniforms = false;
   ForAllProgramUniforms<CopyUniforms, SerialiseUniforms, ReadSerialiser>(
-      NULL, CaptureState::ActiveReplaying, gl, progSrc, progDst, NULL);
+      NULL, CaptureState::ActiveReplaying, gl, progSrc, progDst, NULL, NULL, srcLayout);
 }
 
 template <typename SerialiserType>
 void SerialiseProgramUniforms(SerialiserType &ser, CaptureState state, const GLHookSet &gl,
-                              GLuint prog, map<GLint, GLint> *locTranslate)
+                              GLuint prog, map<GLint, GLint> *locTranslate,
+                              const ProgramUniforms *cachedUniforms)
 {
   const bool CopyUniforms = false;
   const bool SerialiseUniforms = true;
-  ForAllProgramUniforms<CopyUniforms, SerialiseUniforms>(&ser, state, gl, prog, prog, locTranslate);
+  ForAllProgramUniforms<CopyUniforms, SerialiseUniforms>(&ser, state, gl, prog, prog, locTranslate,
+                                                         cachedUniforms, NULL);
 }
 
 template void SerialiseProgramUniforms(ReadSerialiser &ser, CaptureState state, const GLHookSet &gl,
-                                       GLuint prog, map<GLint, GLint> *locTranslate);
+                                       GLuint prog, map<GLint, GLint> *locTranslate,
+                                       const ProgramUniforms *cachedUniforms);
 template void SerialiseProgramUniforms(WriteSerialiser &ser, CaptureState state, const GLHookSet &gl,
-                                       GLuint prog, map<GLint, GLint> *locTranslate);
+                                       GLuint prog, map<GLint, GLint> *locTranslate,
+                                       const ProgramUniforms *cachedUniforms);
+
+void ProgramUniformShadow::Fetch(const GLHookSet &gl, GLuint prog)
+{
+  uniforms = ProgramUniforms();
+  locations.clear();
+
+  FetchProgramUniforms(gl, prog, uniforms);
+
+  for(uint32_t u = 0; u < uniforms.ValueUniforms.size(); u++)
+  {
+    const ProgramUniform &uniform = uniforms.ValueUniforms[u];
+    for(uint32_t arr = 0; arr < uniform.Values.size(); arr++)
+    {
+      if(uniform.Values[arr].Location >= 0)
+        locations[uniform.Values[arr].Location] = {u, arr};
+    }
+  }
+}
+
+template <typename SrcType, typename DstType>
+static void ConvertUniformData(DstType *dst, const SrcType *src, uint32_t cols, uint32_t rows,
+                               bool transpose)
+{
+  for(uint32_t c = 0; c < cols; c++)
+    for(uint32_t r = 0; r < rows; r++)
+      dst[c * rows + r] = DstType(transpose ? src[r * cols + c] : src[c * rows + r]);
+}
+
+void ProgramUniformShadow::Update(GLint location, GLsizei count, const void *value,
+                                  UniformType type, bool transpose)
+{
+  auto it = locations.find(location);
+  if(it == locations.end() || count <= 0)
+    return;
+
+  ProgramUniform &uniform = uniforms.ValueUniforms[it->second.first];
+  uint32_t arr = it->second.second;
+
+  // vectors are treated as single column matrices
+  uint32_t cols = 1, rows = 1;
+  UniformStorage srcStorage = UniformStorage::Float;
+
+  switch(type)
+  {
+    case VEC1fv:
+    case VEC1iv:
+    case VEC1uiv:
+    case VEC1dv: break;
+    case VEC2fv:
+    case VEC2iv:
+    case VEC2uiv:
+    case VEC2dv: rows = 2; break;
+    case VEC3fv:
+    case VEC3iv:
+    case VEC3uiv:
+    case VEC3dv: rows = 3; break;
+    case VEC4fv:
+    case VEC4iv:
+    case VEC4uiv:
+    case VEC4dv: rows = 4; break;
+    case MAT2fv:
+    case MAT2dv: cols = rows = 2; break;
+    case MAT3fv:
+    case MAT3dv: cols = rows = 3; break;
+    case MAT4fv:
+    case MAT4dv: cols = rows = 4; break;
+    case MAT2x3fv:
+    case MAT2x3dv:
+      cols = 2;
+      rows = 3;
+      break;
+    case MAT2x4fv:
+    case MAT2x4dv:
+      cols = 2;
+      rows = 4;
+      break;
+    case MAT3x2fv:
+    case MAT3x2dv:
+      cols = 3;
+      rows = 2;
+      break;
+    case MAT3x4fv:
+    case MAT3x4dv:
+      cols = 3;
+      rows = 4;
+      break;
+    case MAT4x2fv:
+    case MAT4x2dv:
+      cols = 4;
+      rows = 2;
+      break;
+    case MAT4x3fv:
+    case MAT4x3dv:
+      cols = 4;
+      rows = 3;
+      break;
+    default: RDCERR("Unexpected uniform type to shadow: %d", type); return;
+  }
+
+  switch(type)
+  {
+    case VEC1iv:
+    case VEC2iv:
+    case VEC3iv:
+    case VEC4iv: srcStorage = UniformStorage::Int; break;
+    case VEC1uiv:
+    case VEC2uiv:
+    case VEC3uiv:
+    case VEC4uiv: srcStorage = UniformStorage::UInt; break;
+    case VEC1dv:
+    case VEC2dv:
+    case VEC3dv:
+    case VEC4dv:
+    case MAT2dv:
+    case MAT2x3dv:
+    case MAT2x4dv:
+    case MAT3dv:
+    case MAT3x2dv:
+    case MAT3x4dv:
+    case MAT4dv:
+    case MAT4x2dv:
+    case MAT4x3dv: srcStorage = UniformStorage::Double; break;
+    default: break;
+  }
+
+  const uint32_t numComps = cols * rows;
+  const size_t compSize = srcStorage == UniformStorage::Double ? sizeof(double) : sizeof(uint32_t);
+
+  // count updates consecutive array elements starting at the one the location refers to
+  for(GLsizei i = 0; i < count && arr + i < uniform.Values.size(); i++)
+  {
+    ProgramUniformValue &val = uniform.Values[arr + i];
+    const byte *src = (const byte *)value + i * numComps * compSize;
+
+    UniformStorage dstStorage = GetUniformStorage(val.Type);
+
+    // bools can be set from any type, as false if zero and true otherwise. Any other mismatch
+    // between the uniform's type and the function used is an error and doesn't change the value
+    if(dstStorage == UniformStorage::Boolean)
+    {
+      for(uint32_t c = 0; c < numComps; c++)
+      {
+        bool b = false;
+        switch(srcStorage)
+        {
+          case UniformStorage::Float: b = ((const float *)src)[c] != 0.0f; break;
+          case UniformStorage::Double: b = ((const double *)src)[c] != 0.0; break;
+          default: b = ((const uint32_t *)src)[c] != 0; break;
+        }
+        val.data.uval[c] = b ? 1 : 0;
+      }
+    }
+    else if(dstStorage == srcStorage)
+    {
+      if(srcStorage == UniformStorage::Double)
+        ConvertUniformData(val.data.dval, (const double *)src, cols, rows, transpose);
+      else if(srcStorage == UniformStorage::Float)
+        ConvertUniformData(val.data.fval, (const float *)src, cols, rows, transpose);
+      else
+        ConvertUniformData(val.data.uval, (const uint32_t *)src, cols, rows, false);
+    }
+  }
+}
 
 void CopyProgramAttribBindings(const GLHookSet &gl, GLuint progsrc, GLuint progdst,
                                ShaderReflection *refl)
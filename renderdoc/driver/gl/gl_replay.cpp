@@ -83,7 +83,7 @@ ReplayStatus GLReplay::ReadLogInitialisation(RDCFile *rdc, bool storeStructuredB
 void GLReplay::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
 {
   MakeCurrentReplayContext(&m_ReplayCtx);
-  m_pDriver->ReplayLog(0, endEventID, replayType);
+  m_pDriver->ReplayLogIncremental(endEventID, replayType);
 }
 
 const SDFile &GLReplay::GetStructuredFile()
@@ -2694,6 +2694,7 @@ void GLReplay::ReplaceResource(ResourceId from, ResourceId to)
 {
   MakeCurrentReplayContext(&m_ReplayCtx);
   m_pDriver->ReplaceResource(from, to);
+  m_pDriver->InvalidateReplayPosition();
   ClearPostVSCache();
 }
 
@@ -2701,6 +2702,7 @@ void GLReplay::RemoveReplacement(ResourceId id)
 {
   MakeCurrentReplayContext(&m_ReplayCtx);
   m_pDriver->RemoveReplacement(id);
+  m_pDriver->InvalidateReplayPosition();
   ClearPostVSCache();
 }
 
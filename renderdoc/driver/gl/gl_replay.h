@@ -313,13 +313,6 @@ private:
     GLuint customTex;
     ResourceId CustomShaderTexID;
 
-    static const int maxMeshPicks = 500;
-
-    GLuint meshPickProgram;
-    GLuint pickIBBuf, pickVBBuf;
-    uint32_t pickIBSize, pickVBSize;
-    GLuint pickResultBuf;
-
     GLuint MS2Array, Array2MS;
 
     GLuint pointSampler;
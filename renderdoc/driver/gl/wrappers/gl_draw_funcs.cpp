@@ -4111,6 +4111,10 @@ bool WrappedOpenGL::Serialise_glClearTexImage(SerialiserType &ser, GLuint textur
   if(IsReplayingAndReading())
   {
     m_Real.glClearTexImage(texture.name, level, format, type, (const void *)&data[0]);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::Clear));
   }
 
   return true;
@@ -4225,6 +4229,10 @@ bool WrappedOpenGL::Serialise_glClearTexSubImage(SerialiserType &ser, GLuint tex
   {
     m_Real.glClearTexSubImage(texture.name, level, xoffset, yoffset, zoffset, width, height, depth,
                               format, type, (const void *)&data[0]);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::Clear));
   }
 
   return true;
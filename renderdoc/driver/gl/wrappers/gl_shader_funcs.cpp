@@ -600,6 +600,8 @@ bool WrappedOpenGL::Serialise_glCreateShaderProgramv(SerialiserType &ser, GLenum
     progDetails.stageShaders[ShaderIdx(type)] = liveId;
     progDetails.shaderProgramUnlinkable = true;
 
+    FetchProgramUniformLayout(m_Real, real, progDetails.uniformLayout);
+
     auto &shadDetails = m_Shaders[liveId];
 
     shadDetails.type = type;
@@ -647,6 +649,8 @@ GLuint WrappedOpenGL::glCreateShaderProgramv(GLenum type, GLsizei count, const G
     GetResourceManager()->MarkDirtyResource(id);
 
     record->AddChunk(chunk);
+
+    m_ProgramUniformShadows[id].Fetch(m_Real, real);
   }
   else
   {
@@ -767,6 +771,9 @@ bool WrappedOpenGL::Serialise_glLinkProgram(SerialiserType &ser, GLuint programH
 
     m_Real.glLinkProgram(program.name);
 
+    progDetails.uniformLayout = ProgramUniforms();
+    FetchProgramUniformLayout(m_Real, program.name, progDetails.uniformLayout);
+
     AddResourceInitChunk(program);
   }
 
@@ -789,6 +796,16 @@ void WrappedOpenGL::glLinkProgram(GLuint program)
       Serialise_glLinkProgram(ser, program);
 
       record->AddChunk(scope.Get());
+
+      // linking resets all uniforms, so fetch the new layout and default values once here. If the
+      // link failed we drop the shadow and fall back to querying when serialising.
+      GLint status = 0;
+      m_Real.glGetProgramiv(program, eGL_LINK_STATUS, &status);
+
+      if(status)
+        m_ProgramUniformShadows[record->GetResourceID()].Fetch(m_Real, program);
+      else
+        m_ProgramUniformShadows.erase(record->GetResourceID());
     }
   }
   else
@@ -846,6 +863,11 @@ void WrappedOpenGL::glUniformBlockBinding(GLuint program, GLuint uniformBlockInd
       Serialise_glUniformBlockBinding(ser, program, uniformBlockIndex, uniformBlockBinding);
 
       record->AddChunk(scope.Get());
+
+      auto it = m_ProgramUniformShadows.find(record->GetResourceID());
+      if(it != m_ProgramUniformShadows.end() &&
+         uniformBlockIndex < it->second.uniforms.UBOBindings.size())
+        it->second.uniforms.UBOBindings[uniformBlockIndex].Binding = uniformBlockBinding;
     }
   }
 }
@@ -887,6 +909,11 @@ void WrappedOpenGL::glShaderStorageBlockBinding(GLuint program, GLuint storageBl
       Serialise_glShaderStorageBlockBinding(ser, program, storageBlockIndex, storageBlockBinding);
 
       record->AddChunk(scope.Get());
+
+      auto it = m_ProgramUniformShadows.find(record->GetResourceID());
+      if(it != m_ProgramUniformShadows.end() &&
+         storageBlockIndex < it->second.uniforms.SSBOBindings.size())
+        it->second.uniforms.SSBOBindings[storageBlockIndex].Binding = storageBlockBinding;
     }
   }
 }
@@ -1129,6 +1156,7 @@ void WrappedOpenGL::glDeleteProgram(GLuint program)
   GLResource res = ProgramRes(GetCtx(), program);
   if(GetResourceManager()->HasCurrentResource(res))
   {
+    m_ProgramUniformShadows.erase(GetResourceManager()->GetID(res));
     GetResourceManager()->MarkCleanResource(res);
     if(GetResourceManager()->HasResourceRecord(res))
       GetResourceManager()->GetResourceRecord(res)->Delete(GetResourceManager());
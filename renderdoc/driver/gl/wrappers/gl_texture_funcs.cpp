@@ -976,6 +976,10 @@ bool WrappedOpenGL::Serialise_glCopyTextureSubImage1DEXT(SerialiserType &ser, GL
       m_Real.glCopyTextureSubImage1DEXT(texture.name, target, level, xoffset, x, y, width);
     else
       m_Real.glCopyTextureSubImage1D(texture.name, level, xoffset, x, y, width);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -1081,6 +1085,10 @@ bool WrappedOpenGL::Serialise_glCopyTextureSubImage2DEXT(SerialiserType &ser, GL
                                         height);
     else
       m_Real.glCopyTextureSubImage2D(texture.name, level, xoffset, yoffset, x, y, width, height);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -1193,6 +1201,10 @@ bool WrappedOpenGL::Serialise_glCopyTextureSubImage3DEXT(SerialiserType &ser, GL
     else
       m_Real.glCopyTextureSubImage3D(texture.name, level, xoffset, yoffset, zoffset, x, y, width,
                                      height);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -2075,6 +2087,10 @@ bool WrappedOpenGL::Serialise_glTextureImage1DEXT(SerialiserType &ser, GLuint te
     m_Real.glPixelStorei(eGL_UNPACK_ALIGNMENT, align);
 
     AddResourceInitChunk(texture);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -2312,6 +2328,10 @@ bool WrappedOpenGL::Serialise_glTextureImage2DEXT(SerialiserType &ser, GLuint te
     m_Real.glPixelStorei(eGL_UNPACK_ALIGNMENT, align);
 
     AddResourceInitChunk(texture);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -2533,6 +2553,10 @@ bool WrappedOpenGL::Serialise_glTextureImage3DEXT(SerialiserType &ser, GLuint te
     m_Real.glPixelStorei(eGL_UNPACK_ALIGNMENT, align);
 
     AddResourceInitChunk(texture);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -2760,6 +2784,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureImage1DEXT(SerialiserType &ser,
     m_Real.glPixelStorei(eGL_UNPACK_ALIGNMENT, align);
 
     AddResourceInitChunk(texture);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -3107,6 +3135,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureImage2DEXT(SerialiserType &ser,
     m_Real.glPixelStorei(eGL_UNPACK_ALIGNMENT, align);
 
     AddResourceInitChunk(texture);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -3345,6 +3377,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureImage3DEXT(SerialiserType &ser,
     m_Real.glPixelStorei(eGL_UNPACK_ALIGNMENT, align);
 
     AddResourceInitChunk(texture);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -3537,6 +3573,10 @@ bool WrappedOpenGL::Serialise_glCopyTextureImage1DEXT(SerialiserType &ser, GLuin
     m_Real.glCopyTextureImage1DEXT(texture.name, target, level, internalformat, x, y, width, border);
 
     AddResourceInitChunk(texture);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -3693,6 +3733,10 @@ bool WrappedOpenGL::Serialise_glCopyTextureImage2DEXT(SerialiserType &ser, GLuin
                                    border);
 
     AddResourceInitChunk(texture);
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
   return true;
 }
@@ -4686,6 +4730,12 @@ bool WrappedOpenGL::Serialise_glTextureSubImage1DEXT(SerialiserType &ser, GLuint
 
       FreeAlignedBuffer((byte *)pixels);
     }
+
+    // uploads aren't drawcalls, but mid-frame they still need to show up as writes in the usage
+    // so anything keyed on a texture's last write sees the new contents
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -4896,6 +4946,10 @@ bool WrappedOpenGL::Serialise_glTextureSubImage2DEXT(SerialiserType &ser, GLuint
 
       FreeAlignedBuffer((byte *)pixels);
     }
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -5114,6 +5168,10 @@ bool WrappedOpenGL::Serialise_glTextureSubImage3DEXT(SerialiserType &ser, GLuint
 
       FreeAlignedBuffer((byte *)pixels);
     }
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -5315,6 +5373,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage1DEXT(SerialiserType &s
 
       FreeAlignedBuffer((byte *)pixels);
     }
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -5522,6 +5584,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage2DEXT(SerialiserType &s
 
       FreeAlignedBuffer((byte *)pixels);
     }
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
@@ -5736,6 +5802,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage3DEXT(
 
       FreeAlignedBuffer((byte *)pixels);
     }
+
+    if(IsLoading(m_State) && m_CurEventID > 0)
+      m_ResourceUses[GetResourceManager()->GetID(texture)].push_back(
+          EventUsage(m_CurEventID, ResourceUsage::CopyDst));
   }
 
   return true;
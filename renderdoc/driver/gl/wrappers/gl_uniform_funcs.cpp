@@ -331,6 +331,19 @@ bool WrappedOpenGL::Serialise_glProgramUniformMatrix(SerialiserType &ser, GLuint
   return true;
 }
 
+void WrappedOpenGL::ShadowProgramUniform(GLuint program, GLint location, GLsizei count,
+                                         const void *value, UniformType type, bool transpose)
+{
+  if(program == 0 || location < 0)
+    return;
+
+  ResourceId id = GetResourceManager()->GetID(ProgramRes(GetCtx(), program));
+
+  auto it = m_ProgramUniformShadows.find(id);
+  if(it != m_ProgramUniformShadows.end())
+    it->second.Update(location, count, value, type, transpose);
+}
+
 #define UNIFORM_FUNC(count, suffix, paramtype, ...)                                              \
                                                                                                  \
   void WrappedOpenGL::CONCAT(CONCAT(FUNCNAME, count), suffix)(FUNCPARAMS, __VA_ARGS__)           \
@@ -338,11 +351,16 @@ bool WrappedOpenGL::Serialise_glProgramUniformMatrix(SerialiserType &ser, GLuint
   {                                                                                              \
     SERIALISE_TIME_CALL(m_Real.CONCAT(CONCAT(FUNCNAME, count), suffix)(FUNCARGPASS, ARRAYLIST)); \
                                                                                                  \
+    const paramtype vals[] = {ARRAYLIST};                                                        \
+                                                                                                 \
+    if(IsCaptureMode(m_State))                                                                   \
+      ShadowProgramUniform(PROGRAM, location, 1, vals,                                           \
+                           CONCAT(CONCAT(VEC, count), CONCAT(suffix, v)), false);                \
+                                                                                                 \
     if(IsActiveCapturing(m_State))                                                               \
     {                                                                                            \
       USE_SCRATCH_SERIALISER();                                                                  \
       SCOPED_SERIALISE_CHUNK(gl_CurChunk);                                                       \
-      const paramtype vals[] = {ARRAYLIST};                                                      \
       Serialise_glProgramUniformVector(ser, PROGRAM, location, 1, vals,                          \
                                        CONCAT(CONCAT(VEC, count), CONCAT(suffix, v)));           \
       m_ContextRecord->AddChunk(scope.Get());                                                    \
@@ -442,6 +460,10 @@ UNIFORM_FUNC(4, d, GLdouble, GLdouble v0, GLdouble v1, GLdouble v2, GLdouble v3)
     SERIALISE_TIME_CALL(                                                                          \
         m_Real.CONCAT(CONCAT(FUNCNAME, unicount), CONCAT(suffix, v))(FUNCARGPASS, count, value)); \
                                                                                                   \
+    if(IsCaptureMode(m_State))                                                                    \
+      ShadowProgramUniform(PROGRAM, location, count, value,                                       \
+                           CONCAT(CONCAT(VEC, unicount), CONCAT(suffix, v)), false);              \
+                                                                                                  \
     if(IsActiveCapturing(m_State))                                                                \
     {                                                                                             \
       USE_SCRATCH_SERIALISER();                                                                   \
@@ -515,27 +537,31 @@ UNIFORM_FUNC(4, ui, GLuint)
 UNIFORM_FUNC(4, d, GLdouble)
 
 #undef UNIFORM_FUNC
-#define UNIFORM_FUNC(dim, suffix, paramtype)                                                 \
-                                                                                             \
-  void WrappedOpenGL::CONCAT(CONCAT(FUNCNAME, dim), suffix)(                                 \
-      FUNCPARAMS, GLsizei count, GLboolean transpose, const paramtype *value)                \
-                                                                                             \
-  {                                                                                          \
-    SERIALISE_TIME_CALL(                                                                     \
-        m_Real.CONCAT(CONCAT(FUNCNAME, dim), suffix)(FUNCARGPASS, count, transpose, value)); \
-                                                                                             \
-    if(IsActiveCapturing(m_State))                                                           \
-    {                                                                                        \
-      USE_SCRATCH_SERIALISER();                                                              \
-      SCOPED_SERIALISE_CHUNK(gl_CurChunk);                                                   \
-      Serialise_glProgramUniformMatrix(ser, PROGRAM, location, count, transpose, value,      \
-                                       CONCAT(CONCAT(MAT, dim), suffix));                    \
-      m_ContextRecord->AddChunk(scope.Get());                                                \
-    }                                                                                        \
-    else if(IsBackgroundCapturing(m_State))                                                  \
-    {                                                                                        \
-      GetResourceManager()->MarkDirtyResource(ProgramRes(GetCtx(), PROGRAM));                \
-    }                                                                                        \
+#define UNIFORM_FUNC(dim, suffix, paramtype)                                                  \
+                                                                                              \
+  void WrappedOpenGL::CONCAT(CONCAT(FUNCNAME, dim), suffix)(                                  \
+      FUNCPARAMS, GLsizei count, GLboolean transpose, const paramtype *value)                 \
+                                                                                              \
+  {                                                                                           \
+    SERIALISE_TIME_CALL(                                                                      \
+        m_Real.CONCAT(CONCAT(FUNCNAME, dim), suffix)(FUNCARGPASS, count, transpose, value));  \
+                                                                                              \
+    if(IsCaptureMode(m_State))                                                                \
+      ShadowProgramUniform(PROGRAM, location, count, value, CONCAT(CONCAT(MAT, dim), suffix), \
+                           transpose != GL_FALSE);                                            \
+                                                                                              \
+    if(IsActiveCapturing(m_State))                                                            \
+    {                                                                                         \
+      USE_SCRATCH_SERIALISER();                                                               \
+      SCOPED_SERIALISE_CHUNK(gl_CurChunk);                                                    \
+      Serialise_glProgramUniformMatrix(ser, PROGRAM, location, count, transpose, value,       \
+                                       CONCAT(CONCAT(MAT, dim), suffix));                     \
+      m_ContextRecord->AddChunk(scope.Get());                                                 \
+    }                                                                                         \
+    else if(IsBackgroundCapturing(m_State))                                                   \
+    {                                                                                         \
+      GetResourceManager()->MarkDirtyResource(ProgramRes(GetCtx(), PROGRAM));                 \
+    }                                                                                         \
   }
 
 #undef FUNCNAME
@@ -43,8 +43,47 @@ void InitSPIRVCompiler()
 
 void ShutdownSPIRVCompiler()
 {
+  SaveSPIRVReflectionCache();
+
   if(inited)
   {
     glslang::FinalizeProcess();
   }
 }
+
+void SPVArena::Clear()
+{
+  // destroy in reverse order of construction
+  for(auto it = m_Destructors.rbegin(); it != m_Destructors.rend(); ++it)
+    it->second(it->first);
+  m_Destructors.clear();
+
+  for(byte *block : m_Blocks)
+    delete[] block;
+  m_Blocks.clear();
+
+  m_Cur = NULL;
+  m_Remaining = 0;
+  m_AllocatedBytes = 0;
+}
+
+void *SPVArena::Alloc(size_t size, size_t align)
+{
+  size_t padding = (align - (size_t(m_Cur) & (align - 1))) & (align - 1);
+
+  if(m_Cur == NULL || padding + size > m_Remaining)
+  {
+    // new[] returns memory aligned for any fundamental type, which is all we allocate
+    size_t blockSize = size > BlockSize ? size : BlockSize;
+    m_Cur = new byte[blockSize];
+    m_Remaining = blockSize;
+    m_AllocatedBytes += blockSize;
+    m_Blocks.push_back(m_Cur);
+    padding = 0;
+  }
+
+  byte *ret = m_Cur + padding;
+  m_Cur += padding + size;
+  m_Remaining -= padding + size;
+  return ret;
+}
@@ -24,11 +24,14 @@
 
 #pragma once
 
+#include <new>
 #include <stdint.h>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "3rdparty/glslang/SPIRV/spirv.hpp"
+#include "common/threading.h"
 
 using std::string;
 using std::vector;
@@ -65,6 +68,10 @@ struct SPIRVCompilationSettings
 void InitSPIRVCompiler();
 void ShutdownSPIRVCompiler();
 
+// writes out any reflection results from SPVModule::MakeReflection that were added to the on-disk
+// cache during this run. Called from ShutdownSPIRVCompiler.
+void SaveSPIRVReflectionCache();
+
 struct SPVInstruction;
 
 enum class ShaderStage : uint32_t;
@@ -96,6 +103,48 @@ struct SPIRVPatchData
   std::vector<InterfaceAccess> outputs;
 };
 
+// bump allocator for a module's parsed instructions and everything hanging off them. Parsing
+// creates several small objects per instruction, so packing them into large blocks saves the
+// per-allocation overhead and keeps related objects next to each other. Nothing is freed until the
+// whole arena is. Copying gives an empty arena, like the rest of a module's parsed state.
+//
+// This only changes where the existing instruction graph lives, it is not a flat IR: instructions
+// still hold vectors and strings, so each one also records a destructor to run on Clear().
+class SPVArena
+{
+public:
+  SPVArena() = default;
+  SPVArena(const SPVArena &) {}
+  SPVArena &operator=(const SPVArena &)
+  {
+    Clear();
+    return *this;
+  }
+  ~SPVArena() { Clear(); }
+  template <typename T>
+  T *New()
+  {
+    T *ret = new(Alloc(sizeof(T), alignof(T))) T();
+    if(!std::is_trivially_destructible<T>::value)
+      m_Destructors.push_back({ret, [](void *obj) { ((T *)obj)->~T(); }});
+    return ret;
+  }
+
+  void Clear();
+  uint64_t GetAllocatedBytes() const { return m_AllocatedBytes; }
+private:
+  void *Alloc(size_t size, size_t align);
+
+  static const size_t BlockSize = 64 * 1024;
+
+  std::vector<byte *> m_Blocks;
+  byte *m_Cur = NULL;
+  size_t m_Remaining = 0;
+  uint64_t m_AllocatedBytes = 0;
+
+  std::vector<std::pair<void *, void (*)(void *)>> m_Destructors;
+};
+
 struct SPVModule
 {
   SPVModule();
@@ -130,14 +179,41 @@ struct SPVModule
   vector<SPVInstruction *> funcs;            // functions
   vector<SPVInstruction *> structs;          // struct types
 
+  // owns every instruction in operations, and their payloads
+  SPVArena arena;
+
   SPVInstruction *GetByID(uint32_t id);
   string Disassemble(const string &entryPoint);
 
   std::vector<std::string> EntryPoints() const;
   ShaderStage StageForEntry(const string &entryPoint) const;
 
+  // reflection results are cached by a hash of the module, entry point and stage, including on
+  // disk, so the module is only parsed if this entry point has never been reflected before.
   void MakeReflection(ShaderStage stage, const string &entryPoint, ShaderReflection &reflection,
                       ShaderBindpointMapping &mapping, SPIRVPatchData &patchData) const;
+  // always parses and reflects, without looking in or adding to the cache
+  void MakeReflectionUncached(ShaderStage stage, const string &entryPoint,
+                              ShaderReflection &reflection, ShaderBindpointMapping &mapping,
+                              SPIRVPatchData &patchData) const;
+
+private:
+  // ParseSPIRV only validates the header and keeps the words, the instructions are parsed on first
+  // use so that modules which are never inspected cost nothing more than a copy.
+  void Parse() const;
+
+  // parsing a large module takes long enough that waiters shouldn't spin. Copying a module gives
+  // the copy its own unlocked lock, like Threading::SpinLock does
+  struct ParseLock
+  {
+    ParseLock() {}
+    ParseLock(const ParseLock &) {}
+    ParseLock &operator=(const ParseLock &) { return *this; }
+    Threading::CriticalSection lock;
+  };
+
+  mutable ParseLock parseLock;
+  mutable bool parsed = false;
 };
 
 string CompileSPIRV(const SPIRVCompilationSettings &settings, const vector<string> &sources,
@@ -25,11 +25,16 @@
 #include <algorithm>
 #include <utility>
 #include "api/replay/renderdoc_replay.h"
+#include "api/replay/version.h"
 #include "common/common.h"
+#include "common/shader_cache.h"
 #include "maths/formatpacking.h"
 #include "serialise/serialiser.h"
 #include "spirv_common.h"
 
+#define XXH_STATIC_LINKING_ONLY
+#include "3rdparty/zstd/xxhash.h"
+
 using std::pair;
 using std::make_pair;
 
@@ -876,19 +881,6 @@ struct SPVInstruction
     source.col = source.line = 0;
   }
 
-  ~SPVInstruction()
-  {
-    SAFE_DELETE(ext);
-    SAFE_DELETE(entry);
-    SAFE_DELETE(op);
-    SAFE_DELETE(flow);
-    SAFE_DELETE(type);
-    SAFE_DELETE(func);
-    SAFE_DELETE(block);
-    SAFE_DELETE(constant);
-    SAFE_DELETE(var);
-  }
-
   spv::Op opcode;
   uint32_t id;
 
@@ -2001,7 +1993,7 @@ struct SPVInstruction
 
   vector<SPVDecoration> decorations;
 
-  // zero or one of these pointers might be set
+  // zero or one of these pointers might be set, all are allocated from the module's arena
   SPVExtInstSet *ext;       // this ID is an extended instruction set
   SPVEntryPoint *entry;     // this ID is an entry point
   SPVOperation *op;         // this ID is the result of an operation
@@ -2112,9 +2104,6 @@ SPVModule::SPVModule()
 
 SPVModule::~SPVModule()
 {
-  for(size_t i = 0; i < operations.size(); i++)
-    delete operations[i];
-  operations.clear();
 }
 
 SPVInstruction *SPVModule::GetByID(uint32_t id)
@@ -2126,7 +2115,7 @@ SPVInstruction *SPVModule::GetByID(uint32_t id)
   // an ID, it won't be in our list so we have to add a dummy instruction for it
   RDCWARN("Expected to find ID %u but didn't - returning dummy instruction", id);
 
-  operations.push_back(new SPVInstruction());
+  operations.push_back(arena.New<SPVInstruction>());
   SPVInstruction &op = *operations.back();
   op.opcode = spv::OpUnknown;
   op.id = id;
@@ -2162,6 +2151,8 @@ void FindFirstInstructionUse(SPVInstruction *op, SPVInstruction *search, SPVInst
 
 string SPVModule::Disassemble(const string &entryPoint)
 {
+  Parse();
+
   string retDisasm = "";
 
   // TODO filter to only functions/resources used by entryPoint
@@ -3902,24 +3893,53 @@ void AddSignatureParameter(bool isInput, ShaderStage stage, uint32_t id, uint32_
   }
 }
 
+// entry points are declared in the module's preamble, before any types or functions, so they can
+// be read straight from the words without parsing the module.
+static std::vector<std::pair<spv::ExecutionModel, std::string>> FindEntryPoints(
+    const vector<uint32_t> &spirv)
+{
+  std::vector<std::pair<spv::ExecutionModel, std::string>> ret;
+
+  size_t it = 5;
+  while(it < spirv.size())
+  {
+    uint16_t WordCount = spirv[it] >> spv::WordCountShift;
+    spv::Op opcode = spv::Op(spirv[it] & spv::OpCodeMask);
+
+    if(WordCount == 0 || it + WordCount > spirv.size() || opcode == spv::OpTypeVoid ||
+       opcode == spv::OpFunction)
+      break;
+
+    if(opcode == spv::OpEntryPoint && WordCount > 3)
+    {
+      const char *name = (const char *)&spirv[it + 3];
+      size_t len = strnlen(name, (WordCount - 3) * sizeof(uint32_t));
+      ret.push_back(make_pair(spv::ExecutionModel(spirv[it + 1]), std::string(name, len)));
+    }
+
+    it += WordCount;
+  }
+
+  return ret;
+}
+
 std::vector<std::string> SPVModule::EntryPoints() const
 {
   std::vector<std::string> ret;
 
-  for(SPVInstruction *inst : entries)
-    if(inst->entry)
-      ret.push_back(inst->entry->name);
+  for(const std::pair<spv::ExecutionModel, std::string> &e : FindEntryPoints(spirv))
+    ret.push_back(e.second);
 
   return ret;
 }
 
 ShaderStage SPVModule::StageForEntry(const string &entryPoint) const
 {
-  for(SPVInstruction *inst : entries)
+  for(const std::pair<spv::ExecutionModel, std::string> &e : FindEntryPoints(spirv))
   {
-    if(inst->entry && inst->entry->name == entryPoint)
+    if(e.second == entryPoint)
     {
-      switch(inst->entry->model)
+      switch(e.first)
       {
         case spv::ExecutionModelVertex: return ShaderStage::Vertex;
         case spv::ExecutionModelTessellationControl: return ShaderStage::Tess_Control;
@@ -3936,15 +3956,238 @@ ShaderStage SPVModule::StageForEntry(const string &entryPoint) const
   return ShaderStage::Count;
 }
 
+// which operations use each ID as an argument, stored as flat arrays indexed by ID. Reflection
+// checks whether each global is used, and scanning every operation's arguments for each global was
+// quadratic in the size of the module.
+struct SPVUseIndex
+{
+  void Build(const vector<SPVInstruction *> &operations, size_t idBound)
+  {
+    offsets.assign(idBound + 1, 0);
+
+    // count the uses of each ID, then turn the counts into offsets and fill in the users
+    for(const SPVInstruction *inst : operations)
+      if(inst->op)
+        for(const SPVInstruction *arg : inst->op->arguments)
+          if(arg && arg->id != 0 && arg->id < idBound)
+            offsets[arg->id + 1]++;
+
+    for(size_t i = 1; i <= idBound; i++)
+      offsets[i] += offsets[i - 1];
+
+    users.resize(offsets[idBound]);
+
+    vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+
+    for(size_t o = 0; o < operations.size(); o++)
+      if(operations[o]->op)
+        for(const SPVInstruction *arg : operations[o]->op->arguments)
+          if(arg && arg->id != 0 && arg->id < idBound)
+            users[next[arg->id]++] = (uint32_t)o;
+  }
+
+  bool IsUsed(uint32_t id) const
+  {
+    return id + 1 < offsets.size() && offsets[id + 1] > offsets[id];
+  }
+  // indices into the module's operations, in order. An operation using the ID more than once is
+  // listed more than once.
+  const uint32_t *UsersBegin(uint32_t id) const
+  {
+    return id + 1 < offsets.size() ? users.data() + offsets[id] : users.data();
+  }
+  const uint32_t *UsersEnd(uint32_t id) const
+  {
+    return id + 1 < offsets.size() ? users.data() + offsets[id + 1] : users.data();
+  }
+
+  vector<uint32_t> offsets;
+  vector<uint32_t> users;
+};
+
+DECLARE_REFLECTION_STRUCT(SPIRVPatchData::InterfaceAccess);
+DECLARE_REFLECTION_STRUCT(SPIRVPatchData);
+
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, SPIRVPatchData::InterfaceAccess &el)
+{
+  SERIALISE_MEMBER(ID);
+  SERIALISE_MEMBER(accessChain);
+  SERIALISE_MEMBER(isMatrix);
+}
+
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, SPIRVPatchData &el)
+{
+  SERIALISE_MEMBER(inputs);
+  SERIALISE_MEMBER(outputs);
+}
+
+// cache of serialised MakeReflection results, persisted in the same format as the drivers' built-in
+// shader caches. The map is keyed by the low 32 bits of the hash, the full hash is stored at the
+// start of each blob so that a collision is treated as a miss.
+// The build's git hash is part of every entry's hash, so a build with different reflection code
+// never uses another build's results. The version only needs bumping if the file format changes,
+// or for builds without a git hash.
+static const uint32_t SPIRVReflectionCacheMagic = 0xf00d5e1f;
+static const uint32_t SPIRVReflectionCacheVersion = 2;
+static const char SPIRVReflectionCacheFilename[] = "spirvreflection.cache";
+
+// don't let the on-disk cache grow without bound, it's cheap to rebuild
+static const size_t MaxSPIRVReflectionCacheEntries = 64 * 1024;
+
+typedef std::vector<byte> *SPIRVReflectionBlob;
+
+static struct SPIRVReflectionCacheCallbacks
+{
+  bool Create(uint32_t size, byte *data, SPIRVReflectionBlob *ret) const
+  {
+    RDCASSERT(ret);
+
+    *ret = new std::vector<byte>(data, data + size);
+
+    return true;
+  }
+
+  void Destroy(SPIRVReflectionBlob blob) const { delete blob; }
+  uint32_t GetSize(SPIRVReflectionBlob blob) const { return (uint32_t)blob->size(); }
+  const byte *GetData(SPIRVReflectionBlob blob) const { return blob->data(); }
+} SPIRVReflectionCacheCallbacks;
+
+static Threading::CriticalSection reflectionCacheLock;
+static std::map<uint32_t, SPIRVReflectionBlob> reflectionCache;
+static bool reflectionCacheLoaded = false, reflectionCacheDirty = false;
+
+static bool FetchCachedReflection(uint64_t hash, ShaderReflection &reflection,
+                                  ShaderBindpointMapping &mapping, SPIRVPatchData &patchData)
+{
+  SCOPED_LOCK(reflectionCacheLock);
+
+  if(!reflectionCacheLoaded)
+  {
+    reflectionCacheLoaded = true;
+
+    LoadShaderCache(SPIRVReflectionCacheFilename, SPIRVReflectionCacheMagic,
+                    SPIRVReflectionCacheVersion, reflectionCache, SPIRVReflectionCacheCallbacks);
+  }
+
+  auto it = reflectionCache.find(uint32_t(hash & 0xffffffff));
+
+  if(it == reflectionCache.end() || it->second->size() < sizeof(uint64_t) ||
+     memcmp(it->second->data(), &hash, sizeof(uint64_t)) != 0)
+    return false;
+
+  ReadSerialiser ser(new StreamReader(it->second->data() + sizeof(uint64_t),
+                                      it->second->size() - sizeof(uint64_t)),
+                     Ownership::Stream);
+
+  ser.ReadChunk<uint32_t>();
+  SERIALISE_ELEMENT(reflection);
+  SERIALISE_ELEMENT(mapping);
+  SERIALISE_ELEMENT(patchData);
+  ser.EndChunk();
+
+  if(ser.IsErrored())
+  {
+    RDCWARN("Corrupt cached SPIR-V reflection, regenerating");
+    reflection = ShaderReflection();
+    mapping = ShaderBindpointMapping();
+    patchData = SPIRVPatchData();
+    return false;
+  }
+
+  return true;
+}
+
+static void CacheReflection(uint64_t hash, ShaderReflection &reflection,
+                            ShaderBindpointMapping &mapping, SPIRVPatchData &patchData)
+{
+  WriteSerialiser ser(new StreamWriter(4 * 1024), Ownership::Stream);
+
+  {
+    SCOPED_SERIALISE_CHUNK(1U);
+    SERIALISE_ELEMENT(reflection);
+    SERIALISE_ELEMENT(mapping);
+    SERIALISE_ELEMENT(patchData);
+  }
+
+  StreamWriter *writer = ser.GetWriter();
+
+  SPIRVReflectionBlob blob = new std::vector<byte>(sizeof(uint64_t) + writer->GetOffset());
+  memcpy(blob->data(), &hash, sizeof(uint64_t));
+  memcpy(blob->data() + sizeof(uint64_t), writer->GetData(), (size_t)writer->GetOffset());
+
+  SCOPED_LOCK(reflectionCacheLock);
+
+  if(reflectionCache.size() >= MaxSPIRVReflectionCacheEntries)
+  {
+    for(auto it = reflectionCache.begin(); it != reflectionCache.end(); ++it)
+      SPIRVReflectionCacheCallbacks.Destroy(it->second);
+    reflectionCache.clear();
+  }
+
+  SPIRVReflectionBlob &entry = reflectionCache[uint32_t(hash & 0xffffffff)];
+  SAFE_DELETE(entry);
+  entry = blob;
+
+  reflectionCacheDirty = true;
+}
+
+void SaveSPIRVReflectionCache()
+{
+  SCOPED_LOCK(reflectionCacheLock);
+
+  // SaveShaderCache destroys the entries as it writes them
+  if(reflectionCacheDirty)
+  {
+    SaveShaderCache(SPIRVReflectionCacheFilename, SPIRVReflectionCacheMagic,
+                    SPIRVReflectionCacheVersion, reflectionCache, SPIRVReflectionCacheCallbacks);
+  }
+  else
+  {
+    for(auto it = reflectionCache.begin(); it != reflectionCache.end(); ++it)
+      SPIRVReflectionCacheCallbacks.Destroy(it->second);
+  }
+
+  reflectionCache.clear();
+  reflectionCacheLoaded = reflectionCacheDirty = false;
+}
+
 void SPVModule::MakeReflection(ShaderStage stage, const string &entryPoint,
                                ShaderReflection &reflection, ShaderBindpointMapping &mapping,
                                SPIRVPatchData &patchData) const
 {
+  XXH64_state_t state;
+  XXH64_reset(&state, 0);
+  XXH64_update(&state, spirv.data(), spirv.size() * sizeof(uint32_t));
+  XXH64_update(&state, entryPoint.c_str(), entryPoint.size());
+  XXH64_update(&state, &stage, sizeof(stage));
+  XXH64_update(&state, GitVersionHash, sizeof(GitVersionHash));
+  uint64_t hash = XXH64_digest(&state);
+
+  if(FetchCachedReflection(hash, reflection, mapping, patchData))
+    return;
+
+  MakeReflectionUncached(stage, entryPoint, reflection, mapping, patchData);
+
+  CacheReflection(hash, reflection, mapping, patchData);
+}
+
+void SPVModule::MakeReflectionUncached(ShaderStage stage, const string &entryPoint,
+                                       ShaderReflection &reflection,
+                                       ShaderBindpointMapping &mapping,
+                                       SPIRVPatchData &patchData) const
+{
+  Parse();
+
   vector<SigParameter> inputs;
   vector<SigParameter> outputs;
   vector<cblockpair> cblocks;
   vector<shaderrespair> samplers, roresources, rwresources;
 
+  SPVUseIndex uses;
+  uses.Build(operations, ids.size());
+
   // VKTODOLOW filter to only functions/resources used by entryPoint
   reflection.entryPoint = entryPoint;
   reflection.stage = stage;
@@ -4012,26 +4255,8 @@ void SPVModule::MakeReflection(ShaderStage stage, const string &entryPoint,
 
         if(globalCheck)
         {
-          bool eliminate = true;
-
-          for(size_t o = 0; o < operations.size(); o++)
-          {
-            if(operations[o]->op)
-            {
-              for(size_t a = 0; a < operations[o]->op->arguments.size(); a++)
-              {
-                if(operations[o]->op->arguments[a] == inst)
-                {
-                  // we were just looking for any use of this variable
-                  eliminate = false;
-                  break;
-                }
-              }
-            }
-
-            if(!eliminate)
-              break;
-          }
+          // we were just looking for any use of this variable
+          bool eliminate = !uses.IsUsed(inst->id);
 
           if(eliminate)
           {
@@ -4080,23 +4305,24 @@ void SPVModule::MakeReflection(ShaderStage stage, const string &entryPoint,
             {
               bool eliminate = true;
 
-              for(size_t o = 0; o < operations.size(); o++)
+              for(const uint32_t *u = uses.UsersBegin(inst->id); u != uses.UsersEnd(inst->id); u++)
               {
+                SPVInstruction *user = operations[*u];
+
                 // we're only interested in OpAccessChain, which must be used to fetch the
                 // child for use. If we find one with the right index, then we're done
-                if(operations[o]->op && (operations[o]->opcode == spv::OpAccessChain ||
-                                         operations[o]->opcode == spv::OpInBoundsAccessChain))
+                if(user->opcode == spv::OpAccessChain || user->opcode == spv::OpInBoundsAccessChain)
                 {
-                  for(size_t a = 0; a < operations[o]->op->arguments.size() - 1; a++)
+                  for(size_t a = 0; a < user->op->arguments.size() - 1; a++)
                   {
-                    if(operations[o]->op->arguments[a] == inst)
+                    if(user->op->arguments[a] == inst)
                     {
                       // check the next argument to see if it's a constant with the
                       // right value
 
                       // found a use!
-                      if(operations[o]->op->arguments[a + 1]->constant &&
-                         operations[o]->op->arguments[a + 1]->constant->u32 == (uint32_t)c)
+                      if(user->op->arguments[a + 1]->constant &&
+                         user->op->arguments[a + 1]->constant->u32 == (uint32_t)c)
                       {
                         eliminate = false;
                       }
@@ -4216,25 +4442,10 @@ void SPVModule::MakeReflection(ShaderStage stage, const string &entryPoint,
             cblock.byteSize = 0;
         }
 
-        bindmap.used = false;
+        bindmap.used = uses.IsUsed(inst->id);
 
         bindmap.arraySize = arraySize;
 
-        for(size_t o = 0; o < operations.size(); o++)
-        {
-          if(operations[o]->op)
-          {
-            for(size_t a = 0; a < operations[o]->op->arguments.size(); a++)
-            {
-              if(operations[o]->op->arguments[a] == inst)
-              {
-                bindmap.used = true;
-                break;
-              }
-            }
-          }
-        }
-
         // should never have elements that have no binding declared but
         // are used, unless it's push constants (which is handled elsewhere)
         RDCASSERT(!bindmap.used || !cblock.bufferBacked || bindmap.bind >= 0);
@@ -4338,25 +4549,10 @@ void SPVModule::MakeReflection(ShaderStage stage, const string &entryPoint,
             bindmap.bind = (int32_t)inst->decorations[d].val;
         }
 
-        bindmap.used = false;
+        bindmap.used = uses.IsUsed(inst->id);
 
         bindmap.arraySize = arraySize;
 
-        for(size_t o = 0; o < operations.size(); o++)
-        {
-          if(operations[o]->op)
-          {
-            for(size_t a = 0; a < operations[o]->op->arguments.size(); a++)
-            {
-              if(operations[o]->op->arguments[a] == inst)
-              {
-                bindmap.used = true;
-                break;
-              }
-            }
-          }
-        }
-
         // should never have elements that have no binding declared but
         // are used
         RDCASSERT(!bindmap.used || bindmap.bind >= 0);
@@ -4631,6 +4827,12 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
   module.spirv.assign(spirv, spirv + spirvLength);
 
   module.generator = spirv[2];
+}
+
+static void ParseSPIRVInstructions(SPVModule &module)
+{
+  const uint32_t *spirv = module.spirv.data();
+  const size_t spirvLength = module.spirv.size();
 
   uint32_t idbound = spirv[3];
   module.ids.resize(idbound);
@@ -4645,7 +4847,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
   {
     uint16_t WordCount = spirv[it] >> spv::WordCountShift;
 
-    module.operations.push_back(new SPVInstruction());
+    module.operations.push_back(module.arena.New<SPVInstruction>());
     SPVInstruction &op = *module.operations.back();
 
     op.opcode = spv::Op(spirv[it] & spv::OpCodeMask);
@@ -4724,7 +4926,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpEntryPoint:
       {
-        op.entry = new SPVEntryPoint();
+        op.entry = module.arena.New<SPVEntryPoint>();
         op.entry->func = spirv[it + 2];
         op.entry->model = spv::ExecutionModel(spirv[it + 1]);
         op.entry->name = (const char *)&spirv[it + 3];
@@ -4758,7 +4960,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpExtInstImport:
       {
-        op.ext = new SPVExtInstSet();
+        op.ext = module.arena.New<SPVExtInstSet>();
         op.ext->setname = (const char *)&spirv[it + 2];
         op.ext->canonicalNames = NULL;
 
@@ -4784,7 +4986,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       // Type opcodes
       case spv::OpTypeVoid:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eVoid;
 
         op.id = spirv[it + 1];
@@ -4793,7 +4995,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeBool:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eBool;
 
         op.id = spirv[it + 1];
@@ -4802,7 +5004,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeInt:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = spirv[it + 3] ? SPVTypeData::eSInt : SPVTypeData::eUInt;
         op.type->bitCount = spirv[it + 2];
 
@@ -4812,7 +5014,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeFloat:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eFloat;
         op.type->bitCount = spirv[it + 2];
 
@@ -4822,7 +5024,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeVector:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eVector;
 
         SPVInstruction *baseTypeInst = module.GetByID(spirv[it + 2]);
@@ -4837,7 +5039,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeMatrix:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eMatrix;
 
         SPVInstruction *baseTypeInst = module.GetByID(spirv[it + 2]);
@@ -4855,7 +5057,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeArray:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eArray;
 
         SPVInstruction *baseTypeInst = module.GetByID(spirv[it + 2]);
@@ -4874,7 +5076,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeRuntimeArray:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eArray;
 
         SPVInstruction *baseTypeInst = module.GetByID(spirv[it + 2]);
@@ -4889,7 +5091,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeStruct:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eStruct;
 
         for(int i = 2; i < WordCount; i++)
@@ -4910,7 +5112,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypePointer:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::ePointer;
 
         SPVInstruction *baseTypeInst = module.GetByID(spirv[it + 3]);
@@ -4925,7 +5127,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeImage:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eImage;
 
         SPVInstruction *baseTypeInst = module.GetByID(spirv[it + 2]);
@@ -4948,7 +5150,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeSampler:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eSampler;
 
         op.id = spirv[it + 1];
@@ -4957,7 +5159,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeSampledImage:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eSampledImage;
 
         SPVInstruction *baseTypeInst = module.GetByID(spirv[it + 2]);
@@ -4971,7 +5173,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpTypeFunction:
       {
-        op.type = new SPVTypeData();
+        op.type = module.arena.New<SPVTypeData>();
         op.type->type = SPVTypeData::eFunction;
 
         for(int i = 3; i < WordCount; i++)
@@ -5004,7 +5206,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.constant = new SPVConstant();
+        op.constant = module.arena.New<SPVConstant>();
         op.constant->specialized =
             (op.opcode == spv::OpSpecConstantTrue || op.opcode == spv::OpSpecConstantFalse);
         op.constant->type = typeInst->type;
@@ -5021,7 +5223,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.constant = new SPVConstant();
+        op.constant = module.arena.New<SPVConstant>();
         op.constant->type = typeInst->type;
 
         op.constant->u32 = 0;
@@ -5036,7 +5238,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.constant = new SPVConstant();
+        op.constant = module.arena.New<SPVConstant>();
         op.constant->specialized = op.opcode == spv::OpSpecConstant;
         op.constant->type = typeInst->type;
 
@@ -5063,7 +5265,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.constant = new SPVConstant();
+        op.constant = module.arena.New<SPVConstant>();
         op.constant->specialized = op.opcode == spv::OpSpecConstantComposite;
         op.constant->type = typeInst->type;
 
@@ -5085,7 +5287,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.constant = new SPVConstant();
+        op.constant = module.arena.New<SPVConstant>();
         op.constant->type = typeInst->type;
 
         op.constant->sampler.addressing = spv::SamplerAddressingMode(spirv[it + 3]);
@@ -5102,7 +5304,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.constant = new SPVConstant();
+        op.constant = module.arena.New<SPVConstant>();
         op.constant->specialized = true;
         op.constant->type = typeInst->type;
 
@@ -5131,7 +5333,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 4]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.func = new SPVFunction();
+        op.func = module.arena.New<SPVFunction>();
         op.func->retType = retTypeInst->type;
         op.func->funcType = typeInst->type;
         op.func->control = spv::FunctionControlMask(spirv[it + 3]);
@@ -5168,7 +5370,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.var = new SPVVariable();
+        op.var = module.arena.New<SPVVariable>();
         op.var->type = typeInst->type;
         op.var->storage = spv::StorageClass(spirv[it + 3]);
 
@@ -5193,7 +5395,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.var = new SPVVariable();
+        op.var = module.arena.New<SPVVariable>();
         op.var->type = typeInst->type;
         op.var->storage = spv::StorageClassFunction;
 
@@ -5208,7 +5410,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       // Branching/flow control
       case spv::OpLabel:
       {
-        op.block = new SPVBlock();
+        op.block = module.arena.New<SPVBlock>();
 
         RDCASSERT(curFunc);
 
@@ -5223,7 +5425,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       case spv::OpUnreachable:
       case spv::OpReturn:
       {
-        op.flow = new SPVFlowControl();
+        op.flow = module.arena.New<SPVFlowControl>();
 
         curBlock->exitFlow = &op;
         curBlock = NULL;
@@ -5231,7 +5433,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpReturnValue:
       {
-        op.flow = new SPVFlowControl();
+        op.flow = module.arena.New<SPVFlowControl>();
 
         op.flow->targets.push_back(spirv[it + 1]);
 
@@ -5241,7 +5443,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpBranch:
       {
-        op.flow = new SPVFlowControl();
+        op.flow = module.arena.New<SPVFlowControl>();
 
         op.flow->targets.push_back(spirv[it + 1]);
 
@@ -5251,7 +5453,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpBranchConditional:
       {
-        op.flow = new SPVFlowControl();
+        op.flow = module.arena.New<SPVFlowControl>();
 
         SPVInstruction *condInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(condInst);
@@ -5272,7 +5474,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpSwitch:
       {
-        op.flow = new SPVFlowControl();
+        op.flow = module.arena.New<SPVFlowControl>();
 
         SPVInstruction *condInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(condInst);
@@ -5299,7 +5501,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpSelectionMerge:
       {
-        op.flow = new SPVFlowControl();
+        op.flow = module.arena.New<SPVFlowControl>();
 
         op.flow->targets.push_back(spirv[it + 1]);
         op.flow->selControl = spv::SelectionControlMask(spirv[it + 2]);
@@ -5309,7 +5511,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       }
       case spv::OpLoopMerge:
       {
-        op.flow = new SPVFlowControl();
+        op.flow = module.arena.New<SPVFlowControl>();
 
         op.flow->targets.push_back(spirv[it + 1]);
         op.flow->loopControl = spv::LoopControlMask(spirv[it + 2]);
@@ -5324,7 +5526,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = typeInst->type;
 
         SPVInstruction *ptrInst = module.GetByID(spirv[it + 3]);
@@ -5345,7 +5547,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       case spv::OpStore:
       case spv::OpCopyMemory:
       {
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = NULL;
 
         SPVInstruction *ptrInst = module.GetByID(spirv[it + 1]);
@@ -5369,7 +5571,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = typeInst->type;
 
         for(int i = 3; i < WordCount; i += 2)
@@ -5398,7 +5600,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = typeInst->type;
 
         SPVInstruction *imageInst = module.GetByID(spirv[it + 3]);
@@ -5505,7 +5707,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
           default: break;
         }
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
 
         if(op.opcode != spv::OpImageWrite)
         {
@@ -5750,7 +5952,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
 
         word++;
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = typeInst->type;
         op.op->mathop = mathop;
 
@@ -5789,7 +5991,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       {
         // these don't emit an ID, don't take a type, they are just
         // single operations
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = NULL;
 
         curBlock->instructions.push_back(&op);
@@ -5799,7 +6001,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       case spv::OpMemoryBarrier:
       {
         // these don't emit an ID, just have some properties
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = NULL;
 
         int word = 1;
@@ -5843,7 +6045,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = typeInst->type;
 
         {
@@ -5874,7 +6076,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + 1]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = typeInst->type;
 
         {
@@ -5910,7 +6112,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
         SPVInstruction *typeInst = module.GetByID(spirv[it + word]);
         RDCASSERT(typeInst && typeInst->type);
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
         op.op->type = typeInst->type;
 
         word++;
@@ -5974,7 +6176,7 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
       {
         int word = 1;
 
-        op.op = new SPVOperation();
+        op.op = module.arena.New<SPVOperation>();
 
         // all atomic operations but store return a new ID of a given type
         if(op.opcode != spv::OpAtomicStore)
@@ -6201,3 +6403,273 @@ void ParseSPIRV(uint32_t *spirv, size_t spirvLength, SPVModule &module)
 
   std::sort(module.globals.begin(), module.globals.end(), SortByVarClass());
 }
+
+void SPVModule::Parse() const
+{
+  SCOPED_LOCK(parseLock.lock);
+
+  if(parsed)
+    return;
+
+  parsed = true;
+
+  // nothing to parse if ParseSPIRV rejected the module
+  if(spirv.size() < 5)
+    return;
+
+  ParseSPIRVInstructions(const_cast<SPVModule &>(*this));
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+#include "common/timing.h"
+
+// a compute shader with numBuffers storage buffers and numStatements dependent arithmetic
+// statements, to stand in for real shaders of varying size.
+static std::string MakeBenchmarkShader(uint32_t numBuffers, uint32_t numStatements)
+{
+  std::string src = "#version 450 core\nlayout(local_size_x = 64) in;\n";
+
+  for(uint32_t b = 0; b < numBuffers; b++)
+    src += StringFormat::Fmt(
+        "layout(binding = %u, std430) buffer buf%u { vec4 data%u[]; };\n", b, b, b);
+
+  src += "void main() {\n  uint idx = gl_GlobalInvocationID.x;\n  vec4 v = vec4(idx);\n";
+
+  for(uint32_t i = 0; i < numStatements; i++)
+    src += StringFormat::Fmt("  v = v * data%u[idx + %u] + vec4(%u.5);\n", i % numBuffers, i, i);
+
+  src += "  data0[idx] = v;\n}\n";
+
+  return src;
+}
+
+TEST_CASE("Benchmark SPIR-V parsing, disassembly and reflection", "[.][benchmark][spirv]")
+{
+  std::vector<std::vector<uint32_t>> corpus;
+
+  // point this at a directory of .spv files, e.g. dumped from a capture, to benchmark real shaders
+  const char *corpusDir = Process::GetEnvVariable("RENDERDOC_SPIRV_CORPUS");
+
+  if(corpusDir && corpusDir[0])
+  {
+    for(const PathEntry &file : FileIO::GetFilesInDirectory(corpusDir))
+    {
+      std::string filename = file.filename.c_str();
+      if(filename.size() < 4 || filename.substr(filename.size() - 4) != ".spv")
+        continue;
+
+      std::vector<byte> bytes;
+      if(!FileIO::slurp((std::string(corpusDir) + "/" + filename).c_str(), bytes) ||
+         bytes.size() < 20 || bytes.size() % sizeof(uint32_t) != 0)
+        continue;
+
+      corpus.push_back(std::vector<uint32_t>(bytes.size() / sizeof(uint32_t)));
+      memcpy(corpus.back().data(), bytes.data(), bytes.size());
+    }
+  }
+  else
+  {
+    InitSPIRVCompiler();
+
+    for(uint32_t i = 0; i < 200; i++)
+    {
+      // mostly small shaders, with the occasional very large one
+      uint32_t numStatements = (i % 50) == 0 ? 4000 : 20 + (i * 37) % 300;
+
+      std::vector<uint32_t> words;
+      CompileSPIRV(SPIRVCompilationSettings(SPIRVSourceLanguage::VulkanGLSL,
+                                            SPIRVShaderStage::Compute),
+                   {MakeBenchmarkShader(1 + i % 8, numStatements)}, words);
+
+      if(!words.empty())
+        corpus.push_back(words);
+    }
+  }
+
+  REQUIRE(!corpus.empty());
+
+  std::vector<SPVModule> modules(corpus.size());
+
+  uint64_t wordBytes = 0, arenaBytes = 0;
+
+  PerformanceTimer timer;
+
+  for(size_t i = 0; i < corpus.size(); i++)
+  {
+    ParseSPIRV(corpus[i].data(), corpus[i].size(), modules[i]);
+    wordBytes += corpus[i].size() * sizeof(uint32_t);
+  }
+
+  double loadMs = timer.GetMilliseconds();
+
+  timer.Restart();
+
+  uint32_t numReflected = 0;
+
+  for(SPVModule &mod : modules)
+  {
+    for(const std::string &entry : mod.EntryPoints())
+    {
+      ShaderReflection refl;
+      ShaderBindpointMapping mapping;
+      SPIRVPatchData patchData;
+      mod.MakeReflectionUncached(mod.StageForEntry(entry), entry, refl, mapping, patchData);
+      numReflected++;
+    }
+
+    arenaBytes += mod.arena.GetAllocatedBytes();
+  }
+
+  double reflectMs = timer.GetMilliseconds();
+
+  timer.Restart();
+
+  size_t disasmLength = 0;
+
+  for(SPVModule &mod : modules)
+    for(const std::string &entry : mod.EntryPoints())
+      disasmLength += mod.Disassemble(entry).size();
+
+  double disasmMs = timer.GetMilliseconds();
+
+  CHECK(numReflected >= corpus.size());
+  CHECK(disasmLength > 0);
+
+  RDCLOG(
+      "%u modules (%llu KB of SPIR-V): loaded in %.2f ms, parsed and reflected %u entry points in "
+      "%.2f ms, disassembled in %.2f ms. %llu KB of parsed instructions",
+      (uint32_t)corpus.size(), wordBytes / 1024, loadMs, numReflected, reflectMs, disasmMs,
+      arenaBytes / 1024);
+}
+
+TEST_CASE("Check SPIR-V reflection and disassembly against the parsed module", "[spirv]")
+{
+  InitSPIRVCompiler();
+
+  // six buffers but only the first three are accessed, so reflection has unused bindings to find
+  std::vector<uint32_t> words;
+  std::string errors =
+      CompileSPIRV(SPIRVCompilationSettings(SPIRVSourceLanguage::VulkanGLSL,
+                                            SPIRVShaderStage::Compute),
+                   {MakeBenchmarkShader(6, 3)}, words);
+  INFO(errors);
+  REQUIRE(!words.empty());
+
+  SPVModule mod;
+  ParseSPIRV(words.data(), words.size(), mod);
+
+  std::string disasm = mod.Disassemble("main");
+
+  SECTION("Entry points read from the words match the parsed entry points")
+  {
+    std::vector<std::string> entryPoints = mod.EntryPoints();
+
+    REQUIRE(entryPoints.size() == mod.entries.size());
+
+    for(size_t i = 0; i < mod.entries.size(); i++)
+    {
+      REQUIRE(mod.entries[i]->entry);
+      CHECK(entryPoints[i] == mod.entries[i]->entry->name);
+    }
+
+    CHECK(mod.StageForEntry("main") == ShaderStage::Compute);
+    CHECK(mod.StageForEntry("missing") == ShaderStage::Count);
+  };
+
+  SECTION("Use index matches a scan of every operation's arguments")
+  {
+    SPVUseIndex uses;
+    uses.Build(mod.operations, mod.ids.size());
+
+    for(uint32_t id = 0; id < mod.ids.size() + 1; id++)
+    {
+      std::vector<uint32_t> expected;
+
+      for(size_t o = 0; o < mod.operations.size(); o++)
+        if(id != 0 && mod.operations[o]->op)
+          for(const SPVInstruction *arg : mod.operations[o]->op->arguments)
+            if(arg && arg->id == id)
+              expected.push_back((uint32_t)o);
+
+      std::vector<uint32_t> actual(uses.UsersBegin(id), uses.UsersEnd(id));
+
+      INFO("id " << id);
+      CHECK(uses.IsUsed(id) == !expected.empty());
+      CHECK(actual == expected);
+    }
+  };
+
+  SECTION("Reflected bindings are used exactly when an operation references the variable")
+  {
+    ShaderReflection refl;
+    ShaderBindpointMapping mapping;
+    SPIRVPatchData patchData;
+    mod.MakeReflectionUncached(ShaderStage::Compute, "main", refl, mapping, patchData);
+
+    REQUIRE(mapping.readWriteResources.size() == 6);
+
+    for(const SPVInstruction *inst : mod.globals)
+    {
+      int32_t bind = -1;
+      for(const SPVDecoration &dec : inst->decorations)
+        if(dec.decoration == spv::DecorationBinding)
+          bind = (int32_t)dec.val;
+
+      if(bind < 0)
+        continue;
+
+      bool referenced = false;
+      for(const SPVInstruction *user : mod.operations)
+        if(user->op)
+          for(const SPVInstruction *arg : user->op->arguments)
+            referenced |= (arg == inst);
+
+      // buffers 0-2 are accessed by the shader, 3-5 are only declared
+      CHECK(referenced == (bind < 3));
+
+      bool found = false;
+      for(const Bindpoint &bindmap : mapping.readWriteResources)
+      {
+        if(bindmap.bind == bind)
+        {
+          INFO("binding " << bind);
+          CHECK(bindmap.used == referenced);
+          found = true;
+        }
+      }
+
+      CHECK(found);
+    }
+  };
+
+  SECTION("A second parse of the same words gives identical results")
+  {
+    SPVModule other;
+    ParseSPIRV(words.data(), words.size(), other);
+
+    CHECK(other.Disassemble("main") == disasm);
+    CHECK(disasm.find("buf5") != std::string::npos);
+
+    ShaderReflection refl[2];
+    ShaderBindpointMapping mapping[2];
+    SPIRVPatchData patchData[2];
+    mod.MakeReflectionUncached(ShaderStage::Compute, "main", refl[0], mapping[0], patchData[0]);
+    other.MakeReflectionUncached(ShaderStage::Compute, "main", refl[1], mapping[1], patchData[1]);
+
+    REQUIRE(mapping[0].readWriteResources.size() == mapping[1].readWriteResources.size());
+
+    for(size_t i = 0; i < mapping[0].readWriteResources.size(); i++)
+    {
+      const Bindpoint &a = mapping[0].readWriteResources[i];
+      const Bindpoint &b = mapping[1].readWriteResources[i];
+
+      CHECK(a.bindset == b.bindset);
+      CHECK(a.bind == b.bind);
+      CHECK(a.used == b.used);
+    }
+  };
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -23,9 +23,9 @@
  ******************************************************************************/
 
 #include "vk_core.h"
+#include "common/thumbnail.h"
 #include "driver/ihv/amd/amd_rgp.h"
 #include "jpeg-compressor/jpge.h"
-#include "maths/formatpacking.h"
 #include "serialise/rdcfile.h"
 #include "strings/string_utils.h"
 #include "vk_debug.h"
@@ -1046,6 +1046,10 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
     }
 
     m_State = CaptureState::ActiveCapturing;
+
+    // now that descriptor updates will be fully tracked again, bring any sets that had their bind
+    // refs deferred up to date before they're bound and submitted in the frame.
+    FlushDeferredDescriptorRefs();
   }
 
   RDCLOG("Starting capture, frame %u", m_FrameCounter);
@@ -1264,123 +1268,17 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
     RDCASSERT(pData != NULL);
 
-    // point sample info into raw buffer
+    // downscale into raw buffer
     {
       ResourceFormat fmt = MakeResourceFormat(imInfo.format);
 
-      byte *data = (byte *)pData;
-
-      data += layout.offset;
-
-      float widthf = float(imInfo.extent.width);
-      float heightf = float(imInfo.extent.height);
-
-      float aspect = widthf / heightf;
-
-      thwidth = (uint16_t)RDCMIN(maxSize, imInfo.extent.width);
-      thwidth &= ~0x7;    // align down to multiple of 8
-      thheight = uint16_t(float(thwidth) / aspect);
+      CalcThumbnailSize(imInfo.extent.width, imInfo.extent.height, maxSize, thwidth, thheight);
 
       thpixels = new byte[3U * thwidth * thheight];
 
-      uint32_t stride = fmt.compByteWidth * fmt.compCount;
-
-      bool buf1010102 = false;
-      bool buf565 = false, buf5551 = false;
-      bool bufBGRA = (fmt.bgraOrder != false);
-
-      switch(fmt.type)
-      {
-        case ResourceFormatType::R10G10B10A2:
-          stride = 4;
-          buf1010102 = true;
-          break;
-        case ResourceFormatType::R5G6B5:
-          stride = 2;
-          buf565 = true;
-          break;
-        case ResourceFormatType::R5G5B5A1:
-          stride = 2;
-          buf5551 = true;
-          break;
-        default: break;
-      }
-
-      byte *dst = thpixels;
-
-      for(uint32_t y = 0; y < thheight; y++)
-      {
-        for(uint32_t x = 0; x < thwidth; x++)
-        {
-          float xf = float(x) / float(thwidth);
-          float yf = float(y) / float(thheight);
-
-          byte *src =
-              &data[stride * uint32_t(xf * widthf) + layout.rowPitch * uint32_t(yf * heightf)];
-
-          if(buf1010102)
-          {
-            uint32_t *src1010102 = (uint32_t *)src;
-            Vec4f unorm = ConvertFromR10G10B10A2(*src1010102);
-            dst[0] = (byte)(unorm.x * 255.0f);
-            dst[1] = (byte)(unorm.y * 255.0f);
-            dst[2] = (byte)(unorm.z * 255.0f);
-          }
-          else if(buf565)
-          {
-            uint16_t *src565 = (uint16_t *)src;
-            Vec3f unorm = ConvertFromB5G6R5(*src565);
-            dst[0] = (byte)(unorm.z * 255.0f);
-            dst[1] = (byte)(unorm.y * 255.0f);
-            dst[2] = (byte)(unorm.x * 255.0f);
-          }
-          else if(buf5551)
-          {
-            uint16_t *src5551 = (uint16_t *)src;
-            Vec4f unorm = ConvertFromB5G5R5A1(*src5551);
-            dst[0] = (byte)(unorm.z * 255.0f);
-            dst[1] = (byte)(unorm.y * 255.0f);
-            dst[2] = (byte)(unorm.x * 255.0f);
-          }
-          else if(bufBGRA)
-          {
-            dst[0] = src[2];
-            dst[1] = src[1];
-            dst[2] = src[0];
-          }
-          else if(fmt.compByteWidth == 2)    // R16G16B16A16 backbuffer
-          {
-            uint16_t *src16 = (uint16_t *)src;
-
-            float linearR = RDCCLAMP(ConvertFromHalf(src16[0]), 0.0f, 1.0f);
-            float linearG = RDCCLAMP(ConvertFromHalf(src16[1]), 0.0f, 1.0f);
-            float linearB = RDCCLAMP(ConvertFromHalf(src16[2]), 0.0f, 1.0f);
-
-            if(linearR < 0.0031308f)
-              dst[0] = byte(255.0f * (12.92f * linearR));
-            else
-              dst[0] = byte(255.0f * (1.055f * powf(linearR, 1.0f / 2.4f) - 0.055f));
-
-            if(linearG < 0.0031308f)
-              dst[1] = byte(255.0f * (12.92f * linearG));
-            else
-              dst[1] = byte(255.0f * (1.055f * powf(linearG, 1.0f / 2.4f) - 0.055f));
-
-            if(linearB < 0.0031308f)
-              dst[2] = byte(255.0f * (12.92f * linearB));
-            else
-              dst[2] = byte(255.0f * (1.055f * powf(linearB, 1.0f / 2.4f) - 0.055f));
-          }
-          else
-          {
-            dst[0] = src[0];
-            dst[1] = src[1];
-            dst[2] = src[2];
-          }
-
-          dst += 3;
-        }
-      }
+      if(!DownscaleToRGB8(pData + layout.offset, imInfo.extent.width, imInfo.extent.height,
+                          (uint32_t)layout.rowPitch, fmt, false, thpixels, thwidth, thheight))
+        memset(thpixels, 0, 3U * thwidth * thheight);
     }
 
     vt->UnmapMemory(Unwrap(device), Unwrap(readbackMem.mem));
@@ -1475,7 +1373,7 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
       RDCDEBUG("Flushing %u command buffer records to file serialiser",
                (uint32_t)m_CmdBufferRecords.size());
 
-      std::map<int32_t, Chunk *> recordlist;
+      RecordChunkList recordlist;
 
       // ensure all command buffer records within the frame evne if recorded before, but
       // otherwise order must be preserved (vs. queue submits and desc set updates)
@@ -1489,6 +1387,8 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
       m_FrameCaptureRecord->Insert(recordlist);
 
+      SortChunks(recordlist);
+
       RDCDEBUG("Flushing %u chunks to file serialiser from context record",
                (uint32_t)recordlist.size());
 
@@ -1593,47 +1493,66 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
   int chunkIdx = 0;
 
-  struct chunkinfo
-  {
-    chunkinfo() : count(0), totalsize(0), total(0.0) {}
-    int count;
-    uint64_t totalsize;
-    double total;
-  };
-
-  std::map<VulkanChunk, chunkinfo> chunkInfos;
-
   SCOPED_TIMER("chunk initialisation");
 
   uint64_t frameDataSize = 0;
+  uint64_t initDataSize = 0;
+
+  // pipeline creation is by far the most expensive part of loading, so let it run in parallel
+  // with the rest of the stream where possible.
+  m_DeferPipelineCreation =
+      IsReplayMode(m_State) &&
+      RenderDoc::Inst().GetConfigSetting("Vulkan_ParallelPipelineCreation") != "0";
+
+  m_LoadProfiler.Begin();
 
   for(;;)
   {
-    PerformanceTimer timer;
-
     uint64_t offsetStart = reader->GetOffset();
 
+    m_LoadProfiler.BeginChunk(m_StructuredFile->chunks.size());
+
     VulkanChunk context = ser.ReadChunk<VulkanChunk>();
 
     chunkIdx++;
 
     if(reader->IsErrored())
+    {
+      FlushDeferredPipelines();
       return ReplayStatus::APIDataCorrupted;
+    }
+
+    bool success = true;
 
-    bool success = ProcessChunk(ser, context);
+    if(!CanDeferPipelinesPast(context))
+      success = FlushDeferredPipelines();
+
+    if(success)
+      success = ProcessChunk(ser, context);
 
     ser.EndChunk();
 
     if(reader->IsErrored())
+    {
+      FlushDeferredPipelines();
       return ReplayStatus::APIDataCorrupted;
+    }
 
     // if there wasn't a serialisation error, but the chunk didn't succeed, then it's an API replay
     // failure.
     if(!success)
+    {
+      FlushDeferredPipelines();
       return m_FailedReplayStatus;
+    }
 
     uint64_t offsetEnd = reader->GetOffset();
 
+    // the capture scope chunk is a single small chunk, the frame is profiled chunk by chunk in
+    // ContextReplayLog
+    if((SystemChunk)context != SystemChunk::CaptureScope)
+      m_LoadProfiler.EndChunk((uint32_t)context, offsetEnd - offsetStart);
+
     // only set progress after we've initialised the debug manager, to prevent progress jumping
     // backwards.
     if(m_DebugManager || IsStructuredExporting(m_State))
@@ -1651,33 +1570,28 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
       m_FrameReader = new StreamReader(reader, frameDataSize);
 
+      // everything pending was flushed before this chunk, and nothing is deferred within the frame
+      m_DeferPipelineCreation = false;
+
       ReplayStatus status = ContextReplayLog(m_State, 0, 0, false);
 
       if(status != ReplayStatus::Succeeded)
         return status;
     }
 
-    chunkInfos[context].total += timer.GetMilliseconds();
-    chunkInfos[context].totalsize += offsetEnd - offsetStart;
-    chunkInfos[context].count++;
+    if((SystemChunk)context == SystemChunk::InitialContents)
+      initDataSize += offsetEnd - offsetStart;
 
     if((SystemChunk)context == SystemChunk::CaptureScope || reader->IsErrored() || reader->AtEnd())
       break;
   }
 
-#if ENABLED(RDOC_DEVEL)
-  for(auto it = chunkInfos.begin(); it != chunkInfos.end(); ++it)
-  {
-    double dcount = double(it->second.count);
+  bool pipelinesCreated = FlushDeferredPipelines();
 
-    RDCDEBUG(
-        "% 5d chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
-        it->second.count, it->second.total, it->second.total / dcount,
-        double(it->second.totalsize) / (1024.0 * 1024.0),
-        double(it->second.totalsize) / (dcount * 1024.0 * 1024.0),
-        GetChunkName((uint32_t)it->first).c_str(), uint32_t(it->first));
-  }
-#endif
+  m_DeferPipelineCreation = false;
+
+  if(!pipelinesCreated)
+    return m_FailedReplayStatus;
 
   // steal the structured data for ourselves
   m_StructuredFile->Swap(m_StoredStructuredData);
@@ -1685,12 +1599,14 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
   // and in future use this file.
   m_StructuredFile = &m_StoredStructuredData;
 
+  if(!IsStructuredExporting(m_State))
+    m_FrameRecord.frameInfo.loadStats = m_LoadProfiler.Finish(m_StoredStructuredData);
+
   m_FrameRecord.frameInfo.uncompressedFileSize =
       rdc->GetSectionProperties(sectionIdx).uncompressedSize;
   m_FrameRecord.frameInfo.compressedFileSize = rdc->GetSectionProperties(sectionIdx).compressedSize;
   m_FrameRecord.frameInfo.persistentSize = frameDataSize;
-  m_FrameRecord.frameInfo.initDataSize =
-      chunkInfos[(VulkanChunk)SystemChunk::InitialContents].totalsize;
+  m_FrameRecord.frameInfo.initDataSize = initDataSize;
 
   RDCDEBUG("Allocating %llu persistant bytes of memory for the log.",
            m_FrameRecord.frameInfo.persistentSize);
@@ -1705,6 +1621,69 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
   return ReplayStatus::Succeeded;
 }
 
+// exports a range of chunks from the frame capture section as-is, for ExportStructuredParallel.
+// Chunks are processed in stream order without splitting off the frame at the capture scope, which
+// gives the same chunks as ReadLogInitialisation does when structured exporting.
+ReplayStatus WrappedVulkan::ExportStructuredChunks(StreamReader *reader, SDFile &output)
+{
+  RDCASSERT(IsStructuredExporting(m_State));
+
+  ReadSerialiser ser(reader, Ownership::Nothing);
+
+  ser.SetStringDatabase(&m_StringDB);
+  ser.SetUserData(GetResourceManager());
+  ser.SetVersion(m_SectionVersion);
+
+  ser.ConfigureStructuredExport(&GetChunkName, true);
+
+  m_StructuredFile = &ser.GetStructuredFile();
+
+  ReplayStatus status = ReplayStatus::Succeeded;
+
+  while(!reader->AtEnd())
+  {
+    VulkanChunk chunk = ser.ReadChunk<VulkanChunk>();
+
+    if(reader->IsErrored())
+    {
+      status = ReplayStatus::APIDataCorrupted;
+      break;
+    }
+
+    bool success = true;
+
+    // the frame's begin chunk is handled directly by ContextReplayLog rather than ProcessChunk
+    if((SystemChunk)chunk == SystemChunk::CaptureBegin)
+      success = Serialise_BeginCaptureFrame(ser);
+    else
+      success = ProcessChunk(ser, chunk);
+
+    ser.EndChunk();
+
+    if(reader->IsErrored())
+    {
+      status = ReplayStatus::APIDataCorrupted;
+      break;
+    }
+
+    if(!success)
+    {
+      status = m_FailedReplayStatus;
+      break;
+    }
+  }
+
+  if(status == ReplayStatus::Succeeded)
+  {
+    ser.GetStructuredFile().Swap(output);
+    output.version = m_SectionVersion;
+  }
+
+  m_StructuredFile = &m_StoredStructuredData;
+
+  return status;
+}
+
 ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t startEventID,
                                              uint32_t endEventID, bool partial)
 {
@@ -1727,6 +1706,11 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
     m_StructuredFile = &ser.GetStructuredFile();
   }
 
+  uint64_t headerOffset = ser.GetReader()->GetOffset();
+
+  if(IsLoading(m_State))
+    m_LoadProfiler.BeginChunk(m_StructuredFile->chunks.size());
+
   SystemChunk header = ser.ReadChunk<SystemChunk>();
   RDCASSERTEQUAL(header, SystemChunk::CaptureBegin);
 
@@ -1748,13 +1732,16 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 
     SubmitCmds();
     FlushQ();
+
+    // the time to apply initial contents is attributed to the capture's begin chunk
+    m_LoadProfiler.EndChunk((uint32_t)header, ser.GetReader()->GetOffset() - headerOffset);
   }
 
   m_RootEvents.clear();
 
   if(IsActiveReplaying(m_State))
   {
-    APIEvent ev = GetEvent(startEventID);
+    const APIEvent &ev = GetEvent(startEventID);
     m_RootEventID = ev.eventId;
 
     // if not partial, we need to be sure to replay
@@ -1796,6 +1783,9 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
 
     m_CurChunkOffset = ser.GetReader()->GetOffset();
 
+    if(IsLoading(m_State))
+      m_LoadProfiler.BeginChunk(m_StructuredFile->chunks.size());
+
     VulkanChunk chunktype = ser.ReadChunk<VulkanChunk>();
 
     if(ser.GetReader()->IsErrored())
@@ -1817,6 +1807,10 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
     if(!success)
       return m_FailedReplayStatus;
 
+    if(IsLoading(m_State))
+      m_LoadProfiler.EndChunk((uint32_t)chunktype,
+                              ser.GetReader()->GetOffset() - m_CurChunkOffset);
+
     RenderDoc::Inst().SetProgress(
         LoadProgress::FrameEventsRead,
         float(m_CurChunkOffset - startOffset) / float(ser.GetReader()->GetSize()));
@@ -1871,6 +1865,7 @@ ReplayStatus WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t sta
     };
 
     std::sort(m_Events.begin(), m_Events.end(), SortEID());
+    m_EventIndex.Build(m_Events);
     m_ParentDrawcall.children.clear();
   }
 
@@ -3232,13 +3227,7 @@ void WrappedVulkan::AddEvent()
 
 const APIEvent &WrappedVulkan::GetEvent(uint32_t eventId)
 {
-  for(const APIEvent &e : m_Events)
-  {
-    if(e.eventId >= eventId)
-      return e;
-  }
-
-  return m_Events.back();
+  return m_Events[m_EventIndex.Find(eventId)];
 }
 
 const DrawcallDescription *WrappedVulkan::GetDrawcall(uint32_t eventId)
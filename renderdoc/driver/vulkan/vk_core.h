@@ -246,6 +246,8 @@ private:
 
   StreamReader *m_FrameReader = NULL;
 
+  ChunkLoadProfiler m_LoadProfiler;
+
   std::set<std::string> m_StringDB;
 
   VkResourceRecord *m_FrameCaptureRecord;
@@ -267,6 +269,14 @@ private:
 
   Threading::CriticalSection m_CapTransitionLock;
 
+  // descriptor sets with deferred bind refs, when the DeferDescriptorTracking option is enabled.
+  // These are rebuilt when a capture begins, and dropped when the set is freed.
+  Threading::CriticalSection m_DeferredDescSetsLock;
+  std::set<ResourceId> m_DeferredDescSets;
+
+  bool DeferDescriptorRefs(VkResourceRecord *setRecord, FrameRefType ref);
+  void FlushDeferredDescriptorRefs();
+
   VulkanDrawcallCallback *m_DrawcallCallback;
 
   SDFile *m_StructuredFile;
@@ -697,7 +707,47 @@ private:
 
   void ApplyInitialContents();
 
+  // while loading a capture, pipeline creation can be handed off to worker threads so the driver
+  // compiles overlap with each other and with reading the rest of the chunk stream. Pipelines are
+  // only wrapped and registered as live once their batch is flushed, which happens in stream order
+  // before any chunk that might need to refer to them.
+  struct DeferredPipeline
+  {
+    VkDevice device = VK_NULL_HANDLE;
+    ResourceId id;
+
+    // the deserialised create info, which this takes ownership of and is still wrapped. Only one
+    // of these is used depending on whether this is a compute pipeline.
+    bool compute = false;
+    VkGraphicsPipelineCreateInfo graphicsInfo = {};
+    VkComputePipelineCreateInfo computeInfo = {};
+
+    // unwrapped copies for the worker to create from, including the subpass 0 variant
+    VkGraphicsPipelineCreateInfo unwrappedGraphics = {}, unwrappedSubpass0 = {};
+    VkComputePipelineCreateInfo unwrappedCompute = {};
+    std::vector<VkPipelineShaderStageCreateInfo> unwrappedStages;
+
+    VulkanCreationInfo::Pipeline info;
+
+    VkResult result = VK_SUCCESS;
+    VkPipeline pipe = VK_NULL_HANDLE, subpass0pipe = VK_NULL_HANDLE;
+  };
+
+  bool m_DeferPipelineCreation = false;
+  // pipelines waiting for the current batch to fill up, and the batch being compiled by
+  // m_PipelineBatchThread (if it's non-zero)
+  std::vector<DeferredPipeline *> m_QueuedPipelines, m_CompilingPipelines;
+  Threading::ThreadHandle m_PipelineBatchThread = 0;
+
+  bool DeferPipeline(DeferredPipeline *pipe);
+  void CompileDeferredPipelines(const std::vector<DeferredPipeline *> &pipes);
+  bool RegisterDeferredPipelines(std::vector<DeferredPipeline *> &pipes);
+  bool FinishPipelineBatch();
+  bool FlushDeferredPipelines();
+  bool CanDeferPipelinesPast(VulkanChunk chunk);
+
   vector<APIEvent> m_RootEvents, m_Events;
+  EventIndex m_EventIndex;
   bool m_AddedDrawcall;
 
   uint64_t m_CurChunkOffset;
@@ -793,6 +843,9 @@ public:
   void Shutdown();
   void ReplayLog(uint32_t startEventID, uint32_t endEventID, ReplayLogType replayType);
   ReplayStatus ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers);
+  ReplayStatus ExportStructuredChunks(StreamReader *reader, SDFile &output);
+
+  void ReleaseDeferredDescriptorRefs(ResourceId id);
 
   SDFile &GetStructuredFile() { return *m_StructuredFile; }
   FrameRecord &GetFrameRecord() { return m_FrameRecord; }
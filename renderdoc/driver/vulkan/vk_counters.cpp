@@ -31,13 +31,68 @@
 #include "driver/ihv/amd/amd_counters.h"
 #include "driver/ihv/amd/official/GPUPerfAPI/Include/GPUPerfAPI-VK.h"
 
+// pipeline statistics are written in order of their flag bits, this is the index of each within
+// the results for one query with PipeStatsFlags
+enum PipeStatIndex
+{
+  PipeStat_IAVertices = 0,
+  PipeStat_IAPrimitives,
+  PipeStat_VSInvocations,
+  PipeStat_GSInvocations,
+  PipeStat_GSPrimitives,
+  PipeStat_ClipInvocations,
+  PipeStat_ClipPrimitives,
+  PipeStat_FSInvocations,
+  PipeStat_TCSPatches,
+  PipeStat_TESInvocations,
+  PipeStat_CSInvocations,
+  PipeStat_Count,
+};
+
+static const VkQueryPipelineStatisticFlags PipeStatsFlags =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_CONTROL_SHADER_PATCHES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+// returns how many bits are valid in timestamps written on the queue we replay on, which is 0 when
+// timestamps aren't supported at all (e.g. on some software implementations)
+static uint32_t GetTimestampValidBits(WrappedVulkan *driver)
+{
+  VkPhysicalDevice phys = driver->GetPhysDev();
+
+  uint32_t count = 0;
+  ObjDisp(phys)->GetPhysicalDeviceQueueFamilyProperties(Unwrap(phys), &count, NULL);
+
+  vector<VkQueueFamilyProperties> props(count);
+  ObjDisp(phys)->GetPhysicalDeviceQueueFamilyProperties(Unwrap(phys), &count, props.data());
+
+  uint32_t idx = driver->GetQFamilyIdx();
+  if(idx >= count || driver->GetDeviceProps().limits.timestampPeriod <= 0.0f)
+    return 0;
+
+  return props[idx].timestampValidBits;
+}
+
 vector<GPUCounter> VulkanReplay::EnumerateCounters()
 {
   vector<GPUCounter> ret;
 
   VkPhysicalDeviceFeatures availableFeatures = m_pDriver->GetDeviceFeatures();
 
-  ret.push_back(GPUCounter::EventGPUDuration);
+  // every built-in counter is backed by a GPU query, so a device without timestamps, statistics or
+  // precise occlusion queries (e.g. a null or software implementation) reports none of them. There
+  // is no CPU-side fallback: timing the replay on the CPU would measure submission, not the GPU.
+  if(GetTimestampValidBits(m_pDriver) > 0)
+    ret.push_back(GPUCounter::EventGPUDuration);
+
   if(availableFeatures.pipelineStatisticsQuery)
   {
     ret.push_back(GPUCounter::InputVerticesRead);
@@ -332,36 +387,10 @@ vector<CounterResult> VulkanReplay::FetchCountersAMD(const vector<GPUCounter> &c
   std::vector<CounterResult> ret =
       m_pAMDCounters->GetCounterData(sessionID, sampleIndex, eventIDs, counters);
 
-  for(size_t i = 0; i < m_pAMDDrawCallback->m_AliasEvents.size(); i++)
-  {
-    for(size_t c = 0; c < counters.size(); c++)
-    {
-      CounterResult search;
-      search.counter = counters[c];
-      search.eventId = m_pAMDDrawCallback->m_AliasEvents[i].first;
-
-      // find the result we're aliasing
-      auto it = std::find(ret.begin(), ret.end(), search);
-      if(it != ret.end())
-      {
-        // duplicate the result and append
-        CounterResult aliased = *it;
-        aliased.eventId = m_pAMDDrawCallback->m_AliasEvents[i].second;
-        ret.push_back(aliased);
-      }
-      else
-      {
-        RDCERR("Expected to find alias-target result for EID %u counter %u, but didn't",
-               search.eventId, search.counter);
-      }
-    }
-  }
+  AddAliasedCounterResults(ret, m_pAMDDrawCallback->m_AliasEvents, counters);
 
   SAFE_DELETE(m_pAMDDrawCallback);
 
-  // sort so that the alias results appear in the right places
-  std::sort(ret.begin(), ret.end());
-
   return ret;
 }
 
@@ -385,14 +414,16 @@ struct VulkanGPUTimerCallback : public VulkanDrawcallCallback
                                   VK_QUERY_CONTROL_PRECISE_BIT);
     if(m_PipeStatsQueryPool != VK_NULL_HANDLE)
       ObjDisp(cmd)->CmdBeginQuery(Unwrap(cmd), m_PipeStatsQueryPool, (uint32_t)m_Results.size(), 0);
-    ObjDisp(cmd)->CmdWriteTimestamp(Unwrap(cmd), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                                    m_TimeStampQueryPool, (uint32_t)(m_Results.size() * 2 + 0));
+    if(m_TimeStampQueryPool != VK_NULL_HANDLE)
+      ObjDisp(cmd)->CmdWriteTimestamp(Unwrap(cmd), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                      m_TimeStampQueryPool, (uint32_t)(m_Results.size() * 2 + 0));
   }
 
   bool PostDraw(uint32_t eid, VkCommandBuffer cmd) override
   {
-    ObjDisp(cmd)->CmdWriteTimestamp(Unwrap(cmd), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                                    m_TimeStampQueryPool, (uint32_t)(m_Results.size() * 2 + 1));
+    if(m_TimeStampQueryPool != VK_NULL_HANDLE)
+      ObjDisp(cmd)->CmdWriteTimestamp(Unwrap(cmd), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                      m_TimeStampQueryPool, (uint32_t)(m_Results.size() * 2 + 1));
     if(m_OcclusionQueryPool != VK_NULL_HANDLE)
       ObjDisp(cmd)->CmdEndQuery(Unwrap(cmd), m_OcclusionQueryPool, (uint32_t)m_Results.size());
     if(m_PipeStatsQueryPool != VK_NULL_HANDLE)
@@ -466,34 +497,7 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
 
   VkDevice dev = m_pDriver->GetDev();
 
-  VkQueryPoolCreateInfo timeStampPoolCreateInfo = {
-      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, NULL, 0, VK_QUERY_TYPE_TIMESTAMP, maxEID * 2, 0};
-
-  VkQueryPoolCreateInfo occlusionPoolCreateInfo = {
-      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, NULL, 0, VK_QUERY_TYPE_OCCLUSION, maxEID, 0};
-
-  VkQueryPipelineStatisticFlags pipeStatsFlags =
-      VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_INVOCATIONS_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_PRIMITIVES_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_CONTROL_SHADER_PATCHES_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT |
-      VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
-
-  VkQueryPoolCreateInfo pipeStatsPoolCreateInfo = {
-      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, NULL,   0,
-      VK_QUERY_TYPE_PIPELINE_STATISTICS,        maxEID, pipeStatsFlags};
-
-  VkQueryPool timeStampPool;
-  VkResult vkr =
-      ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &timeStampPoolCreateInfo, NULL, &timeStampPool);
-  RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
+  bool timestampsNeeded = false;
   bool occlNeeded = false;
   bool statsNeeded = false;
 
@@ -501,6 +505,7 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
   {
     switch(vkCounters[c])
     {
+      case GPUCounter::EventGPUDuration: timestampsNeeded = true; break;
       case GPUCounter::InputVerticesRead:
       case GPUCounter::IAPrimitives:
       case GPUCounter::GSPrimitives:
@@ -517,17 +522,41 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
     }
   }
 
+  const uint32_t timestampBits = GetTimestampValidBits(m_pDriver);
+
+  // every query type needed is recorded around each event in a single replay, into pools large
+  // enough for every event in the frame. Each event gets a query index that maps back to its EID
+  VkQueryPool timeStampPool = VK_NULL_HANDLE;
+  if(timestampBits > 0 && timestampsNeeded)
+  {
+    VkQueryPoolCreateInfo timeStampPoolCreateInfo = {
+        VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, NULL, 0, VK_QUERY_TYPE_TIMESTAMP, maxEID * 2, 0};
+
+    VkResult vkr =
+        ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &timeStampPoolCreateInfo, NULL, &timeStampPool);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
+
   VkQueryPool occlusionPool = VK_NULL_HANDLE;
   if(availableFeatures.occlusionQueryPrecise && occlNeeded)
   {
-    vkr = ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &occlusionPoolCreateInfo, NULL, &occlusionPool);
+    VkQueryPoolCreateInfo occlusionPoolCreateInfo = {
+        VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, NULL, 0, VK_QUERY_TYPE_OCCLUSION, maxEID, 0};
+
+    VkResult vkr =
+        ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &occlusionPoolCreateInfo, NULL, &occlusionPool);
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
   }
 
   VkQueryPool pipeStatsPool = VK_NULL_HANDLE;
   if(availableFeatures.pipelineStatisticsQuery && statsNeeded)
   {
-    vkr = ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &pipeStatsPoolCreateInfo, NULL, &pipeStatsPool);
+    VkQueryPoolCreateInfo pipeStatsPoolCreateInfo = {
+        VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, NULL,   0,
+        VK_QUERY_TYPE_PIPELINE_STATISTICS,        maxEID, PipeStatsFlags};
+
+    VkResult vkr =
+        ObjDisp(dev)->CreateQueryPool(Unwrap(dev), &pipeStatsPoolCreateInfo, NULL, &pipeStatsPool);
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
   }
 
@@ -536,10 +565,11 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
   VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
                                         VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
 
-  vkr = ObjDisp(dev)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+  VkResult vkr = ObjDisp(dev)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
   RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-  ObjDisp(dev)->CmdResetQueryPool(Unwrap(cmd), timeStampPool, 0, maxEID * 2);
+  if(timeStampPool != VK_NULL_HANDLE)
+    ObjDisp(dev)->CmdResetQueryPool(Unwrap(cmd), timeStampPool, 0, maxEID * 2);
   if(occlusionPool != VK_NULL_HANDLE)
     ObjDisp(dev)->CmdResetQueryPool(Unwrap(cmd), occlusionPool, 0, maxEID);
   if(pipeStatsPool != VK_NULL_HANDLE)
@@ -557,45 +587,66 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
   // replay the events to perform all the queries
   m_pDriver->ReplayLog(0, maxEID, eReplay_Full);
 
-  vector<uint64_t> m_TimeStampData;
-  m_TimeStampData.resize(cb.m_Results.size() * 2);
+  const uint32_t numEvents = (uint32_t)cb.m_Results.size();
 
-  vkr = ObjDisp(dev)->GetQueryPoolResults(
-      Unwrap(dev), timeStampPool, 0, (uint32_t)m_TimeStampData.size(),
-      sizeof(uint64_t) * m_TimeStampData.size(), &m_TimeStampData[0], sizeof(uint64_t),
-      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
-  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  // results for any query type we couldn't record stay as 0
+  vector<uint64_t> timeStampData(numEvents * 2);
+  vector<uint64_t> occlusionData(numEvents);
+  vector<uint64_t> pipeStatsData(numEvents * PipeStat_Count);
+
+  if(timeStampPool != VK_NULL_HANDLE)
+  {
+    if(numEvents > 0)
+    {
+      vkr = ObjDisp(dev)->GetQueryPoolResults(
+          Unwrap(dev), timeStampPool, 0, numEvents * 2, sizeof(uint64_t) * timeStampData.size(),
+          timeStampData.data(), sizeof(uint64_t),
+          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
 
-  ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), timeStampPool, NULL);
+    ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), timeStampPool, NULL);
+  }
 
-  vector<uint64_t> m_OcclusionData;
-  m_OcclusionData.resize(cb.m_Results.size());
   if(occlusionPool != VK_NULL_HANDLE)
   {
-    vkr = ObjDisp(dev)->GetQueryPoolResults(
-        Unwrap(dev), occlusionPool, 0, (uint32_t)m_OcclusionData.size(),
-        sizeof(uint64_t) * m_OcclusionData.size(), &m_OcclusionData[0], sizeof(uint64_t),
-        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    if(numEvents > 0)
+    {
+      vkr = ObjDisp(dev)->GetQueryPoolResults(
+          Unwrap(dev), occlusionPool, 0, numEvents, sizeof(uint64_t) * occlusionData.size(),
+          occlusionData.data(), sizeof(uint64_t),
+          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
 
     ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), occlusionPool, NULL);
   }
 
-  vector<uint64_t> m_PipeStatsData;
-  m_PipeStatsData.resize(cb.m_Results.size() * 11);
   if(pipeStatsPool != VK_NULL_HANDLE)
   {
-    vkr = ObjDisp(dev)->GetQueryPoolResults(
-        Unwrap(dev), pipeStatsPool, 0, (uint32_t)cb.m_Results.size(),
-        sizeof(uint64_t) * m_PipeStatsData.size(), &m_PipeStatsData[0], sizeof(uint64_t) * 11,
-        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    if(numEvents > 0)
+    {
+      vkr = ObjDisp(dev)->GetQueryPoolResults(
+          Unwrap(dev), pipeStatsPool, 0, numEvents, sizeof(uint64_t) * pipeStatsData.size(),
+          pipeStatsData.data(), sizeof(uint64_t) * PipeStat_Count,
+          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
 
     ObjDisp(dev)->DestroyQueryPool(Unwrap(dev), pipeStatsPool, NULL);
   }
 
-  for(size_t i = 0; i < cb.m_Results.size(); i++)
+  // timestamps only have timestampBits valid bits, so mask the delta to handle wrapping
+  const uint64_t timestampMask = timestampBits >= 64 ? ~0ULL : (1ULL << timestampBits) - 1;
+  const double timestampPeriod = m_pDriver->GetDeviceProps().limits.timestampPeriod;
+
+  ret.reserve(ret.size() + numEvents * vkCounters.size() +
+              cb.m_AliasEvents.size() * vkCounters.size());
+
+  for(uint32_t i = 0; i < numEvents; i++)
   {
+    const uint64_t *stats = &pipeStatsData[i * PipeStat_Count];
+
     for(size_t c = 0; c < vkCounters.size(); c++)
     {
       CounterResult result;
@@ -607,61 +658,34 @@ vector<CounterResult> VulkanReplay::FetchCounters(const vector<GPUCounter> &coun
       {
         case GPUCounter::EventGPUDuration:
         {
-          uint64_t delta = m_TimeStampData[i * 2 + 1] - m_TimeStampData[i * 2 + 0];
-          result.value.d = (double(m_pDriver->GetDeviceProps().limits.timestampPeriod) *
-                            double(delta))                  // nanoseconds
-                           / (1000.0 * 1000.0 * 1000.0);    // to seconds
+          uint64_t delta = (timeStampData[i * 2 + 1] - timeStampData[i * 2 + 0]) & timestampMask;
+          result.value.d = (timestampPeriod * double(delta))    // nanoseconds
+                           / (1000.0 * 1000.0 * 1000.0);       // to seconds
         }
         break;
-        case GPUCounter::InputVerticesRead: result.value.u64 = m_PipeStatsData[i * 11 + 0]; break;
-        case GPUCounter::IAPrimitives: result.value.u64 = m_PipeStatsData[i * 11 + 1]; break;
-        case GPUCounter::GSPrimitives: result.value.u64 = m_PipeStatsData[i * 11 + 4]; break;
+        case GPUCounter::InputVerticesRead: result.value.u64 = stats[PipeStat_IAVertices]; break;
+        case GPUCounter::IAPrimitives: result.value.u64 = stats[PipeStat_IAPrimitives]; break;
+        case GPUCounter::GSPrimitives: result.value.u64 = stats[PipeStat_GSPrimitives]; break;
         case GPUCounter::RasterizerInvocations:
-          result.value.u64 = m_PipeStatsData[i * 11 + 5];
+          result.value.u64 = stats[PipeStat_ClipInvocations];
           break;
         case GPUCounter::RasterizedPrimitives:
-          result.value.u64 = m_PipeStatsData[i * 11 + 6];
+          result.value.u64 = stats[PipeStat_ClipPrimitives];
           break;
-        case GPUCounter::SamplesWritten: result.value.u64 = m_OcclusionData[i]; break;
-        case GPUCounter::VSInvocations: result.value.u64 = m_PipeStatsData[i * 11 + 2]; break;
-        case GPUCounter::TCSInvocations: result.value.u64 = m_PipeStatsData[i * 11 + 8]; break;
-        case GPUCounter::TESInvocations: result.value.u64 = m_PipeStatsData[i * 11 + 9]; break;
-        case GPUCounter::GSInvocations: result.value.u64 = m_PipeStatsData[i * 11 + 3]; break;
-        case GPUCounter::PSInvocations: result.value.u64 = m_PipeStatsData[i * 11 + 9]; break;
-        case GPUCounter::CSInvocations: result.value.u64 = m_PipeStatsData[i * 11 + 10]; break;
+        case GPUCounter::SamplesWritten: result.value.u64 = occlusionData[i]; break;
+        case GPUCounter::VSInvocations: result.value.u64 = stats[PipeStat_VSInvocations]; break;
+        case GPUCounter::TCSInvocations: result.value.u64 = stats[PipeStat_TCSPatches]; break;
+        case GPUCounter::TESInvocations: result.value.u64 = stats[PipeStat_TESInvocations]; break;
+        case GPUCounter::GSInvocations: result.value.u64 = stats[PipeStat_GSInvocations]; break;
+        case GPUCounter::PSInvocations: result.value.u64 = stats[PipeStat_FSInvocations]; break;
+        case GPUCounter::CSInvocations: result.value.u64 = stats[PipeStat_CSInvocations]; break;
         default: break;
       }
       ret.push_back(result);
     }
   }
 
-  for(size_t i = 0; i < cb.m_AliasEvents.size(); i++)
-  {
-    for(size_t c = 0; c < vkCounters.size(); c++)
-    {
-      CounterResult search;
-      search.counter = vkCounters[c];
-      search.eventId = cb.m_AliasEvents[i].first;
-
-      // find the result we're aliasing
-      auto it = std::find(ret.begin(), ret.end(), search);
-      if(it != ret.end())
-      {
-        // duplicate the result and append
-        CounterResult aliased = *it;
-        aliased.eventId = cb.m_AliasEvents[i].second;
-        ret.push_back(aliased);
-      }
-      else
-      {
-        RDCERR("Expected to find alias-target result for EID %u counter %u, but didn't",
-               search.eventId, search.counter);
-      }
-    }
-  }
-
-  // sort so that the alias results appear in the right places
-  std::sort(ret.begin(), ret.end());
+  AddAliasedCounterResults(ret, cb.m_AliasEvents, vkCounters);
 
   return ret;
 }
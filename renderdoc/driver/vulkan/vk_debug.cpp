@@ -756,457 +756,16 @@ void VulkanDebugManager::CreateCustomShaderPipeline(ResourceId shader, VkPipelin
   CREATE_OBJECT(m_Custom.TexPipeline, customPipe);
 }
 
-// TODO: Point meshes don't pick correctly
 uint32_t VulkanReplay::PickVertex(uint32_t eventId, int32_t w, int32_t h, const MeshDisplay &cfg,
                                   uint32_t x, uint32_t y)
 {
-  VkDevice dev = m_pDriver->GetDev();
-  const VkLayerDispatchTable *vt = ObjDisp(dev);
-
   VkMarkerRegion::Begin(StringFormat::Fmt("VulkanReplay::PickVertex(%u, %u)", x, y));
 
-  Matrix4f projMat = Matrix4f::Perspective(90.0f, 0.1f, 100000.0f, float(w) / float(h));
-
-  Matrix4f camMat = cfg.cam ? ((Camera *)cfg.cam)->GetMatrix() : Matrix4f::Identity();
-  Matrix4f pickMVP = projMat.Mul(camMat);
-
-  Matrix4f pickMVPProj;
-  if(cfg.position.unproject)
-  {
-    // the derivation of the projection matrix might not be right (hell, it could be an
-    // orthographic projection). But it'll be close enough likely.
-    Matrix4f guessProj =
-        cfg.position.farPlane != FLT_MAX
-            ? Matrix4f::Perspective(cfg.fov, cfg.position.nearPlane, cfg.position.farPlane, cfg.aspect)
-            : Matrix4f::ReversePerspective(cfg.fov, cfg.position.nearPlane, cfg.aspect);
-
-    if(cfg.ortho)
-      guessProj = Matrix4f::Orthographic(cfg.position.nearPlane, cfg.position.farPlane);
-
-    pickMVPProj = projMat.Mul(camMat.Mul(guessProj.Inverse()));
-  }
-
-  vec3 rayPos;
-  vec3 rayDir;
-  // convert mouse pos to world space ray
-  {
-    Matrix4f inversePickMVP = pickMVP.Inverse();
-
-    float pickX = ((float)x) / ((float)w);
-    float pickXCanonical = RDCLERP(-1.0f, 1.0f, pickX);
-
-    float pickY = ((float)y) / ((float)h);
-    // flip the Y axis
-    float pickYCanonical = RDCLERP(1.0f, -1.0f, pickY);
-
-    vec3 cameraToWorldNearPosition =
-        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
-
-    vec3 cameraToWorldFarPosition =
-        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
-
-    vec3 testDir = (cameraToWorldFarPosition - cameraToWorldNearPosition);
-    testDir.Normalise();
-
-    /* Calculate the ray direction first in the regular way (above), so we can use the
-    the output for testing if the ray we are picking is negative or not. This is similar
-    to checking against the forward direction of the camera, but more robust
-    */
-    if(cfg.position.unproject)
-    {
-      Matrix4f inversePickMVPGuess = pickMVPProj.Inverse();
-
-      vec3 nearPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
-
-      vec3 farPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
-
-      rayDir = (farPosProj - nearPosProj);
-      rayDir.Normalise();
-
-      if(testDir.z < 0)
-      {
-        rayDir = -rayDir;
-      }
-      rayPos = nearPosProj;
-    }
-    else
-    {
-      rayDir = testDir;
-      rayPos = cameraToWorldNearPosition;
-    }
-  }
-
-  MeshPickUBOData *ubo = (MeshPickUBOData *)m_VertexPick.UBO.Map();
-
-  ubo->rayPos = rayPos;
-  ubo->rayDir = rayDir;
-  ubo->use_indices = cfg.position.indexByteStride ? 1U : 0U;
-  ubo->numVerts = cfg.position.numIndices;
-  bool isTriangleMesh = true;
-
-  switch(cfg.position.topology)
-  {
-    case Topology::TriangleList:
-    {
-      ubo->meshMode = MESH_TRIANGLE_LIST;
-      break;
-    };
-    case Topology::TriangleStrip:
-    {
-      ubo->meshMode = MESH_TRIANGLE_STRIP;
-      break;
-    };
-    case Topology::TriangleFan:
-    {
-      ubo->meshMode = MESH_TRIANGLE_FAN;
-      break;
-    };
-    case Topology::TriangleList_Adj:
-    {
-      ubo->meshMode = MESH_TRIANGLE_LIST_ADJ;
-      break;
-    };
-    case Topology::TriangleStrip_Adj:
-    {
-      ubo->meshMode = MESH_TRIANGLE_STRIP_ADJ;
-      break;
-    };
-    default:    // points, lines, patchlists, unknown
-    {
-      ubo->meshMode = MESH_OTHER;
-      isTriangleMesh = false;
-    };
-  }
-
-  // line/point data
-  ubo->unproject = cfg.position.unproject;
-  ubo->mvp = cfg.position.unproject ? pickMVPProj : pickMVP;
-  ubo->coords = Vec2f((float)x, (float)y);
-  ubo->viewport = Vec2f((float)w, (float)h);
-
-  m_VertexPick.UBO.Unmap();
-
-  bytebuf idxs;
-
-  uint32_t minIndex = 0;
-  uint32_t maxIndex = cfg.position.numIndices;
-
-  if(cfg.position.indexByteStride && cfg.position.indexResourceId != ResourceId())
-    GetBufferData(cfg.position.indexResourceId, cfg.position.indexByteOffset, 0, idxs);
-
-  uint32_t idxclamp = 0;
-  if(cfg.position.baseVertex < 0)
-    idxclamp = uint32_t(-cfg.position.baseVertex);
-
-  // We copy into our own buffers to promote to the target type (uint32) that the shader expects.
-  // Most IBs will be 16-bit indices, most VBs will not be float4. We also apply baseVertex here
-
-  if(!idxs.empty())
-  {
-    // resize up on demand
-    if(m_VertexPick.IBSize < cfg.position.numIndices * sizeof(uint32_t))
-    {
-      if(m_VertexPick.IBSize > 0)
-      {
-        m_VertexPick.IB.Destroy();
-        m_VertexPick.IBUpload.Destroy();
-      }
-
-      m_VertexPick.IBSize = cfg.position.numIndices * sizeof(uint32_t);
-
-      m_VertexPick.IB.Create(m_pDriver, dev, m_VertexPick.IBSize, 1,
-                             GPUBuffer::eGPUBufferGPULocal | GPUBuffer::eGPUBufferSSBO);
-      m_VertexPick.IBUpload.Create(m_pDriver, dev, m_VertexPick.IBSize, 1, 0);
-    }
-
-    uint32_t *outidxs = (uint32_t *)m_VertexPick.IBUpload.Map();
-
-    memset(outidxs, 0, m_VertexPick.IBSize);
-
-    uint16_t *idxs16 = (uint16_t *)&idxs[0];
-    uint32_t *idxs32 = (uint32_t *)&idxs[0];
-
-    if(cfg.position.indexByteStride == 2)
-    {
-      size_t bufsize = idxs.size() / 2;
-
-      for(uint32_t i = 0; i < bufsize && i < cfg.position.numIndices; i++)
-      {
-        uint32_t idx = idxs16[i];
-
-        if(idx < idxclamp)
-          idx = 0;
-        else if(cfg.position.baseVertex < 0)
-          idx -= idxclamp;
-        else if(cfg.position.baseVertex > 0)
-          idx += cfg.position.baseVertex;
-
-        if(i == 0)
-        {
-          minIndex = maxIndex = idx;
-        }
-        else
-        {
-          minIndex = RDCMIN(idx, minIndex);
-          maxIndex = RDCMAX(idx, maxIndex);
-        }
-
-        outidxs[i] = idx;
-      }
-    }
-    else
-    {
-      uint32_t bufsize = uint32_t(idxs.size() / 4);
-
-      minIndex = maxIndex = idxs32[0];
-
-      for(uint32_t i = 0; i < RDCMIN(bufsize, cfg.position.numIndices); i++)
-      {
-        uint32_t idx = idxs32[i];
-
-        if(idx < idxclamp)
-          idx = 0;
-        else if(cfg.position.baseVertex < 0)
-          idx -= idxclamp;
-        else if(cfg.position.baseVertex > 0)
-          idx += cfg.position.baseVertex;
-
-        minIndex = RDCMIN(idx, minIndex);
-        maxIndex = RDCMAX(idx, maxIndex);
-
-        outidxs[i] = idx;
-      }
-    }
-
-    m_VertexPick.IBUpload.Unmap();
-  }
-
-  // unpack and linearise the data
-  {
-    bytebuf oldData;
-    GetBufferData(cfg.position.vertexResourceId, cfg.position.vertexByteOffset, 0, oldData);
-
-    // clamp maxIndex to upper bound in case we got invalid indices or primitive restart indices
-    maxIndex = RDCMIN(maxIndex, uint32_t(oldData.size() / cfg.position.vertexByteStride));
-
-    if(m_VertexPick.VBSize < (maxIndex + 1) * sizeof(FloatVector))
-    {
-      if(m_VertexPick.VBSize > 0)
-      {
-        m_VertexPick.VB.Destroy();
-        m_VertexPick.VBUpload.Destroy();
-      }
-
-      m_VertexPick.VBSize = (maxIndex + 1) * sizeof(FloatVector);
-
-      m_VertexPick.VB.Create(m_pDriver, dev, m_VertexPick.VBSize, 1,
-                             GPUBuffer::eGPUBufferGPULocal | GPUBuffer::eGPUBufferSSBO);
-      m_VertexPick.VBUpload.Create(m_pDriver, dev, m_VertexPick.VBSize, 1, 0);
-    }
-
-    byte *data = &oldData[0];
-    byte *dataEnd = data + oldData.size();
-
-    bool valid = true;
-
-    FloatVector *vbData = (FloatVector *)m_VertexPick.VBUpload.Map();
-
-    // the index buffer may refer to vertices past the start of the vertex buffer, so we can't just
-    // conver the first N vertices we'll need.
-    // Instead we grab min and max above, and convert every vertex in that range. This might
-    // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg.position.vertexByteStride,
-                                                    cfg.position.format, dataEnd, valid);
-
-    m_VertexPick.VBUpload.Unmap();
-  }
-
-  VkDescriptorBufferInfo ibInfo = {};
-  VkDescriptorBufferInfo vbInfo = {};
-
-  m_VertexPick.VB.FillDescriptor(vbInfo);
-  m_VertexPick.IB.FillDescriptor(ibInfo);
-
-  VkWriteDescriptorSet writes[] = {
-      {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, Unwrap(m_VertexPick.DescSet), 1, 0, 1,
-       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, NULL, &vbInfo, NULL},
-      {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, Unwrap(m_VertexPick.DescSet), 2, 0, 1,
-       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, NULL, &ibInfo, NULL},
-  };
-
-  if(!idxs.empty())
-    vt->UpdateDescriptorSets(Unwrap(m_Device), 2, writes, 0, NULL);
-  else
-    vt->UpdateDescriptorSets(Unwrap(m_Device), 1, writes, 0, NULL);
-
-  VkCommandBuffer cmd = m_pDriver->GetNextCmd();
-
-  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
-                                        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
-
-  VkBufferCopy bufCopy = {0, 0, 0};
-
-  vt->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
-
-  // reset first uint (used as atomic counter) to 0
-  vt->CmdFillBuffer(Unwrap(cmd), Unwrap(m_VertexPick.Result.buf), 0, sizeof(uint32_t) * 4, 0);
-
-  VkBufferMemoryBarrier bufBarrier = {
-      VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-      NULL,
-      VK_ACCESS_TRANSFER_WRITE_BIT,
-      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT,
-      VK_QUEUE_FAMILY_IGNORED,
-      VK_QUEUE_FAMILY_IGNORED,
-      Unwrap(m_VertexPick.Result.buf),
-      0,
-      VK_WHOLE_SIZE,
-  };
-
-  // wait for zero to be written to atomic counter before using in shader
-  DoPipelineBarrier(cmd, 1, &bufBarrier);
-
-  // copy uploaded VB and if needed IB
-  if(!idxs.empty())
-  {
-    // wait for writes
-    bufBarrier.buffer = Unwrap(m_VertexPick.IBUpload.buf);
-    bufBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-    bufBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    DoPipelineBarrier(cmd, 1, &bufBarrier);
-
-    // do copy
-    bufCopy.size = m_VertexPick.IBSize;
-    vt->CmdCopyBuffer(Unwrap(cmd), Unwrap(m_VertexPick.IBUpload.buf), Unwrap(m_VertexPick.IB.buf),
-                      1, &bufCopy);
-
-    // wait for copy
-    bufBarrier.buffer = Unwrap(m_VertexPick.IB.buf);
-    bufBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    bufBarrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
-    DoPipelineBarrier(cmd, 1, &bufBarrier);
-  }
-
-  // wait for writes
-  bufBarrier.buffer = Unwrap(m_VertexPick.VBUpload.buf);
-  bufBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-  bufBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-  DoPipelineBarrier(cmd, 1, &bufBarrier);
-
-  // do copy
-  bufCopy.size = m_VertexPick.VBSize;
-  vt->CmdCopyBuffer(Unwrap(cmd), Unwrap(m_VertexPick.VBUpload.buf), Unwrap(m_VertexPick.VB.buf), 1,
-                    &bufCopy);
-
-  // wait for copy
-  bufBarrier.buffer = Unwrap(m_VertexPick.VB.buf);
-  bufBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  bufBarrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
-  DoPipelineBarrier(cmd, 1, &bufBarrier);
-
-  vt->CmdBindPipeline(Unwrap(cmd), VK_PIPELINE_BIND_POINT_COMPUTE, Unwrap(m_VertexPick.Pipeline));
-  vt->CmdBindDescriptorSets(Unwrap(cmd), VK_PIPELINE_BIND_POINT_COMPUTE, Unwrap(m_VertexPick.Layout),
-                            0, 1, UnwrapPtr(m_VertexPick.DescSet), 0, NULL);
-
-  uint32_t workgroupx = uint32_t(cfg.position.numIndices / 128 + 1);
-  vt->CmdDispatch(Unwrap(cmd), workgroupx, 1, 1);
-
-  // wait for shader to finish writing before transferring to readback buffer
-  bufBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-  bufBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-  bufBarrier.buffer = Unwrap(m_VertexPick.Result.buf);
-  DoPipelineBarrier(cmd, 1, &bufBarrier);
-
-  bufCopy.size = m_VertexPick.Result.totalsize;
-
-  // copy to readback buffer
-  vt->CmdCopyBuffer(Unwrap(cmd), Unwrap(m_VertexPick.Result.buf),
-                    Unwrap(m_VertexPick.ResultReadback.buf), 1, &bufCopy);
-
-  // wait for transfer to finish before reading on CPU
-  bufBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  bufBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
-  bufBarrier.buffer = Unwrap(m_VertexPick.ResultReadback.buf);
-  DoPipelineBarrier(cmd, 1, &bufBarrier);
-
-  VkResult vkr = vt->EndCommandBuffer(Unwrap(cmd));
-  RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-#if ENABLED(SINGLE_FLUSH_VALIDATE)
-  m_pDriver->SubmitCmds();
-#endif
-
-  m_pDriver->SubmitCmds();
-  m_pDriver->FlushQ();
-
-  uint32_t *pickResultData = (uint32_t *)m_VertexPick.ResultReadback.Map();
-  uint32_t numResults = *pickResultData;
-
-  uint32_t ret = ~0U;
-
-  if(numResults > 0)
-  {
-    if(isTriangleMesh)
-    {
-      struct PickResult
-      {
-        uint32_t vertid;
-        vec3 intersectionPoint;
-      };
-
-      PickResult *pickResults = (PickResult *)(pickResultData + 4);
-
-      PickResult *closest = pickResults;
-      // distance from raycast hit to nearest worldspace position of the mouse
-      float closestPickDistance = (closest->intersectionPoint - rayPos).Length();
+  // picking is done on the CPU against a BVH built from the same data we cache for highlighting,
+  // so after the first pick on a mesh there's no further buffer readback.
+  m_HighlightCache.CacheHighlightingData(eventId, cfg);
 
-      // min with size of results buffer to protect against overflows
-      for(uint32_t i = 1; i < RDCMIN((uint32_t)VertexPicking::MaxMeshPicks, numResults); i++)
-      {
-        float pickDistance = (pickResults[i].intersectionPoint - rayPos).Length();
-        if(pickDistance < closestPickDistance)
-        {
-          closest = pickResults + i;
-        }
-      }
-      ret = closest->vertid;
-    }
-    else
-    {
-      struct PickResult
-      {
-        uint32_t vertid;
-        uint32_t idx;
-        float len;
-        float depth;
-      };
-
-      PickResult *pickResults = (PickResult *)(pickResultData + 4);
-
-      PickResult *closest = pickResults;
-
-      // min with size of results buffer to protect against overflows
-      for(uint32_t i = 1; i < RDCMIN((uint32_t)VertexPicking::MaxMeshPicks, numResults); i++)
-      {
-        // We need to keep the picking order consistent in the face
-        // of random buffer appends, when multiple vertices have the
-        // identical position (e.g. if UVs or normals are different).
-        //
-        // We could do something to try and disambiguate, but it's
-        // never going to be intuitive, it's just going to flicker
-        // confusingly.
-        if(pickResults[i].len < closest->len ||
-           (pickResults[i].len == closest->len && pickResults[i].depth < closest->depth) ||
-           (pickResults[i].len == closest->len && pickResults[i].depth == closest->depth &&
-            pickResults[i].vertid < closest->vertid))
-          closest = pickResults + i;
-      }
-      ret = closest->vertid;
-    }
-  }
-
-  m_VertexPick.ResultReadback.Unmap();
+  uint32_t ret = m_HighlightCache.PickVertex(w, h, cfg, x, y, true);
 
   VkMarkerRegion::Set(StringFormat::Fmt("Result is %u", ret));
 
@@ -1365,7 +924,6 @@ void VulkanReplay::CreateResources()
 
   RenderDoc::Inst().SetProgress(LoadProgress::DebugManagerInit, 0.6f);
 
-  m_VertexPick.Init(m_pDriver, m_General.DescriptorPool);
 
   RenderDoc::Inst().SetProgress(LoadProgress::DebugManagerInit, 0.7f);
 
@@ -1394,8 +952,6 @@ void VulkanReplay::CreateResources()
           {4, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 16, VK_SHADER_STAGE_COMPUTE_BIT, NULL},
       });
 
-  CREATE_OBJECT(m_MeshFetchDescSet, m_General.DescriptorPool, m_MeshFetchDescSetLayout);
-
   GPA_vkContextOpenInfo context = {Unwrap(m_pDriver->GetInstance()),
                                    Unwrap(m_pDriver->GetPhysDev()), Unwrap(m_pDriver->GetDev())};
 
@@ -1431,11 +987,15 @@ void VulkanReplay::DestroyResources()
   if(m_MeshFetchDescSetLayout != VK_NULL_HANDLE)
     m_pDriver->vkDestroyDescriptorSetLayout(m_pDriver->GetDev(), m_MeshFetchDescSetLayout, NULL);
 
+  for(VkDescriptorPool pool : m_MeshFetchDescPools)
+    m_pDriver->vkDestroyDescriptorPool(m_pDriver->GetDev(), pool, NULL);
+  m_MeshFetchDescPools.clear();
+  m_MeshFetchDescSets.clear();
+
   m_General.Destroy(m_pDriver);
   m_TexRender.Destroy(m_pDriver);
   m_Overlay.Destroy(m_pDriver);
   m_Checkerboard.Destroy(m_pDriver);
-  m_VertexPick.Destroy(m_pDriver);
   m_PixelPick.Destroy(m_pDriver);
   m_Histogram.Destroy(m_pDriver);
 
@@ -2058,73 +1618,6 @@ void VulkanReplay::MeshRendering::Destroy(WrappedVulkan *driver)
   driver->vkDestroyPipelineLayout(driver->GetDev(), PipeLayout, NULL);
 }
 
-void VulkanReplay::VertexPicking::Init(WrappedVulkan *driver, VkDescriptorPool descriptorPool)
-{
-  VulkanShaderCache *shaderCache = driver->GetShaderCache();
-
-  CREATE_OBJECT(DescSetLayout,
-                {
-                    {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL, NULL},
-                    {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, NULL},
-                    {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, NULL},
-                    {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, NULL},
-                });
-
-  CREATE_OBJECT(Layout, DescSetLayout, 0);
-  CREATE_OBJECT(DescSet, descriptorPool, DescSetLayout);
-
-  // sizes are always 0 so that these buffers are created on demand
-  IBSize = 0;
-  VBSize = 0;
-
-  UBO.Create(driver, driver->GetDev(), 128, 1, 0);
-  RDCCOMPILE_ASSERT(sizeof(MeshPickUBOData) <= 128, "mesh pick UBO size");
-
-  const size_t meshPickResultSize = MaxMeshPicks * sizeof(FloatVector) + sizeof(uint32_t);
-
-  Result.Create(driver, driver->GetDev(), meshPickResultSize, 1,
-                GPUBuffer::eGPUBufferGPULocal | GPUBuffer::eGPUBufferSSBO);
-  ResultReadback.Create(driver, driver->GetDev(), meshPickResultSize, 1,
-                        GPUBuffer::eGPUBufferReadback);
-
-  CREATE_OBJECT(Pipeline, Layout, shaderCache->GetBuiltinModule(BuiltinShader::MeshCS));
-
-  VkDescriptorBufferInfo vertexpickUBO = {};
-  VkDescriptorBufferInfo vertexpickResult = {};
-
-  UBO.FillDescriptor(vertexpickUBO);
-  Result.FillDescriptor(vertexpickResult);
-
-  VkWriteDescriptorSet writes[] = {
-      {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, Unwrap(DescSet), 0, 0, 1,
-       VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, NULL, &vertexpickUBO, NULL},
-      {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, Unwrap(DescSet), 3, 0, 1,
-       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, NULL, &vertexpickResult, NULL},
-  };
-
-  VkDevice dev = driver->GetDev();
-
-  ObjDisp(dev)->UpdateDescriptorSets(Unwrap(dev), ARRAY_COUNT(writes), writes, 0, NULL);
-}
-
-void VulkanReplay::VertexPicking::Destroy(WrappedVulkan *driver)
-{
-  if(DescSetLayout == VK_NULL_HANDLE)
-    return;
-
-  UBO.Destroy();
-  IB.Destroy();
-  IBUpload.Destroy();
-  VB.Destroy();
-  VBUpload.Destroy();
-  Result.Destroy();
-  ResultReadback.Destroy();
-
-  driver->vkDestroyDescriptorSetLayout(driver->GetDev(), DescSetLayout, NULL);
-  driver->vkDestroyPipelineLayout(driver->GetDev(), Layout, NULL);
-  driver->vkDestroyPipeline(driver->GetDev(), Pipeline, NULL);
-}
-
 void VulkanReplay::PixelPicking::Init(WrappedVulkan *driver, VkDescriptorPool descriptorPool)
 {
   VkResult vkr = VK_SUCCESS;
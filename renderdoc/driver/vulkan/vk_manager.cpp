@@ -39,6 +39,11 @@ bool VulkanResourceManager::SerialisableResource(ResourceId id, VkResourceRecord
 #define TRDBG(...)
 #endif
 
+void VulkanResourceManager::ReleaseDeferredDescriptorRefs(ResourceId id)
+{
+  m_Core->ReleaseDeferredDescriptorRefs(id);
+}
+
 template <typename SrcBarrierType>
 void VulkanResourceManager::RecordSingleBarrier(vector<pair<ResourceId, ImageRegionState> > &dststates,
                                                 ResourceId id, const SrcBarrierType &t,
@@ -261,8 +266,16 @@ void VulkanResourceManager::SerialiseImageStates(SerialiserType &ser,
 
   for(uint32_t i = 0; i < NumImages; i++)
   {
+    // while capturing, queue submits on other threads can be applying barriers to this image
+    ImageLayouts srcState;
+    if(ser.IsWriting())
+    {
+      SCOPED_SPINLOCK(srcit->second.lock);
+      srcState = srcit->second;
+    }
+
     SERIALISE_ELEMENT_LOCAL(Image, (ResourceId)(srcit->first)).TypedAs("VkImage");
-    SERIALISE_ELEMENT_LOCAL(ImageState, (ImageLayouts)(srcit->second));
+    SERIALISE_ELEMENT_LOCAL(ImageState, srcState);
 
     ResourceId liveid;
     if(IsReplayingAndReading() && HasLiveResource(Image))
@@ -320,6 +333,8 @@ void VulkanResourceManager::SerialiseImageStates(SerialiserType &ser,
   {
     ImageLayouts &layouts = it->second;
 
+    SCOPED_SPINLOCK(layouts.lock);
+
     if(layouts.subresourceStates.size() > 1 &&
        layouts.subresourceStates.size() == size_t(layouts.layerCount * layouts.levelCount))
     {
@@ -396,168 +411,224 @@ void VulkanResourceManager::ApplyBarriers(vector<pair<ResourceId, ImageRegionSta
       continue;
     }
 
-    uint32_t nummips = t.subresourceRange.levelCount;
-    uint32_t numslices = t.subresourceRange.layerCount;
-    if(nummips == VK_REMAINING_MIP_LEVELS)
-      nummips = layouts[id].levelCount;
-    if(numslices == VK_REMAINING_ARRAY_LAYERS)
-      numslices = layouts[id].layerCount;
+    ApplyBarrier(stit->second, t);
+  }
+}
 
-    if(nummips == 0)
-      nummips = 1;
-    if(numslices == 0)
-      numslices = 1;
+void VulkanResourceManager::ResolveBarrierLayouts(
+    const vector<pair<ResourceId, ImageRegionState> > &states,
+    map<ResourceId, ImageLayouts> &layouts, vector<ImageLayouts *> &resolved)
+{
+  resolved.resize(states.size());
 
-    if(t.oldLayout == t.newLayout)
+  for(size_t ti = 0; ti < states.size(); ti++)
+  {
+    // states are sorted by ID, so we only need to look up once per image
+    if(ti > 0 && states[ti].first == states[ti - 1].first)
+    {
+      resolved[ti] = resolved[ti - 1];
       continue;
+    }
 
-    TRDBG("Barrier of %s (%u->%u, %u->%u) from %s to %s", ToStr(t.subresourceRange.aspect).c_str(),
-          t.subresourceRange.baseMipLevel, t.subresourceRange.levelCount,
-          t.subresourceRange.baseArrayLayer, t.subresourceRange.layerCount,
-          ToStr(t.oldLayout).c_str(), ToStr(t.newLayout).c_str());
+    auto stit = layouts.find(states[ti].first);
+    resolved[ti] = stit == layouts.end() ? NULL : &stit->second;
+  }
+}
+
+void VulkanResourceManager::ApplyBarriers(const vector<pair<ResourceId, ImageRegionState> > &states,
+                                          const vector<ImageLayouts *> &resolved)
+{
+  TRDBG("Applying %u resolved barriers", (uint32_t)states.size());
 
-    bool done = false;
+  RDCASSERT(states.size() == resolved.size());
 
-    TRDBG("Matching image has %u subresource states", stit->second.subresourceStates.size());
+  size_t ti = 0;
+  while(ti < states.size())
+  {
+    ImageLayouts *layouts = resolved[ti];
 
-    auto it = stit->second.subresourceStates.begin();
-    for(; it != stit->second.subresourceStates.end(); ++it)
+    if(layouts == NULL)
     {
-      TRDBG(".. state %s (%u->%u, %u->%u) from %s to %s", ToStr(it->subresourceRange.aspect).c_str(),
-            it->range.baseMipLevel, it->range.levelCount, it->range.baseArrayLayer,
-            it->range.layerCount, ToStr(it->oldLayout).c_str(), ToStr(it->newLayout).c_str());
-
-      // image barriers are handled by initially inserting one subresource range for the whole
-      // object,
-      // and whenever we need more fine-grained detail we split it immediately.
-      // Thereafter if a barrier comes in that covers multiple subresources, we update all matching
-      // ranges.
-      // NOTE: Depth-stencil images must always be trasnsitioned together for both aspects, so we
-      // don't
-      // have to worry about different aspects being in different states and can in fact ignore the
-      // aspect
-      // for the purpose of this case.
+      TRDBG("Didn't find ID in image layouts");
+      ti++;
+      continue;
+    }
+
+    // lock each image once for the run of barriers that affect it. The barrier states themselves
+    // are shared by every submission of this command buffer so we apply a copy.
+    SCOPED_SPINLOCK(layouts->lock);
+
+    for(; ti < states.size() && resolved[ti] == layouts; ti++)
+    {
+      ImageRegionState t = states[ti].second;
+      ApplyBarrier(*layouts, t);
+    }
+  }
+}
+
+void VulkanResourceManager::ApplyBarrier(ImageLayouts &layouts, ImageRegionState &t)
+{
+  uint32_t nummips = t.subresourceRange.levelCount;
+  uint32_t numslices = t.subresourceRange.layerCount;
+  if(nummips == VK_REMAINING_MIP_LEVELS)
+    nummips = layouts.levelCount;
+  if(numslices == VK_REMAINING_ARRAY_LAYERS)
+    numslices = layouts.layerCount;
+
+  if(nummips == 0)
+    nummips = 1;
+  if(numslices == 0)
+    numslices = 1;
+
+  if(t.oldLayout == t.newLayout)
+    return;
+
+  TRDBG("Barrier of %s (%u->%u, %u->%u) from %s to %s", ToStr(t.subresourceRange.aspect).c_str(),
+        t.subresourceRange.baseMipLevel, t.subresourceRange.levelCount,
+        t.subresourceRange.baseArrayLayer, t.subresourceRange.layerCount,
+        ToStr(t.oldLayout).c_str(), ToStr(t.newLayout).c_str());
+
+  bool done = false;
 
+  TRDBG("Matching image has %u subresource states", layouts.subresourceStates.size());
+
+  auto it = layouts.subresourceStates.begin();
+  for(; it != layouts.subresourceStates.end(); ++it)
+  {
+    TRDBG(".. state %s (%u->%u, %u->%u) from %s to %s", ToStr(it->subresourceRange.aspect).c_str(),
+          it->range.baseMipLevel, it->range.levelCount, it->range.baseArrayLayer,
+          it->range.layerCount, ToStr(it->oldLayout).c_str(), ToStr(it->newLayout).c_str());
+
+    // image barriers are handled by initially inserting one subresource range for the whole
+    // object,
+    // and whenever we need more fine-grained detail we split it immediately.
+    // Thereafter if a barrier comes in that covers multiple subresources, we update all matching
+    // ranges.
+    // NOTE: Depth-stencil images must always be trasnsitioned together for both aspects, so we
+    // don't
+    // have to worry about different aspects being in different states and can in fact ignore the
+    // aspect
+    // for the purpose of this case.
+
+    {
+      // we've found a range that completely matches our region, doesn't matter if that's
+      // a whole image and the barrier is the whole image, or it's one subresource.
+      // note that for images with only one array/mip slice (e.g. render targets) we'll never
+      // really have to worry about the else{} branch
+      if(it->subresourceRange.baseMipLevel == t.subresourceRange.baseMipLevel &&
+         it->subresourceRange.levelCount == nummips &&
+         it->subresourceRange.baseArrayLayer == t.subresourceRange.baseArrayLayer &&
+         it->subresourceRange.layerCount == numslices)
+      {
+        /*
+        RDCASSERT(t.oldLayout == UNKNOWN_PREV_IMG_LAYOUT || it->newLayout ==
+        UNKNOWN_PREV_IMG_LAYOUT || // renderdoc untracked/ignored
+                  it->newLayout == t.oldLayout || // valid barrier
+                  t.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED); // can barrier from UNDEFINED to any
+        state
+        */
+        if(it->oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
+          it->oldLayout = t.oldLayout;
+        t.oldLayout = it->newLayout;
+        it->newLayout = t.newLayout;
+
+        done = true;
+        break;
+      }
+      else
       {
-        // we've found a range that completely matches our region, doesn't matter if that's
-        // a whole image and the barrier is the whole image, or it's one subresource.
-        // note that for images with only one array/mip slice (e.g. render targets) we'll never
-        // really have to worry about the else{} branch
-        if(it->subresourceRange.baseMipLevel == t.subresourceRange.baseMipLevel &&
-           it->subresourceRange.levelCount == nummips &&
-           it->subresourceRange.baseArrayLayer == t.subresourceRange.baseArrayLayer &&
-           it->subresourceRange.layerCount == numslices)
+        // this handles the case where the barrier covers a number of subresources and we need
+        // to update each matching subresource. If the barrier was only one mip & array slice
+        // it would have hit the case above. Find each subresource within the range, update it,
+        // and continue (marking as done so whenever we stop finding matching ranges, we are
+        // satisfied.
+        //
+        // note that regardless of how we lay out our subresources (slice-major or mip-major) the
+        // new
+        // range could be sparse, but that's OK as we only break out of the loop once we go past
+        // the whole
+        // aspect. Any subresources that don't match the range, after the split, will fail to meet
+        // any
+        // of the handled cases, so we'll just continue processing.
+        if(it->subresourceRange.levelCount == 1 && it->subresourceRange.layerCount == 1 &&
+           it->subresourceRange.baseMipLevel >= t.subresourceRange.baseMipLevel &&
+           it->subresourceRange.baseMipLevel < t.subresourceRange.baseMipLevel + nummips &&
+           it->subresourceRange.baseArrayLayer >= t.subresourceRange.baseArrayLayer &&
+           it->subresourceRange.baseArrayLayer < t.subresourceRange.baseArrayLayer + numslices)
         {
-          /*
-          RDCASSERT(t.oldLayout == UNKNOWN_PREV_IMG_LAYOUT || it->newLayout ==
-          UNKNOWN_PREV_IMG_LAYOUT || // renderdoc untracked/ignored
-                    it->newLayout == t.oldLayout || // valid barrier
-                    t.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED); // can barrier from UNDEFINED to any
-          state
-          */
+          // apply it (prevstate is from the start of all barriers accumulated, so only set once)
           if(it->oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
             it->oldLayout = t.oldLayout;
-          t.oldLayout = it->newLayout;
           it->newLayout = t.newLayout;
 
+          // continue as there might be more, but we're done
           done = true;
-          break;
+          continue;
         }
-        else
+        // finally handle the case where we have a range that covers a whole image but we need to
+        // split it. If the barrier covered the whole image too it would have hit the very first
+        // case, so we know that the barrier doesn't cover the whole range.
+        // Also, if we've already done the split this case won't be hit and we'll either fall into
+        // the case above, or we'll finish as we've covered the whole barrier.
+        else if(it->subresourceRange.levelCount > 1 || it->subresourceRange.layerCount > 1)
         {
-          // this handles the case where the barrier covers a number of subresources and we need
-          // to update each matching subresource. If the barrier was only one mip & array slice
-          // it would have hit the case above. Find each subresource within the range, update it,
-          // and continue (marking as done so whenever we stop finding matching ranges, we are
-          // satisfied.
-          //
-          // note that regardless of how we lay out our subresources (slice-major or mip-major) the
-          // new
-          // range could be sparse, but that's OK as we only break out of the loop once we go past
-          // the whole
-          // aspect. Any subresources that don't match the range, after the split, will fail to meet
-          // any
-          // of the handled cases, so we'll just continue processing.
-          if(it->subresourceRange.levelCount == 1 && it->subresourceRange.layerCount == 1 &&
-             it->subresourceRange.baseMipLevel >= t.subresourceRange.baseMipLevel &&
+          ImageRegionState existing = *it;
+
+          // remember where we were in the array, as after this iterators will be
+          // invalidated.
+          size_t offs = it - layouts.subresourceStates.begin();
+          size_t count = it->subresourceRange.levelCount * it->subresourceRange.layerCount;
+
+          // only insert count-1 as we want count entries total - one per subresource
+          layouts.subresourceStates.insert(it, count - 1, existing);
+
+          // it now points at the first subresource, but we need to modify the ranges
+          // to be valid
+          it = layouts.subresourceStates.begin() + offs;
+
+          for(size_t i = 0; i < count; i++)
+          {
+            it->subresourceRange.levelCount = 1;
+            it->subresourceRange.layerCount = 1;
+
+            // slice-major
+            it->subresourceRange.baseArrayLayer =
+                uint32_t(i / existing.subresourceRange.levelCount);
+            it->subresourceRange.baseMipLevel = uint32_t(i % existing.subresourceRange.levelCount);
+            it++;
+          }
+
+          // reset the iterator to point to the first subresource
+          it = layouts.subresourceStates.begin() + offs;
+
+          // the loop will continue after this point and look at the next subresources
+          // so we need to check to see if the first subresource lies in the range here
+          if(it->subresourceRange.baseMipLevel >= t.subresourceRange.baseMipLevel &&
              it->subresourceRange.baseMipLevel < t.subresourceRange.baseMipLevel + nummips &&
              it->subresourceRange.baseArrayLayer >= t.subresourceRange.baseArrayLayer &&
              it->subresourceRange.baseArrayLayer < t.subresourceRange.baseArrayLayer + numslices)
           {
-            // apply it (prevstate is from the start of all barriers accumulated, so only set once)
+            // apply it (prevstate is from the start of all barriers accumulated, so only set
+            // once)
             if(it->oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
               it->oldLayout = t.oldLayout;
             it->newLayout = t.newLayout;
 
             // continue as there might be more, but we're done
             done = true;
-            continue;
-          }
-          // finally handle the case where we have a range that covers a whole image but we need to
-          // split it. If the barrier covered the whole image too it would have hit the very first
-          // case, so we know that the barrier doesn't cover the whole range.
-          // Also, if we've already done the split this case won't be hit and we'll either fall into
-          // the case above, or we'll finish as we've covered the whole barrier.
-          else if(it->subresourceRange.levelCount > 1 || it->subresourceRange.layerCount > 1)
-          {
-            ImageRegionState existing = *it;
-
-            // remember where we were in the array, as after this iterators will be
-            // invalidated.
-            size_t offs = it - stit->second.subresourceStates.begin();
-            size_t count = it->subresourceRange.levelCount * it->subresourceRange.layerCount;
-
-            // only insert count-1 as we want count entries total - one per subresource
-            stit->second.subresourceStates.insert(it, count - 1, existing);
-
-            // it now points at the first subresource, but we need to modify the ranges
-            // to be valid
-            it = stit->second.subresourceStates.begin() + offs;
-
-            for(size_t i = 0; i < count; i++)
-            {
-              it->subresourceRange.levelCount = 1;
-              it->subresourceRange.layerCount = 1;
-
-              // slice-major
-              it->subresourceRange.baseArrayLayer =
-                  uint32_t(i / existing.subresourceRange.levelCount);
-              it->subresourceRange.baseMipLevel = uint32_t(i % existing.subresourceRange.levelCount);
-              it++;
-            }
-
-            // reset the iterator to point to the first subresource
-            it = stit->second.subresourceStates.begin() + offs;
-
-            // the loop will continue after this point and look at the next subresources
-            // so we need to check to see if the first subresource lies in the range here
-            if(it->subresourceRange.baseMipLevel >= t.subresourceRange.baseMipLevel &&
-               it->subresourceRange.baseMipLevel < t.subresourceRange.baseMipLevel + nummips &&
-               it->subresourceRange.baseArrayLayer >= t.subresourceRange.baseArrayLayer &&
-               it->subresourceRange.baseArrayLayer < t.subresourceRange.baseArrayLayer + numslices)
-            {
-              // apply it (prevstate is from the start of all barriers accumulated, so only set
-              // once)
-              if(it->oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
-                it->oldLayout = t.oldLayout;
-              it->newLayout = t.newLayout;
-
-              // continue as there might be more, but we're done
-              done = true;
-            }
-
-            // continue processing from here
-            continue;
           }
+
+          // continue processing from here
+          continue;
         }
       }
-
-      // otherwise continue to try and find the subresource range
     }
 
-    if(!done)
-      RDCERR("Couldn't find subresource range to apply barrier to - invalid!");
+    // otherwise continue to try and find the subresource range
   }
+
+  if(!done)
+    RDCERR("Couldn't find subresource range to apply barrier to - invalid!");
 }
 
 bool VulkanResourceManager::Force_InitialState(WrappedVkRes *res, bool prepare)
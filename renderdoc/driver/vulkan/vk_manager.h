@@ -256,6 +256,18 @@ public:
   void ApplyBarriers(vector<pair<ResourceId, ImageRegionState> > &states,
                      map<ResourceId, ImageLayouts> &layouts);
 
+  // looks up the tracked layouts for each image in a list of barriers, so that they can be applied
+  // later without looking up (and locking) the whole layouts map. Must be called with the layouts
+  // lock held, and the pointers are only valid as long as the images are alive.
+  void ResolveBarrierLayouts(const vector<pair<ResourceId, ImageRegionState> > &states,
+                             map<ResourceId, ImageLayouts> &layouts,
+                             vector<ImageLayouts *> &resolved);
+
+  // applies barriers to layouts previously resolved by ResolveBarrierLayouts, taking only each
+  // image's own lock.
+  void ApplyBarriers(const vector<pair<ResourceId, ImageRegionState> > &states,
+                     const vector<ImageLayouts *> &resolved);
+
   template <typename SerialiserType>
   void SerialiseImageStates(SerialiserType &ser, std::map<ResourceId, ImageLayouts> &states,
                             std::vector<VkImageMemoryBarrier> &barriers);
@@ -371,6 +383,11 @@ public:
         record->pooledChildren.clear();
       }
 
+      // this covers vkFreeDescriptorSets as well as sets freed by resetting or destroying their
+      // pool
+      if(record->descInfo && record->descInfo->bindRefsDeferred)
+        ReleaseDeferredDescriptorRefs(id);
+
       record->Delete(this);
     }
     if(clearID)
@@ -405,7 +422,12 @@ public:
   // helper for sparse mappings
   void MarkSparseMapReferenced(SparseMapping *sparse);
 
+  // stop tracking a descriptor set that's being freed as having deferred bind refs
+  void ReleaseDeferredDescriptorRefs(ResourceId id);
+
 private:
+  void ApplyBarrier(ImageLayouts &layouts, ImageRegionState &t);
+
   bool SerialisableResource(ResourceId id, VkResourceRecord *record);
 
   bool ResourceTypeRelease(WrappedVkRes *res);
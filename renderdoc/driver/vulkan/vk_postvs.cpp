@@ -1102,8 +1102,16 @@ void VulkanReplay::ClearPostVSCache()
 {
   VkDevice dev = m_Device;
 
+  // draws fetched together share one output buffer, so only destroy each buffer once
+  std::set<VkBuffer> destroyed;
+
   for(auto it = m_PostVSData.begin(); it != m_PostVSData.end(); ++it)
   {
+    if(it->second.vsout.buf == VK_NULL_HANDLE || destroyed.count(it->second.vsout.buf))
+      continue;
+
+    destroyed.insert(it->second.vsout.buf);
+
     m_pDriver->vkDestroyBuffer(dev, it->second.vsout.buf, NULL);
     m_pDriver->vkFreeMemory(dev, it->second.vsout.bufmem, NULL);
   }
@@ -1111,162 +1119,579 @@ void VulkanReplay::ClearPostVSCache()
   m_PostVSData.clear();
 }
 
-void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
+// reads back arbitrary ranges of buffers with a single submission. Overlapping or adjacent ranges
+// of the same buffer are merged, so e.g. many draws sourcing from one large vertex buffer only read
+// it once.
+class VulkanBatchedReadback
 {
-  // go through any aliasing
-  if(m_PostVSAlias.find(eventId) != m_PostVSAlias.end())
-    eventId = m_PostVSAlias[eventId];
+public:
+  VulkanBatchedReadback(WrappedVulkan *driver, VulkanCreationInfo &creationInfo)
+      : m_pDriver(driver), m_CreationInfo(creationInfo)
+  {
+  }
+  ~VulkanBatchedReadback() { Release(); }
+  // returns an index to look up the data with once Execute() has been called. Ranges are clamped to
+  // the buffer's size the same as GetBufferData.
+  size_t Add(ResourceId buf, VkDeviceSize offset, VkDeviceSize len)
+  {
+    Request req = {buf, offset, 0, 0};
 
-  if(m_PostVSData.find(eventId) != m_PostVSData.end())
-    return;
+    VkDeviceSize bufsize = m_CreationInfo.m_Buffer[buf].size;
 
-  const VulkanRenderState &state = m_pDriver->m_RenderState;
-  VulkanCreationInfo &creationInfo = m_pDriver->m_CreationInfo;
+    if(m_pDriver->GetResourceManager()->GetCurrentHandle<VkBuffer>(buf) == VK_NULL_HANDLE)
+      RDCERR("Getting buffer data for unknown buffer %llu!", buf);
+    else if(offset < bufsize)
+      req.size = RDCMIN(len, bufsize - offset);
 
-  if(state.graphics.pipeline == ResourceId() || state.renderPass == ResourceId())
-    return;
+    m_Requests.push_back(req);
+    return m_Requests.size() - 1;
+  }
 
-  const VulkanCreationInfo::Pipeline &pipeInfo = creationInfo.m_Pipeline[state.graphics.pipeline];
+  void Execute()
+  {
+    // sort the requests by buffer then offset, and merge them into regions to copy
+    std::vector<size_t> order;
+    for(size_t i = 0; i < m_Requests.size(); i++)
+      if(m_Requests[i].size > 0)
+        order.push_back(i);
+
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+      const Request &ra = m_Requests[a];
+      const Request &rb = m_Requests[b];
+      if(ra.buf != rb.buf)
+        return ra.buf < rb.buf;
+      return ra.offset < rb.offset;
+    });
+
+    std::vector<Region> regions;
+
+    for(size_t i : order)
+    {
+      Request &req = m_Requests[i];
 
-  if(pipeInfo.shaders[0].module == ResourceId())
-    return;
+      if(regions.empty() || regions.back().buf != req.buf ||
+         regions.back().offset + regions.back().size < req.offset)
+      {
+        Region region = {req.buf, req.offset, req.size, 0};
+        if(!regions.empty())
+          region.dstOffset = AlignUp16(regions.back().dstOffset + regions.back().size);
+        regions.push_back(region);
+      }
+      else
+      {
+        Region &region = regions.back();
+        region.size = RDCMAX(region.size, req.offset + req.size - region.offset);
+      }
+
+      req.dstOffset = regions.back().dstOffset + (req.offset - regions.back().offset);
+    }
+
+    if(regions.empty())
+      return;
+
+    VkDevice dev = m_pDriver->GetDev();
+    VkResult vkr = VK_SUCCESS;
+
+    VkBufferCreateInfo bufInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        NULL,
+        0,
+        regions.back().dstOffset + regions.back().size,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    };
+
+    vkr = m_pDriver->vkCreateBuffer(dev, &bufInfo, NULL, &m_Buf);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    VkMemoryRequirements mrq = {0};
+    m_pDriver->vkGetBufferMemoryRequirements(dev, m_Buf, &mrq);
+
+    VkMemoryAllocateInfo allocInfo = {
+        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, mrq.size,
+        m_pDriver->GetReadbackMemoryIndex(mrq.memoryTypeBits),
+    };
+
+    vkr = m_pDriver->vkAllocateMemory(dev, &allocInfo, NULL, &m_Mem);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    vkr = m_pDriver->vkBindBufferMemory(dev, m_Buf, m_Mem, 0);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    VkCommandBuffer cmd = m_pDriver->GetNextCmd();
+
+    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
+                                          VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
 
-  const VulkanCreationInfo::ShaderModule &moduleInfo =
-      creationInfo.m_ShaderModule[pipeInfo.shaders[0].module];
+    vkr = ObjDisp(dev)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-  ShaderReflection *refl = pipeInfo.shaders[0].refl;
+    // wait for previous writes to happen before we copy
+    VkMemoryBarrier memBarrier = {
+        VK_STRUCTURE_TYPE_MEMORY_BARRIER, NULL, VK_ACCESS_ALL_WRITE_BITS,
+        VK_ACCESS_TRANSFER_READ_BIT,
+    };
+
+    DoPipelineBarrier(cmd, 1, &memBarrier);
+
+    for(const Region &region : regions)
+    {
+      VkBuffer src = m_pDriver->GetResourceManager()->GetCurrentHandle<VkBuffer>(region.buf);
 
-  // no outputs from this shader? unexpected but theoretically possible (dummy VS before
-  // tessellation maybe). Just fill out an empty data set
-  if(refl->outputSignature.empty())
+      VkBufferCopy copy = {region.offset, region.dstOffset, region.size};
+      ObjDisp(dev)->CmdCopyBuffer(Unwrap(cmd), Unwrap(src), Unwrap(m_Buf), 1, &copy);
+    }
+
+    memBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    memBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+    // wait for the copies to finish before we read
+    DoPipelineBarrier(cmd, 1, &memBarrier);
+
+    vkr = ObjDisp(dev)->EndCommandBuffer(Unwrap(cmd));
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    m_pDriver->SubmitCmds();
+    m_pDriver->FlushQ();
+
+    vkr = m_pDriver->vkMapMemory(dev, m_Mem, 0, VK_WHOLE_SIZE, 0, (void **)&m_Data);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
+
+  const byte *Data(size_t idx) const
   {
-    // empty vertex output signature
-    m_PostVSData[eventId].vsin.topo = pipeInfo.topology;
-    m_PostVSData[eventId].vsout.buf = VK_NULL_HANDLE;
-    m_PostVSData[eventId].vsout.instStride = 0;
-    m_PostVSData[eventId].vsout.vertStride = 0;
-    m_PostVSData[eventId].vsout.nearPlane = 0.0f;
-    m_PostVSData[eventId].vsout.farPlane = 0.0f;
-    m_PostVSData[eventId].vsout.useIndices = false;
-    m_PostVSData[eventId].vsout.hasPosOut = false;
-    m_PostVSData[eventId].vsout.idxBuf = ResourceId();
+    return m_Data && m_Requests[idx].size > 0 ? m_Data + m_Requests[idx].dstOffset : NULL;
+  }
+  size_t Size(size_t idx) const { return m_Data ? (size_t)m_Requests[idx].size : 0; }
+  void Release()
+  {
+    VkDevice dev = m_pDriver->GetDev();
 
-    m_PostVSData[eventId].vsout.topo = pipeInfo.topology;
+    if(m_Data)
+      m_pDriver->vkUnmapMemory(dev, m_Mem);
+    m_Data = NULL;
 
-    return;
+    m_pDriver->vkDestroyBuffer(dev, m_Buf, NULL);
+    m_pDriver->vkFreeMemory(dev, m_Mem, NULL);
+    m_Buf = VK_NULL_HANDLE;
+    m_Mem = VK_NULL_HANDLE;
+
+    m_Requests.clear();
+  }
+
+private:
+  struct Request
+  {
+    ResourceId buf;
+    VkDeviceSize offset, size, dstOffset;
+  };
+
+  struct Region
+  {
+    ResourceId buf;
+    VkDeviceSize offset, size, dstOffset;
+  };
+
+  WrappedVulkan *m_pDriver;
+  VulkanCreationInfo &m_CreationInfo;
+  std::vector<Request> m_Requests;
+
+  VkBuffer m_Buf = VK_NULL_HANDLE;
+  VkDeviceMemory m_Mem = VK_NULL_HANDLE;
+  byte *m_Data = NULL;
+};
+
+// compacts one vertex attribute into a tightly packed array of a format that can be read as a
+// texel buffer, upcasting the data if the original format isn't natively supported.
+static void CompactVertexAttribute(const byte *src, const byte *srcEnd, size_t stride, byte *dst,
+                                   const byte *dstEnd, VkFormat origFormat, VkFormat expandedFormat,
+                                   uint32_t elemSize)
+{
+  // used for interpreting the original data, if we're upcasting
+  ResourceFormat fmt = MakeResourceFormat(origFormat);
+
+  // fast memcpy compaction case for natively supported texel buffer formats
+  if(origFormat == expandedFormat)
+  {
+    while(src < srcEnd && dst < dstEnd)
+    {
+      memcpy(dst, src, elemSize);
+      dst += elemSize;
+      src += stride;
+    }
+  }
+  else
+  {
+    uint32_t zero = 0;
+
+    // upcasting path
+    if(IsDoubleFormat(origFormat))
+    {
+      while(src < srcEnd && dst < dstEnd)
+      {
+        // the double is already in "packed uvec2" order, with least significant 32-bits
+        // first, so we can copy directly
+        memcpy(dst, src, sizeof(double) * fmt.compCount);
+        dst += sizeof(double) * fmt.compCount;
+
+        // fill up to *8* zeros not 4, since we're filling two for every component
+        for(uint8_t c = fmt.compCount * 2; c < 8; c++)
+        {
+          memcpy(dst, &zero, sizeof(uint32_t));
+          dst += sizeof(uint32_t);
+        }
+
+        src += stride;
+      }
+    }
+    else if(IsUIntFormat(expandedFormat))
+    {
+      while(src < srcEnd && dst < dstEnd)
+      {
+        uint32_t val = 0;
+
+        const byte *s = src;
+
+        uint8_t c = 0;
+        for(; c < fmt.compCount; c++)
+        {
+          if(fmt.compByteWidth == 1)
+            val = *s;
+          else if(fmt.compByteWidth == 2)
+            val = *(uint16_t *)s;
+          else if(fmt.compByteWidth == 4)
+            val = *(uint32_t *)s;
+
+          memcpy(dst, &val, sizeof(uint32_t));
+          dst += sizeof(uint32_t);
+          s += fmt.compByteWidth;
+        }
+
+        for(; c < 4; c++)
+        {
+          memcpy(dst, &zero, sizeof(uint32_t));
+          dst += sizeof(uint32_t);
+        }
+
+        src += stride;
+      }
+    }
+    else if(IsSIntFormat(expandedFormat))
+    {
+      while(src < srcEnd && dst < dstEnd)
+      {
+        int32_t val = 0;
+
+        const byte *s = src;
+
+        uint8_t c = 0;
+        for(; c < fmt.compCount; c++)
+        {
+          if(fmt.compByteWidth == 1)
+            val = *(int8_t *)s;
+          else if(fmt.compByteWidth == 2)
+            val = *(int16_t *)s;
+          else if(fmt.compByteWidth == 4)
+            val = *(int32_t *)s;
+
+          memcpy(dst, &val, sizeof(int32_t));
+          dst += sizeof(int32_t);
+          s += fmt.compByteWidth;
+        }
+
+        for(; c < 4; c++)
+        {
+          memcpy(dst, &zero, sizeof(uint32_t));
+          dst += sizeof(uint32_t);
+        }
+
+        src += stride;
+      }
+    }
+    else
+    {
+      while(src < srcEnd && dst < dstEnd)
+      {
+        bool valid = false;
+        FloatVector vec = HighlightCache::InterpretVertex(src, 0, 0, fmt, srcEnd, valid);
+
+        memcpy(dst, &vec, sizeof(FloatVector));
+        dst += sizeof(FloatVector);
+        src += stride;
+      }
+    }
   }
+}
+
+struct VulkanPostVSDraw
+{
+  VulkanPostVSDraw(uint32_t eid, const VulkanRenderState &st) : eventId(eid), state(st) {}
+  uint32_t eventId;
+  VulkanRenderState state;
+  const DrawcallDescription *drawcall = NULL;
+
+  std::vector<VkVertexInputBindingDescription> vbinds;
+  std::vector<VkVertexInputAttributeDescription> vattrs;
+  VkPrimitiveTopology topo = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+
+  uint32_t idxsize = 0;
+  uint32_t maxIdx = 0;
+  size_t idxRead = ~0U;
+  std::vector<size_t> vbRead;
+
+  uint32_t numVerts = 0;
+  uint64_t numFetchVerts = 0;
+  int32_t baseVertex = 0;
+  uint32_t minIndex = 0, maxIndex = 0, maxInstance = 0;
+  std::vector<uint32_t> indices;
+
+  // the compacted inputs, suballocated from the shared upload buffer
+  struct Attribute
+  {
+    uint32_t location;
+    uint32_t binding;
+    VkFormat origFormat, expandedFormat;
+    uint32_t elemSize;
+    const byte *src, *srcEnd;
+    size_t stride;
+    VkDeviceSize offset, size;
+    VkBufferView view;
+  };
+  std::vector<Attribute> attrs;
+  std::vector<uint32_t> attrInstDivisor;
+
+  VkDeviceSize idxOffset = 0;
+  VkBufferView idxView = VK_NULL_HANDLE;
+
+  std::vector<uint32_t> modSpirv;
+  uint32_t descSet = 0, bufStride = 0;
+
+  VkPipelineLayout pipeLayout = VK_NULL_HANDLE;
+  VkShaderModule module = VK_NULL_HANDLE;
+  VkPipeline pipe = VK_NULL_HANDLE;
 
-  const DrawcallDescription *drawcall = m_pDriver->GetDrawcall(eventId);
+  VkDeviceSize outOffset = 0, outSize = 0;
+};
+
+void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
+{
+  std::vector<VulkanPostVSDraw> draws;
+  draws.push_back(VulkanPostVSDraw(eventId, m_pDriver->m_RenderState));
 
-  if(drawcall == NULL || drawcall->numIndices == 0 || drawcall->numInstances == 0)
+  FetchPostVSBuffers(draws);
+}
+
+void VulkanReplay::GetMeshFetchDescSets(uint32_t count)
+{
+  if(m_MeshFetchDescSets.size() >= count)
     return;
 
-  // the SPIR-V patching will determine the next descriptor set to use, after all sets statically
-  // used by the shader. This gets around the problem where the shader only uses 0 and 1, but the
-  // layout declares 0-4, and 2,3,4 are invalid at bind time and we are unable to bind our new set
-  // 5. Instead we'll notice that only 0 and 1 are used and just use 2 ourselves (although it was
-  // in
-  // the original set layout, we know it's statically unused by the shader so we can safely steal
-  // it).
-  uint32_t descSet = 0;
+  // grow by at least double to avoid creating many small pools
+  uint32_t newSets = RDCMAX(count - (uint32_t)m_MeshFetchDescSets.size(),
+                            RDCMAX(16U, (uint32_t)m_MeshFetchDescSets.size()));
+
+  VkDescriptorPoolSize poolSizes[] = {
+      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, newSets},
+      {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, newSets * (1 + 3 * MeshOutputTBufferArraySize)},
+  };
+
+  VkDescriptorPoolCreateInfo poolInfo = {
+      VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      NULL,
+      0,
+      newSets,
+      ARRAY_COUNT(poolSizes),
+      &poolSizes[0],
+  };
+
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  VkResult vkr = m_pDriver->vkCreateDescriptorPool(m_Device, &poolInfo, NULL, &pool);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  m_MeshFetchDescPools.push_back(pool);
+
+  std::vector<VkDescriptorSetLayout> layouts(newSets, m_MeshFetchDescSetLayout);
+
+  VkDescriptorSetAllocateInfo allocInfo = {
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, NULL, pool, newSets, layouts.data(),
+  };
+
+  size_t prevSize = m_MeshFetchDescSets.size();
+  m_MeshFetchDescSets.resize(prevSize + newSets);
+
+  vkr = m_pDriver->vkAllocateDescriptorSets(m_Device, &allocInfo, &m_MeshFetchDescSets[prevSize]);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+}
+
+void VulkanReplay::FetchPostVSBuffers(std::vector<VulkanPostVSDraw> &allDraws)
+{
+  VulkanCreationInfo &creationInfo = m_pDriver->m_CreationInfo;
 
   // we go through the driver for all these creations since they need to be properly
   // registered in order to be put in the partial replay state
   VkResult vkr = VK_SUCCESS;
   VkDevice dev = m_Device;
 
-  VkPipelineLayout pipeLayout;
+  const VkPhysicalDeviceLimits &limits = m_pDriver->GetDeviceProps().limits;
 
-  VkGraphicsPipelineCreateInfo pipeCreateInfo;
+  std::vector<VulkanPostVSDraw *> draws;
 
-  // get pipeline create info
-  m_pDriver->GetShaderCache()->MakeGraphicsPipelineInfo(pipeCreateInfo, state.graphics.pipeline);
+  VulkanBatchedReadback idxReadback(m_pDriver, creationInfo);
 
-  VkBuffer meshBuffer = VK_NULL_HANDLE, readbackBuffer = VK_NULL_HANDLE;
-  VkDeviceMemory meshMem = VK_NULL_HANDLE, readbackMem = VK_NULL_HANDLE;
+  for(VulkanPostVSDraw &d : allDraws)
+  {
+    // go through any aliasing
+    if(m_PostVSAlias.find(d.eventId) != m_PostVSAlias.end())
+      d.eventId = m_PostVSAlias[d.eventId];
 
-  VkBuffer uniqIdxBuf = VK_NULL_HANDLE;
-  VkDeviceMemory uniqIdxBufMem = VK_NULL_HANDLE;
-  VkBufferView uniqIdxBufView = VK_NULL_HANDLE;
+    if(m_PostVSData.find(d.eventId) != m_PostVSData.end())
+      continue;
 
-  uint32_t numVerts = drawcall->numIndices;
-  uint64_t numFetchVerts = drawcall->numIndices;
-  VkDeviceSize bufSize = 0;
+    const VulkanRenderState &state = d.state;
 
-  uint32_t idxsize = state.ibuffer.bytewidth;
+    if(state.graphics.pipeline == ResourceId() || state.renderPass == ResourceId())
+      continue;
 
-  int32_t baseVertex = 0;
+    const VulkanCreationInfo::Pipeline &pipeInfo = creationInfo.m_Pipeline[state.graphics.pipeline];
 
-  uint32_t minIndex = 0, maxIndex = RDCMAX(drawcall->baseVertex, 0) + numVerts - 1;
+    if(pipeInfo.shaders[0].module == ResourceId())
+      continue;
 
-  uint32_t maxInstance = drawcall->instanceOffset + drawcall->numInstances - 1;
+    ShaderReflection *refl = pipeInfo.shaders[0].refl;
 
-  if(drawcall->flags & DrawFlags::UseIBuffer)
-  {
-    bool index16 = (idxsize == 2);
-    bytebuf idxdata;
-    std::vector<uint32_t> indices;
-    uint16_t *idx16 = NULL;
-    uint32_t *idx32 = NULL;
-
-    // fetch ibuffer
-    GetBufferData(state.ibuffer.buf, state.ibuffer.offs + drawcall->indexOffset * idxsize,
-                  uint64_t(drawcall->numIndices) * idxsize, idxdata);
-
-    // figure out what the maximum index could be, so we can clamp our index buffer to something
-    // sane
-    uint32_t maxIdx = 0;
-
-    // if there are no active bindings assume the vertex shader is generating its own data
-    // and don't clamp the indices
-    if(pipeCreateInfo.pVertexInputState->vertexBindingDescriptionCount == 0)
-      maxIdx = ~0U;
-
-    for(uint32_t b = 0; b < pipeCreateInfo.pVertexInputState->vertexBindingDescriptionCount; b++)
+    // no outputs from this shader? unexpected but theoretically possible (dummy VS before
+    // tessellation maybe). Just fill out an empty data set
+    if(refl->outputSignature.empty())
+    {
+      // empty vertex output signature
+      m_PostVSData[d.eventId].vsin.topo = pipeInfo.topology;
+      m_PostVSData[d.eventId].vsout.buf = VK_NULL_HANDLE;
+      m_PostVSData[d.eventId].vsout.instStride = 0;
+      m_PostVSData[d.eventId].vsout.vertStride = 0;
+      m_PostVSData[d.eventId].vsout.nearPlane = 0.0f;
+      m_PostVSData[d.eventId].vsout.farPlane = 0.0f;
+      m_PostVSData[d.eventId].vsout.useIndices = false;
+      m_PostVSData[d.eventId].vsout.hasPosOut = false;
+      m_PostVSData[d.eventId].vsout.idxBuf = ResourceId();
+
+      m_PostVSData[d.eventId].vsout.topo = pipeInfo.topology;
+
+      continue;
+    }
+
+    d.drawcall = m_pDriver->GetDrawcall(d.eventId);
+
+    if(d.drawcall == NULL || d.drawcall->numIndices == 0 || d.drawcall->numInstances == 0)
+      continue;
+
+    // the same event could be listed twice, e.g. through an alias. Only fetch it once
+    bool duplicate = false;
+    for(VulkanPostVSDraw *other : draws)
+      duplicate |= (other->eventId == d.eventId);
+    if(duplicate)
+      continue;
+
+    const DrawcallDescription *drawcall = d.drawcall;
+
+    // get pipeline create info. This is only valid until the next call, so copy what we need
+    VkGraphicsPipelineCreateInfo pipeCreateInfo;
+    m_pDriver->GetShaderCache()->MakeGraphicsPipelineInfo(pipeCreateInfo, state.graphics.pipeline);
+
+    const VkPipelineVertexInputStateCreateInfo *vi = pipeCreateInfo.pVertexInputState;
+
+    d.vbinds.assign(vi->pVertexBindingDescriptions,
+                    vi->pVertexBindingDescriptions + vi->vertexBindingDescriptionCount);
+    d.vattrs.assign(vi->pVertexAttributeDescriptions,
+                    vi->pVertexAttributeDescriptions + vi->vertexAttributeDescriptionCount);
+    d.topo = pipeCreateInfo.pInputAssemblyState->topology;
+
+    d.numVerts = drawcall->numIndices;
+    d.numFetchVerts = drawcall->numIndices;
+    d.idxsize = state.ibuffer.bytewidth;
+    d.minIndex = 0;
+    d.maxIndex = RDCMAX(drawcall->baseVertex, 0) + d.numVerts - 1;
+    d.maxInstance = drawcall->instanceOffset + drawcall->numInstances - 1;
+
+    if(drawcall->flags & DrawFlags::UseIBuffer)
     {
-      const VkVertexInputBindingDescription &input =
-          pipeCreateInfo.pVertexInputState->pVertexBindingDescriptions[b];
-      // only vertex inputs (not instance inputs) count
-      if(input.inputRate == VK_VERTEX_INPUT_RATE_VERTEX)
+      // fetch ibuffer
+      d.idxRead = idxReadback.Add(state.ibuffer.buf,
+                                  state.ibuffer.offs + drawcall->indexOffset * d.idxsize,
+                                  uint64_t(drawcall->numIndices) * d.idxsize);
+
+      // figure out what the maximum index could be, so we can clamp our index buffer to something
+      // sane
+      d.maxIdx = 0;
+
+      // if there are no active bindings assume the vertex shader is generating its own data
+      // and don't clamp the indices
+      if(d.vbinds.empty())
+        d.maxIdx = ~0U;
+
+      for(uint32_t b = 0; b < d.vbinds.size(); b++)
       {
-        if(b >= state.vbuffers.size())
-          continue;
+        const VkVertexInputBindingDescription &input = d.vbinds[b];
+        // only vertex inputs (not instance inputs) count
+        if(input.inputRate == VK_VERTEX_INPUT_RATE_VERTEX)
+        {
+          if(b >= state.vbuffers.size())
+            continue;
 
-        ResourceId buf = state.vbuffers[b].buf;
-        VkDeviceSize offs = state.vbuffers[b].offs;
+          ResourceId buf = state.vbuffers[b].buf;
+          VkDeviceSize offs = state.vbuffers[b].offs;
 
-        VkDeviceSize bufsize = creationInfo.m_Buffer[buf].size;
+          VkDeviceSize bufsize = creationInfo.m_Buffer[buf].size;
 
-        // the maximum valid index on this particular input is the one that reaches
-        // the end of the buffer. The maximum valid index at all is the one that reads
-        // off the end of ALL buffers (so we max it with any other maxindex value
-        // calculated).
-        if(input.stride > 0)
-          maxIdx = RDCMAX(maxIdx, uint32_t((bufsize - offs) / input.stride));
+          // the maximum valid index on this particular input is the one that reaches
+          // the end of the buffer. The maximum valid index at all is the one that reads
+          // off the end of ALL buffers (so we max it with any other maxindex value
+          // calculated).
+          if(input.stride > 0)
+            d.maxIdx = RDCMAX(d.maxIdx, uint32_t((bufsize - offs) / input.stride));
+        }
       }
+
+      // in case the vertex buffers were set but had invalid stride (0), max with the number
+      // of vertices too. This is fine since the max here is just a conservative limit
+      d.maxIdx = RDCMAX(d.maxIdx, drawcall->numIndices);
     }
 
-    // in case the vertex buffers were set but had invalid stride (0), max with the number
-    // of vertices too. This is fine since the max here is just a conservative limit
-    maxIdx = RDCMAX(maxIdx, drawcall->numIndices);
+    draws.push_back(&d);
+  }
 
-    // do ibuffer rebasing/remapping
+  if(draws.empty())
+    return;
 
-    idx16 = (uint16_t *)&idxdata[0];
-    idx32 = (uint32_t *)&idxdata[0];
+  // read back every index buffer at once, then do the rebasing/remapping across all cores
+  idxReadback.Execute();
+
+  Threading::ParallelFor((uint32_t)draws.size(), [&draws, &idxReadback](uint32_t i) {
+    VulkanPostVSDraw &d = *draws[i];
+    const DrawcallDescription *drawcall = d.drawcall;
+
+    if(!(drawcall->flags & DrawFlags::UseIBuffer))
+      return;
+
+    bool index16 = (d.idxsize == 2);
+    const byte *idxdata = idxReadback.Data(d.idxRead);
+    size_t idxdataSize = idxReadback.Size(d.idxRead);
+    const uint16_t *idx16 = (const uint16_t *)idxdata;
+    const uint32_t *idx32 = (const uint32_t *)idxdata;
 
     // only read as many indices as were available in the buffer
     uint32_t numIndices =
-        RDCMIN(uint32_t(index16 ? idxdata.size() / 2 : idxdata.size() / 4), drawcall->numIndices);
+        RDCMIN(uint32_t(index16 ? idxdataSize / 2 : idxdataSize / 4), drawcall->numIndices);
 
     uint32_t idxclamp = 0;
     if(drawcall->baseVertex < 0)
       idxclamp = uint32_t(-drawcall->baseVertex);
 
-    // grab all unique vertex indices referenced
-    for(uint32_t i = 0; i < numIndices; i++)
+    std::vector<uint32_t> rebasedIndices;
+    rebasedIndices.resize(numIndices);
+
+    // rebase and clamp all indices, then grab all unique vertex indices referenced
+    for(uint32_t idx = 0; idx < numIndices; idx++)
     {
-      uint32_t i32 = index16 ? uint32_t(idx16[i]) : idx32[i];
+      uint32_t i32 = index16 ? uint32_t(idx16[idx]) : idx32[idx];
 
       // apply baseVertex but clamp to 0 (don't allow index to become negative)
       if(i32 < idxclamp)
@@ -1279,168 +1704,121 @@ void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
       // we clamp to maxIdx here, to avoid any invalid indices like 0xffffffff
       // from filtering through. Worst case we index to the end of the vertex
       // buffers which is generally much more reasonable
-      i32 = RDCMIN(maxIdx, i32);
-
-      auto it = std::lower_bound(indices.begin(), indices.end(), i32);
-
-      if(it != indices.end() && *it == i32)
-        continue;
-
-      indices.insert(it, i32);
+      rebasedIndices[idx] = RDCMIN(d.maxIdx, i32);
     }
 
+    GetUniqueIndices(rebasedIndices.data(), rebasedIndices.size(), d.indices);
+
     // if we read out of bounds, we'll also have a 0 index being referenced
     // (as 0 is read). Don't insert 0 if we already have 0 though
-    if(numIndices < drawcall->numIndices && (indices.empty() || indices[0] != 0))
-      indices.insert(indices.begin(), 0);
+    if(numIndices < drawcall->numIndices && (d.indices.empty() || d.indices[0] != 0))
+      d.indices.insert(d.indices.begin(), 0);
 
-    minIndex = indices[0];
-    maxIndex = indices[indices.size() - 1];
+    d.minIndex = d.indices[0];
+    d.maxIndex = d.indices[d.indices.size() - 1];
 
     // set numVerts
-    numVerts = maxIndex - minIndex + 1;
-    numFetchVerts = (uint64_t)indices.size();
+    d.numVerts = d.maxIndex - d.minIndex + 1;
+    d.numFetchVerts = (uint64_t)d.indices.size();
 
     // An index buffer could be something like: 500, 520, 518, 553, 554, 556
     // but in our vertex buffer that will be: 0, 20, 18, 53, 54, 56
     // so we add -minIndex as the baseVertex when rendering. The existing baseVertex was 'applied'
     // when we fetched the mesh output so it can be discarded.
-    baseVertex = -(int32_t)minIndex;
+    d.baseVertex = -(int32_t)d.minIndex;
+  });
 
-    // create buffer with unique 0-based indices
-    VkBufferCreateInfo bufInfo = {
-        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        NULL,
-        0,
-        indices.size() * sizeof(uint32_t),
-        VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-    };
-
-    vkr = m_pDriver->vkCreateBuffer(dev, &bufInfo, NULL, &uniqIdxBuf);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  idxReadback.Release();
 
-    VkMemoryRequirements mrq = {0};
-    m_pDriver->vkGetBufferMemoryRequirements(dev, uniqIdxBuf, &mrq);
-
-    VkMemoryAllocateInfo allocInfo = {
-        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, mrq.size,
-        m_pDriver->GetUploadMemoryIndex(mrq.memoryTypeBits),
-    };
-
-    vkr = m_pDriver->vkAllocateMemory(dev, &allocInfo, NULL, &uniqIdxBufMem);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-    vkr = m_pDriver->vkBindBufferMemory(dev, uniqIdxBuf, uniqIdxBufMem, 0);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-    VkBufferViewCreateInfo viewInfo = {
-        VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO,
-        NULL,
-        0,
-        uniqIdxBuf,
-        VK_FORMAT_R32_UINT,
-        0,
-        VK_WHOLE_SIZE,
-    };
-
-    vkr = m_pDriver->vkCreateBufferView(dev, &viewInfo, NULL, &uniqIdxBufView);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-    byte *idxData = NULL;
-    vkr = m_pDriver->vkMapMemory(m_Device, uniqIdxBufMem, 0, VK_WHOLE_SIZE, 0, (void **)&idxData);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-    memcpy(idxData, &indices[0], indices.size() * sizeof(uint32_t));
-
-    m_pDriver->vkUnmapMemory(m_Device, uniqIdxBufMem);
-  }
-
-  uint32_t bufStride = 0;
-  vector<uint32_t> modSpirv = moduleInfo.spirv.spirv;
-
-  struct CompactedAttrBuffer
-  {
-    VkDeviceMemory mem;
-    VkBuffer buf;
-    VkBufferView view;
-  };
-
-  std::vector<uint32_t> attrInstDivisor;
-  CompactedAttrBuffer vbuffers[64];
-  RDCEraseEl(vbuffers);
+  // we fetch the vertex buffer data up front here since there's a very high chance of either
+  // overlap due to interleaved attributes, or no overlap and no wastage due to separate compact
+  // attributes. All draws' vertex buffers are read back together.
+  VulkanBatchedReadback vbReadback(m_pDriver, creationInfo);
 
+  for(VulkanPostVSDraw *draw : draws)
   {
-    VkWriteDescriptorSet descWrites[64];
-    uint32_t numWrites = 0;
-
-    RDCEraseEl(descWrites);
-
-    const VkPipelineVertexInputStateCreateInfo *vi = pipeCreateInfo.pVertexInputState;
-
-    RDCASSERT(vi->vertexAttributeDescriptionCount <= MeshOutputTBufferArraySize);
+    VulkanPostVSDraw &d = *draw;
+    const DrawcallDescription *drawcall = d.drawcall;
 
-    // we fetch the vertex buffer data up front here since there's a very high chance of either
-    // overlap due to interleaved attributes, or no overlap and no wastage due to separate compact
-    // attributes.
-    bytebuf origVBs[16];
+    d.vbRead.resize(d.vbinds.size());
 
-    for(uint32_t vb = 0; vb < vi->vertexBindingDescriptionCount; vb++)
+    for(uint32_t vb = 0; vb < d.vbinds.size(); vb++)
     {
-      VkDeviceSize offs = state.vbuffers[vb].offs;
+      VkDeviceSize offs = d.state.vbuffers[vb].offs;
       uint64_t len = 0;
 
-      if(vi->pVertexBindingDescriptions[vb].inputRate == VK_VERTEX_INPUT_RATE_INSTANCE)
+      if(d.vbinds[vb].inputRate == VK_VERTEX_INPUT_RATE_INSTANCE)
       {
-        len = uint64_t(maxInstance + 1) * vi->pVertexBindingDescriptions[vb].stride;
+        len = uint64_t(d.maxInstance + 1) * d.vbinds[vb].stride;
 
-        offs += drawcall->instanceOffset * vi->pVertexBindingDescriptions[vb].stride;
+        offs += drawcall->instanceOffset * d.vbinds[vb].stride;
       }
       else
       {
-        len = uint64_t(maxIndex + 1) * vi->pVertexBindingDescriptions[vb].stride;
+        len = uint64_t(d.maxIndex + 1) * d.vbinds[vb].stride;
 
-        offs += drawcall->vertexOffset * vi->pVertexBindingDescriptions[vb].stride;
+        offs += drawcall->vertexOffset * d.vbinds[vb].stride;
       }
 
-      GetBufferData(state.vbuffers[vb].buf, offs, len, origVBs[vb]);
+      d.vbRead[vb] = vbReadback.Add(d.state.vbuffers[vb].buf, offs, len);
     }
+  }
+
+  vbReadback.Execute();
+
+  // lay out every draw's compacted attributes and unique indices in one upload buffer
+  VkDeviceSize uploadSize = 0;
+  const VkDeviceSize texelAlign = RDCMAX(limits.minTexelBufferOffsetAlignment, (VkDeviceSize)16);
 
-    for(uint32_t i = 0; i < vi->vertexAttributeDescriptionCount; i++)
+  for(VulkanPostVSDraw *draw : draws)
+  {
+    VulkanPostVSDraw &d = *draw;
+
+    RDCASSERT(d.vattrs.size() <= MeshOutputTBufferArraySize);
+
+    for(const VkVertexInputAttributeDescription &attrDesc : d.vattrs)
     {
-      const VkVertexInputAttributeDescription &attrDesc = vi->pVertexAttributeDescriptions[i];
       uint32_t attr = attrDesc.location;
 
       RDCASSERT(attr < 64);
-      if(attr >= ARRAY_COUNT(vbuffers))
+      if(attr >= 64)
       {
         RDCERR("Attribute index too high! Resize array.");
         continue;
       }
 
-      uint32_t instDivisor = ~0U;
-      size_t stride = 1;
+      VulkanPostVSDraw::Attribute a = {};
+      a.location = attr;
+      a.binding = attrDesc.binding;
 
-      const byte *origVBBegin = NULL;
-      const byte *origVBEnd = NULL;
+      uint32_t instDivisor = ~0U;
+      a.stride = 1;
 
-      for(uint32_t vb = 0; vb < vi->vertexBindingDescriptionCount; vb++)
+      for(uint32_t vb = 0; vb < d.vbinds.size(); vb++)
       {
-        const VkVertexInputBindingDescription &vbDesc = vi->pVertexBindingDescriptions[vb];
+        const VkVertexInputBindingDescription &vbDesc = d.vbinds[vb];
         if(vbDesc.binding == attrDesc.binding)
         {
-          origVBBegin = origVBs[vb].data() + attrDesc.offset;
-          origVBEnd = origVBs[vb].data() + origVBs[vb].size();
-          stride = vbDesc.stride;
+          const byte *data = vbReadback.Data(d.vbRead[vb]);
+          size_t dataSize = vbReadback.Size(d.vbRead[vb]);
+
+          // an empty readback is treated the same as an empty buffer
+          if(data)
+          {
+            a.src = data + attrDesc.offset;
+            a.srcEnd = data + dataSize;
+          }
+          a.stride = vbDesc.stride;
           if(vbDesc.inputRate == VK_VERTEX_INPUT_RATE_INSTANCE)
-            instDivisor = pipeInfo.vertexBindings[vbDesc.binding].instanceDivisor;
+            instDivisor =
+                creationInfo.m_Pipeline[d.state.graphics.pipeline].vertexBindings[vbDesc.binding]
+                    .instanceDivisor;
           else
             instDivisor = ~0U;
           break;
         }
       }
 
-      RDCASSERT(origVBEnd);
-
       // in some limited cases, provided we added the UNIFORM_TEXEL_BUFFER usage bit, we could use
       // the original buffers here as-is and read out of them. However it is likely that the offset
       // is not a multiple of the minimum texel buffer offset for at least some of the buffers if
@@ -1450,8 +1828,8 @@ void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
       // we also need to handle the case where the format is not natively supported as a texel
       // buffer, which requires us to then pick a supported format that's wider (so contains the
       // same precision) but does support texel buffers, and expand to that.
-      VkFormat origFormat = attrDesc.format;
-      VkFormat expandedFormat = attrDesc.format;
+      a.origFormat = attrDesc.format;
+      a.expandedFormat = attrDesc.format;
 
       if((m_pDriver->GetFormatProperties(attrDesc.format).bufferFeatures &
           VK_FORMAT_FEATURE_UNIFORM_TEXEL_BUFFER_BIT) == 0)
@@ -1466,328 +1844,280 @@ void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
         //
         // Note: This does not handle double format inputs, which must have special handling.
 
-        if(IsDoubleFormat(origFormat))
-          expandedFormat = VK_FORMAT_R32G32B32A32_UINT;
-        if(IsUIntFormat(origFormat))
-          expandedFormat = VK_FORMAT_R32G32B32A32_UINT;
-        else if(IsSIntFormat(origFormat))
-          expandedFormat = VK_FORMAT_R32G32B32A32_SINT;
+        if(IsDoubleFormat(a.origFormat))
+          a.expandedFormat = VK_FORMAT_R32G32B32A32_UINT;
+        if(IsUIntFormat(a.origFormat))
+          a.expandedFormat = VK_FORMAT_R32G32B32A32_UINT;
+        else if(IsSIntFormat(a.origFormat))
+          a.expandedFormat = VK_FORMAT_R32G32B32A32_SINT;
         else
-          expandedFormat = VK_FORMAT_R32G32B32A32_SFLOAT;
+          a.expandedFormat = VK_FORMAT_R32G32B32A32_SFLOAT;
       }
 
-      uint32_t elemSize = GetByteSize(1, 1, 1, expandedFormat, 0);
+      a.elemSize = GetByteSize(1, 1, 1, a.expandedFormat, 0);
 
       // doubles are packed as uvec2
-      if(IsDoubleFormat(origFormat))
-        elemSize *= 2;
+      if(IsDoubleFormat(a.origFormat))
+        a.elemSize *= 2;
 
-      // used for interpreting the original data, if we're upcasting
-      ResourceFormat fmt = MakeResourceFormat(origFormat);
+      if(instDivisor != ~0U)
+        a.size = a.elemSize * (d.maxInstance + 1);
+      else
+        a.size = a.elemSize * (d.maxIndex + 1);
 
-      {
-        VkBufferCreateInfo bufInfo = {
-            VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            NULL,
-            0,
-            elemSize * (maxIndex + 1),
-            VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        };
+      a.offset = AlignUp(uploadSize, texelAlign);
+      uploadSize = a.offset + a.size;
 
-        if(instDivisor != ~0U)
-          bufInfo.size = elemSize * (maxInstance + 1);
+      d.attrs.push_back(a);
 
-        vkr = m_pDriver->vkCreateBuffer(dev, &bufInfo, NULL, &vbuffers[attr].buf);
-        RDCASSERTEQUAL(vkr, VK_SUCCESS);
+      d.attrInstDivisor.resize(RDCMAX(d.attrInstDivisor.size(), size_t(attr + 1)));
+      d.attrInstDivisor[attr] = instDivisor;
+    }
 
-        VkMemoryRequirements mrq = {0};
-        m_pDriver->vkGetBufferMemoryRequirements(dev, vbuffers[attr].buf, &mrq);
+    if(!d.indices.empty())
+    {
+      d.idxOffset = AlignUp(uploadSize, texelAlign);
+      uploadSize = d.idxOffset + d.indices.size() * sizeof(uint32_t);
+    }
+  }
 
-        VkMemoryAllocateInfo allocInfo = {
-            VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, mrq.size,
-            m_pDriver->GetUploadMemoryIndex(mrq.memoryTypeBits),
-        };
+  VkBuffer uploadBuf = VK_NULL_HANDLE;
+  VkDeviceMemory uploadMem = VK_NULL_HANDLE;
+  byte *uploadData = NULL;
 
-        vkr = m_pDriver->vkAllocateMemory(dev, &allocInfo, NULL, &vbuffers[attr].mem);
-        RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  if(uploadSize > 0)
+  {
+    VkBufferCreateInfo bufInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        NULL,
+        0,
+        uploadSize,
+        VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+    };
 
-        vkr = m_pDriver->vkBindBufferMemory(dev, vbuffers[attr].buf, vbuffers[attr].mem, 0);
-        RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    vkr = m_pDriver->vkCreateBuffer(dev, &bufInfo, NULL, &uploadBuf);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-        byte *compactedData = NULL;
-        vkr = m_pDriver->vkMapMemory(m_Device, vbuffers[attr].mem, 0, VK_WHOLE_SIZE, 0,
-                                     (void **)&compactedData);
-        RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    VkMemoryRequirements mrq = {0};
+    m_pDriver->vkGetBufferMemoryRequirements(dev, uploadBuf, &mrq);
 
-        if(compactedData && origVBEnd)
-        {
-          const byte *src = origVBBegin;
-          byte *dst = compactedData;
-          const byte *dstEnd = dst + bufInfo.size;
+    VkMemoryAllocateInfo allocInfo = {
+        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, mrq.size,
+        m_pDriver->GetUploadMemoryIndex(mrq.memoryTypeBits),
+    };
 
-          // fast memcpy compaction case for natively supported texel buffer formats
-          if(origFormat == expandedFormat)
-          {
-            while(src < origVBEnd && dst < dstEnd)
-            {
-              memcpy(dst, src, elemSize);
-              dst += elemSize;
-              src += stride;
-            }
-          }
-          else
-          {
-            uint32_t zero = 0;
+    vkr = m_pDriver->vkAllocateMemory(dev, &allocInfo, NULL, &uploadMem);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-            // upcasting path
-            if(IsDoubleFormat(origFormat))
-            {
-              while(src < origVBEnd && dst < dstEnd)
-              {
-                // the double is already in "packed uvec2" order, with least significant 32-bits
-                // first, so we can copy directly
-                memcpy(dst, src, sizeof(double) * fmt.compCount);
-                dst += sizeof(double) * fmt.compCount;
-
-                // fill up to *8* zeros not 4, since we're filling two for every component
-                for(uint8_t c = fmt.compCount * 2; c < 8; c++)
-                {
-                  memcpy(dst, &zero, sizeof(uint32_t));
-                  dst += sizeof(uint32_t);
-                }
-
-                src += stride;
-              }
-            }
-            else if(IsUIntFormat(expandedFormat))
-            {
-              while(src < origVBEnd && dst < dstEnd)
-              {
-                uint32_t val = 0;
-
-                const byte *s = src;
-
-                uint8_t c = 0;
-                for(; c < fmt.compCount; c++)
-                {
-                  if(fmt.compByteWidth == 1)
-                    val = *s;
-                  else if(fmt.compByteWidth == 2)
-                    val = *(uint16_t *)s;
-                  else if(fmt.compByteWidth == 4)
-                    val = *(uint32_t *)s;
-
-                  memcpy(dst, &val, sizeof(uint32_t));
-                  dst += sizeof(uint32_t);
-                  s += fmt.compByteWidth;
-                }
-
-                for(; c < 4; c++)
-                {
-                  memcpy(dst, &zero, sizeof(uint32_t));
-                  dst += sizeof(uint32_t);
-                }
-
-                src += stride;
-              }
-            }
-            else if(IsSIntFormat(expandedFormat))
-            {
-              while(src < origVBEnd && dst < dstEnd)
-              {
-                int32_t val = 0;
-
-                const byte *s = src;
-
-                uint8_t c = 0;
-                for(; c < fmt.compCount; c++)
-                {
-                  if(fmt.compByteWidth == 1)
-                    val = *(int8_t *)s;
-                  else if(fmt.compByteWidth == 2)
-                    val = *(int16_t *)s;
-                  else if(fmt.compByteWidth == 4)
-                    val = *(int32_t *)s;
-
-                  memcpy(dst, &val, sizeof(int32_t));
-                  dst += sizeof(int32_t);
-                  s += fmt.compByteWidth;
-                }
-
-                for(; c < 4; c++)
-                {
-                  memcpy(dst, &zero, sizeof(uint32_t));
-                  dst += sizeof(uint32_t);
-                }
-
-                src += stride;
-              }
-            }
-            else
-            {
-              while(src < origVBEnd && dst < dstEnd)
-              {
-                bool valid = false;
-                FloatVector vec = HighlightCache::InterpretVertex(src, 0, 0, fmt, origVBEnd, valid);
-
-                memcpy(dst, &vec, sizeof(FloatVector));
-                dst += sizeof(FloatVector);
-                src += stride;
-              }
-            }
-          }
-        }
+    vkr = m_pDriver->vkBindBufferMemory(dev, uploadBuf, uploadMem, 0);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    vkr = m_pDriver->vkMapMemory(m_Device, uploadMem, 0, VK_WHOLE_SIZE, 0, (void **)&uploadData);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
 
-        m_pDriver->vkUnmapMemory(m_Device, vbuffers[attr].mem);
+  // compact the vertex data and patch each vertex shader into a compute shader, across all cores
+  Threading::ParallelFor((uint32_t)draws.size(), [&draws, uploadData, &creationInfo](uint32_t i) {
+    VulkanPostVSDraw &d = *draws[i];
+
+    if(uploadData)
+    {
+      for(const VulkanPostVSDraw::Attribute &a : d.attrs)
+      {
+        byte *dst = uploadData + a.offset;
+
+        if(a.src)
+          CompactVertexAttribute(a.src, a.srcEnd, a.stride, dst, dst + a.size, a.origFormat,
+                                 a.expandedFormat, a.elemSize);
       }
 
+      if(!d.indices.empty())
+        memcpy(uploadData + d.idxOffset, d.indices.data(), d.indices.size() * sizeof(uint32_t));
+    }
+
+    const VulkanCreationInfo::Pipeline &pipeInfo =
+        creationInfo.m_Pipeline.find(d.state.graphics.pipeline)->second;
+
+    // the SPIR-V patching will determine the next descriptor set to use, after all sets statically
+    // used by the shader. This gets around the problem where the shader only uses 0 and 1, but the
+    // layout declares 0-4, and 2,3,4 are invalid at bind time and we are unable to bind our new set
+    // 5. Instead we'll notice that only 0 and 1 are used and just use 2 ourselves (although it was
+    // in the original set layout, we know it's statically unused by the shader so we can safely
+    // steal it).
+    d.modSpirv = creationInfo.m_ShaderModule.find(pipeInfo.shaders[0].module)->second.spirv.spirv;
+
+    ConvertToMeshOutputCompute(*pipeInfo.shaders[0].refl, *pipeInfo.shaders[0].patchData,
+                               pipeInfo.shaders[0].entryPoint.c_str(), d.attrInstDivisor, d.descSet,
+                               d.drawcall, d.baseVertex, d.numFetchVerts, d.numVerts, d.modSpirv,
+                               d.bufStride);
+  });
+
+  vbReadback.Release();
+
+  if(uploadData)
+    m_pDriver->vkUnmapMemory(m_Device, uploadMem);
+
+  GetMeshFetchDescSets((uint32_t)draws.size());
+
+  // create the views, patched pipelines and descriptor sets, and lay out all the outputs in one
+  // shared buffer
+  VkDeviceSize outputSize = 0;
+
+  for(size_t i = 0; i < draws.size(); i++)
+  {
+    VulkanPostVSDraw &d = *draws[i];
+
+    const VulkanCreationInfo::Pipeline &pipeInfo =
+        creationInfo.m_Pipeline[d.state.graphics.pipeline];
+
+    VkDescriptorSet fetchSet = m_MeshFetchDescSets[i];
+
+    VkWriteDescriptorSet descWrites[64 + 2];
+    uint32_t numWrites = 0;
+
+    RDCEraseEl(descWrites);
+
+    for(VulkanPostVSDraw::Attribute &a : d.attrs)
+    {
       VkBufferViewCreateInfo info = {
           VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO,
           NULL,
           0,
-          vbuffers[attr].buf,
-          expandedFormat,
-          0,
-          VK_WHOLE_SIZE,
+          uploadBuf,
+          a.expandedFormat,
+          a.offset,
+          a.size,
       };
 
-      if((m_pDriver->GetFormatProperties(expandedFormat).bufferFeatures &
+      if((m_pDriver->GetFormatProperties(a.expandedFormat).bufferFeatures &
           VK_FORMAT_FEATURE_UNIFORM_TEXEL_BUFFER_BIT) == 0)
       {
         RDCERR(
             "Format %s doesn't support texel buffers, and no suitable upcasting format was found! "
             "Replacing with safe but broken format to avoid crashes, but vertex data will be "
             "wrong.",
-            ToStr(origFormat).c_str());
+            ToStr(a.origFormat).c_str());
         info.format = VK_FORMAT_R8G8B8A8_UNORM;
       }
 
-      m_pDriver->vkCreateBufferView(dev, &info, NULL, &vbuffers[attr].view);
-
-      attrInstDivisor.resize(RDCMAX(attrInstDivisor.size(), size_t(attr + 1)));
-      attrInstDivisor[attr] = instDivisor;
+      m_pDriver->vkCreateBufferView(dev, &info, NULL, &a.view);
 
       descWrites[numWrites].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descWrites[numWrites].dstSet = m_MeshFetchDescSet;
-      if(IsSIntFormat(attrDesc.format))
+      descWrites[numWrites].dstSet = fetchSet;
+      if(IsSIntFormat(a.origFormat))
         descWrites[numWrites].dstBinding = 4;
-      else if(IsUIntFormat(attrDesc.format) || IsDoubleFormat(attrDesc.format))
+      else if(IsUIntFormat(a.origFormat) || IsDoubleFormat(a.origFormat))
         descWrites[numWrites].dstBinding = 3;
       else
         descWrites[numWrites].dstBinding = 2;
-      descWrites[numWrites].dstArrayElement = attr;
+      descWrites[numWrites].dstArrayElement = a.location;
       descWrites[numWrites].descriptorCount = 1;
       descWrites[numWrites].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-      descWrites[numWrites].pTexelBufferView = &vbuffers[attr].view;
+      descWrites[numWrites].pTexelBufferView = &a.view;
       numWrites++;
     }
 
     // add a write of the index buffer
-    if(uniqIdxBufView != VK_NULL_HANDLE)
+    if(!d.indices.empty())
     {
+      VkBufferViewCreateInfo viewInfo = {
+          VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO,
+          NULL,
+          0,
+          uploadBuf,
+          VK_FORMAT_R32_UINT,
+          d.idxOffset,
+          d.indices.size() * sizeof(uint32_t),
+      };
+
+      vkr = m_pDriver->vkCreateBufferView(dev, &viewInfo, NULL, &d.idxView);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
       descWrites[numWrites].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descWrites[numWrites].dstSet = m_MeshFetchDescSet;
+      descWrites[numWrites].dstSet = fetchSet;
       descWrites[numWrites].dstBinding = 1;
       descWrites[numWrites].dstArrayElement = 0;
       descWrites[numWrites].descriptorCount = 1;
       descWrites[numWrites].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-      descWrites[numWrites].pTexelBufferView = &uniqIdxBufView;
+      descWrites[numWrites].pTexelBufferView = &d.idxView;
       numWrites++;
     }
 
     m_pDriver->vkUpdateDescriptorSets(dev, numWrites, descWrites, 0, NULL);
-  }
-
-  ConvertToMeshOutputCompute(*refl, *pipeInfo.shaders[0].patchData,
-                             pipeInfo.shaders[0].entryPoint.c_str(), attrInstDivisor, descSet,
-                             drawcall, baseVertex, numFetchVerts, numVerts, modSpirv, bufStride);
 
-  VkComputePipelineCreateInfo compPipeInfo = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
+    {
+      // descSet will be the index of our new descriptor set
+      std::vector<VkDescriptorSetLayout> descSetLayouts(d.descSet + 1);
 
-  {
-    VkDescriptorSetLayout *descSetLayouts;
+      for(uint32_t s = 0; s < d.descSet; s++)
+        descSetLayouts[s] =
+            m_pDriver->GetResourceManager()->GetCurrentHandle<VkDescriptorSetLayout>(
+                creationInfo.m_PipelineLayout[pipeInfo.layout].descSetLayouts[s]);
 
-    // descSet will be the index of our new descriptor set
-    descSetLayouts = new VkDescriptorSetLayout[descSet + 1];
+      // this layout just says it has one storage buffer
+      descSetLayouts[d.descSet] = m_MeshFetchDescSetLayout;
 
-    for(uint32_t i = 0; i < descSet; i++)
-      descSetLayouts[i] = m_pDriver->GetResourceManager()->GetCurrentHandle<VkDescriptorSetLayout>(
-          creationInfo.m_PipelineLayout[pipeInfo.layout].descSetLayouts[i]);
+      std::vector<VkPushConstantRange> push =
+          creationInfo.m_PipelineLayout[pipeInfo.layout].pushRanges;
 
-    // this layout just says it has one storage buffer
-    descSetLayouts[descSet] = m_MeshFetchDescSetLayout;
+      // ensure the push range is visible to the compute shader
+      for(VkPushConstantRange &range : push)
+        range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
-    std::vector<VkPushConstantRange> push = creationInfo.m_PipelineLayout[pipeInfo.layout].pushRanges;
+      VkPipelineLayoutCreateInfo pipeLayoutInfo = {
+          VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+          NULL,
+          0,
+          d.descSet + 1,
+          descSetLayouts.data(),
+          (uint32_t)push.size(),
+          push.empty() ? NULL : &push[0],
+      };
 
-    // ensure the push range is visible to the compute shader
-    for(VkPushConstantRange &range : push)
-      range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+      // create pipeline layout with same descriptor set layouts, plus our mesh output set
+      vkr = m_pDriver->vkCreatePipelineLayout(dev, &pipeLayoutInfo, NULL, &d.pipeLayout);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
 
-    VkPipelineLayoutCreateInfo pipeLayoutInfo = {
-        VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        NULL,
-        0,
-        descSet + 1,
-        descSetLayouts,
-        (uint32_t)push.size(),
-        push.empty() ? NULL : &push[0],
+    // create vertex shader with modified code
+    VkShaderModuleCreateInfo moduleCreateInfo = {
+        VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, NULL,           0,
+        d.modSpirv.size() * sizeof(uint32_t),        &d.modSpirv[0],
     };
 
-    // create pipeline layout with same descriptor set layouts, plus our mesh output set
-    vkr = m_pDriver->vkCreatePipelineLayout(dev, &pipeLayoutInfo, NULL, &pipeLayout);
+    vkr = m_pDriver->vkCreateShaderModule(dev, &moduleCreateInfo, NULL, &d.module);
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    SAFE_DELETE_ARRAY(descSetLayouts);
-
-    // repoint pipeline layout
-    compPipeInfo.layout = pipeLayout;
-  }
-
-  // create vertex shader with modified code
-  VkShaderModuleCreateInfo moduleCreateInfo = {
-      VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, NULL,         0,
-      modSpirv.size() * sizeof(uint32_t),          &modSpirv[0],
-  };
-
-  VkShaderModule module;
-  vkr = m_pDriver->vkCreateShaderModule(dev, &moduleCreateInfo, NULL, &module);
-  RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-  compPipeInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-  compPipeInfo.stage.module = module;
-  compPipeInfo.stage.pName = PatchedMeshOutputEntryPoint;
-  compPipeInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-
-  // create new pipeline
-  VkPipeline pipe;
-  vkr = m_pDriver->vkCreateComputePipelines(m_Device, VK_NULL_HANDLE, 1, &compPipeInfo, NULL, &pipe);
-  RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-  // make copy of state to draw from
-  VulkanRenderState modifiedstate = state;
+    VkComputePipelineCreateInfo compPipeInfo = {VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
 
-  // bind created pipeline to partial replay state
-  modifiedstate.compute.pipeline = GetResID(pipe);
+    compPipeInfo.layout = d.pipeLayout;
+    compPipeInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    compPipeInfo.stage.module = d.module;
+    compPipeInfo.stage.pName = PatchedMeshOutputEntryPoint;
+    compPipeInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
 
-  // move graphics descriptor sets onto the compute pipe.
-  modifiedstate.compute.descSets = modifiedstate.graphics.descSets;
-
-  // push back extra descriptor set to partial replay state
-  // note that we examined the used pipeline layout above and inserted our descriptor set
-  // after any the application used. So there might be more bound, but we want to ensure to
-  // bind to the slot we're using
-  modifiedstate.compute.descSets.resize(descSet + 1);
-  modifiedstate.compute.descSets[descSet].descSet = GetResID(m_MeshFetchDescSet);
+    // create new pipeline
+    vkr = m_pDriver->vkCreateComputePipelines(m_Device, VK_NULL_HANDLE, 1, &compPipeInfo, NULL,
+                                              &d.pipe);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-  {
-    // create buffer of sufficient size
     // this can't just be bufStride * num unique indices per instance, as we don't
     // have a compact 0-based index to index into the buffer. We must use
     // index-minIndex which is 0-based but potentially sparse, so this buffer may
     // be more or less wasteful
+    d.outSize = VkDeviceSize(d.numVerts) * d.drawcall->numInstances * d.bufStride;
+    d.outOffset = AlignUp(outputSize, limits.minStorageBufferOffsetAlignment);
+    outputSize = AlignUp4(d.outOffset + d.outSize);
+  }
+
+  VkBuffer meshBuffer = VK_NULL_HANDLE, readbackBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory meshMem = VK_NULL_HANDLE, readbackMem = VK_NULL_HANDLE;
+
+  if(outputSize > 0)
+  {
+    // create buffer of sufficient size
     VkBufferCreateInfo bufInfo = {
-        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,          NULL, 0,
-        numVerts * drawcall->numInstances * bufStride, 0,
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO, NULL, 0, outputSize, 0,
     };
 
     bufInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
@@ -1819,6 +2149,7 @@ void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
 
     m_pDriver->vkGetBufferMemoryRequirements(dev, readbackBuffer, &mrq);
 
+    allocInfo.allocationSize = mrq.size;
     allocInfo.memoryTypeIndex = m_pDriver->GetReadbackMemoryIndex(mrq.memoryTypeBits);
 
     vkr = m_pDriver->vkAllocateMemory(dev, &allocInfo, NULL, &readbackMem);
@@ -1836,18 +2167,7 @@ void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
     // fill destination buffer with 0s to ensure unwritten vertices have sane data
-    ObjDisp(dev)->CmdFillBuffer(Unwrap(cmd), Unwrap(meshBuffer), 0, bufInfo.size, 0xbaadf00d);
-
-    VkBufferMemoryBarrier meshbufbarrier = {
-        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-        NULL,
-        VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT,
-        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
-        VK_QUEUE_FAMILY_IGNORED,
-        VK_QUEUE_FAMILY_IGNORED,
-    };
-
-    meshbufbarrier.size = VK_WHOLE_SIZE;
+    ObjDisp(dev)->CmdFillBuffer(Unwrap(cmd), Unwrap(meshBuffer), 0, outputSize, 0xbaadf00d);
 
     VkMemoryBarrier globalbarrier = {
         VK_STRUCTURE_TYPE_MEMORY_BARRIER, NULL,
@@ -1855,47 +2175,82 @@ void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
         VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
     };
 
-    // wait for uploads of index buffer (if used), compacted vertex buffers, and the above fill to
-    // finish.
+    // wait for uploads of index buffers, compacted vertex buffers, and the above fill to finish.
     DoPipelineBarrier(cmd, 1, &globalbarrier);
 
-    // set bufSize
-    bufSize = numVerts * drawcall->numInstances * bufStride;
+    std::vector<VkBufferCopy> copies;
 
-    // vkUpdateDescriptorSet desc set to point to buffer
-    VkDescriptorBufferInfo fetchdesc = {0};
-    fetchdesc.buffer = meshBuffer;
-    fetchdesc.offset = 0;
-    fetchdesc.range = bufInfo.size;
+    for(size_t i = 0; i < draws.size(); i++)
+    {
+      VulkanPostVSDraw &d = *draws[i];
 
-    VkWriteDescriptorSet write = {
-        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, m_MeshFetchDescSet, 0,   0, 1,
-        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,      NULL, &fetchdesc,         NULL};
-    m_pDriver->vkUpdateDescriptorSets(dev, 1, &write, 0, NULL);
+      if(d.outSize == 0)
+        continue;
 
-    // do single draw
-    modifiedstate.BindPipeline(cmd, VulkanRenderState::BindCompute, true);
-    uint64_t totalVerts = numFetchVerts * uint64_t(drawcall->numInstances);
+      VkDescriptorSet fetchSet = m_MeshFetchDescSets[i];
 
-    // the validation layers will probably complain about this dispatch saying some arrays aren't
-    // fully updated. That's because they don't statically analyse that only fixed indices are
-    // referred to. It's safe to leave unused array indices as invalid descriptors.
-    ObjDisp(cmd)->CmdDispatch(Unwrap(cmd), uint32_t(totalVerts / MeshOutputDispatchWidth) + 1, 1, 1);
+      // vkUpdateDescriptorSet desc set to point to this draw's part of the buffer
+      VkDescriptorBufferInfo fetchdesc = {0};
+      fetchdesc.buffer = meshBuffer;
+      fetchdesc.offset = d.outOffset;
+      fetchdesc.range = d.outSize;
 
-    // wait for mesh output writing to finish
-    meshbufbarrier.buffer = Unwrap(meshBuffer);
-    meshbufbarrier.size = bufSize;
-    meshbufbarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    meshbufbarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+      VkWriteDescriptorSet write = {
+          VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, fetchSet, 0,   0, 1,
+          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,      NULL, &fetchdesc, NULL};
+      m_pDriver->vkUpdateDescriptorSets(dev, 1, &write, 0, NULL);
 
-    DoPipelineBarrier(cmd, 1, &meshbufbarrier);
+      // make copy of state to draw from
+      VulkanRenderState modifiedstate = d.state;
+
+      // bind created pipeline to partial replay state
+      modifiedstate.compute.pipeline = GetResID(d.pipe);
+
+      // move graphics descriptor sets onto the compute pipe.
+      modifiedstate.compute.descSets = modifiedstate.graphics.descSets;
+
+      // push back extra descriptor set to partial replay state
+      // note that we examined the used pipeline layout above and inserted our descriptor set
+      // after any the application used. So there might be more bound, but we want to ensure to
+      // bind to the slot we're using
+      modifiedstate.compute.descSets.resize(d.descSet + 1);
+      modifiedstate.compute.descSets[d.descSet].descSet = GetResID(fetchSet);
 
-    VkBufferCopy bufcopy = {
-        0, 0, bufInfo.size,
+      modifiedstate.BindPipeline(cmd, VulkanRenderState::BindCompute, true);
+      uint64_t totalVerts = d.numFetchVerts * uint64_t(d.drawcall->numInstances);
+
+      // the validation layers will probably complain about this dispatch saying some arrays aren't
+      // fully updated. That's because they don't statically analyse that only fixed indices are
+      // referred to. It's safe to leave unused array indices as invalid descriptors.
+      ObjDisp(cmd)->CmdDispatch(Unwrap(cmd), uint32_t(totalVerts / MeshOutputDispatchWidth) + 1, 1,
+                                1);
+
+      // we only need the first instance's vertices back, to calculate near/far
+      VkBufferCopy copy = {
+          d.outOffset, d.outOffset, RDCMIN(d.outSize, VkDeviceSize(d.numVerts) * d.bufStride),
+      };
+      copies.push_back(copy);
+    }
+
+    // wait for mesh output writing to finish
+    VkBufferMemoryBarrier meshbufbarrier = {
+        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        NULL,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        VK_ACCESS_TRANSFER_READ_BIT,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        Unwrap(meshBuffer),
+        0,
+        outputSize,
     };
 
+    DoPipelineBarrier(cmd, 1, &meshbufbarrier);
+
     // copy to readback buffer
-    ObjDisp(dev)->CmdCopyBuffer(Unwrap(cmd), Unwrap(meshBuffer), Unwrap(readbackBuffer), 1, &bufcopy);
+    if(!copies.empty())
+      ObjDisp(dev)->CmdCopyBuffer(Unwrap(cmd), Unwrap(meshBuffer), Unwrap(readbackBuffer),
+                                  (uint32_t)copies.size(), copies.data());
 
     meshbufbarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     meshbufbarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
@@ -1907,142 +2262,157 @@ void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
     vkr = ObjDisp(dev)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    // submit & flush so that we don't have to keep pipeline around for a while
+    // submit & flush so that we don't have to keep pipelines around for a while
     m_pDriver->SubmitCmds();
     m_pDriver->FlushQ();
   }
 
-  for(CompactedAttrBuffer attrBuf : vbuffers)
+  // readback mesh data
+  byte *byteData = NULL;
+  if(readbackMem != VK_NULL_HANDLE)
   {
-    m_pDriver->vkDestroyBufferView(dev, attrBuf.view, NULL);
-    m_pDriver->vkDestroyBuffer(dev, attrBuf.buf, NULL);
-    m_pDriver->vkFreeMemory(dev, attrBuf.mem, NULL);
+    vkr = m_pDriver->vkMapMemory(m_Device, readbackMem, 0, VK_WHOLE_SIZE, 0, (void **)&byteData);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
   }
 
-  // readback mesh data
-  byte *byteData = NULL;
-  vkr = m_pDriver->vkMapMemory(m_Device, readbackMem, 0, VK_WHOLE_SIZE, 0, (void **)&byteData);
+  for(VulkanPostVSDraw *draw : draws)
+  {
+    VulkanPostVSDraw &d = *draw;
+    const DrawcallDescription *drawcall = d.drawcall;
+    const VulkanRenderState &state = d.state;
 
-  // do near/far calculations
+    ShaderReflection *refl = creationInfo.m_Pipeline[state.graphics.pipeline].shaders[0].refl;
 
-  float nearp = 0.1f;
-  float farp = 100.0f;
+    // do near/far calculations
 
-  Vec4f *pos0 = (Vec4f *)byteData;
+    float nearp = 0.1f;
+    float farp = 100.0f;
 
-  bool found = false;
+    if(byteData && d.outSize > 0)
+    {
+      const byte *drawData = byteData + d.outOffset;
 
-  // expect position at the start of the buffer, as system values are sorted first
-  // and position is the first value
+      Vec4f *pos0 = (Vec4f *)drawData;
 
-  for(uint32_t i = 1;
-      refl->outputSignature[0].systemValue == ShaderBuiltin::Position && i < numVerts; i++)
-  {
-    //////////////////////////////////////////////////////////////////////////////////
-    // derive near/far, assuming a standard perspective matrix
-    //
-    // the transformation from from pre-projection {Z,W} to post-projection {Z,W}
-    // is linear. So we can say Zpost = Zpre*m + c . Here we assume Wpre = 1
-    // and we know Wpost = Zpre from the perspective matrix.
-    // we can then see from the perspective matrix that
-    // m = F/(F-N)
-    // c = -(F*N)/(F-N)
-    //
-    // with re-arranging and substitution, we then get:
-    // N = -c/m
-    // F = c/(1-m)
-    //
-    // so if we can derive m and c then we can determine N and F. We can do this with
-    // two points, and we pick them reasonably distinct on z to reduce floating-point
-    // error
-
-    Vec4f *pos = (Vec4f *)(byteData + i * bufStride);
-
-    // skip invalid vertices (w=0)
-    if(pos->w != 0.0f && fabs(pos->w - pos0->w) > 0.01f && fabs(pos->z - pos0->z) > 0.01f)
-    {
-      Vec2f A(pos0->w, pos0->z);
-      Vec2f B(pos->w, pos->z);
+      bool found = false;
 
-      float m = (B.y - A.y) / (B.x - A.x);
-      float c = B.y - B.x * m;
+      // expect position at the start of the buffer, as system values are sorted first
+      // and position is the first value
 
-      if(m == 1.0f)
-        continue;
+      for(uint32_t i = 1;
+          refl->outputSignature[0].systemValue == ShaderBuiltin::Position && i < d.numVerts; i++)
+      {
+        //////////////////////////////////////////////////////////////////////////////////
+        // derive near/far, assuming a standard perspective matrix
+        //
+        // the transformation from from pre-projection {Z,W} to post-projection {Z,W}
+        // is linear. So we can say Zpost = Zpre*m + c . Here we assume Wpre = 1
+        // and we know Wpost = Zpre from the perspective matrix.
+        // we can then see from the perspective matrix that
+        // m = F/(F-N)
+        // c = -(F*N)/(F-N)
+        //
+        // with re-arranging and substitution, we then get:
+        // N = -c/m
+        // F = c/(1-m)
+        //
+        // so if we can derive m and c then we can determine N and F. We can do this with
+        // two points, and we pick them reasonably distinct on z to reduce floating-point
+        // error
 
-      if(-c / m <= 0.000001f)
-        continue;
+        Vec4f *pos = (Vec4f *)(drawData + i * d.bufStride);
+
+        // skip invalid vertices (w=0)
+        if(pos->w != 0.0f && fabs(pos->w - pos0->w) > 0.01f && fabs(pos->z - pos0->z) > 0.01f)
+        {
+          Vec2f A(pos0->w, pos0->z);
+          Vec2f B(pos->w, pos->z);
+
+          float m = (B.y - A.y) / (B.x - A.x);
+          float c = B.y - B.x * m;
+
+          if(m == 1.0f)
+            continue;
+
+          if(-c / m <= 0.000001f)
+            continue;
 
-      nearp = -c / m;
-      farp = c / (1 - m);
+          nearp = -c / m;
+          farp = c / (1 - m);
 
-      found = true;
+          found = true;
 
-      break;
+          break;
+        }
+      }
+
+      // if we didn't find anything, all z's and w's were identical.
+      // If the z is positive and w greater for the first element then
+      // we detect this projection as reversed z with infinite far plane
+      if(!found && pos0->z > 0.0f && pos0->w > pos0->z)
+      {
+        nearp = pos0->z;
+        farp = FLT_MAX;
+      }
     }
-  }
 
-  // if we didn't find anything, all z's and w's were identical.
-  // If the z is positive and w greater for the first element then
-  // we detect this projection as reversed z with infinite far plane
-  if(!found && pos0->z > 0.0f && pos0->w > pos0->z)
-  {
-    nearp = pos0->z;
-    farp = FLT_MAX;
-  }
+    uint32_t eventId = d.eventId;
 
-  m_pDriver->vkUnmapMemory(m_Device, readbackMem);
+    // fill out m_PostVSData. The output buffer is shared by every draw in the batch, and is
+    // destroyed once none of them are using it any more
+    m_PostVSData[eventId].vsin.topo = d.topo;
+    m_PostVSData[eventId].vsout.topo = d.topo;
+    m_PostVSData[eventId].vsout.buf = meshBuffer;
+    m_PostVSData[eventId].vsout.bufmem = meshMem;
+    m_PostVSData[eventId].vsout.bufOffset = d.outOffset;
 
-  // clean up temporary memories
-  m_pDriver->vkDestroyBuffer(m_Device, readbackBuffer, NULL);
-  m_pDriver->vkFreeMemory(m_Device, readbackMem, NULL);
+    m_PostVSData[eventId].vsout.baseVertex = d.baseVertex + drawcall->baseVertex;
 
-  if(uniqIdxBuf != VK_NULL_HANDLE)
-  {
-    m_pDriver->vkDestroyBuffer(m_Device, uniqIdxBuf, NULL);
-    m_pDriver->vkFreeMemory(m_Device, uniqIdxBufMem, NULL);
-    m_pDriver->vkDestroyBufferView(m_Device, uniqIdxBufView, NULL);
-  }
+    m_PostVSData[eventId].vsout.vertStride = d.bufStride;
+    m_PostVSData[eventId].vsout.nearPlane = nearp;
+    m_PostVSData[eventId].vsout.farPlane = farp;
 
-  // fill out m_PostVSData
-  m_PostVSData[eventId].vsin.topo = pipeCreateInfo.pInputAssemblyState->topology;
-  m_PostVSData[eventId].vsout.topo = pipeCreateInfo.pInputAssemblyState->topology;
-  m_PostVSData[eventId].vsout.buf = meshBuffer;
-  m_PostVSData[eventId].vsout.bufmem = meshMem;
+    m_PostVSData[eventId].vsout.useIndices = bool(drawcall->flags & DrawFlags::UseIBuffer);
+    m_PostVSData[eventId].vsout.numVerts = drawcall->numIndices;
 
-  m_PostVSData[eventId].vsout.baseVertex = baseVertex + drawcall->baseVertex;
+    m_PostVSData[eventId].vsout.instStride = 0;
+    if(drawcall->flags & DrawFlags::Instanced)
+      m_PostVSData[eventId].vsout.instStride = uint32_t(d.outSize / drawcall->numInstances);
 
-  m_PostVSData[eventId].vsout.vertStride = bufStride;
-  m_PostVSData[eventId].vsout.nearPlane = nearp;
-  m_PostVSData[eventId].vsout.farPlane = farp;
+    m_PostVSData[eventId].vsout.idxBuf = ResourceId();
+    if(m_PostVSData[eventId].vsout.useIndices && state.ibuffer.buf != ResourceId())
+    {
+      m_PostVSData[eventId].vsout.idxBuf = GetResourceManager()->GetOriginalID(state.ibuffer.buf);
+      m_PostVSData[eventId].vsout.idxOffset =
+          state.ibuffer.offs + drawcall->indexOffset * d.idxsize;
+      m_PostVSData[eventId].vsout.idxFmt =
+          d.idxsize == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    }
 
-  m_PostVSData[eventId].vsout.useIndices = bool(drawcall->flags & DrawFlags::UseIBuffer);
-  m_PostVSData[eventId].vsout.numVerts = drawcall->numIndices;
+    m_PostVSData[eventId].vsout.hasPosOut =
+        refl->outputSignature[0].systemValue == ShaderBuiltin::Position;
 
-  m_PostVSData[eventId].vsout.instStride = 0;
-  if(drawcall->flags & DrawFlags::Instanced)
-    m_PostVSData[eventId].vsout.instStride = uint32_t(bufSize / drawcall->numInstances);
+    // clean up temporary objects
+    for(const VulkanPostVSDraw::Attribute &a : d.attrs)
+      m_pDriver->vkDestroyBufferView(dev, a.view, NULL);
+    m_pDriver->vkDestroyBufferView(dev, d.idxView, NULL);
 
-  m_PostVSData[eventId].vsout.idxBuf = ResourceId();
-  if(m_PostVSData[eventId].vsout.useIndices && state.ibuffer.buf != ResourceId())
-  {
-    m_PostVSData[eventId].vsout.idxBuf = GetResourceManager()->GetOriginalID(state.ibuffer.buf);
-    m_PostVSData[eventId].vsout.idxOffset = state.ibuffer.offs + drawcall->indexOffset * idxsize;
-    m_PostVSData[eventId].vsout.idxFmt = idxsize == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    m_pDriver->vkDestroyPipelineLayout(dev, d.pipeLayout, NULL);
+    m_pDriver->vkDestroyPipeline(dev, d.pipe, NULL);
+    m_pDriver->vkDestroyShaderModule(dev, d.module, NULL);
   }
 
-  m_PostVSData[eventId].vsout.hasPosOut =
-      refl->outputSignature[0].systemValue == ShaderBuiltin::Position;
+  if(byteData)
+    m_pDriver->vkUnmapMemory(m_Device, readbackMem);
 
-  // delete pipeline layout
-  m_pDriver->vkDestroyPipelineLayout(dev, pipeLayout, NULL);
-
-  // delete pipeline
-  m_pDriver->vkDestroyPipeline(dev, pipe, NULL);
+  // clean up temporary memories
+  m_pDriver->vkDestroyBuffer(m_Device, readbackBuffer, NULL);
+  m_pDriver->vkFreeMemory(m_Device, readbackMem, NULL);
 
-  // delete shader/shader module
-  m_pDriver->vkDestroyShaderModule(dev, module, NULL);
+  m_pDriver->vkDestroyBuffer(m_Device, uploadBuf, NULL);
+  m_pDriver->vkFreeMemory(m_Device, uploadMem, NULL);
 }
+
 struct VulkanInitPostVSCallback : public VulkanDrawcallCallback
 {
   VulkanInitPostVSCallback(WrappedVulkan *vk, const vector<uint32_t> &events)
@@ -2053,8 +2423,23 @@ struct VulkanInitPostVSCallback : public VulkanDrawcallCallback
   ~VulkanInitPostVSCallback() { m_pDriver->SetDrawcallCB(NULL); }
   void PreDraw(uint32_t eid, VkCommandBuffer cmd)
   {
-    if(std::find(m_Events.begin(), m_Events.end(), eid) != m_Events.end())
-      m_pDriver->GetReplay()->InitPostVSBuffers(eid);
+    if(std::find(m_Events.begin(), m_Events.end(), eid) == m_Events.end())
+      return;
+
+    // just record the state for each draw, and then fetch them all at once on the last one. At
+    // that point the pass hasn't been submitted yet, so every draw sees the same buffer contents
+    // it would have if it had been fetched individually.
+    m_Draws.push_back(VulkanPostVSDraw(eid, m_pDriver->GetRenderState()));
+
+    if(eid == m_Events.back())
+      Flush();
+  }
+
+  void Flush()
+  {
+    if(!m_Draws.empty())
+      m_pDriver->GetReplay()->FetchPostVSBuffers(m_Draws);
+    m_Draws.clear();
   }
 
   bool PostDraw(uint32_t eid, VkCommandBuffer cmd) { return false; }
@@ -2076,6 +2461,7 @@ struct VulkanInitPostVSCallback : public VulkanDrawcallCallback
 
   WrappedVulkan *m_pDriver;
   const std::vector<uint32_t> &m_Events;
+  std::vector<VulkanPostVSDraw> m_Draws;
 };
 
 void VulkanReplay::InitPostVSBuffers(const vector<uint32_t> &events)
@@ -2091,6 +2477,9 @@ void VulkanReplay::InitPostVSBuffers(const vector<uint32_t> &events)
   // GetPassEvents above) to come from the same command buffer, so the event IDs are
   // still locally continuous, even if we jump into replaying.
   m_pDriver->ReplayLog(events.front(), events.back(), eReplay_Full);
+
+  // if the last event wasn't a draw we'll still have some left to fetch
+  cb.Flush();
 }
 
 MeshFormat VulkanReplay::GetPostVSBuffers(uint32_t eventId, uint32_t instID, MeshDataStage stage)
@@ -2127,7 +2516,7 @@ MeshFormat VulkanReplay::GetPostVSBuffers(uint32_t eventId, uint32_t instID, Mes
   else
     ret.vertexResourceId = ResourceId();
 
-  ret.vertexByteOffset = s.instStride * instID;
+  ret.vertexByteOffset = s.bufOffset + s.instStride * instID;
   ret.vertexByteStride = s.vertStride;
 
   ret.format.compCount = 4;
@@ -3527,7 +3527,41 @@ void Vulkan_ProcessStructured(RDCFile *rdc, SDFile &output)
   if(sectionIdx < 0)
     return;
 
-  vulkan.SetStructuredExport(rdc->GetSectionProperties(sectionIdx).version);
+  uint64_t version = rdc->GetSectionProperties(sectionIdx).version;
+
+  // exporting in parallel holds the whole section in memory alongside the structured data, so it's
+  // only done when asked for. See ExportStructuredParallel.
+  if(RenderDoc::Inst().GetConfigSetting("Replay_ParallelStructuredExport") == "1")
+  {
+    // each range gets its own driver to serialise with. These are created up front on this thread
+    // since construction registers global state.
+    std::vector<WrappedVulkan *> drivers;
+
+    ReplayStatus status = ExportStructuredParallel(
+        rdc, sectionIdx,
+        [&drivers, version]() -> ChunkRangeExporter {
+          WrappedVulkan *driver = new WrappedVulkan();
+          driver->SetStructuredExport(version);
+          drivers.push_back(driver);
+
+          return [driver](StreamReader *reader, SDFile &out) {
+            return driver->ExportStructuredChunks(reader, out);
+          };
+        },
+        output);
+
+    for(WrappedVulkan *driver : drivers)
+      delete driver;
+
+    if(status != ReplayStatus::Succeeded)
+      RDCERR("Failed to export structured data: %s", ToStr(status).c_str());
+
+    output.version = version;
+
+    return;
+  }
+
+  vulkan.SetStructuredExport(version);
   ReplayStatus status = vulkan.ReadLogInitialisation(rdc, true);
 
   if(status == ReplayStatus::Succeeded)
@@ -125,6 +125,7 @@ class WrappedVulkan;
 class VulkanDebugManager;
 class VulkanResourceManager;
 struct VulkanAMDDrawCallback;
+struct VulkanPostVSDraw;
 
 struct VulkanPostVSData
 {
@@ -132,6 +133,8 @@ struct VulkanPostVSData
   {
     VkBuffer buf;
     VkDeviceMemory bufmem;
+    // the buffer may be shared with other events, this is where this event's data starts
+    VkDeviceSize bufOffset;
     VkPrimitiveTopology topo;
 
     int32_t baseVertex;
@@ -247,6 +250,9 @@ public:
 
   void InitPostVSBuffers(uint32_t eventId);
   void InitPostVSBuffers(const std::vector<uint32_t> &passEvents);
+  // fetches the post-VS data for every draw in the batch with a single GPU round-trip. The draws
+  // must all be at the same point in the replay, such as a series of draws in one pass
+  void FetchPostVSBuffers(std::vector<VulkanPostVSDraw> &draws);
   // indicates that EID alias is the same as eventId
   void AliasPostVSBuffers(uint32_t eventId, uint32_t alias) { m_PostVSAlias[alias] = eventId; }
   void ClearPostVSCache();
@@ -511,26 +517,6 @@ private:
     VkDescriptorSet DescSet = VK_NULL_HANDLE;
   } m_MeshRender;
 
-  struct VertexPicking
-  {
-    void Init(WrappedVulkan *driver, VkDescriptorPool descriptorPool);
-    void Destroy(WrappedVulkan *driver);
-
-    static constexpr int MaxMeshPicks = 500;
-
-    GPUBuffer UBO;
-    GPUBuffer IB;
-    GPUBuffer IBUpload;
-    GPUBuffer VB;
-    GPUBuffer VBUpload;
-    uint32_t IBSize = 0, VBSize = 0;
-    GPUBuffer Result, ResultReadback;
-    VkDescriptorSetLayout DescSetLayout = VK_NULL_HANDLE;
-    VkDescriptorSet DescSet = VK_NULL_HANDLE;
-    VkPipelineLayout Layout = VK_NULL_HANDLE;
-    VkPipeline Pipeline = VK_NULL_HANDLE;
-  } m_VertexPick;
-
   struct PixelPicking
   {
     void Init(WrappedVulkan *driver, VkDescriptorPool descriptorPool);
@@ -572,7 +558,11 @@ private:
   std::map<uint32_t, uint32_t> m_PostVSAlias;
 
   VkDescriptorSetLayout m_MeshFetchDescSetLayout = VK_NULL_HANDLE;
-  VkDescriptorSet m_MeshFetchDescSet = VK_NULL_HANDLE;
+  // one set per draw fetched in a batch, grown on demand
+  std::vector<VkDescriptorPool> m_MeshFetchDescPools;
+  std::vector<VkDescriptorSet> m_MeshFetchDescSets;
+
+  void GetMeshFetchDescSets(uint32_t count);
 
   std::vector<ResourceDescription> m_Resources;
   std::map<ResourceId, size_t> m_ResourceIdx;
@@ -1087,3 +1087,156 @@ void SparseMapping::Update(uint32_t numBindings, const VkSparseMemoryBind *pBind
       opaquemappings.push_back(curRange);
   }
 }
+
+DescSetBindRefs::Entry *DescSetBindRefs::Find(ResourceId id)
+{
+  if(m_Entries.empty())
+    return NULL;
+
+  const size_t mask = m_Entries.size() - 1;
+
+  for(size_t i = Hash(id) & mask;; i = (i + 1) & mask)
+  {
+    if(m_Entries[i].id == id)
+      return &m_Entries[i];
+
+    // the table is never full, so we always hit an empty slot eventually
+    if(m_Entries[i].id == ResourceId())
+      return NULL;
+  }
+}
+
+DescSetBindRefs::Entry &DescSetBindRefs::FindOrAdd(ResourceId id)
+{
+  // keep the load factor at or below 3/4 so probe sequences stay short
+  if((m_Count + 1) * 4 > m_Entries.size() * 3)
+    Grow();
+
+  const size_t mask = m_Entries.size() - 1;
+
+  for(size_t i = Hash(id) & mask;; i = (i + 1) & mask)
+  {
+    if(m_Entries[i].id == id)
+      return m_Entries[i];
+
+    if(m_Entries[i].id == ResourceId())
+    {
+      m_Entries[i].id = id;
+      m_Count++;
+      return m_Entries[i];
+    }
+  }
+}
+
+void DescSetBindRefs::Erase(Entry *entry)
+{
+  const size_t mask = m_Entries.size() - 1;
+
+  size_t hole = entry - m_Entries.data();
+
+  // backward-shift deletion: move later entries in the same probe run back into the hole, so we
+  // never need tombstones and lookups stay as short as if the entry had never been added.
+  for(size_t i = (hole + 1) & mask; m_Entries[i].id != ResourceId(); i = (i + 1) & mask)
+  {
+    size_t home = Hash(m_Entries[i].id) & mask;
+
+    // the entry can only move back if its home slot isn't cyclically within (hole, i]
+    bool homeInRange = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+
+    if(!homeInRange)
+    {
+      m_Entries[hole] = m_Entries[i];
+      hole = i;
+    }
+  }
+
+  m_Entries[hole] = Entry();
+  m_Count--;
+}
+
+void DescSetBindRefs::Grow()
+{
+  std::vector<Entry> old;
+  old.swap(m_Entries);
+
+  m_Entries.resize(old.empty() ? 8 : old.size() * 2);
+  m_Count = 0;
+
+  for(const Entry &e : old)
+  {
+    if(e.id != ResourceId())
+      FindOrAdd(e.id) = e;
+  }
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#undef None
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Descriptor set bind ref tracking", "[vulkan]")
+{
+  std::vector<ResourceId> ids;
+  for(int i = 0; i < 1000; i++)
+    ids.push_back(ResourceIDGen::GetNewUniqueID());
+
+  DescSetBindRefs refs;
+
+  CHECK(refs.empty());
+  CHECK(refs.Find(ids[0]) == NULL);
+  CHECK(!(refs.begin() != refs.end()));
+
+  for(size_t i = 0; i < ids.size(); i++)
+  {
+    DescSetBindRefs::Entry &e = refs.FindOrAdd(ids[i]);
+    CHECK(e.refcount == 0);
+    e.refcount = uint32_t(i + 1);
+    e.ref = eFrameRef_Read;
+  }
+
+  CHECK(refs.size() == ids.size());
+
+  // adding again finds the existing entries
+  for(size_t i = 0; i < ids.size(); i++)
+    CHECK(refs.FindOrAdd(ids[i]).refcount == uint32_t(i + 1));
+
+  CHECK(refs.size() == ids.size());
+
+  // remove every third entry
+  for(size_t i = 0; i < ids.size(); i += 3)
+    refs.Erase(refs.Find(ids[i]));
+
+  size_t iterated = 0;
+  for(auto it = refs.begin(); it != refs.end(); ++it)
+  {
+    iterated++;
+    CHECK(it->refcount > 0);
+    CHECK((it->ref == eFrameRef_Read));
+  }
+
+  CHECK(iterated == refs.size());
+
+  for(size_t i = 0; i < ids.size(); i++)
+  {
+    DescSetBindRefs::Entry *e = refs.Find(ids[i]);
+
+    if(i % 3 == 0)
+    {
+      CHECK(e == NULL);
+    }
+    else
+    {
+      REQUIRE(e != NULL);
+      CHECK(e->id == ids[i]);
+      CHECK(e->refcount == uint32_t(i + 1));
+    }
+  }
+
+  refs.clear();
+
+  CHECK(refs.empty());
+  CHECK(refs.Find(ids[1]) == NULL);
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -896,6 +896,8 @@ struct SparseMapping
   void Update(uint32_t numBindings, const VkSparseImageMemoryBind *pBindings);
 };
 
+struct ImageLayouts;
+
 struct CmdBufferRecordingInfo
 {
   VkDevice device;
@@ -906,6 +908,10 @@ struct CmdBufferRecordingInfo
 
   vector<pair<ResourceId, ImageRegionState> > imgbarriers;
 
+  // the tracked layouts for each image in imgbarriers, resolved once at vkEndCommandBuffer so
+  // queue submits don't need to take the global image layouts lock.
+  vector<ImageLayouts *> imgLayouts;
+
   // sparse resources referenced by this command buffer (at submit time
   // need to go through the sparse mapping and reference all memory)
   set<SparseMapping *> sparse;
@@ -923,6 +929,90 @@ struct CmdBufferRecordingInfo
 
 struct DescSetLayout;
 
+// the resources referenced by a descriptor set's current bindings, each with a refcount and the
+// frame ref type to apply when the set is used. Descriptor writes are very frequent so this is a
+// flat open-addressed table rather than a map - no allocation per entry, and iterating it on
+// submit is a linear walk over one array.
+class DescSetBindRefs
+{
+public:
+  struct Entry
+  {
+    Entry() : refcount(0), ref(eFrameRef_Unknown) {}
+    ResourceId id;
+    uint32_t refcount;
+    FrameRefType ref;
+  };
+
+  class const_iterator
+  {
+  public:
+    const_iterator(const Entry *e, const Entry *end) : m_Entry(e), m_End(end) { Skip(); }
+    const Entry &operator*() const { return *m_Entry; }
+    const Entry *operator->() const { return m_Entry; }
+    const_iterator &operator++()
+    {
+      m_Entry++;
+      Skip();
+      return *this;
+    }
+    bool operator==(const const_iterator &o) const { return m_Entry == o.m_Entry; }
+    bool operator!=(const const_iterator &o) const { return m_Entry != o.m_Entry; }
+  private:
+    void Skip()
+    {
+      while(m_Entry != m_End && m_Entry->id == ResourceId())
+        m_Entry++;
+    }
+
+    const Entry *m_Entry;
+    const Entry *m_End;
+  };
+
+  const_iterator begin() const
+  {
+    return const_iterator(m_Entries.data(), m_Entries.data() + m_Entries.size());
+  }
+  const_iterator end() const
+  {
+    return const_iterator(m_Entries.data() + m_Entries.size(),
+                          m_Entries.data() + m_Entries.size());
+  }
+
+  size_t size() const { return m_Count; }
+  bool empty() const { return m_Count == 0; }
+  void clear()
+  {
+    m_Entries.clear();
+    m_Count = 0;
+  }
+
+  // returns NULL if id isn't present
+  Entry *Find(ResourceId id);
+
+  // returns the entry for id, adding one with a refcount of 0 if it isn't present. The returned
+  // pointer is invalidated by any later add or erase.
+  Entry &FindOrAdd(ResourceId id);
+
+  void Erase(Entry *entry);
+
+private:
+  static size_t Hash(ResourceId id)
+  {
+    uint64_t val;
+    RDCCOMPILE_ASSERT(sizeof(val) == sizeof(id), "ResourceId is expected to be 64-bit");
+    memcpy(&val, &id, sizeof(val));
+    // IDs are mostly sequential, fibonacci hashing spreads them over the table
+    return size_t((val * 11400714819323198485ULL) >> 32);
+  }
+
+  void Grow();
+
+  // power-of-two sized, empty slots have a NULL id
+  std::vector<Entry> m_Entries;
+  size_t m_Count = 0;
+};
+
 struct DescriptorSetData
 {
   DescriptorSetData() : layout(NULL) {}
@@ -945,7 +1035,15 @@ struct DescriptorSetData
   // the refcount has the high-bit set if this resource has sparse
   // mapping information
   static const uint32_t SPARSE_REF_BIT = 0x80000000;
-  map<ResourceId, pair<uint32_t, FrameRefType> > bindFrameRefs;
+  DescSetBindRefs bindFrameRefs;
+
+  // non-zero if some descriptor writes skipped updating bindFrameRefs while idle, so that it is
+  // out of date and must be rebuilt from descBindings before the next capture.
+  volatile int32_t bindRefsDeferred = 0;
+
+  // held while the slots and bind refs are updated with deferred tracking enabled, so that
+  // rebuilding deferred refs at the start of a capture doesn't race with an application thread.
+  Threading::SpinLock refsLock;
 };
 
 struct PipelineLayoutData
@@ -1015,6 +1113,7 @@ public:
     cmdInfo->dirtied.swap(bakedCommands->cmdInfo->dirtied);
     cmdInfo->boundDescSets.swap(bakedCommands->cmdInfo->boundDescSets);
     cmdInfo->imgbarriers.swap(bakedCommands->cmdInfo->imgbarriers);
+    cmdInfo->imgLayouts.swap(bakedCommands->cmdInfo->imgLayouts);
     cmdInfo->subcmds.swap(bakedCommands->cmdInfo->subcmds);
     cmdInfo->sparse.swap(bakedCommands->cmdInfo->sparse);
   }
@@ -1027,17 +1126,19 @@ public:
       return;
     }
 
-    if((descInfo->bindFrameRefs[id].first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
+    DescSetBindRefs::Entry &entry = descInfo->bindFrameRefs.FindOrAdd(id);
+
+    if((entry.refcount & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
     {
-      descInfo->bindFrameRefs[id] =
-          std::make_pair(1 | (hasSparse ? DescriptorSetData::SPARSE_REF_BIT : 0), ref);
+      entry.refcount = 1 | (hasSparse ? DescriptorSetData::SPARSE_REF_BIT : 0);
+      entry.ref = ref;
     }
     else
     {
       // be conservative - mark refs as read before write if we see a write and a read ref on it
-      if(ref == eFrameRef_Write && descInfo->bindFrameRefs[id].second == eFrameRef_Read)
-        descInfo->bindFrameRefs[id].second = eFrameRef_ReadBeforeWrite;
-      descInfo->bindFrameRefs[id].first++;
+      if(ref == eFrameRef_Write && entry.ref == eFrameRef_Read)
+        entry.ref = eFrameRef_ReadBeforeWrite;
+      entry.refcount++;
     }
   }
 
@@ -1048,19 +1149,19 @@ public:
     if(id == ResourceId())
       return;
 
-    auto it = descInfo->bindFrameRefs.find(id);
+    DescSetBindRefs::Entry *entry = descInfo->bindFrameRefs.Find(id);
 
     // in the case of re-used handles bound to descriptor sets,
     // it's possible to try and remove a frameref on something we
     // don't have (which means we'll have a corresponding stale ref)
     // but this is harmless so we can ignore it.
-    if(it == descInfo->bindFrameRefs.end())
+    if(entry == NULL)
       return;
 
-    it->second.first--;
+    entry->refcount--;
 
-    if((it->second.first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
-      descInfo->bindFrameRefs.erase(it);
+    if((entry->refcount & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
+      descInfo->bindFrameRefs.Erase(entry);
   }
 
   // we have a lot of 'cold' data in the resource record, as it can be accessed
@@ -1197,6 +1298,10 @@ struct ImageLayouts
   int layerCount, levelCount, sampleCount;
   VkExtent3D extent;
   VkFormat format;
+
+  // protects subresourceStates while barriers are applied, so that submits touching different
+  // images don't contend. Not serialised.
+  Threading::SpinLock lock;
 };
 
 DECLARE_REFLECTION_STRUCT(ImageLayouts);
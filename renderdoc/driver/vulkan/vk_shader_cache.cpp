@@ -65,8 +65,6 @@ static const BuiltinShaderConfig builtinShaders[] = {
      FeatureCheck::NoCheck, true},
     {BuiltinShader::MeshFS, EmbeddedResource(glsl_mesh_frag), SPIRVShaderStage::Fragment,
      FeatureCheck::NoCheck, true},
-    {BuiltinShader::MeshCS, EmbeddedResource(glsl_mesh_comp), SPIRVShaderStage::Compute,
-     FeatureCheck::NoCheck, true},
     {BuiltinShader::OutlineFS, EmbeddedResource(glsl_outline_frag), SPIRVShaderStage::Fragment,
      FeatureCheck::NoCheck, true},
     {BuiltinShader::QuadResolveFS, EmbeddedResource(glsl_quadresolve_frag),
@@ -124,6 +122,28 @@ VulkanShaderCache::VulkanShaderCache(WrappedVulkan *driver)
   m_pDriver = driver;
   m_Device = driver->GetDev();
 
+  if(IsReplayMode(driver->GetState()) &&
+     RenderDoc::Inst().GetConfigSetting("Vulkan_PipelineCache") != "0")
+  {
+    std::vector<byte> initialData;
+    LoadPipelineCache(initialData);
+
+    m_PipelineCacheLoadedSize = initialData.size();
+
+    VkPipelineCacheCreateInfo cacheInfo = {
+        VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO, NULL, 0, initialData.size(),
+        initialData.empty() ? NULL : initialData.data(),
+    };
+
+    VkResult vkr = ObjDisp(m_Device)->CreatePipelineCache(Unwrap(m_Device), &cacheInfo, NULL,
+                                                          &m_PipelineCache);
+    if(vkr != VK_SUCCESS)
+    {
+      RDCWARN("Couldn't create replay pipeline cache: %s", ToStr(vkr).c_str());
+      m_PipelineCache = VK_NULL_HANDLE;
+    }
+  }
+
   SetCaching(true);
 
   VkDriverInfo driverVersion = driver->GetDriverVersion();
@@ -208,6 +228,85 @@ VulkanShaderCache::~VulkanShaderCache()
 
   for(size_t i = 0; i < ARRAY_COUNT(m_BuiltinShaderModules); i++)
     m_pDriver->vkDestroyShaderModule(m_Device, m_BuiltinShaderModules[i], NULL);
+
+  if(m_PipelineCache != VK_NULL_HANDLE)
+  {
+    SavePipelineCache();
+
+    ObjDisp(m_Device)->DestroyPipelineCache(Unwrap(m_Device), m_PipelineCache, NULL);
+  }
+}
+
+std::string VulkanShaderCache::GetPipelineCacheFilename()
+{
+  const VkPhysicalDeviceProperties &props = m_pDriver->GetDeviceProps();
+
+  // the cache data is only usable on the exact same device and driver, but the header check below
+  // catches driver updates so we only need to keep one cache per device.
+  return FileIO::GetAppFolderFilename(
+      StringFormat::Fmt("vkpipelines_%08x_%08x.cache", props.vendorID, props.deviceID));
+}
+
+void VulkanShaderCache::LoadPipelineCache(std::vector<byte> &data)
+{
+  std::string filename = GetPipelineCacheFilename();
+
+  if(!FileIO::exists(filename.c_str()) || !FileIO::slurp(filename.c_str(), data))
+  {
+    data.clear();
+    return;
+  }
+
+  const VkPhysicalDeviceProperties &props = m_pDriver->GetDeviceProps();
+
+  // implementations are required to ignore incompatible data, but don't rely on that - check the
+  // header ourselves and start from empty if it doesn't match this device and driver.
+  uint32_t header[4] = {};
+  const size_t headerSize = sizeof(header) + VK_UUID_SIZE;
+
+  if(data.size() >= headerSize)
+    memcpy(header, data.data(), sizeof(header));
+
+  if(data.size() < headerSize || header[0] < headerSize || header[0] > data.size() ||
+     header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || header[2] != props.vendorID ||
+     header[3] != props.deviceID ||
+     memcmp(data.data() + sizeof(header), props.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+  {
+    RDCLOG("Discarding stale replay pipeline cache %s", filename.c_str());
+    data.clear();
+  }
+}
+
+void VulkanShaderCache::SavePipelineCache()
+{
+  size_t size = 0;
+  VkResult vkr =
+      ObjDisp(m_Device)->GetPipelineCacheData(Unwrap(m_Device), m_PipelineCache, &size, NULL);
+
+  // nothing was added since we loaded it, no need to write it back out
+  if(vkr != VK_SUCCESS || size == m_PipelineCacheLoadedSize)
+    return;
+
+  std::string filename = GetPipelineCacheFilename();
+
+  if(size > m_MaxPipelineCacheSize)
+  {
+    RDCLOG("Replay pipeline cache has grown to %llu bytes, resetting it", (uint64_t)size);
+    FileIO::Delete(filename.c_str());
+    return;
+  }
+
+  std::vector<byte> data(size);
+  vkr = ObjDisp(m_Device)->GetPipelineCacheData(Unwrap(m_Device), m_PipelineCache, &size,
+                                                data.data());
+
+  if(vkr != VK_SUCCESS)
+    return;
+
+  data.resize(size);
+
+  if(!FileIO::dump(filename.c_str(), data.data(), data.size()))
+    RDCWARN("Couldn't write replay pipeline cache to %s", filename.c_str());
 }
 
 std::string VulkanShaderCache::GetSPIRVBlob(const SPIRVCompilationSettings &settings,
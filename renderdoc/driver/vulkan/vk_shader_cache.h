@@ -42,7 +42,6 @@ enum class BuiltinShader
   MeshVS,
   MeshGS,
   MeshFS,
-  MeshCS,
   OutlineFS,
   QuadResolveFS,
   QuadWriteFS,
@@ -76,7 +75,18 @@ public:
   void MakeComputePipelineInfo(VkComputePipelineCreateInfo &pipeCreateInfo, ResourceId pipeline);
 
   void SetCaching(bool enabled) { m_CacheShaders = enabled; }
+  // an unwrapped pipeline cache used for all pipelines created on replay, persisted to disk between
+  // runs so that reloading a capture (or one sharing the same shaders) skips the driver compiles.
+  // VK_NULL_HANDLE when capturing, or if disabled with the Vulkan_PipelineCache config setting.
+  VkPipelineCache GetPipelineCache() { return m_PipelineCache; }
 private:
+  std::string GetPipelineCacheFilename();
+  void LoadPipelineCache(std::vector<byte> &data);
+  void SavePipelineCache();
+
+  // don't let the on-disk pipeline cache grow without bound
+  static const size_t m_MaxPipelineCacheSize = 256 * 1024 * 1024;
+
   static const uint32_t m_ShaderCacheMagic = 0xf00d00d5;
   static const uint32_t m_ShaderCacheVersion = 1;
 
@@ -86,6 +96,9 @@ private:
   bool m_ShaderCacheDirty = false, m_CacheShaders = false;
   std::map<uint32_t, SPIRVBlob> m_ShaderCache;
 
+  VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+  size_t m_PipelineCacheLoadedSize = 0;
+
   SPIRVBlob m_BuiltinShaderBlobs[arraydim<BuiltinShader>()] = {NULL};
   VkShaderModule m_BuiltinShaderModules[arraydim<BuiltinShader>()] = {VK_NULL_HANDLE};
 };
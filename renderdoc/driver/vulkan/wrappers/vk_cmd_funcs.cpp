@@ -984,6 +984,12 @@ VkResult WrappedVulkan::vkEndCommandBuffer(VkCommandBuffer commandBuffer)
       record->AddChunk(scope.Get());
     }
 
+    {
+      SCOPED_LOCK(m_ImageLayoutsLock);
+      GetResourceManager()->ResolveBarrierLayouts(record->cmdInfo->imgbarriers, m_ImageLayouts,
+                                                  record->cmdInfo->imgLayouts);
+    }
+
     record->Bake();
   }
 
@@ -1623,12 +1629,12 @@ void WrappedVulkan::vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer,
     {
       VkResourceRecord *descSet = GetRecord(pDescriptorSets[i]);
 
-      map<ResourceId, pair<uint32_t, FrameRefType> > &frameRefs = descSet->descInfo->bindFrameRefs;
+      const DescSetBindRefs &frameRefs = descSet->descInfo->bindFrameRefs;
 
       for(auto it = frameRefs.begin(); it != frameRefs.end(); ++it)
       {
-        if(it->second.second == eFrameRef_Write || it->second.second == eFrameRef_ReadBeforeWrite)
-          record->cmdInfo->dirtied.insert(it->first);
+        if(it->ref == eFrameRef_Write || it->ref == eFrameRef_ReadBeforeWrite)
+          record->cmdInfo->dirtied.insert(it->id);
       }
     }
   }
@@ -795,6 +795,119 @@ void WrappedVulkan::ReplayDescriptorSetCopy(VkDevice device, const VkCopyDescrip
   }
 }
 
+// slots aren't updated when an object they point to is destroyed. Normally bind refs are added at
+// write time while the object is still alive, but when rebuilding deferred refs we might see stale
+// handles, so NULL out any that no longer have a live record.
+template <typename VulkanType>
+static void DropStaleHandle(VulkanResourceManager *rm, VulkanType &handle)
+{
+  if(handle == VK_NULL_HANDLE)
+    return;
+
+  ResourceId id = GetResID(handle);
+  if(id == ResourceId() || rm->GetResourceRecord(id) == NULL)
+    handle = VK_NULL_HANDLE;
+}
+
+// FlushDeferredDescriptorRefs only rebuilds sets with deferred refs, so an update only needs to
+// lock its set against the flush if the set's refs are, or could become, deferred. With the
+// DeferDescriptorTracking option off that is never the case, and no lock is taken.
+class DeferredRefsLock
+{
+public:
+  DeferredRefsLock(DescriptorSetData &descInfo, bool deferTracking)
+      : m_SL(deferTracking || descInfo.bindRefsDeferred ? &descInfo.refsLock : NULL)
+  {
+    if(m_SL)
+      m_SL->Lock();
+  }
+  ~DeferredRefsLock()
+  {
+    if(m_SL)
+      m_SL->Unlock();
+  }
+
+private:
+  Threading::SpinLock *m_SL;
+};
+
+bool WrappedVulkan::DeferDescriptorRefs(VkResourceRecord *setRecord, FrameRefType ref)
+{
+  // descriptors that can be written through are always tracked immediately, since binding the set
+  // marks their resources as dirty even while idle. Only read-only descriptors can be deferred.
+  // The read of the capture state must happen under the set's lock, see vkUpdateDescriptorSets.
+  if(ref != eFrameRef_Read || IsActiveCapturing(m_State))
+    return false;
+
+  // only the first deferred write since the last flush needs to queue up the set
+  if(Atomic::CmpExch32(&setRecord->descInfo->bindRefsDeferred, 0, 1) == 0)
+  {
+    SCOPED_LOCK(m_DeferredDescSetsLock);
+    m_DeferredDescSets.insert(setRecord->GetResourceID());
+  }
+
+  return true;
+}
+
+void WrappedVulkan::ReleaseDeferredDescriptorRefs(ResourceId id)
+{
+  SCOPED_LOCK(m_DeferredDescSetsLock);
+  m_DeferredDescSets.erase(id);
+}
+
+void WrappedVulkan::FlushDeferredDescriptorRefs()
+{
+  std::set<ResourceId> sets;
+  {
+    SCOPED_LOCK(m_DeferredDescSetsLock);
+    sets.swap(m_DeferredDescSets);
+  }
+
+  if(sets.empty())
+    return;
+
+  RDCDEBUG("Rebuilding bind refs for %u descriptor sets with deferred tracking",
+           (uint32_t)sets.size());
+
+  VulkanResourceManager *rm = GetResourceManager();
+
+  for(ResourceId setId : sets)
+  {
+    // the set might have been freed since it was queued
+    VkResourceRecord *record = rm->GetResourceRecord(setId);
+    if(record == NULL || record->descInfo == NULL || record->descInfo->layout == NULL)
+      continue;
+
+    DescriptorSetData &descInfo = *record->descInfo;
+    const DescSetLayout &layout = *descInfo.layout;
+
+    // an application thread could be partway through updating this set
+    SCOPED_SPINLOCK(descInfo.refsLock);
+
+    // reset the flag before rebuilding, so a write racing with us queues the set up again instead
+    // of being lost.
+    descInfo.bindRefsDeferred = 0;
+    descInfo.bindFrameRefs.clear();
+
+    for(size_t b = 0; b < descInfo.descBindings.size(); b++)
+    {
+      FrameRefType ref = GetRefType(layout.bindings[b].descriptorType);
+
+      for(uint32_t d = 0; d < layout.bindings[b].descriptorCount; d++)
+      {
+        DescriptorSetSlot slot = descInfo.descBindings[b][d];
+
+        DropStaleHandle(rm, slot.texelBufferView);
+        DropStaleHandle(rm, slot.imageInfo.imageView);
+        DropStaleHandle(rm, slot.imageInfo.sampler);
+        DropStaleHandle(rm, slot.bufferInfo.buffer);
+
+        slot.AddBindRefs(record, ref);
+      }
+    }
+  }
+}
+
 template <typename SerialiserType>
 bool WrappedVulkan::Serialise_vkUpdateDescriptorSets(SerialiserType &ser, VkDevice device,
                                                      uint32_t writeCount,
@@ -921,11 +1034,10 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
         Unwrap(device), writeCount, unwrappedWrites, copyCount, unwrappedCopies));
   }
 
-  bool capframe = false;
-  {
-    SCOPED_LOCK(m_CapTransitionLock);
-    capframe = IsActiveCapturing(m_State);
-  }
+  // no need to take m_CapTransitionLock here - taking it would serialise every descriptor update
+  // in the application. An update racing with the start of a capture is still tracked below into
+  // the set's bind refs, and those are all referenced when the set is next bound and submitted.
+  bool capframe = IsActiveCapturing(m_State);
 
   if(capframe)
   {
@@ -974,11 +1086,11 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
       for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
           refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
       {
-        GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
+        GetResourceManager()->MarkResourceFrameReferenced(refit->id, refit->ref);
 
-        if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
+        if(refit->refcount & DescriptorSetData::SPARSE_REF_BIT)
         {
-          VkResourceRecord *record = GetResourceManager()->GetResourceRecord(refit->first);
+          VkResourceRecord *record = GetResourceManager()->GetResourceRecord(refit->id);
 
           GetResourceManager()->MarkSparseMapReferenced(record->sparseInfo);
         }
@@ -989,6 +1101,8 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
   // need to track descriptor set contents whether capframing or idle
   if(IsCaptureMode(m_State))
   {
+    const bool deferTracking = RenderDoc::Inst().GetCaptureOptions().deferDescriptorTracking;
+
     for(uint32_t i = 0; i < writeCount; i++)
     {
       const VkWriteDescriptorSet &descWrite = pDescriptorWrites[i];
@@ -1005,6 +1119,17 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
 
       FrameRefType ref = GetRefType(layoutBinding->descriptorType);
 
+      // with the DeferDescriptorTracking option we skip maintaining bind refs for read-only
+      // descriptors while idle, and only store the slot contents. The refs are rebuilt from the
+      // slots when a capture begins, in FlushDeferredDescriptorRefs.
+      //
+      // The set's lock stops that rebuild from seeing a half-written update. The capture state is
+      // read again under the lock, because a capture may have started and flushed this set since
+      // capframe was read - in which case the refs must be tracked directly.
+      DeferredRefsLock lock(*record->descInfo, deferTracking);
+
+      bool deferRefs = deferTracking && DeferDescriptorRefs(record, ref);
+
       // We need to handle the cases where these bindings are stale:
       // ie. image handle 0xf00baa is allocated
       // bound into a descriptor set
@@ -1045,7 +1170,8 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
 
         DescriptorSetSlot &bind = (*binding)[curIdx];
 
-        bind.RemoveBindRefs(record);
+        if(!deferRefs)
+          bind.RemoveBindRefs(record);
 
         if(descWrite.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER ||
            descWrite.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER)
@@ -1072,7 +1198,8 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
           bind.bufferInfo = descWrite.pBufferInfo[d];
         }
 
-        bind.AddBindRefs(record, ref);
+        if(!deferRefs)
+          bind.AddBindRefs(record, ref);
       }
     }
 
@@ -1105,6 +1232,10 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
 
       FrameRefType ref = GetRefType(dstlayoutBinding->descriptorType);
 
+      DeferredRefsLock lock(*dstrecord->descInfo, deferTracking);
+
+      bool deferRefs = deferTracking && DeferDescriptorRefs(dstrecord, ref);
+
       // allow roll-over between consecutive bindings. See above in the plain write case for more
       // explanation
       uint32_t curSrcIdx = pDescriptorCopies[i].srcArrayElement;
@@ -1129,9 +1260,11 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
 
         DescriptorSetSlot &bind = (*dstbinding)[curDstIdx];
 
-        bind.RemoveBindRefs(dstrecord);
+        if(!deferRefs)
+          bind.RemoveBindRefs(dstrecord);
         bind = (*srcbinding)[curSrcIdx];
-        bind.AddBindRefs(dstrecord, ref);
+        if(!deferRefs)
+          bind.AddBindRefs(dstrecord, ref);
       }
     }
   }
@@ -1346,11 +1479,8 @@ void WrappedVulkan::vkUpdateDescriptorSetWithTemplate(
         Unwrap(device), Unwrap(descriptorSet), Unwrap(descriptorUpdateTemplate), memory));
   }
 
-  bool capframe = false;
-  {
-    SCOPED_LOCK(m_CapTransitionLock);
-    capframe = IsActiveCapturing(m_State);
-  }
+  // see vkUpdateDescriptorSets for why the capture transition lock isn't needed
+  bool capframe = IsActiveCapturing(m_State);
 
   if(capframe)
   {
@@ -1371,6 +1501,8 @@ void WrappedVulkan::vkUpdateDescriptorSetWithTemplate(
   // need to track descriptor set contents whether capframing or idle
   if(IsCaptureMode(m_State))
   {
+    const bool deferTracking = RenderDoc::Inst().GetCaptureOptions().deferDescriptorTracking;
+
     for(const VkDescriptorUpdateTemplateEntry &entry : tempInfo->updates)
     {
       VkResourceRecord *record = GetRecord(descriptorSet);
@@ -1385,6 +1517,11 @@ void WrappedVulkan::vkUpdateDescriptorSetWithTemplate(
 
       FrameRefType ref = GetRefType(layoutBinding->descriptorType);
 
+      // see vkUpdateDescriptorSets
+      DeferredRefsLock lock(*record->descInfo, deferTracking);
+
+      bool deferRefs = deferTracking && DeferDescriptorRefs(record, ref);
+
       // start at the dstArrayElement
       uint32_t curIdx = entry.dstArrayElement;
 
@@ -1412,7 +1549,8 @@ void WrappedVulkan::vkUpdateDescriptorSetWithTemplate(
 
         DescriptorSetSlot &bind = (*binding)[curIdx];
 
-        bind.RemoveBindRefs(record);
+        if(!deferRefs)
+          bind.RemoveBindRefs(record);
 
         if(entry.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER ||
            entry.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER)
@@ -1439,7 +1577,8 @@ void WrappedVulkan::vkUpdateDescriptorSetWithTemplate(
           bind.bufferInfo = *(VkDescriptorBufferInfo *)src;
         }
 
-        bind.AddBindRefs(record, ref);
+        if(!deferRefs)
+          bind.AddBindRefs(record, ref);
       }
     }
   }
@@ -595,11 +595,8 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
       VkResourceRecord *record = GetRecord(pSubmits[s].pCommandBuffers[i]);
 
-      {
-        SCOPED_LOCK(m_ImageLayoutsLock);
-        GetResourceManager()->ApplyBarriers(record->bakedCommands->cmdInfo->imgbarriers,
-                                            m_ImageLayouts);
-      }
+      GetResourceManager()->ApplyBarriers(record->bakedCommands->cmdInfo->imgbarriers,
+                                          record->bakedCommands->cmdInfo->imgLayouts);
 
       // need to lock the whole section of code, not just the check on
       // m_State, as we also need to make sure we don't check the state,
@@ -632,12 +629,12 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
           for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
               refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
           {
-            refdIDs.insert(refit->first);
-            GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
+            refdIDs.insert(refit->id);
+            GetResourceManager()->MarkResourceFrameReferenced(refit->id, refit->ref);
 
-            if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
+            if(refit->refcount & DescriptorSetData::SPARSE_REF_BIT)
             {
-              VkResourceRecord *sparserecord = GetResourceManager()->GetResourceRecord(refit->first);
+              VkResourceRecord *sparserecord = GetResourceManager()->GetResourceRecord(refit->id);
 
               GetResourceManager()->MarkSparseMapReferenced(sparserecord->sparseInfo);
             }
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "../vk_core.h"
+#include "../vk_shader_cache.h"
 #include "driver/shaders/spirv/spirv_common.h"
 
 template <>
@@ -387,6 +388,181 @@ VkResult WrappedVulkan::vkCreatePipelineCache(VkDevice device,
   return ret;
 }
 
+bool WrappedVulkan::CanDeferPipelinesPast(VulkanChunk chunk)
+{
+  // these chunks never look up a pipeline's live handle, so they can be processed while earlier
+  // pipelines are still being created. Anything else flushes the deferred pipelines first.
+  switch(chunk)
+  {
+    case VulkanChunk::vkCreateRenderPass:
+    case VulkanChunk::vkCreateDescriptorSetLayout:
+    case VulkanChunk::vkCreateSampler:
+    case VulkanChunk::vkCreateShaderModule:
+    case VulkanChunk::vkCreatePipelineLayout:
+    case VulkanChunk::vkCreatePipelineCache:
+    case VulkanChunk::vkCreateGraphicsPipelines:
+    case VulkanChunk::vkCreateComputePipelines:
+    case VulkanChunk::SetShaderDebugPath:
+    // names for pending pipelines are stored against the original ID and moved over when the
+    // pipeline is registered
+    case VulkanChunk::vkDebugMarkerSetObjectNameEXT:
+    case VulkanChunk::vkSetDebugUtilsObjectNameEXT: return true;
+    default: break;
+  }
+
+  return false;
+}
+
+bool WrappedVulkan::DeferPipeline(DeferredPipeline *pipe)
+{
+  m_QueuedPipelines.push_back(pipe);
+
+  // batch up enough pipelines to keep every core busy without spinning up threads constantly
+  const size_t batchSize = RDCMAX(64U, Threading::GetCoreCount() * 8);
+
+  if(m_QueuedPipelines.size() < batchSize)
+    return true;
+
+  // wait for the previous batch and register it, so that pipelines are always registered in the
+  // order they were created, then start compiling this batch in the background.
+  bool success = FinishPipelineBatch();
+
+  m_CompilingPipelines.swap(m_QueuedPipelines);
+
+  m_PipelineBatchThread =
+      Threading::CreateThread([this]() { CompileDeferredPipelines(m_CompilingPipelines); });
+
+  if(m_PipelineBatchThread == 0)
+    CompileDeferredPipelines(m_CompilingPipelines);
+
+  return success;
+}
+
+void WrappedVulkan::CompileDeferredPipelines(const std::vector<DeferredPipeline *> &pipes)
+{
+  if(pipes.empty())
+    return;
+
+  VkPipelineCache cache = GetShaderCache()->GetPipelineCache();
+
+  Threading::ParallelFor((uint32_t)pipes.size(), [&pipes, cache](uint32_t idx) {
+    DeferredPipeline &p = *pipes[idx];
+    VkDevice dev = Unwrap(p.device);
+
+    if(p.compute)
+    {
+      p.result = ObjDisp(p.device)->CreateComputePipelines(dev, cache, 1, &p.unwrappedCompute,
+                                                           NULL, &p.pipe);
+    }
+    else
+    {
+      p.result = ObjDisp(p.device)->CreateGraphicsPipelines(dev, cache, 1, &p.unwrappedGraphics,
+                                                            NULL, &p.pipe);
+
+      // the subpass 0 variant is needed for any pipeline that is registered, so create it here
+      // too. If this pipeline turns out to be a duplicate it's destroyed again.
+      if(p.result == VK_SUCCESS)
+      {
+        VkResult vkr = ObjDisp(p.device)->CreateGraphicsPipelines(
+            dev, cache, 1, &p.unwrappedSubpass0, NULL, &p.subpass0pipe);
+        RDCASSERTEQUAL(vkr, VK_SUCCESS);
+      }
+    }
+  });
+}
+
+bool WrappedVulkan::RegisterDeferredPipelines(std::vector<DeferredPipeline *> &pipes)
+{
+  bool success = true;
+
+  for(DeferredPipeline *p : pipes)
+  {
+    VkDevice device = p->device;
+
+    if(p->result != VK_SUCCESS)
+    {
+      RDCERR("Failed on resource serialise-creation, VkResult: %s", ToStr(p->result).c_str());
+      success = false;
+    }
+    else if(GetResourceManager()->HasWrapper(ToTypedHandle(p->pipe)))
+    {
+      ResourceId live = GetResourceManager()->GetNonDispWrapper(p->pipe)->id;
+
+      // destroy this instance of the duplicate, as we must have matching create/destroy
+      // calls and there won't be a wrapped resource hanging around to destroy this one.
+      ObjDisp(device)->DestroyPipeline(Unwrap(device), p->pipe, NULL);
+      if(p->subpass0pipe != VK_NULL_HANDLE)
+        ObjDisp(device)->DestroyPipeline(Unwrap(device), p->subpass0pipe, NULL);
+
+      // whenever the new ID is requested, return the old ID, via replacements.
+      GetResourceManager()->ReplaceResource(p->id, GetResourceManager()->GetOriginalID(live));
+    }
+    else
+    {
+      ResourceId live = GetResourceManager()->WrapResource(Unwrap(device), p->pipe);
+      GetResourceManager()->AddLiveResource(p->id, p->pipe);
+
+      // the specialisation info points into the pipeline's own storage, so it must be moved rather
+      // than copied.
+      VulkanCreationInfo::Pipeline &pipeInfo = m_CreationInfo.m_Pipeline[live];
+      pipeInfo = std::move(p->info);
+
+      if(!p->compute)
+      {
+        pipeInfo.subpass0pipe = p->subpass0pipe;
+
+        ResourceId subpass0id =
+            GetResourceManager()->WrapResource(Unwrap(device), pipeInfo.subpass0pipe);
+
+        // register as a live-only resource, so it is cleaned up properly
+        GetResourceManager()->AddLiveResource(subpass0id, pipeInfo.subpass0pipe);
+      }
+
+      // any name set while the pipeline was pending was stored on the original ID
+      auto it = m_CreationInfo.m_Names.find(p->id);
+      if(it != m_CreationInfo.m_Names.end())
+      {
+        m_CreationInfo.m_Names[live] = it->second;
+        m_CreationInfo.m_Names.erase(it);
+      }
+    }
+
+    if(p->compute)
+      Deserialise(p->computeInfo);
+    else
+      Deserialise(p->graphicsInfo);
+
+    delete p;
+  }
+
+  pipes.clear();
+
+  return success;
+}
+
+bool WrappedVulkan::FinishPipelineBatch()
+{
+  if(m_PipelineBatchThread)
+  {
+    Threading::JoinThread(m_PipelineBatchThread);
+    Threading::CloseThread(m_PipelineBatchThread);
+    m_PipelineBatchThread = 0;
+  }
+
+  return RegisterDeferredPipelines(m_CompilingPipelines);
+}
+
+bool WrappedVulkan::FlushDeferredPipelines()
+{
+  bool success = FinishPipelineBatch();
+
+  CompileDeferredPipelines(m_QueuedPipelines);
+
+  success &= RegisterDeferredPipelines(m_QueuedPipelines);
+
+  return success;
+}
+
 template <typename SerialiserType>
 bool WrappedVulkan::Serialise_vkCreateGraphicsPipelines(
     SerialiserType &ser, VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
@@ -409,19 +585,52 @@ bool WrappedVulkan::Serialise_vkCreateGraphicsPipelines(
     VkRenderPass origRP = CreateInfo.renderPass;
     VkPipelineCache origCache = pipelineCache;
 
-    // don't use pipeline caches on replay
-    pipelineCache = VK_NULL_HANDLE;
+    // don't use the application's pipeline caches on replay, only our own persistent one
+    VkPipelineCache replayCache = GetShaderCache()->GetPipelineCache();
+
+    DeferredPipeline *deferred = NULL;
+    VkResult ret = VK_SUCCESS;
 
-    VkGraphicsPipelineCreateInfo *unwrapped = UnwrapInfos(&CreateInfo, 1);
-    VkResult ret = ObjDisp(device)->CreateGraphicsPipelines(Unwrap(device), Unwrap(pipelineCache),
-                                                            1, unwrapped, NULL, &pipe);
+    if(m_DeferPipelineCreation)
+    {
+      deferred = new DeferredPipeline;
+      deferred->device = device;
+      deferred->id = Pipeline;
+      deferred->info.Init(GetResourceManager(), m_CreationInfo, &CreateInfo);
+
+      VkGraphicsPipelineCreateInfo *unwrapped = UnwrapInfos(&CreateInfo, 1);
+      deferred->unwrappedStages.assign(unwrapped->pStages,
+                                       unwrapped->pStages + unwrapped->stageCount);
+      deferred->unwrappedGraphics = *unwrapped;
+      deferred->unwrappedGraphics.pStages = deferred->unwrappedStages.data();
+
+      // the base pipeline may still be pending creation, and it's only a hint so just drop it.
+      if(deferred->unwrappedGraphics.basePipelineHandle == VK_NULL_HANDLE)
+      {
+        deferred->unwrappedGraphics.flags &= ~VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+        deferred->unwrappedGraphics.basePipelineIndex = -1;
+      }
+
+      ResourceId renderPassID = GetResID(CreateInfo.renderPass);
+
+      deferred->unwrappedSubpass0 = deferred->unwrappedGraphics;
+      deferred->unwrappedSubpass0.renderPass =
+          Unwrap(m_CreationInfo.m_RenderPass[renderPassID].loadRPs[CreateInfo.subpass]);
+      deferred->unwrappedSubpass0.subpass = 0;
+    }
+    else
+    {
+      VkGraphicsPipelineCreateInfo *unwrapped = UnwrapInfos(&CreateInfo, 1);
+      ret = ObjDisp(device)->CreateGraphicsPipelines(Unwrap(device), replayCache, 1, unwrapped,
+                                                     NULL, &pipe);
+    }
 
     if(ret != VK_SUCCESS)
     {
       RDCERR("Failed on resource serialise-creation, VkResult: %s", ToStr(ret).c_str());
       return false;
     }
-    else
+    else if(!deferred)
     {
       ResourceId live;
 
@@ -450,9 +659,9 @@ bool WrappedVulkan::Serialise_vkCreateGraphicsPipelines(
         CreateInfo.renderPass = m_CreationInfo.m_RenderPass[renderPassID].loadRPs[CreateInfo.subpass];
         CreateInfo.subpass = 0;
 
-        unwrapped = UnwrapInfos(&CreateInfo, 1);
-        ret = ObjDisp(device)->CreateGraphicsPipelines(Unwrap(device), Unwrap(pipelineCache), 1,
-                                                       unwrapped, NULL, &pipeInfo.subpass0pipe);
+        VkGraphicsPipelineCreateInfo *unwrapped = UnwrapInfos(&CreateInfo, 1);
+        ret = ObjDisp(device)->CreateGraphicsPipelines(Unwrap(device), replayCache, 1, unwrapped,
+                                                       NULL, &pipeInfo.subpass0pipe);
         RDCASSERTEQUAL(ret, VK_SUCCESS);
 
         ResourceId subpass0id =
@@ -473,6 +682,15 @@ bool WrappedVulkan::Serialise_vkCreateGraphicsPipelines(
     DerivedResource(CreateInfo.layout, Pipeline);
     for(uint32_t i = 0; i < CreateInfo.stageCount; i++)
       DerivedResource(CreateInfo.pStages[i].module, Pipeline);
+
+    if(deferred)
+    {
+      // take ownership of the deserialised create info, it's freed once the pipeline is registered
+      deferred->graphicsInfo = CreateInfo;
+      CreateInfo = VkGraphicsPipelineCreateInfo();
+
+      return DeferPipeline(deferred);
+    }
   }
 
   return true;
@@ -591,19 +809,42 @@ bool WrappedVulkan::Serialise_vkCreateComputePipelines(SerialiserType &ser, VkDe
 
     VkPipelineCache origCache = pipelineCache;
 
-    // don't use pipeline caches on replay
-    pipelineCache = VK_NULL_HANDLE;
+    // don't use the application's pipeline caches on replay, only our own persistent one
+    VkPipelineCache replayCache = GetShaderCache()->GetPipelineCache();
+
+    DeferredPipeline *deferred = NULL;
+    VkResult ret = VK_SUCCESS;
+
+    if(m_DeferPipelineCreation)
+    {
+      deferred = new DeferredPipeline;
+      deferred->device = device;
+      deferred->id = Pipeline;
+      deferred->compute = true;
+      deferred->info.Init(GetResourceManager(), m_CreationInfo, &CreateInfo);
 
-    VkComputePipelineCreateInfo *unwrapped = UnwrapInfos(&CreateInfo, 1);
-    VkResult ret = ObjDisp(device)->CreateComputePipelines(Unwrap(device), Unwrap(pipelineCache), 1,
-                                                           unwrapped, NULL, &pipe);
+      deferred->unwrappedCompute = *UnwrapInfos(&CreateInfo, 1);
+
+      // the base pipeline may still be pending creation, and it's only a hint so just drop it.
+      if(deferred->unwrappedCompute.basePipelineHandle == VK_NULL_HANDLE)
+      {
+        deferred->unwrappedCompute.flags &= ~VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+        deferred->unwrappedCompute.basePipelineIndex = -1;
+      }
+    }
+    else
+    {
+      VkComputePipelineCreateInfo *unwrapped = UnwrapInfos(&CreateInfo, 1);
+      ret = ObjDisp(device)->CreateComputePipelines(Unwrap(device), replayCache, 1, unwrapped,
+                                                    NULL, &pipe);
+    }
 
     if(ret != VK_SUCCESS)
     {
       RDCERR("Failed on resource serialise-creation, VkResult: %s", ToStr(ret).c_str());
       return false;
     }
-    else
+    else if(!deferred)
     {
       ResourceId live;
 
@@ -634,6 +875,15 @@ bool WrappedVulkan::Serialise_vkCreateComputePipelines(SerialiserType &ser, VkDe
       DerivedResource(CreateInfo.basePipelineHandle, Pipeline);
     DerivedResource(CreateInfo.layout, Pipeline);
     DerivedResource(CreateInfo.stage.module, Pipeline);
+
+    if(deferred)
+    {
+      // take ownership of the deserialised create info, it's freed once the pipeline is registered
+      deferred->computeInfo = CreateInfo;
+      CreateInfo = VkComputePipelineCreateInfo();
+
+      return DeferPipeline(deferred);
+    }
   }
 
   return true;
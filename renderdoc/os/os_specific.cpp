@@ -196,6 +196,7 @@ string OSUtility::MakeMachineIdentString(uint64_t ident)
 #if ENABLED(ENABLE_UNIT_TESTS)
 
 #include "3rdparty/catch/catch.hpp"
+#include "common/threading.h"
 
 TEST_CASE("Test OS-specific functions", "[osspecific]")
 {
@@ -559,6 +560,41 @@ TEST_CASE("Test OS-specific functions", "[osspecific]")
       lock.Unlock();
   };
 
+  SECTION("Spin locks")
+  {
+    // check that a spin lock serialises increments on multiple overlapping threads
+    int64_t value = 0;
+    Threading::SpinLock lock;
+
+    Threading::ThreadHandle threads[numThreads];
+    for(int threadID = 0; threadID < numThreads; threadID++)
+    {
+      threads[threadID] = Threading::CreateThread([&value, &lock]() {
+        for(int i = 0; i < 10000; i++)
+        {
+          SCOPED_SPINLOCK(lock);
+          value++;
+        }
+      });
+    }
+
+    for(int threadID = 0; threadID < numThreads; threadID++)
+    {
+      Threading::JoinThread(threads[threadID]);
+      Threading::CloseThread(threads[threadID]);
+    }
+
+    CHECK(value == 10000 * numThreads);
+
+    // a copy of a held lock starts unlocked
+    lock.Lock();
+    Threading::SpinLock copy(lock);
+    CHECK_FALSE(lock.Trylock());
+    CHECK(copy.Trylock());
+    copy.Unlock();
+    lock.Unlock();
+  };
+
   SECTION("IP processing")
   {
     CHECK(Network::MakeIP(127, 0, 0, 1) == 0x7f000001);
@@ -75,6 +75,8 @@ ExecuteResult LaunchAndInjectIntoProcess(const char *app, const char *workingDir
                                          const rdcarray<EnvironmentModification> &env,
                                          const char *logfile, const CaptureOptions &opts,
                                          bool waitForExit);
+bool IsProcessRunning(uint32_t pid);
+bool LimitProcessMemory(uint64_t bytes);
 void *LoadModule(const char *module);
 void *GetFunctionAddress(void *module, const char *function);
 uint32_t GetCurrentPID();
@@ -123,6 +125,9 @@ void JoinThread(ThreadHandle handle);
 void CloseThread(ThreadHandle handle);
 void Sleep(uint32_t milliseconds);
 
+// returns the number of logical processors available, always at least 1
+uint32_t GetCoreCount();
+
 // kind of windows specific, to handle this case:
 // http://blogs.msdn.com/b/oldnewthing/archive/2013/11/05/10463645.aspx
 void KeepModuleAlive();
@@ -152,6 +157,13 @@ public:
   bool RecvDataBlocking(void *data, uint32_t length);
   bool RecvDataNonBlocking(void *data, uint32_t &length);
 
+  // transfer directly between a file and the socket, without the data being copied through our
+  // own memory. Only available if CanTransferFiles() returns true, otherwise the data must be sent
+  // with the functions above. These don't use or modify the FILE's position or buffering.
+  bool CanTransferFiles() const;
+  bool SendFileBlocking(FILE *file, uint64_t offset, uint64_t length);
+  bool RecvFileBlocking(FILE *file, uint64_t offset, uint64_t length);
+
 private:
   ptrdiff_t socket;
   uint32_t timeoutMS;
@@ -260,6 +272,8 @@ uint64_t GetModifiedTimestamp(const string &filename);
 bool Copy(const char *from, const char *to, bool allowOverwrite);
 bool Move(const char *from, const char *to, bool allowOverwrite);
 void Delete(const char *path);
+// update the file's modified time to now, without changing its contents
+void Touch(const char *path);
 std::vector<PathEntry> GetFilesInDirectory(const char *path);
 
 FILE *fopen(const char *filename, const char *mode);
@@ -278,6 +292,12 @@ void fseek64(FILE *f, uint64_t offset, int origin);
 
 void ftruncateat(FILE *f, uint64_t length);
 
+// advisory locks on an open file, shared between processes. Any number of shared locks can be held
+// at once but an exclusive lock only when no other lock is. If wait is false this fails instead of
+// blocking until the lock is available.
+bool lockfile(FILE *f, bool exclusive, bool wait);
+void unlockfile(FILE *f);
+
 bool fflush(FILE *f);
 
 bool feof(FILE *f);
@@ -32,6 +32,23 @@ uint32_t Socket::GetRemoteIP() const
   return GetIPFromTCPSocket((int)socket);
 }
 
+bool Socket::CanTransferFiles() const
+{
+  return false;
+}
+
+bool Socket::SendFileBlocking(FILE *file, uint64_t offset, uint64_t length)
+{
+  RDCERR("Direct file transfer not supported on this platform");
+  return false;
+}
+
+bool Socket::RecvFileBlocking(FILE *file, uint64_t offset, uint64_t length)
+{
+  RDCERR("Direct file transfer not supported on this platform");
+  return false;
+}
+
 Socket *CreateServerSocket(const char *bindaddr, uint16_t port, int queuesize)
 {
   return CreateTCPServerSocket(bindaddr, port, queuesize);
@@ -22,9 +22,32 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include "os/os_specific.h"
 #include "os/posix/posix_network.h"
 
+// capture files can be several GB, at which point the default socket buffers limit throughput
+// more than anything else. Make sure they're at least this big while transferring files.
+static const int FileTransferSocketBufferSize = 4 * 1024 * 1024;
+
+// size of the pipe used to splice from the socket into the file
+static const int FileTransferPipeSize = 1024 * 1024;
+
+static void EnsureSocketBufferSize(int socket, int option)
+{
+  int size = 0;
+  socklen_t len = sizeof(size);
+  getsockopt(socket, SOL_SOCKET, option, (char *)&size, &len);
+
+  if(size < FileTransferSocketBufferSize)
+    setsockopt(socket, SOL_SOCKET, option, (const char *)&FileTransferSocketBufferSize,
+               sizeof(FileTransferSocketBufferSize));
+}
+
 namespace Network
 {
 uint32_t Socket::GetRemoteIP() const
@@ -32,6 +55,175 @@ uint32_t Socket::GetRemoteIP() const
   return GetIPFromTCPSocket((int)socket);
 }
 
+bool Socket::CanTransferFiles() const
+{
+  return true;
+}
+
+bool Socket::SendFileBlocking(FILE *file, uint64_t offset, uint64_t length)
+{
+  if(length == 0)
+    return true;
+
+  int fd = fileno(file);
+
+  int flags = fcntl(socket, F_GETFL, 0);
+  fcntl(socket, F_SETFL, flags & ~O_NONBLOCK);
+
+  timeval oldtimeout = {0};
+  socklen_t len = sizeof(oldtimeout);
+  getsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (char *)&oldtimeout, &len);
+
+  timeval timeout = {0};
+  timeout.tv_sec = (timeoutMS / 1000);
+  timeout.tv_usec = (timeoutMS % 1000) * 1000;
+  setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+
+  EnsureSocketBufferSize((int)socket, SO_SNDBUF);
+
+  off_t offs = (off_t)offset;
+
+  while(length > 0)
+  {
+    ssize_t ret = sendfile((int)socket, fd, &offs, (size_t)length);
+
+    if(ret == 0)
+    {
+      RDCWARN("sendfile: Unexpected end of file");
+      Shutdown();
+      return false;
+    }
+    else if(ret < 0)
+    {
+      int err = errno;
+
+      if(err == EINTR)
+        continue;
+
+      if(err == EWOULDBLOCK || err == EAGAIN)
+        RDCWARN("Timeout in sendfile");
+      else
+        RDCWARN("sendfile: %s", errno_string(err).c_str());
+
+      Shutdown();
+      return false;
+    }
+
+    length -= (uint64_t)ret;
+  }
+
+  flags = fcntl(socket, F_GETFL, 0);
+  fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+
+  setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&oldtimeout, sizeof(oldtimeout));
+
+  return true;
+}
+
+bool Socket::RecvFileBlocking(FILE *file, uint64_t offset, uint64_t length)
+{
+  if(length == 0)
+    return true;
+
+  int fd = fileno(file);
+
+  // there's no direct socket to file transfer, but splicing through a pipe moves pages between
+  // kernel buffers without copying them out to us
+  int pipes[2];
+  if(pipe2(pipes, O_CLOEXEC) != 0)
+  {
+    RDCWARN("pipe2: %s", errno_string(errno).c_str());
+    Shutdown();
+    return false;
+  }
+
+  // this is only a hint, if it fails the default pipe size still works
+  fcntl(pipes[1], F_SETPIPE_SZ, FileTransferPipeSize);
+
+  int flags = fcntl(socket, F_GETFL, 0);
+  fcntl(socket, F_SETFL, flags & ~O_NONBLOCK);
+
+  timeval oldtimeout = {0};
+  socklen_t len = sizeof(oldtimeout);
+  getsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&oldtimeout, &len);
+
+  timeval timeout = {0};
+  timeout.tv_sec = (timeoutMS / 1000);
+  timeout.tv_usec = (timeoutMS % 1000) * 1000;
+  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+
+  EnsureSocketBufferSize((int)socket, SO_RCVBUF);
+
+  loff_t offs = (loff_t)offset;
+
+  bool success = true;
+
+  while(success && length > 0)
+  {
+    ssize_t received = splice((int)socket, NULL, pipes[1], NULL,
+                              (size_t)RDCMIN<uint64_t>(length, FileTransferPipeSize),
+                              SPLICE_F_MOVE | SPLICE_F_MORE);
+
+    if(received == 0)
+    {
+      success = false;
+      break;
+    }
+    else if(received < 0)
+    {
+      int err = errno;
+
+      if(err == EINTR)
+        continue;
+
+      if(err == EWOULDBLOCK || err == EAGAIN)
+        RDCWARN("Timeout in splice");
+      else
+        RDCWARN("splice: %s", errno_string(err).c_str());
+
+      success = false;
+      break;
+    }
+
+    length -= (uint64_t)received;
+
+    // drain everything we just received into the file
+    while(received > 0)
+    {
+      ssize_t written = splice(pipes[0], NULL, fd, &offs, (size_t)received, SPLICE_F_MOVE);
+
+      if(written <= 0)
+      {
+        if(written < 0 && errno == EINTR)
+          continue;
+
+        RDCERR("Error writing to file, errno %d", errno);
+        success = false;
+        break;
+      }
+
+      received -= written;
+    }
+  }
+
+  close(pipes[0]);
+  close(pipes[1]);
+
+  // the rest of the data is still in flight, so the connection can't be used after a failure
+  if(!success)
+  {
+    Shutdown();
+    return false;
+  }
+
+  flags = fcntl(socket, F_GETFL, 0);
+  fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+
+  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&oldtimeout, sizeof(oldtimeout));
+
+  return true;
+}
+
 Socket *CreateServerSocket(const char *bindaddr, uint16_t port, int queuesize)
 {
   return CreateTCPServerSocket(bindaddr, port, queuesize);
@@ -43,7 +43,7 @@
 using std::string;
 
 // because strerror_r is a complete mess...
-static std::string errno_string(int err)
+std::string errno_string(int err)
 {
   switch(err)
   {
@@ -24,6 +24,8 @@
 
 #pragma once
 
+std::string errno_string(int err);
+
 namespace Network
 {
 uint32_t GetIPFromTCPSocket(int socket);
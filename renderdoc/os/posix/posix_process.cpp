@@ -26,8 +26,10 @@
 #include <errno.h>
 #include <limits.h>
 #include <pwd.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -620,6 +622,40 @@ void Process::StopGlobalHook()
 {
 }
 
+bool Process::IsProcessRunning(uint32_t pid)
+{
+  int status = 0;
+  pid_t ret = waitpid((pid_t)pid, &status, WNOHANG);
+
+  // still running child
+  if(ret == 0)
+    return true;
+
+  // child that has exited, and has now been reaped
+  if(ret == (pid_t)pid)
+    return false;
+
+  // not one of our children, check if it exists at all
+  return kill((pid_t)pid, 0) == 0;
+}
+
+bool Process::LimitProcessMemory(uint64_t bytes)
+{
+  // RLIMIT_DATA rather than RLIMIT_AS, since GPU drivers commonly reserve large amounts of address
+  // space that is never backed and would quickly exhaust an address space limit.
+  rlimit limit;
+  limit.rlim_cur = (rlim_t)bytes;
+  limit.rlim_max = (rlim_t)bytes;
+
+  if(setrlimit(RLIMIT_DATA, &limit) != 0)
+  {
+    RDCWARN("Couldn't limit process memory to %llu bytes: %d", bytes, errno);
+    return false;
+  }
+
+  return true;
+}
+
 void *Process::LoadModule(const char *module)
 {
   return dlopen(module, RTLD_NOW);
@@ -33,6 +33,7 @@
 #include <string.h>
 #include <sys/file.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
@@ -320,6 +321,11 @@ void Delete(const char *path)
   unlink(path);
 }
 
+void Touch(const char *path)
+{
+  utimes(path, NULL);
+}
+
 std::vector<PathEntry> GetFilesInDirectory(const char *path)
 {
   std::vector<PathEntry> ret;
@@ -455,6 +461,20 @@ void ftruncateat(FILE *f, uint64_t length)
   ::ftruncate(fd, (off_t)length);
 }
 
+bool lockfile(FILE *f, bool exclusive, bool wait)
+{
+  int op = exclusive ? LOCK_EX : LOCK_SH;
+  if(!wait)
+    op |= LOCK_NB;
+
+  return flock(::fileno(f), op) == 0;
+}
+
+void unlockfile(FILE *f)
+{
+  flock(::fileno(f), LOCK_UN);
+}
+
 bool fflush(FILE *f)
 {
   return ::fflush(f) == 0;
@@ -320,6 +320,23 @@ bool Socket::RecvDataBlocking(void *buf, uint32_t length)
   return true;
 }
 
+bool Socket::CanTransferFiles() const
+{
+  return false;
+}
+
+bool Socket::SendFileBlocking(FILE *file, uint64_t offset, uint64_t length)
+{
+  RDCERR("Direct file transfer not supported on this platform");
+  return false;
+}
+
+bool Socket::RecvFileBlocking(FILE *file, uint64_t offset, uint64_t length)
+{
+  RDCERR("Direct file transfer not supported on this platform");
+  return false;
+}
+
 Socket *CreateServerSocket(const char *bindaddr, uint16_t port, int queuesize)
 {
   SOCKET s = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, NULL, 0,
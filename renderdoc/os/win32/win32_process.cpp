@@ -1561,6 +1561,48 @@ void Process::StopGlobalHook()
   globalHook = NULL;
 }
 
+bool Process::IsProcessRunning(uint32_t pid)
+{
+  HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+
+  if(h == NULL)
+    return false;
+
+  DWORD exitCode = 0;
+  BOOL success = GetExitCodeProcess(h, &exitCode);
+
+  CloseHandle(h);
+
+  return success && exitCode == STILL_ACTIVE;
+}
+
+bool Process::LimitProcessMemory(uint64_t bytes)
+{
+  // the job object must stay alive for as long as the limit applies, so it's deliberately never
+  // closed. The process is torn down along with it.
+  HANDLE job = CreateJobObjectW(NULL, NULL);
+
+  if(job == NULL)
+  {
+    RDCWARN("Couldn't create job object: %d", GetLastError());
+    return false;
+  }
+
+  JOBOBJECT_EXTENDED_LIMIT_INFORMATION info = {};
+  info.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_PROCESS_MEMORY;
+  info.ProcessMemoryLimit = (SIZE_T)bytes;
+
+  if(!SetInformationJobObject(job, JobObjectExtendedLimitInformation, &info, sizeof(info)) ||
+     !AssignProcessToJobObject(job, GetCurrentProcess()))
+  {
+    RDCWARN("Couldn't limit process memory to %llu bytes: %d", bytes, GetLastError());
+    CloseHandle(job);
+    return false;
+  }
+
+  return true;
+}
+
 void *Process::LoadModule(const char *module)
 {
   HMODULE mod = GetModuleHandleA(module);
@@ -411,15 +411,15 @@ bool Move(const char *from, const char *to, bool allowOverwrite)
   wstring wfrom = StringFormat::UTF82Wide(string(from));
   wstring wto = StringFormat::UTF82Wide(string(to));
 
-  if(exists(to))
-  {
-    if(allowOverwrite)
-      Delete(to);
-    else
-      return false;
-  }
+  if(exists(to) && !allowOverwrite)
+    return false;
+
+  // replace in one step, so nothing else can see the destination missing
+  DWORD flags = MOVEFILE_COPY_ALLOWED;
+  if(allowOverwrite)
+    flags |= MOVEFILE_REPLACE_EXISTING;
 
-  return ::MoveFileW(wfrom.c_str(), wto.c_str()) != 0;
+  return ::MoveFileExW(wfrom.c_str(), wto.c_str(), flags) != 0;
 }
 
 void Delete(const char *path)
@@ -428,6 +428,24 @@ void Delete(const char *path)
   ::DeleteFileW(wpath.c_str());
 }
 
+void Touch(const char *path)
+{
+  wstring wpath = StringFormat::UTF82Wide(string(path));
+
+  HANDLE h = ::CreateFileW(wpath.c_str(), FILE_WRITE_ATTRIBUTES,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  if(h == INVALID_HANDLE_VALUE)
+    return;
+
+  FILETIME now;
+  ::GetSystemTimeAsFileTime(&now);
+  ::SetFileTime(h, NULL, NULL, &now);
+
+  ::CloseHandle(h);
+}
+
 std::vector<PathEntry> GetFilesInDirectory(const char *path)
 {
   std::vector<PathEntry> ret;
@@ -618,6 +636,29 @@ void ftruncateat(FILE *f, uint64_t length)
   ::_chsize_s(fd, (int64_t)length);
 }
 
+bool lockfile(FILE *f, bool exclusive, bool wait)
+{
+  HANDLE h = (HANDLE)::_get_osfhandle(::_fileno(f));
+
+  DWORD flags = 0;
+  if(exclusive)
+    flags |= LOCKFILE_EXCLUSIVE_LOCK;
+  if(!wait)
+    flags |= LOCKFILE_FAIL_IMMEDIATELY;
+
+  // the lock covers a single byte, which doesn't need to exist in the file
+  OVERLAPPED overlapped = {};
+  return ::LockFileEx(h, flags, 0, 1, 0, &overlapped) != FALSE;
+}
+
+void unlockfile(FILE *f)
+{
+  HANDLE h = (HANDLE)::_get_osfhandle(::_fileno(f));
+
+  OVERLAPPED overlapped = {};
+  ::UnlockFileEx(h, 0, 1, 0, &overlapped);
+}
+
 bool fflush(FILE *f)
 {
   return ::fflush(f) == 0;
@@ -48,6 +48,9 @@ int RENDERDOC_CC SetCaptureOptionU32(RENDERDOC_CaptureOption opt, uint32_t val)
     case eRENDERDOC_Option_SaveAllInitials: opts.saveAllInitials = (val != 0); break;
     case eRENDERDOC_Option_CaptureAllCmdLists: opts.captureAllCmdLists = (val != 0); break;
     case eRENDERDOC_Option_DebugOutputMute: opts.debugOutputMute = (val != 0); break;
+    case eRENDERDOC_Option_DeferDescriptorTracking:
+      opts.deferDescriptorTracking = (val != 0);
+      break;
     default: RDCLOG("Unrecognised capture option '%d'", opt); return 0;
   }
 
@@ -75,6 +78,9 @@ int RENDERDOC_CC SetCaptureOptionF32(RENDERDOC_CaptureOption opt, float val)
     case eRENDERDOC_Option_SaveAllInitials: opts.saveAllInitials = (val != 0.0f); break;
     case eRENDERDOC_Option_CaptureAllCmdLists: opts.captureAllCmdLists = (val != 0.0f); break;
     case eRENDERDOC_Option_DebugOutputMute: opts.debugOutputMute = (val != 0.0f); break;
+    case eRENDERDOC_Option_DeferDescriptorTracking:
+      opts.deferDescriptorTracking = (val != 0.0f);
+      break;
     default: RDCLOG("Unrecognised capture option '%d'", opt); return 0;
   }
 
@@ -110,6 +116,8 @@ uint32_t RENDERDOC_CC GetCaptureOptionU32(RENDERDOC_CaptureOption opt)
       return (RenderDoc::Inst().GetCaptureOptions().captureAllCmdLists ? 1 : 0);
     case eRENDERDOC_Option_DebugOutputMute:
       return (RenderDoc::Inst().GetCaptureOptions().debugOutputMute ? 1 : 0);
+    case eRENDERDOC_Option_DeferDescriptorTracking:
+      return (RenderDoc::Inst().GetCaptureOptions().deferDescriptorTracking ? 1 : 0);
     default: break;
   }
 
@@ -145,6 +153,8 @@ float RENDERDOC_CC GetCaptureOptionF32(RENDERDOC_CaptureOption opt)
       return (RenderDoc::Inst().GetCaptureOptions().captureAllCmdLists ? 1.0f : 0.0f);
     case eRENDERDOC_Option_DebugOutputMute:
       return (RenderDoc::Inst().GetCaptureOptions().debugOutputMute ? 1.0f : 0.0f);
+    case eRENDERDOC_Option_DeferDescriptorTracking:
+      return (RenderDoc::Inst().GetCaptureOptions().deferDescriptorTracking ? 1.0f : 0.0f);
     default: break;
   }
 
@@ -166,4 +176,5 @@ CaptureOptions::CaptureOptions()
   saveAllInitials = false;
   captureAllCmdLists = false;
   debugOutputMute = true;
+  deferDescriptorTracking = false;
 }
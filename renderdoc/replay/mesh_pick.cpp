@@ -0,0 +1,743 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "mesh_pick.h"
+#include <float.h>
+#include <algorithm>
+#include "common/common.h"
+#include "common/threading.h"
+#include "maths/matrix.h"
+#include "os/os_specific.h"
+
+// maximum number of primitives in a leaf node
+static const uint32_t MaxLeafPrims = 4;
+
+// below this many primitives it's not worth handing a subtree to another thread
+static const uint32_t MinPrimsPerJob = 4096;
+
+struct MeshPickBVH::BuildData
+{
+  std::vector<Vec3f> mins, maxs, centres;
+};
+
+struct MeshPickBVH::SubtreeJob
+{
+  uint32_t begin, end;
+  // the node in m_Nodes that the root of this subtree will be written to
+  uint32_t node;
+  std::vector<Node> nodes;
+};
+
+static bool IsTriangleTopology(Topology topology)
+{
+  return topology == Topology::TriangleList || topology == Topology::TriangleStrip ||
+         topology == Topology::TriangleFan || topology == Topology::TriangleList_Adj ||
+         topology == Topology::TriangleStrip_Adj;
+}
+
+static uint32_t NumTriangles(Topology topology, uint32_t numVerts)
+{
+  switch(topology)
+  {
+    case Topology::TriangleList: return numVerts / 3;
+    case Topology::TriangleStrip:
+    case Topology::TriangleFan: return numVerts >= 3 ? numVerts - 2 : 0;
+    case Topology::TriangleList_Adj: return numVerts / 6;
+    case Topology::TriangleStrip_Adj: return numVerts >= 6 ? (numVerts - 4) / 2 : 0;
+    default: break;
+  }
+
+  return 0;
+}
+
+static inline float Axis(const Vec3f &v, int axis)
+{
+  return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+static inline Vec3f Min(const Vec3f &a, const Vec3f &b)
+{
+  return Vec3f(RDCMIN(a.x, b.x), RDCMIN(a.y, b.y), RDCMIN(a.z, b.z));
+}
+
+static inline Vec3f Max(const Vec3f &a, const Vec3f &b)
+{
+  return Vec3f(RDCMAX(a.x, b.x), RDCMAX(a.y, b.y), RDCMAX(a.z, b.z));
+}
+
+static inline Vec4f TransformPoint(const Matrix4f &m, const Vec3f &p)
+{
+  return Vec4f(m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+               m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+               m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14],
+               m[3] * p.x + m[7] * p.y + m[11] * p.z + m[15]);
+}
+
+static bool RayHitsBox(const Vec3f &bmin, const Vec3f &bmax, const Vec3f &pos, const Vec3f &invDir,
+                       float maxT)
+{
+  float t0 = 0.0f, t1 = maxT;
+
+  for(int a = 0; a < 3; a++)
+  {
+    float lo = (Axis(bmin, a) - Axis(pos, a)) * Axis(invDir, a);
+    float hi = (Axis(bmax, a) - Axis(pos, a)) * Axis(invDir, a);
+
+    if(lo > hi)
+      std::swap(lo, hi);
+
+    // written so that NaNs (from a ray lying exactly in a slab plane) don't cull anything
+    t0 = lo > t0 ? lo : t0;
+    t1 = hi < t1 ? hi : t1;
+
+    if(t0 > t1)
+      return false;
+  }
+
+  return true;
+}
+
+// Moller-Trumbore ray/triangle intersection, returning the distance along the ray in t
+static bool RayHitsTriangle(const Vec3f &A, const Vec3f &B, const Vec3f &C, const Vec3f &pos,
+                            const Vec3f &dir, float &t)
+{
+  Vec3f v0v1 = B - A;
+  Vec3f v0v2 = C - A;
+  Vec3f pvec = dir.Cross(v0v2);
+  float det = v0v1.Dot(pvec);
+
+  // if the determinant is negative the triangle is backfacing, but we still take those!
+  // if the determinant is 0, the ray misses the triangle
+  if(!(fabsf(det) > 0.0f))
+    return false;
+
+  float invDet = 1.0f / det;
+
+  Vec3f tvec = pos - A;
+  Vec3f qvec = tvec.Cross(v0v1);
+  float u = tvec.Dot(pvec) * invDet;
+  float v = dir.Dot(qvec) * invDet;
+
+  if(!(u >= 0.0f && u <= 1.0f && v >= 0.0f && u + v <= 1.0f))
+    return false;
+
+  t = v0v2.Dot(qvec) * invDet;
+
+  return t > 0.0f;
+}
+
+void MeshPickBVH::Clear()
+{
+  m_Topology = Topology::Unknown;
+  m_Triangles = false;
+  m_Positions.clear();
+  m_Indices.clear();
+  m_Nodes.clear();
+  m_Prims.clear();
+}
+
+uint32_t MeshPickBVH::PrimVertex(uint32_t prim, uint32_t v) const
+{
+  switch(m_Topology)
+  {
+    case Topology::TriangleList: return prim * 3 + v;
+    case Topology::TriangleStrip: return prim + v;
+    case Topology::TriangleFan: return v == 0 ? 0 : prim + v;
+    case Topology::TriangleList_Adj: return prim * 6 + v * 2;
+    case Topology::TriangleStrip_Adj: return prim * 2 + v * 2;
+    default: break;
+  }
+
+  return prim;
+}
+
+uint32_t MeshPickBVH::VertexIndex(uint32_t vertid) const
+{
+  if(m_Indices.empty())
+    return vertid;
+
+  return vertid < m_Indices.size() ? m_Indices[vertid] : ~0U;
+}
+
+void MeshPickBVH::Build(Topology topology, uint32_t numVerts, std::vector<Vec3f> positions,
+                        std::vector<uint32_t> indices)
+{
+  Clear();
+
+  m_Topology = topology;
+  m_Triangles = IsTriangleTopology(topology);
+  m_Positions.swap(positions);
+  m_Indices.swap(indices);
+
+  const uint32_t numPrims = m_Triangles ? NumTriangles(topology, numVerts) : numVerts;
+  const uint32_t primVerts = m_Triangles ? 3 : 1;
+
+  if(numPrims == 0)
+    return;
+
+  const uint32_t numCores = Threading::GetCoreCount();
+
+  BuildData data;
+  data.mins.resize(numPrims);
+  data.maxs.resize(numPrims);
+  data.centres.resize(numPrims);
+
+  std::vector<byte> valid(numPrims);
+
+  // calculate the bounds of every primitive, in fixed ranges since each one is the same work
+  uint32_t numJobs = RDCCLAMP(numPrims / MinPrimsPerJob, 1U, numCores);
+
+  Threading::RunParallelJobs(numJobs, [&](uint32_t job) {
+    uint32_t begin = uint32_t(uint64_t(numPrims) * job / numJobs);
+    uint32_t end = uint32_t(uint64_t(numPrims) * (job + 1) / numJobs);
+
+    for(uint32_t prim = begin; prim < end; prim++)
+    {
+      Vec3f mn(FLT_MAX, FLT_MAX, FLT_MAX);
+      Vec3f mx(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+      valid[prim] = 1;
+
+      for(uint32_t v = 0; v < primVerts; v++)
+      {
+        uint32_t idx = VertexIndex(PrimVertex(prim, v));
+
+        if(idx >= m_Positions.size())
+        {
+          valid[prim] = 0;
+          break;
+        }
+
+        mn = Min(mn, m_Positions[idx]);
+        mx = Max(mx, m_Positions[idx]);
+      }
+
+      data.mins[prim] = mn;
+      data.maxs[prim] = mx;
+      data.centres[prim] = (mn + mx) * 0.5f;
+    }
+  });
+
+  m_Prims.reserve(numPrims);
+  for(uint32_t prim = 0; prim < numPrims; prim++)
+    if(valid[prim])
+      m_Prims.push_back(prim);
+
+  if(m_Prims.empty())
+    return;
+
+  // build the top of the tree serially until there are enough independent subtrees to keep every
+  // core busy, then build those in parallel and stitch them in afterwards.
+  uint32_t depth = 0;
+  while(numCores > 1 && (1U << depth) < numCores * 4)
+    depth++;
+
+  std::vector<SubtreeJob> jobs;
+  BuildTop(data, 0, (uint32_t)m_Prims.size(), depth, jobs);
+
+  Threading::ParallelFor((uint32_t)jobs.size(), [&](uint32_t j) {
+    BuildSubtree(data, jobs[j].begin, jobs[j].end, jobs[j].nodes);
+  }, numCores);
+
+  for(SubtreeJob &job : jobs)
+  {
+    // the subtree root replaces the placeholder node, the rest are appended
+    const uint32_t base = (uint32_t)m_Nodes.size() - 1;
+
+    for(size_t i = 0; i < job.nodes.size(); i++)
+    {
+      Node n = job.nodes[i];
+
+      if(n.count == 0)
+      {
+        n.first += base;
+        n.second += base;
+      }
+
+      if(i == 0)
+        m_Nodes[job.node] = n;
+      else
+        m_Nodes.push_back(n);
+    }
+  }
+}
+
+int MeshPickBVH::CalcBounds(const BuildData &data, uint32_t begin, uint32_t end, Node &node) const
+{
+  Vec3f cmin(FLT_MAX, FLT_MAX, FLT_MAX);
+  Vec3f cmax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+  node.bmin = cmin;
+  node.bmax = cmax;
+
+  for(uint32_t i = begin; i < end; i++)
+  {
+    uint32_t prim = m_Prims[i];
+
+    node.bmin = Min(node.bmin, data.mins[prim]);
+    node.bmax = Max(node.bmax, data.maxs[prim]);
+    cmin = Min(cmin, data.centres[prim]);
+    cmax = Max(cmax, data.centres[prim]);
+  }
+
+  // split along whichever axis the primitive centres are most spread out on
+  Vec3f extent = cmax - cmin;
+
+  if(extent.x >= extent.y && extent.x >= extent.z)
+    return 0;
+  return extent.y >= extent.z ? 1 : 2;
+}
+
+void MeshPickBVH::Split(const BuildData &data, int axis, uint32_t begin, uint32_t mid, uint32_t end)
+{
+  const std::vector<Vec3f> &centres = data.centres;
+
+  std::nth_element(m_Prims.begin() + begin, m_Prims.begin() + mid, m_Prims.begin() + end,
+                   [&centres, axis](uint32_t a, uint32_t b) {
+                     return Axis(centres[a], axis) < Axis(centres[b], axis);
+                   });
+}
+
+uint32_t MeshPickBVH::BuildTop(const BuildData &data, uint32_t begin, uint32_t end, uint32_t depth,
+                               std::vector<SubtreeJob> &jobs)
+{
+  uint32_t nodeIdx = (uint32_t)m_Nodes.size();
+  m_Nodes.push_back(Node());
+
+  if(depth == 0 || end - begin <= MinPrimsPerJob)
+  {
+    SubtreeJob job;
+    job.begin = begin;
+    job.end = end;
+    job.node = nodeIdx;
+    jobs.push_back(job);
+    return nodeIdx;
+  }
+
+  Node node;
+  int axis = CalcBounds(data, begin, end, node);
+
+  uint32_t mid = begin + (end - begin) / 2;
+  Split(data, axis, begin, mid, end);
+
+  node.first = BuildTop(data, begin, mid, depth - 1, jobs);
+  node.second = BuildTop(data, mid, end, depth - 1, jobs);
+  node.count = 0;
+
+  m_Nodes[nodeIdx] = node;
+
+  return nodeIdx;
+}
+
+uint32_t MeshPickBVH::BuildSubtree(const BuildData &data, uint32_t begin, uint32_t end,
+                                   std::vector<Node> &nodes)
+{
+  uint32_t nodeIdx = (uint32_t)nodes.size();
+  nodes.push_back(Node());
+
+  Node node;
+  int axis = CalcBounds(data, begin, end, node);
+
+  if(end - begin <= MaxLeafPrims)
+  {
+    node.first = begin;
+    node.second = 0;
+    node.count = end - begin;
+  }
+  else
+  {
+    uint32_t mid = begin + (end - begin) / 2;
+    Split(data, axis, begin, mid, end);
+
+    node.first = BuildSubtree(data, begin, mid, nodes);
+    node.second = BuildSubtree(data, mid, end, nodes);
+    node.count = 0;
+  }
+
+  nodes[nodeIdx] = node;
+
+  return nodeIdx;
+}
+
+uint32_t MeshPickBVH::PickTriangle(const Vec3f &rayPos, const Vec3f &rayDir) const
+{
+  if(!m_Triangles || m_Nodes.empty())
+    return ~0U;
+
+  const Vec3f invDir(1.0f / rayDir.x, 1.0f / rayDir.y, 1.0f / rayDir.z);
+
+  float closestT = FLT_MAX;
+  uint32_t closestPrim = ~0U;
+
+  // the tree is balanced, so its depth is at most log2 of the number of primitives
+  uint32_t stack[64];
+  uint32_t stackSize = 0;
+  stack[stackSize++] = 0;
+
+  while(stackSize > 0)
+  {
+    const Node &node = m_Nodes[stack[--stackSize]];
+
+    if(!RayHitsBox(node.bmin, node.bmax, rayPos, invDir, closestT))
+      continue;
+
+    if(node.count == 0)
+    {
+      stack[stackSize++] = node.first;
+      stack[stackSize++] = node.second;
+      continue;
+    }
+
+    for(uint32_t i = node.first; i < node.first + node.count; i++)
+    {
+      uint32_t prim = m_Prims[i];
+
+      float t;
+      if(RayHitsTriangle(m_Positions[VertexIndex(PrimVertex(prim, 0))],
+                         m_Positions[VertexIndex(PrimVertex(prim, 1))],
+                         m_Positions[VertexIndex(PrimVertex(prim, 2))], rayPos, rayDir, t) &&
+         t < closestT)
+      {
+        closestT = t;
+        closestPrim = prim;
+      }
+    }
+  }
+
+  if(closestPrim == ~0U)
+    return ~0U;
+
+  // return the vertex that was closest to the triangle/ray intersection point
+  Vec3f hit = rayPos + rayDir * closestT;
+
+  float dist[3];
+  for(uint32_t v = 0; v < 3; v++)
+    dist[v] = (m_Positions[VertexIndex(PrimVertex(closestPrim, v))] - hit).Length();
+
+  if(dist[1] < dist[0] && dist[1] < dist[2])
+    return PrimVertex(closestPrim, 1);
+  else if(dist[2] < dist[0] && dist[2] < dist[1])
+    return PrimVertex(closestPrim, 2);
+
+  return PrimVertex(closestPrim, 0);
+}
+
+uint32_t MeshPickBVH::PickPoint(const Matrix4f &mvp, bool divideW, Vec2f viewport, Vec2f coords,
+                                float maxDist) const
+{
+  if(m_Triangles || m_Nodes.empty())
+    return ~0U;
+
+  float closestLen = maxDist;
+  float closestDepth = FLT_MAX;
+  uint32_t closestVert = ~0U;
+
+  uint32_t stack[64];
+  uint32_t stackSize = 0;
+  stack[stackSize++] = 0;
+
+  while(stackSize > 0)
+  {
+    const Node &node = m_Nodes[stack[--stackSize]];
+
+    // project the corners of the box to get its screen-space bounds. If any corner is behind the
+    // eye the projection isn't bounded by the corners, so we can't cull the node.
+    float scrMin[2] = {FLT_MAX, FLT_MAX};
+    float scrMax[2] = {-FLT_MAX, -FLT_MAX};
+    bool cullable = true;
+
+    for(int c = 0; c < 8 && cullable; c++)
+    {
+      Vec3f corner((c & 1) ? node.bmax.x : node.bmin.x, (c & 2) ? node.bmax.y : node.bmin.y,
+                   (c & 4) ? node.bmax.z : node.bmin.z);
+
+      Vec4f p = TransformPoint(mvp, corner);
+
+      if(divideW)
+      {
+        if(!(p.w > 0.0f))
+        {
+          cullable = false;
+          break;
+        }
+
+        p.x /= p.w;
+        p.y /= p.w;
+      }
+
+      float sx = (p.x + 1.0f) * 0.5f * viewport.x;
+      float sy = (1.0f - p.y) * 0.5f * viewport.y;
+
+      scrMin[0] = RDCMIN(scrMin[0], sx);
+      scrMin[1] = RDCMIN(scrMin[1], sy);
+      scrMax[0] = RDCMAX(scrMax[0], sx);
+      scrMax[1] = RDCMAX(scrMax[1], sy);
+    }
+
+    if(cullable)
+    {
+      float dx = RDCMAX(RDCMAX(scrMin[0] - coords.x, coords.x - scrMax[0]), 0.0f);
+      float dy = RDCMAX(RDCMAX(scrMin[1] - coords.y, coords.y - scrMax[1]), 0.0f);
+
+      if(dx * dx + dy * dy > closestLen * closestLen)
+        continue;
+    }
+
+    if(node.count == 0)
+    {
+      stack[stackSize++] = node.first;
+      stack[stackSize++] = node.second;
+      continue;
+    }
+
+    for(uint32_t i = node.first; i < node.first + node.count; i++)
+    {
+      uint32_t vert = m_Prims[i];
+
+      Vec4f p = TransformPoint(mvp, m_Positions[VertexIndex(vert)]);
+
+      if(divideW)
+      {
+        p.x /= p.w;
+        p.y /= p.w;
+        p.z /= p.w;
+      }
+
+      float dx = (p.x + 1.0f) * 0.5f * viewport.x - coords.x;
+      float dy = (1.0f - p.y) * 0.5f * viewport.y - coords.y;
+      float len = sqrtf(dx * dx + dy * dy);
+
+      if(!(len < maxDist))
+        continue;
+
+      // keep the picking order consistent when multiple vertices have the identical position
+      // (e.g. if UVs or normals are different), otherwise the result flickers confusingly.
+      if(len < closestLen || (len == closestLen && p.z < closestDepth) ||
+         (len == closestLen && p.z == closestDepth && vert < closestVert))
+      {
+        closestLen = len;
+        closestDepth = p.z;
+        closestVert = vert;
+      }
+    }
+  }
+
+  return closestVert;
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+#include "common/timing.h"
+
+// a grid of quads in the XY plane, from 0 to size in each axis, as an indexed triangle list
+static void MakeGrid(uint32_t size, float z, std::vector<Vec3f> &positions,
+                     std::vector<uint32_t> &indices)
+{
+  for(uint32_t y = 0; y <= size; y++)
+    for(uint32_t x = 0; x <= size; x++)
+      positions.push_back(Vec3f(float(x), float(y), z));
+
+  for(uint32_t y = 0; y < size; y++)
+  {
+    for(uint32_t x = 0; x < size; x++)
+    {
+      uint32_t v = y * (size + 1) + x;
+
+      indices.push_back(v);
+      indices.push_back(v + 1);
+      indices.push_back(v + size + 1);
+      indices.push_back(v + 1);
+      indices.push_back(v + size + 2);
+      indices.push_back(v + size + 1);
+    }
+  }
+}
+
+TEST_CASE("Mesh picking BVH", "[meshpick]")
+{
+  MeshPickBVH bvh;
+
+  SECTION("Empty mesh")
+  {
+    bvh.Build(Topology::TriangleList, 0, std::vector<Vec3f>(), std::vector<uint32_t>());
+
+    CHECK(bvh.IsTriangleMesh());
+    CHECK(bvh.PickTriangle(Vec3f(0.0f, 0.0f, -1.0f), Vec3f(0.0f, 0.0f, 1.0f)) == ~0U);
+  };
+
+  SECTION("Ray picking triangles")
+  {
+    std::vector<Vec3f> positions;
+    std::vector<uint32_t> indices;
+
+    MakeGrid(100, 5.0f, positions, indices);
+
+    uint32_t numVerts = (uint32_t)indices.size();
+    std::vector<uint32_t> gridIndices = indices;
+
+    bvh.Build(Topology::TriangleList, numVerts, positions, indices);
+
+    REQUIRE(bvh.IsTriangleMesh());
+
+    Vec3f down(0.0f, 0.0f, 1.0f);
+
+    // cast just next to a vertex, the closest vertex in the hit triangle must be that vertex
+    for(uint32_t y = 0; y < 100; y += 7)
+    {
+      for(uint32_t x = 0; x < 100; x += 3)
+      {
+        uint32_t vertid = bvh.PickTriangle(Vec3f(x + 0.1f, y + 0.2f, -10.0f), down);
+
+        REQUIRE(vertid < numVerts);
+        CHECK(gridIndices[vertid] == y * 101 + x);
+      }
+    }
+
+    // misses
+    CHECK(bvh.PickTriangle(Vec3f(-0.5f, 50.0f, -10.0f), down) == ~0U);
+    CHECK(bvh.PickTriangle(Vec3f(50.0f, 50.0f, -10.0f), Vec3f(0.0f, 0.0f, -1.0f)) == ~0U);
+    CHECK(bvh.PickTriangle(Vec3f(50.0f, 50.0f, 10.0f), down) == ~0U);
+
+    // backfaces are still hit
+    uint32_t vertid = bvh.PickTriangle(Vec3f(20.1f, 30.1f, 10.0f), Vec3f(0.0f, 0.0f, -1.0f));
+    REQUIRE(vertid < numVerts);
+    CHECK(gridIndices[vertid] == 30 * 101 + 20);
+  };
+
+  SECTION("Closest hit wins")
+  {
+    std::vector<Vec3f> positions;
+    std::vector<uint32_t> indices;
+
+    // two overlapping grids, the second one nearer to the ray origin
+    MakeGrid(10, 5.0f, positions, indices);
+    size_t numPositions = positions.size();
+    size_t numIndices = indices.size();
+    MakeGrid(10, 2.0f, positions, indices);
+
+    for(size_t i = numIndices; i < indices.size(); i++)
+      indices[i] += (uint32_t)numPositions;
+
+    bvh.Build(Topology::TriangleList, (uint32_t)indices.size(), positions, indices);
+
+    uint32_t vertid = bvh.PickTriangle(Vec3f(3.1f, 4.1f, -10.0f), Vec3f(0.0f, 0.0f, 1.0f));
+    REQUIRE(vertid != ~0U);
+    CHECK(vertid >= numIndices);
+  };
+
+  SECTION("Out of bounds vertices are ignored")
+  {
+    std::vector<Vec3f> positions = {Vec3f(0.0f, 0.0f, 0.0f), Vec3f(1.0f, 0.0f, 0.0f),
+                                    Vec3f(0.0f, 1.0f, 0.0f)};
+    std::vector<uint32_t> indices = {0, 1, 2, 0, 1, 0xffff};
+
+    bvh.Build(Topology::TriangleList, 6, positions, indices);
+
+    CHECK(bvh.PickTriangle(Vec3f(0.1f, 0.1f, -1.0f), Vec3f(0.0f, 0.0f, 1.0f)) == 0);
+  };
+
+  SECTION("Non-indexed strips")
+  {
+    std::vector<Vec3f> positions;
+    for(uint32_t i = 0; i < 20; i++)
+      positions.push_back(Vec3f(float(i / 2), float(i % 2), 0.0f));
+
+    bvh.Build(Topology::TriangleStrip, 20, positions, std::vector<uint32_t>());
+
+    CHECK(bvh.PickTriangle(Vec3f(4.1f, 0.8f, -1.0f), Vec3f(0.0f, 0.0f, 1.0f)) == 9);
+    CHECK(bvh.PickTriangle(Vec3f(6.9f, 0.05f, -1.0f), Vec3f(0.0f, 0.0f, 1.0f)) == 14);
+  };
+
+  SECTION("Point picking")
+  {
+    // a line of points across the screen, with a duplicate of one of them
+    std::vector<Vec3f> positions;
+    for(uint32_t i = 0; i < 1000; i++)
+      positions.push_back(Vec3f(float(i) / 500.0f - 1.0f, 0.0f, 0.5f));
+    positions.push_back(positions[250]);
+
+    bvh.Build(Topology::PointList, (uint32_t)positions.size(), positions,
+              std::vector<uint32_t>());
+
+    REQUIRE(!bvh.IsTriangleMesh());
+
+    Matrix4f ident = Matrix4f::Identity();
+    Vec2f viewport(1000.0f, 1000.0f);
+
+    // vertex i is at screen x = i
+    CHECK(bvh.PickPoint(ident, false, viewport, Vec2f(300.0f, 510.0f), 35.0f) == 300);
+    CHECK(bvh.PickPoint(ident, true, viewport, Vec2f(301.2f, 490.0f), 35.0f) == 301);
+    // the duplicate picks the lower index
+    CHECK(bvh.PickPoint(ident, false, viewport, Vec2f(250.0f, 500.0f), 35.0f) == 250);
+    // nothing within range
+    CHECK(bvh.PickPoint(ident, false, viewport, Vec2f(500.0f, 100.0f), 35.0f) == ~0U);
+  };
+};
+
+TEST_CASE("Benchmark mesh picking BVH", "[.][benchmark][meshpick]")
+{
+  std::vector<Vec3f> positions;
+  std::vector<uint32_t> indices;
+
+  // ~1M triangles, with some height variation so the tree isn't flat
+  MakeGrid(708, 0.0f, positions, indices);
+  for(size_t i = 0; i < positions.size(); i++)
+    positions[i].z = sinf(positions[i].x * 0.1f) * cosf(positions[i].y * 0.1f) * 10.0f;
+
+  uint32_t numVerts = (uint32_t)indices.size();
+
+  MeshPickBVH bvh;
+
+  PerformanceTimer timer;
+
+  bvh.Build(Topology::TriangleList, numVerts, positions, indices);
+
+  double buildMs = timer.GetMilliseconds();
+
+  const uint32_t numPicks = 10000;
+  uint32_t hits = 0;
+
+  timer.Restart();
+
+  for(uint32_t i = 0; i < numPicks; i++)
+  {
+    Vec3f pos(float(i % 700) + 0.3f, float((i * 7) % 700) + 0.6f, -100.0f);
+    Vec3f dir(0.01f, 0.02f, 1.0f);
+    dir.Normalise();
+
+    if(bvh.PickTriangle(pos, dir) != ~0U)
+      hits++;
+  }
+
+  double pickMs = timer.GetMilliseconds();
+
+  CHECK(hits == numPicks);
+
+  RDCLOG("Built BVH over %u triangles on %u cores in %.2f ms, %.2f us per pick", numVerts / 3,
+         Threading::GetCoreCount(), buildMs, pickMs * 1000.0 / numPicks);
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+#include "api/replay/renderdoc_replay.h"
+#include "maths/vec.h"
+
+class Matrix4f;
+
+// a CPU-side bounding volume hierarchy over the primitives of a mesh, so that vertex picking can be
+// answered without a GPU dispatch and readback. Triangle topologies are stored as triangles and
+// picked by casting a ray, everything else is stored as individual vertices and picked by the
+// nearest vertex in screen space.
+//
+// Primitives are identified by their position in the draw's index stream, so the picked 'vertex'
+// is the same as what the mesh viewer displays as the vertex ID.
+class MeshPickBVH
+{
+public:
+  // positions are the (already unprojected, if necessary) vertex positions indexed by vertex index.
+  // indices maps each of the numVerts entries in the index stream to a vertex index, or can be
+  // empty for a non-indexed draw. Any primitive referencing a vertex outside of positions is
+  // skipped.
+  void Build(Topology topology, uint32_t numVerts, std::vector<Vec3f> positions,
+             std::vector<uint32_t> indices);
+  void Clear();
+
+  bool IsTriangleMesh() const { return m_Triangles; }
+  // returns the index stream position of the vertex closest to where the ray first hits a
+  // triangle, or ~0U if nothing is hit. Only valid for triangle meshes.
+  uint32_t PickTriangle(const Vec3f &rayPos, const Vec3f &rayDir) const;
+
+  // returns the index stream position of the vertex closest to coords in screen space, as long as
+  // it's within maxDist pixels, or ~0U if there is none. Ties are broken by depth, then by vertex.
+  // If divideW is set the projected positions are divided by their w.
+  uint32_t PickPoint(const Matrix4f &mvp, bool divideW, Vec2f viewport, Vec2f coords,
+                     float maxDist) const;
+
+private:
+  struct Node
+  {
+    Vec3f bmin, bmax;
+    // for leaves, the primitives are m_Prims[first] to m_Prims[first + count - 1]. Interior nodes
+    // have a count of 0 and first/second are the child node indices.
+    uint32_t first, second, count;
+  };
+
+  struct BuildData;
+  struct SubtreeJob;
+
+  uint32_t PrimVertex(uint32_t prim, uint32_t v) const;
+  uint32_t VertexIndex(uint32_t vertid) const;
+
+  int CalcBounds(const BuildData &data, uint32_t begin, uint32_t end, Node &node) const;
+  void Split(const BuildData &data, int axis, uint32_t begin, uint32_t mid, uint32_t end);
+  uint32_t BuildTop(const BuildData &data, uint32_t begin, uint32_t end, uint32_t depth,
+                    std::vector<SubtreeJob> &jobs);
+  uint32_t BuildSubtree(const BuildData &data, uint32_t begin, uint32_t end,
+                        std::vector<Node> &nodes);
+
+  Topology m_Topology = Topology::Unknown;
+  bool m_Triangles = false;
+  std::vector<Vec3f> m_Positions;
+  std::vector<uint32_t> m_Indices;
+
+  std::vector<Node> m_Nodes;
+  std::vector<uint32_t> m_Prims;
+};
@@ -112,6 +112,7 @@ void DoSerialise(SerialiserType &ser, CaptureOptions &el)
   SERIALISE_MEMBER(saveAllInitials);
   SERIALISE_MEMBER(captureAllCmdLists);
   SERIALISE_MEMBER(debugOutputMute);
+  SERIALISE_MEMBER(deferDescriptorTracking);
 
   SIZE_CHECK(20);
 }
@@ -682,6 +683,43 @@ void DoSerialise(SerialiserType &ser, FrameStatistics &el)
   SIZE_CHECK(1136);
 }
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ChunkLoadStats &el)
+{
+  SERIALISE_MEMBER(chunkID);
+  SERIALISE_MEMBER(name);
+  SERIALISE_MEMBER(count);
+  SERIALISE_MEMBER(totalBytes);
+  SERIALISE_MEMBER(totalTime);
+  SERIALISE_MEMBER(medianTime);
+  SERIALISE_MEMBER(p90Time);
+  SERIALISE_MEMBER(p99Time);
+  SERIALISE_MEMBER(maxTime);
+
+  SIZE_CHECK(80);
+}
+
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ResourceLoadStats &el)
+{
+  SERIALISE_MEMBER(resourceId);
+  SERIALISE_MEMBER(count);
+  SERIALISE_MEMBER(totalTime);
+
+  SIZE_CHECK(24);
+}
+
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, LoadStatistics &el)
+{
+  SERIALISE_MEMBER(recorded);
+  SERIALISE_MEMBER(totalTime);
+  SERIALISE_MEMBER(chunks);
+  SERIALISE_MEMBER(resources);
+
+  SIZE_CHECK(48);
+}
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, FrameDescription &el)
 {
@@ -693,9 +731,10 @@ void DoSerialise(SerialiserType &ser, FrameDescription &el)
   SERIALISE_MEMBER(initDataSize);
   SERIALISE_MEMBER(captureTime);
   SERIALISE_MEMBER(stats);
+  SERIALISE_MEMBER(loadStats);
   SERIALISE_MEMBER(debugMessages);
 
-  SIZE_CHECK(1208);
+  SIZE_CHECK(1256);
 }
 
 template <typename SerialiserType>
@@ -2118,6 +2157,9 @@ INSTANTIATE_SERIALISE_TYPE(DepthStencilStats)
 INSTANTIATE_SERIALISE_TYPE(RasterizationStats)
 INSTANTIATE_SERIALISE_TYPE(OutputTargetStats)
 INSTANTIATE_SERIALISE_TYPE(FrameStatistics)
+INSTANTIATE_SERIALISE_TYPE(ChunkLoadStats)
+INSTANTIATE_SERIALISE_TYPE(ResourceLoadStats)
+INSTANTIATE_SERIALISE_TYPE(LoadStatistics)
 INSTANTIATE_SERIALISE_TYPE(FrameDescription)
 INSTANTIATE_SERIALISE_TYPE(FrameRecord)
 INSTANTIATE_SERIALISE_TYPE(MeshFormat)
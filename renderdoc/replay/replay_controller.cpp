@@ -163,6 +163,28 @@ float ConvertComponent(const ResourceFormat &fmt, const byte *data)
   return 0.0f;
 }
 
+// upper bound on the number of results kept in each query cache. Stepping through a large frame
+// would otherwise keep every event's results alive.
+static const size_t MaxCachedQueries = 512;
+
+// upper bound on the memory used by cached constant buffer contents. Prefetching stops at this
+static const uint64_t MaxCBufferCacheBytes = 16 * 1024 * 1024;
+
+// bounds on the texture readback cache. Picked pixels are tiny so most entries are small, but
+// full texture data can be large so that is bounded by size too.
+static const size_t MaxCachedTextureQueries = 4096;
+static const uint64_t MaxTextureCacheBytes = 64 * 1024 * 1024;
+
+static uint64_t ShaderVariablesSize(const rdcarray<ShaderVariable> &vars)
+{
+  uint64_t ret = vars.size() * sizeof(ShaderVariable);
+
+  for(const ShaderVariable &v : vars)
+    ret += v.name.size() + ShaderVariablesSize(v.members);
+
+  return ret;
+}
+
 static void fileWriteFunc(void *context, void *data, int size)
 {
   FileIO::fwrite(data, 1, size, (FILE *)context);
@@ -208,16 +230,194 @@ void ReplayController::SetFrameEvent(uint32_t eventId, bool force)
 {
   if(eventId != m_EventID || force)
   {
+    // if we prefetched this event the replay is already just before it, with its state saved.
+    // Otherwise the driver continues on from wherever the replay is, or replays from the start.
+    bool prefetched = !force && eventId == m_PrefetchedEventID;
+
     m_EventID = eventId;
+    m_PrefetchedEventID = 0;
 
-    m_pDevice->ReplayLog(eventId, eReplay_WithoutDraw);
+    if(!prefetched)
+      m_pDevice->ReplayLog(eventId, eReplay_WithoutDraw);
 
     for(size_t i = 0; i < m_Outputs.size(); i++)
       m_Outputs[i]->SetFrameEvent(eventId);
 
     m_pDevice->ReplayLog(eventId, eReplay_OnlyDraw);
 
-    FetchPipelineState();
+    if(prefetched)
+      CopyPipelineState();
+    else
+      FetchPipelineState();
+  }
+}
+
+void ReplayController::PrefetchEvent(uint32_t eventId)
+{
+  // only prefetch forward. The drivers can continue a replay from where it is, but going back would
+  // need a full replay both ways. For the same reason we can't go back to an earlier prefetch.
+  if(eventId <= m_EventID || eventId <= m_PrefetchedEventID || GetDrawcallByEID(eventId) == NULL)
+    return;
+
+  m_pDevice->ReplayLog(eventId, eReplay_WithoutDraw);
+
+  m_PrefetchedEventID = eventId;
+
+  // this only updates the driver's state, not the copy we return
+  m_pDevice->SavePipelineState();
+
+  PrefetchCBuffers(eventId);
+}
+
+void ReplayController::RestoreReplayPosition()
+{
+  if(m_PrefetchedEventID == 0)
+    return;
+
+  m_PrefetchedEventID = 0;
+
+  // the outputs don't need to be refreshed since nothing they rendered for this event has changed
+  m_pDevice->ReplayLog(m_EventID, eReplay_Full);
+  m_pDevice->SavePipelineState();
+}
+
+void ReplayController::PrefetchCBuffers(uint32_t eventId)
+{
+  // this mirrors how the UI looks up the constant buffers bound to each stage, so the cached
+  // results match what it will request
+  if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
+  {
+    const D3D11Pipe::State &state = m_pDevice->GetD3D11PipelineState();
+    const D3D11Pipe::Shader *stages[] = {
+        &state.vertexShader,   &state.hullShader,  &state.domainShader,
+        &state.geometryShader, &state.pixelShader, &state.computeShader,
+    };
+
+    for(const D3D11Pipe::Shader *sh : stages)
+    {
+      if(sh->reflection == NULL)
+        continue;
+
+      for(int i = 0; i < sh->reflection->constantBlocks.count(); i++)
+      {
+        const Bindpoint &bind =
+            sh->bindpointMapping.constantBlocks[sh->reflection->constantBlocks[i].bindPoint];
+
+        if(bind.bind >= sh->constantBuffers.count() || m_CBufferCacheBytes >= MaxCBufferCacheBytes)
+          continue;
+
+        const D3D11Pipe::ConstantBuffer &cb = sh->constantBuffers[bind.bind];
+
+        CachedCBufferContents(eventId, sh->resourceId, "", i, cb.resourceId,
+                              cb.vecOffset * 4 * sizeof(float));
+      }
+    }
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
+  {
+    const D3D12Pipe::State &state = m_pDevice->GetD3D12PipelineState();
+    const D3D12Pipe::Shader *stages[] = {
+        &state.vertexShader,   &state.hullShader,  &state.domainShader,
+        &state.geometryShader, &state.pixelShader, &state.computeShader,
+    };
+
+    for(const D3D12Pipe::Shader *sh : stages)
+    {
+      if(sh->reflection == NULL)
+        continue;
+
+      for(int i = 0; i < sh->reflection->constantBlocks.count(); i++)
+      {
+        const Bindpoint &bind =
+            sh->bindpointMapping.constantBlocks[sh->reflection->constantBlocks[i].bindPoint];
+
+        if(bind.bindset >= sh->spaces.count() ||
+           bind.bind >= sh->spaces[bind.bindset].constantBuffers.count() ||
+           m_CBufferCacheBytes >= MaxCBufferCacheBytes)
+          continue;
+
+        const D3D12Pipe::ConstantBuffer &cb = sh->spaces[bind.bindset].constantBuffers[bind.bind];
+
+        CachedCBufferContents(eventId, sh->resourceId, "", i, cb.resourceId, cb.byteOffset);
+      }
+    }
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
+  {
+    const GLPipe::State &state = m_pDevice->GetGLPipelineState();
+    const GLPipe::Shader *stages[] = {
+        &state.vertexShader,   &state.tessControlShader, &state.tessEvalShader,
+        &state.geometryShader, &state.fragmentShader,    &state.computeShader,
+    };
+
+    for(const GLPipe::Shader *sh : stages)
+    {
+      if(sh->reflection == NULL)
+        continue;
+
+      for(int i = 0; i < sh->reflection->constantBlocks.count(); i++)
+      {
+        if(sh->reflection->constantBlocks[i].bindPoint < 0)
+          continue;
+
+        int uboIdx =
+            sh->bindpointMapping.constantBlocks[sh->reflection->constantBlocks[i].bindPoint].bind;
+
+        if(uboIdx < 0 || uboIdx >= state.uniformBuffers.count() ||
+           m_CBufferCacheBytes >= MaxCBufferCacheBytes)
+          continue;
+
+        const GLPipe::Buffer &b = state.uniformBuffers[uboIdx];
+
+        CachedCBufferContents(eventId, sh->shaderResourceId, "", i, b.resourceId, b.byteOffset);
+      }
+    }
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
+  {
+    const VKPipe::State &state = m_pDevice->GetVulkanPipelineState();
+    const VKPipe::Shader *stages[] = {
+        &state.vertexShader,   &state.tessControlShader, &state.tessEvalShader,
+        &state.geometryShader, &state.fragmentShader,    &state.computeShader,
+    };
+
+    for(const VKPipe::Shader *sh : stages)
+    {
+      if(sh->reflection == NULL)
+        continue;
+
+      const VKPipe::Pipeline &pipe = sh == &state.computeShader ? state.compute : state.graphics;
+
+      for(int i = 0; i < sh->reflection->constantBlocks.count(); i++)
+      {
+        const ConstantBlock &block = sh->reflection->constantBlocks[i];
+
+        if(m_CBufferCacheBytes >= MaxCBufferCacheBytes)
+          continue;
+
+        // push constants are fetched without a buffer
+        if(!block.bufferBacked)
+        {
+          CachedCBufferContents(eventId, sh->resourceId, sh->entryPoint.c_str(), i, ResourceId(),
+                                0);
+          continue;
+        }
+
+        const Bindpoint &bind = sh->bindpointMapping.constantBlocks[block.bindPoint];
+
+        if(bind.bindset >= pipe.descriptorSets.count() ||
+           bind.bind >= pipe.descriptorSets[bind.bindset].bindings.count() ||
+           pipe.descriptorSets[bind.bindset].bindings[bind.bind].binds.empty())
+          continue;
+
+        // only the first array element is displayed by default
+        const VKPipe::BindingElement &el =
+            pipe.descriptorSets[bind.bindset].bindings[bind.bind].binds[0];
+
+        CachedCBufferContents(eventId, sh->resourceId, sh->entryPoint.c_str(), i,
+                              el.resourceResourceId, el.byteOffset);
+      }
+    }
   }
 }
 
@@ -292,6 +492,8 @@ rdcarray<DrawcallDescription> ReplayController::GetDrawcalls()
 
 rdcarray<CounterResult> ReplayController::FetchCounters(const rdcarray<GPUCounter> &counters)
 {
+  RestoreReplayPosition();
+
   std::vector<GPUCounter> counterArray(counters.begin(), counters.end());
 
   return m_pDevice->FetchCounters(counterArray);
@@ -342,7 +544,176 @@ rdcarray<EventUsage> ReplayController::GetUsage(ResourceId id)
   id = m_pDevice->GetLiveID(id);
   if(id == ResourceId())
     return rdcarray<EventUsage>();
-  return m_pDevice->GetUsage(id);
+
+  return CachedUsage(id);
+}
+
+const rdcarray<EventUsage> &ReplayController::CachedUsage(ResourceId liveId)
+{
+  // usage covers the whole frame, so doesn't depend on the current event
+  auto it = m_UsageCache.find(liveId);
+  if(it != m_UsageCache.end())
+    return it->second;
+
+  rdcarray<EventUsage> usage = m_pDevice->GetUsage(liveId);
+
+  if(m_UsageCache.size() >= MaxCachedQueries)
+    m_UsageCache.clear();
+
+  rdcarray<EventUsage> &ret = m_UsageCache[liveId];
+  ret.swap(usage);
+
+  return ret;
+}
+
+uint32_t ReplayController::GetTextureWriteEvent(ResourceId id)
+{
+  // only textures from the capture have usage we can rely on. Anything else, like custom shader
+  // outputs, is regenerated on demand
+  bool found = false;
+
+  for(size_t t = 0; t < m_Textures.size(); t++)
+  {
+    if(m_Textures[t].resourceId == id)
+    {
+      // texture buffers are written through their buffer, which isn't in the texture's usage
+      found = (m_Textures[t].type != TextureType::Buffer);
+      break;
+    }
+  }
+
+  if(!found)
+    return ~0U;
+
+  // these overlays clear the real texture, so its contents don't match the capture
+  for(ReplayOutput *out : m_Outputs)
+  {
+    if(out->m_Type == ReplayOutputType::Texture &&
+       (out->m_RenderData.texDisplay.overlay == DebugOverlay::ClearBeforeDraw ||
+        out->m_RenderData.texDisplay.overlay == DebugOverlay::ClearBeforePass))
+      return ~0U;
+  }
+
+  ResourceId liveId = m_pDevice->GetLiveID(id);
+
+  if(liveId == ResourceId())
+    return ~0U;
+
+  const rdcarray<EventUsage> &usage = CachedUsage(liveId);
+
+  // 0 means the texture still has its initial contents
+  uint32_t ret = 0;
+
+  for(const EventUsage &u : usage)
+  {
+    if(u.eventId > m_EventID || u.eventId < ret)
+      continue;
+
+    switch(u.usage)
+    {
+      case ResourceUsage::VertexBuffer:
+      case ResourceUsage::IndexBuffer:
+      case ResourceUsage::VS_Constants:
+      case ResourceUsage::HS_Constants:
+      case ResourceUsage::DS_Constants:
+      case ResourceUsage::GS_Constants:
+      case ResourceUsage::PS_Constants:
+      case ResourceUsage::CS_Constants:
+      case ResourceUsage::All_Constants:
+      case ResourceUsage::VS_Resource:
+      case ResourceUsage::HS_Resource:
+      case ResourceUsage::DS_Resource:
+      case ResourceUsage::GS_Resource:
+      case ResourceUsage::PS_Resource:
+      case ResourceUsage::CS_Resource:
+      case ResourceUsage::All_Resource:
+      case ResourceUsage::InputTarget:
+      case ResourceUsage::CopySrc:
+      case ResourceUsage::ResolveSrc:
+      case ResourceUsage::Indirect:
+        // read-only, contents are unchanged
+        continue;
+
+      // barriers can discard contents with a layout transition, so treat them as writes
+      case ResourceUsage::Barrier:
+      case ResourceUsage::Unused:
+      case ResourceUsage::StreamOut:
+      case ResourceUsage::VS_RWResource:
+      case ResourceUsage::HS_RWResource:
+      case ResourceUsage::DS_RWResource:
+      case ResourceUsage::GS_RWResource:
+      case ResourceUsage::PS_RWResource:
+      case ResourceUsage::CS_RWResource:
+      case ResourceUsage::All_RWResource:
+      case ResourceUsage::ColorTarget:
+      case ResourceUsage::DepthStencilTarget:
+      case ResourceUsage::Clear:
+      case ResourceUsage::Copy:
+      case ResourceUsage::CopyDst:
+      case ResourceUsage::Resolve:
+      case ResourceUsage::ResolveDst:
+      case ResourceUsage::GenMips: break;
+    }
+
+    ret = u.eventId;
+  }
+
+  return ret;
+}
+
+bool ReplayController::MakeTextureCacheKey(TextureQuery query, ResourceId id, uint32_t slice,
+                                           uint32_t mip, uint32_t sample, CompType typeHint,
+                                           TextureCacheKey &key)
+{
+  RDCEraseEl(key);
+
+  uint32_t writeEventId = GetTextureWriteEvent(id);
+
+  if(writeEventId == ~0U)
+    return false;
+  key.query = query;
+  key.tex = id;
+  key.writeEventId = writeEventId;
+  key.slice = slice;
+  key.mip = mip;
+  key.sample = sample;
+  key.typeHint = typeHint;
+
+  return true;
+}
+
+bool ReplayController::FindCachedTextureData(const TextureCacheKey &key, bytebuf &data)
+{
+  auto it = m_TextureCache.find(key);
+  if(it == m_TextureCache.end())
+    return false;
+
+  // move to the front as most recently used
+  m_TextureCacheLRU.splice(m_TextureCacheLRU.begin(), m_TextureCacheLRU, it->second);
+
+  data = it->second->data;
+
+  return true;
+}
+
+void ReplayController::CacheTextureData(const TextureCacheKey &key, const bytebuf &data)
+{
+  if(data.size() > MaxTextureCacheBytes || m_TextureCache.find(key) != m_TextureCache.end())
+    return;
+
+  m_TextureCacheLRU.push_front({key, data});
+  m_TextureCache[key] = m_TextureCacheLRU.begin();
+  m_TextureCacheBytes += data.size();
+
+  while(m_TextureCache.size() > MaxCachedTextureQueries ||
+        m_TextureCacheBytes > MaxTextureCacheBytes)
+  {
+    TextureCacheEntry &oldest = m_TextureCacheLRU.back();
+
+    m_TextureCacheBytes -= oldest.data.size();
+    m_TextureCache.erase(oldest.key);
+    m_TextureCacheLRU.pop_back();
+  }
 }
 
 MeshFormat ReplayController::GetPostVSData(uint32_t instID, MeshDataStage stage)
@@ -357,9 +728,24 @@ MeshFormat ReplayController::GetPostVSData(uint32_t instID, MeshDataStage stage)
 
   instID = RDCMIN(instID, draw->numInstances - 1);
 
+  PostVSKey key = {draw->eventId, instID, stage};
+
+  auto it = m_PostVSCache.find(key);
+  if(it != m_PostVSCache.end())
+    return it->second;
+
+  RestoreReplayPosition();
+
   m_pDevice->InitPostVSBuffers(draw->eventId);
 
-  return m_pDevice->GetPostVSBuffers(draw->eventId, instID, stage);
+  ret = m_pDevice->GetPostVSBuffers(draw->eventId, instID, stage);
+
+  if(m_PostVSCache.size() >= MaxCachedQueries)
+    m_PostVSCache.clear();
+
+  m_PostVSCache[key] = ret;
+
+  return ret;
 }
 
 bytebuf ReplayController::GetBufferData(ResourceId buff, uint64_t offset, uint64_t len)
@@ -377,6 +763,8 @@ bytebuf ReplayController::GetBufferData(ResourceId buff, uint64_t offset, uint64
     return retData;
   }
 
+  RestoreReplayPosition();
+
   m_pDevice->GetBufferData(liveId, offset, len, retData);
 
   return retData;
@@ -394,13 +782,27 @@ bytebuf ReplayController::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint
     return ret;
   }
 
+  TextureCacheKey key;
+  bool cacheable =
+      MakeTextureCacheKey(TextureQuery::Data, tex, arrayIdx, mip, 0, CompType::Typeless, key);
+
+  if(cacheable && FindCachedTextureData(key, ret))
+    return ret;
+
+  RestoreReplayPosition();
+
   m_pDevice->GetTextureData(liveId, arrayIdx, mip, GetTextureDataParams(), ret);
 
+  if(cacheable)
+    CacheTextureData(key, ret);
+
   return ret;
 }
 
 bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path)
 {
+  RestoreReplayPosition();
+
   TextureSave sd = saveData;    // mutable copy
   ResourceId liveid = m_pDevice->GetLiveID(sd.resourceId);
 
@@ -1233,6 +1635,8 @@ rdcarray<PixelModification> ReplayController::PixelHistory(ResourceId target, ui
                                                            uint32_t y, uint32_t slice, uint32_t mip,
                                                            uint32_t sampleIdx, CompType typeHint)
 {
+  RestoreReplayPosition();
+
   rdcarray<PixelModification> ret;
 
   for(size_t t = 0; t < m_Textures.size(); t++)
@@ -1341,6 +1745,8 @@ rdcarray<PixelModification> ReplayController::PixelHistory(ResourceId target, ui
 ShaderDebugTrace *ReplayController::DebugVertex(uint32_t vertid, uint32_t instid, uint32_t idx,
                                                 uint32_t instOffset, uint32_t vertOffset)
 {
+  RestoreReplayPosition();
+
   ShaderDebugTrace *ret = new ShaderDebugTrace;
 
   *ret = m_pDevice->DebugVertex(m_EventID, vertid, instid, idx, instOffset, vertOffset);
@@ -1353,6 +1759,8 @@ ShaderDebugTrace *ReplayController::DebugVertex(uint32_t vertid, uint32_t instid
 ShaderDebugTrace *ReplayController::DebugPixel(uint32_t x, uint32_t y, uint32_t sample,
                                                uint32_t primitive)
 {
+  RestoreReplayPosition();
+
   ShaderDebugTrace *ret = new ShaderDebugTrace;
 
   *ret = m_pDevice->DebugPixel(m_EventID, x, y, sample, primitive);
@@ -1364,6 +1772,8 @@ ShaderDebugTrace *ReplayController::DebugPixel(uint32_t x, uint32_t y, uint32_t
 
 ShaderDebugTrace *ReplayController::DebugThread(const uint32_t groupid[3], const uint32_t threadid[3])
 {
+  RestoreReplayPosition();
+
   ShaderDebugTrace *ret = new ShaderDebugTrace;
 
   *ret = m_pDevice->DebugThread(m_EventID, groupid, threadid);
@@ -1381,6 +1791,30 @@ void ReplayController::FreeTrace(ShaderDebugTrace *trace)
 rdcarray<ShaderVariable> ReplayController::GetCBufferVariableContents(
     ResourceId shader, const char *entryPoint, uint32_t cbufslot, ResourceId buffer, uint64_t offs)
 {
+  CBufferKey key = {m_EventID, shader, entryPoint ? entryPoint : "", cbufslot, buffer, offs};
+
+  auto it = m_CBufferCache.find(key);
+  if(it != m_CBufferCache.end())
+    return it->second;
+
+  RestoreReplayPosition();
+
+  return CachedCBufferContents(m_EventID, shader, entryPoint, cbufslot, buffer, offs);
+}
+
+rdcarray<ShaderVariable> ReplayController::CachedCBufferContents(uint32_t eventId,
+                                                                 ResourceId shader,
+                                                                 const char *entryPoint,
+                                                                 uint32_t cbufslot,
+                                                                 ResourceId buffer, uint64_t offs)
+{
+  // the buffer contents are read at the replay's current position, so they're only valid there
+  CBufferKey key = {eventId, shader, entryPoint ? entryPoint : "", cbufslot, buffer, offs};
+
+  auto it = m_CBufferCache.find(key);
+  if(it != m_CBufferCache.end())
+    return it->second;
+
   bytebuf data;
   if(buffer != ResourceId())
   {
@@ -1396,7 +1830,18 @@ rdcarray<ShaderVariable> ReplayController::GetCBufferVariableContents(
   if(shader != ResourceId())
     m_pDevice->FillCBufferVariables(shader, entryPoint, cbufslot, v, data);
 
-  return v;
+  rdcarray<ShaderVariable> ret = v;
+
+  if(m_CBufferCache.size() >= MaxCachedQueries || m_CBufferCacheBytes >= MaxCBufferCacheBytes)
+  {
+    m_CBufferCache.clear();
+    m_CBufferCacheBytes = 0;
+  }
+
+  m_CBufferCache[key] = ret;
+  m_CBufferCacheBytes += ShaderVariablesSize(ret);
+
+  return ret;
 }
 
 rdcarray<WindowingSystem> ReplayController::GetSupportedWindowSystems()
@@ -1406,6 +1851,8 @@ rdcarray<WindowingSystem> ReplayController::GetSupportedWindowSystems()
 
 rdcstr ReplayController::CreateRGPProfile(WindowingData window)
 {
+  RestoreReplayPosition();
+
   AMDRGPControl *rgp = m_pDevice->GetRGPControl();
 
   if(!rgp)
@@ -1527,6 +1974,8 @@ void ReplayController::CancelReplayLoop()
 
 ReplayOutput *ReplayController::CreateOutput(WindowingData window, ReplayOutputType type)
 {
+  RestoreReplayPosition();
+
   ReplayOutput *out = new ReplayOutput(this, window, type);
 
   m_Outputs.push_back(out);
@@ -1622,10 +2071,23 @@ void ReplayController::FreeCustomShader(ResourceId id)
   m_pDevice->FreeCustomShader(id);
 }
 
+void ReplayController::ClearQueryCache()
+{
+  m_UsageCache.clear();
+  m_PostVSCache.clear();
+  m_CBufferCache.clear();
+  m_CBufferCacheBytes = 0;
+  m_TextureCacheLRU.clear();
+  m_TextureCache.clear();
+  m_TextureCacheBytes = 0;
+}
+
 void ReplayController::ReplaceResource(ResourceId from, ResourceId to)
 {
   m_pDevice->ReplaceResource(from, to);
 
+  ClearQueryCache();
+
   SetFrameEvent(m_EventID, true);
 
   for(size_t i = 0; i < m_Outputs.size(); i++)
@@ -1637,6 +2099,8 @@ void ReplayController::RemoveReplacement(ResourceId id)
 {
   m_pDevice->RemoveReplacement(id);
 
+  ClearQueryCache();
+
   SetFrameEvent(m_EventID, true);
 
   for(size_t i = 0; i < m_Outputs.size(); i++)
@@ -1680,10 +2144,10 @@ ReplayStatus ReplayController::PostCreateInit(IReplayDriver *device, RDCFile *rd
   if(status != ReplayStatus::Succeeded)
     return status;
 
-  FetchPipelineState();
-
   m_APIProps = m_pDevice->GetAPIProperties();
 
+  FetchPipelineState();
+
   // fetch GCN ISA targets
   GCNISA::GetTargets(m_APIProps.pipelineType, m_GCNTargets);
 
@@ -1732,8 +2196,23 @@ void ReplayController::FetchPipelineState()
 {
   m_pDevice->SavePipelineState();
 
-  m_D3D11PipelineState = &m_pDevice->GetD3D11PipelineState();
-  m_D3D12PipelineState = &m_pDevice->GetD3D12PipelineState();
-  m_GLPipelineState = &m_pDevice->GetGLPipelineState();
-  m_VulkanPipelineState = &m_pDevice->GetVulkanPipelineState();
+  CopyPipelineState();
+}
+
+void ReplayController::CopyPipelineState()
+{
+  // only the state for the capture's API is filled out, the others stay at their defaults
+  if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
+    m_D3D11State = m_pDevice->GetD3D11PipelineState();
+  else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
+    m_D3D12State = m_pDevice->GetD3D12PipelineState();
+  else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
+    m_GLState = m_pDevice->GetGLPipelineState();
+  else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
+    m_VulkanState = m_pDevice->GetVulkanPipelineState();
+
+  m_D3D11PipelineState = &m_D3D11State;
+  m_D3D12PipelineState = &m_D3D12State;
+  m_GLPipelineState = &m_GLState;
+  m_VulkanPipelineState = &m_VulkanState;
 }
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include <list>
+#include <map>
 #include <set>
 #include <vector>
 #include "api/replay/renderdoc_replay.h"
@@ -90,6 +92,10 @@ private:
     CompType typeHint;
     uint64_t outputID;
 
+    // the event the texture was last written at when this was rendered, see
+    // ReplayController::GetTextureWriteEvent
+    uint32_t writeEventId;
+
     bool dirty;
   } m_MainOutput;
 
@@ -133,6 +139,7 @@ public:
   void FileChanged();
 
   void SetFrameEvent(uint32_t eventId, bool force);
+  void PrefetchEvent(uint32_t eventId);
 
   void FetchPipelineState();
 
@@ -208,6 +215,74 @@ private:
 
   DrawcallDescription *GetDrawcallByEID(uint32_t eventId);
 
+  void ClearQueryCache();
+  rdcarray<ShaderVariable> CachedCBufferContents(uint32_t eventId, ResourceId shader,
+                                                 const char *entryPoint, uint32_t cbufslot,
+                                                 ResourceId buffer, uint64_t offs);
+  void PrefetchCBuffers(uint32_t eventId);
+  void CopyPipelineState();
+  void RestoreReplayPosition();
+
+  const rdcarray<EventUsage> &CachedUsage(ResourceId liveId);
+  uint32_t GetTextureWriteEvent(ResourceId id);
+
+  enum class TextureQuery : uint32_t
+  {
+    MinMax,
+    Histogram,
+    Pixel,
+    Data,
+  };
+
+  // texture readbacks are keyed on the last event at or before the current one that wrote to the
+  // texture, rather than the current event itself. Moving between events that don't touch a
+  // texture then keeps its results valid.
+  struct TextureCacheKey
+  {
+    TextureQuery query;
+    ResourceId tex;
+    uint32_t writeEventId;
+    uint32_t slice;
+    uint32_t mip;
+    uint32_t sample;
+    CompType typeHint;
+    // query-specific parameters - the pixel co-ordinate, or the histogram range and channels
+    uint32_t params[3];
+
+    bool operator<(const TextureCacheKey &o) const
+    {
+      if(query != o.query)
+        return query < o.query;
+      if(tex != o.tex)
+        return tex < o.tex;
+      if(writeEventId != o.writeEventId)
+        return writeEventId < o.writeEventId;
+      if(slice != o.slice)
+        return slice < o.slice;
+      if(mip != o.mip)
+        return mip < o.mip;
+      if(sample != o.sample)
+        return sample < o.sample;
+      if(typeHint != o.typeHint)
+        return typeHint < o.typeHint;
+      for(size_t i = 0; i < ARRAY_COUNT(params); i++)
+        if(params[i] != o.params[i])
+          return params[i] < o.params[i];
+      return false;
+    }
+  };
+
+  struct TextureCacheEntry
+  {
+    TextureCacheKey key;
+    bytebuf data;
+  };
+
+  bool MakeTextureCacheKey(TextureQuery query, ResourceId id, uint32_t slice, uint32_t mip,
+                           uint32_t sample, CompType typeHint, TextureCacheKey &key);
+  bool FindCachedTextureData(const TextureCacheKey &key, bytebuf &data);
+  void CacheTextureData(const TextureCacheKey &key, const bytebuf &data);
+
   IReplayDriver *GetDevice() { return m_pDevice; }
   FrameRecord m_FrameRecord;
   vector<DrawcallDescription *> m_Drawcalls;
@@ -225,6 +300,17 @@ private:
   const GLPipe::State *m_GLPipelineState;
   const VKPipe::State *m_VulkanPipelineState;
 
+  // our own copy of the current event's pipeline state, which is what we return. Prefetching moves
+  // the driver's state on to the next event while the UI might still be reading ours.
+  D3D11Pipe::State m_D3D11State;
+  D3D12Pipe::State m_D3D12State;
+  GLPipe::State m_GLState;
+  VKPipe::State m_VulkanState;
+
+  // if non-zero, the replay has been moved forward to just before this event by PrefetchEvent and
+  // needs to be restored to m_EventID before anything uses it.
+  uint32_t m_PrefetchedEventID = 0;
+
   std::vector<ReplayOutput *> m_Outputs;
 
   rdcarray<ResourceDescription> m_Resources;
@@ -236,5 +322,59 @@ private:
   std::set<ResourceId> m_TargetResources;
   std::set<ResourceId> m_CustomShaders;
 
+  // results of queries that are idempotent for a given event, so that repeated requests - from
+  // several UI panels, or over a remote connection - don't go back to the driver. Replacing a
+  // resource can change any of them so that clears the cache.
+  struct PostVSKey
+  {
+    uint32_t eventId;
+    uint32_t instID;
+    MeshDataStage stage;
+
+    bool operator<(const PostVSKey &o) const
+    {
+      if(eventId != o.eventId)
+        return eventId < o.eventId;
+      if(instID != o.instID)
+        return instID < o.instID;
+      return stage < o.stage;
+    }
+  };
+
+  struct CBufferKey
+  {
+    uint32_t eventId;
+    ResourceId shader;
+    std::string entryPoint;
+    uint32_t cbufslot;
+    ResourceId buffer;
+    uint64_t offs;
+
+    bool operator<(const CBufferKey &o) const
+    {
+      if(eventId != o.eventId)
+        return eventId < o.eventId;
+      if(shader != o.shader)
+        return shader < o.shader;
+      if(entryPoint != o.entryPoint)
+        return entryPoint < o.entryPoint;
+      if(cbufslot != o.cbufslot)
+        return cbufslot < o.cbufslot;
+      if(buffer != o.buffer)
+        return buffer < o.buffer;
+      return offs < o.offs;
+    }
+  };
+
+  std::map<ResourceId, rdcarray<EventUsage>> m_UsageCache;
+  std::map<PostVSKey, MeshFormat> m_PostVSCache;
+  std::map<CBufferKey, rdcarray<ShaderVariable>> m_CBufferCache;
+  uint64_t m_CBufferCacheBytes = 0;
+
+  // most recently used entries are at the front of the list, and evicted from the back
+  std::list<TextureCacheEntry> m_TextureCacheLRU;
+  std::map<TextureCacheKey, std::list<TextureCacheEntry>::iterator> m_TextureCache;
+  uint64_t m_TextureCacheBytes = 0;
+
   friend struct ReplayOutput;
 };
@@ -23,7 +23,12 @@
  ******************************************************************************/
 
 #include "replay_driver.h"
+#include <float.h>
+#include "common/threading.h"
+#include "maths/camera.h"
 #include "maths/formatpacking.h"
+#include "maths/matrix.h"
+#include "serialise/rdcfile.h"
 #include "serialise/serialiser.h"
 
 template <>
@@ -203,6 +208,117 @@ void PatchLineStripIndexBuffer(const DrawcallDescription *draw, uint8_t *idx8, u
 #undef IDX_VALUE
 }
 
+void GetUniqueIndices(const uint32_t *indices, size_t count, std::vector<uint32_t> &uniqueIndices)
+{
+  uniqueIndices.clear();
+
+  if(count == 0)
+    return;
+
+  // find the range of the indices. This is a simple reduction that the compiler can vectorise
+  uint32_t minIdx = indices[0], maxIdx = indices[0];
+  for(size_t i = 1; i < count; i++)
+  {
+    minIdx = RDCMIN(minIdx, indices[i]);
+    maxIdx = RDCMAX(maxIdx, indices[i]);
+  }
+
+  const uint64_t range = uint64_t(maxIdx - minIdx) + 1;
+
+  // a bitmap costs one bit per value in the range plus a scan over it, so use it whenever that's
+  // not much more work than touching each index. That covers almost all real index buffers, with
+  // the radix sort below for the rare case of a few huge or garbage indices.
+  if(range <= RDCMAX(uint64_t(count) * 32, uint64_t(1) << 20))
+  {
+    std::vector<uint32_t> bitmap(size_t((range + 31) / 32), 0);
+
+    for(size_t i = 0; i < count; i++)
+    {
+      uint32_t offs = indices[i] - minIdx;
+      bitmap[offs / 32] |= (1U << (offs % 32));
+    }
+
+    uniqueIndices.reserve((size_t)RDCMIN(uint64_t(count), range));
+
+    for(size_t w = 0; w < bitmap.size(); w++)
+    {
+      uint32_t bits = bitmap[w];
+
+      while(bits)
+      {
+        // isolate and clear the lowest set bit
+        uint32_t lowest = bits & (~bits + 1);
+        bits ^= lowest;
+
+        uniqueIndices.push_back(minIdx + uint32_t(w * 32) + 31 - Bits::CountLeadingZeroes(lowest));
+      }
+    }
+
+    return;
+  }
+
+  // LSD radix sort a byte at a time, then drop duplicates. Histograms for all four passes are built
+  // in one go, and any pass where every index has the same byte value is skipped.
+  std::vector<uint32_t> sorted(indices, indices + count);
+  std::vector<uint32_t> scratch(count);
+
+  std::vector<size_t> histograms(256 * 4, 0);
+  for(size_t i = 0; i < count; i++)
+  {
+    uint32_t idx = indices[i];
+    histograms[0 * 256 + ((idx >> 0) & 0xff)]++;
+    histograms[1 * 256 + ((idx >> 8) & 0xff)]++;
+    histograms[2 * 256 + ((idx >> 16) & 0xff)]++;
+    histograms[3 * 256 + ((idx >> 24) & 0xff)]++;
+  }
+
+  for(uint32_t pass = 0; pass < 4; pass++)
+  {
+    const uint32_t shift = pass * 8;
+    size_t *histogram = &histograms[pass * 256];
+
+    if(histogram[(sorted[0] >> shift) & 0xff] == count)
+      continue;
+
+    // convert counts to starting offsets
+    size_t offs = 0;
+    for(uint32_t b = 0; b < 256; b++)
+    {
+      size_t num = histogram[b];
+      histogram[b] = offs;
+      offs += num;
+    }
+
+    for(size_t i = 0; i < count; i++)
+      scratch[histogram[(sorted[i] >> shift) & 0xff]++] = sorted[i];
+
+    sorted.swap(scratch);
+  }
+
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+  uniqueIndices.swap(sorted);
+}
+
+UniqueIndexRemap::UniqueIndexRemap(const std::vector<uint32_t> &uniqueIndices)
+    : m_Unique(uniqueIndices)
+{
+  if(uniqueIndices.empty())
+    return;
+
+  m_Base = uniqueIndices.front();
+
+  const uint64_t range = uint64_t(uniqueIndices.back() - m_Base) + 1;
+
+  // a flat table is much faster than searching, as long as the indices aren't too sparse
+  if(range <= RDCMAX(uint64_t(uniqueIndices.size()) * 8, uint64_t(1) << 16))
+  {
+    m_Table.resize((size_t)range, 0);
+
+    for(size_t i = 0; i < uniqueIndices.size(); i++)
+      m_Table[uniqueIndices[i] - m_Base] = uint32_t(i);
+  }
+}
+
 FloatVector HighlightCache::InterpretVertex(const byte *data, uint32_t vert, const MeshDisplay &cfg,
                                             const byte *end, bool useidx, bool &valid)
 {
@@ -323,6 +439,10 @@ void HighlightCache::CacheHighlightingData(uint32_t eventId, const MeshDisplay &
   newKey = inthash(cfg.position.vertexByteStride, newKey);
   newKey = inthash(cfg.position.indexResourceId, newKey);
   newKey = inthash(cfg.position.vertexResourceId, newKey);
+  newKey = inthash((uint64_t)cfg.position.format.type, newKey);
+  newKey = inthash((uint64_t)cfg.position.format.compType, newKey);
+  newKey = inthash(cfg.position.format.compCount, newKey);
+  newKey = inthash(cfg.position.format.compByteWidth, newKey);
 
   if(cacheKey != newKey)
   {
@@ -420,6 +540,147 @@ void HighlightCache::CacheHighlightingData(uint32_t eventId, const MeshDisplay &
   }
 }
 
+uint32_t HighlightCache::PickVertex(int32_t width, int32_t height, const MeshDisplay &cfg,
+                                    uint32_t x, uint32_t y, bool flipUnprojectedY)
+{
+  uint64_t newKey = inthash((uint64_t)cfg.position.unproject, cacheKey);
+  newKey = inthash((uint64_t)flipUnprojectedY, newKey);
+
+  if(pickKey != newKey)
+  {
+    pickKey = newKey;
+
+    const uint32_t stride = cfg.position.vertexByteStride;
+    const uint32_t numPositions = stride ? uint32_t(vertexData.size() / stride) : 0;
+
+    std::vector<Vec3f> positions(numPositions);
+
+    // InterpretVertex only fails when reading off the end of the data, so the valid vertices are
+    // all at the start and anything after the first invalid one is dropped.
+    const uint32_t numJobs = RDCCLAMP(numPositions / 16384, 1U, Threading::GetCoreCount());
+    std::vector<uint32_t> firstInvalid(numJobs, numPositions);
+
+    Threading::RunParallelJobs(numJobs, [&](uint32_t job) {
+      const byte *data = vertexData.data();
+      const byte *dataEnd = data + vertexData.size();
+
+      uint32_t begin = uint32_t(uint64_t(numPositions) * job / numJobs);
+      uint32_t end = uint32_t(uint64_t(numPositions) * (job + 1) / numJobs);
+
+      for(uint32_t v = begin; v < end; v++)
+      {
+        bool valid = true;
+        FloatVector pos = InterpretVertex(data, v, stride, cfg.position.format, dataEnd, valid);
+
+        if(!valid)
+        {
+          firstInvalid[job] = v;
+          break;
+        }
+
+        if(cfg.position.unproject)
+        {
+          if(flipUnprojectedY)
+            pos.y = -pos.y;
+
+          positions[v] = Vec3f(pos.x / pos.w, pos.y / pos.w, pos.z / pos.w);
+        }
+        else
+        {
+          positions[v] = Vec3f(pos.x, pos.y, pos.z);
+        }
+      }
+    });
+
+    positions.resize(*std::min_element(firstInvalid.begin(), firstInvalid.end()));
+
+    pickBVH.Build(cfg.position.topology, cfg.position.numIndices, std::move(positions),
+                  idxData ? indices : std::vector<uint32_t>());
+  }
+
+  Matrix4f projMat = Matrix4f::Perspective(90.0f, 0.1f, 100000.0f, float(width) / float(height));
+
+  Matrix4f camMat = cfg.cam ? ((Camera *)cfg.cam)->GetMatrix() : Matrix4f::Identity();
+  Matrix4f pickMVP = projMat.Mul(camMat);
+
+  Matrix4f pickMVPProj;
+  if(cfg.position.unproject)
+  {
+    // the derivation of the projection matrix might not be right (hell, it could be an
+    // orthographic projection). But it'll be close enough likely.
+    Matrix4f guessProj =
+        cfg.position.farPlane != FLT_MAX
+            ? Matrix4f::Perspective(cfg.fov, cfg.position.nearPlane, cfg.position.farPlane, cfg.aspect)
+            : Matrix4f::ReversePerspective(cfg.fov, cfg.position.nearPlane, cfg.aspect);
+
+    if(cfg.ortho)
+      guessProj = Matrix4f::Orthographic(cfg.position.nearPlane, cfg.position.farPlane);
+
+    pickMVPProj = projMat.Mul(camMat.Mul(guessProj.Inverse()));
+  }
+
+  if(!pickBVH.IsTriangleMesh())
+  {
+    // points, lines, patchlists - pick the nearest vertex to the cursor on screen
+    return pickBVH.PickPoint(cfg.position.unproject ? pickMVPProj : pickMVP,
+                             cfg.position.unproject, Vec2f((float)width, (float)height),
+                             Vec2f((float)x, (float)y), 35.0f);
+  }
+
+  Vec3f rayPos;
+  Vec3f rayDir;
+  // convert mouse pos to world space ray
+  {
+    Matrix4f inversePickMVP = pickMVP.Inverse();
+
+    float pickX = ((float)x) / ((float)width);
+    float pickXCanonical = RDCLERP(-1.0f, 1.0f, pickX);
+
+    float pickY = ((float)y) / ((float)height);
+    // flip the Y axis
+    float pickYCanonical = RDCLERP(1.0f, -1.0f, pickY);
+
+    Vec3f cameraToWorldNearPosition =
+        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
+
+    Vec3f cameraToWorldFarPosition =
+        inversePickMVP.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
+
+    Vec3f testDir = (cameraToWorldFarPosition - cameraToWorldNearPosition);
+    testDir.Normalise();
+
+    /* Calculate the ray direction first in the regular way (above), so we can use the
+    the output for testing if the ray we are picking is negative or not. This is similar
+    to checking against the forward direction of the camera, but more robust
+    */
+    if(cfg.position.unproject)
+    {
+      Matrix4f inversePickMVPGuess = pickMVPProj.Inverse();
+
+      Vec3f nearPosProj =
+          inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, -1), 1);
+
+      Vec3f farPosProj = inversePickMVPGuess.Transform(Vec3f(pickXCanonical, pickYCanonical, 1), 1);
+
+      rayDir = (farPosProj - nearPosProj);
+      rayDir.Normalise();
+
+      if(testDir.z < 0)
+      {
+        rayDir = -rayDir;
+      }
+      rayPos = nearPosProj;
+    }
+    else
+    {
+      rayDir = testDir;
+      rayPos = cameraToWorldNearPosition;
+    }
+  }
+
+  return pickBVH.PickTriangle(rayPos, rayDir);
+}
+
 bool HighlightCache::FetchHighlightPositions(const MeshDisplay &cfg, FloatVector &activeVertex,
                                              vector<FloatVector> &activePrim,
                                              vector<FloatVector> &adjacentPrimVertices,
@@ -744,3 +1005,753 @@ bool HighlightCache::FetchHighlightPositions(const MeshDisplay &cfg, FloatVector
 
   return valid;
 }
+
+void EventIndex::Build(const std::vector<APIEvent> &events)
+{
+  m_Count = events.size();
+  m_Index.clear();
+
+  if(events.empty())
+    return;
+
+  m_Index.resize(events.back().eventId + 1);
+
+  uint32_t e = 0;
+  for(uint32_t eid = 0; eid < m_Index.size(); eid++)
+  {
+    while(events[e].eventId < eid)
+      e++;
+    m_Index[eid] = e;
+  }
+}
+
+void AddAliasedCounterResults(std::vector<CounterResult> &results,
+                              const std::vector<std::pair<uint32_t, uint32_t> > &aliases,
+                              const std::vector<GPUCounter> &counters)
+{
+  std::sort(results.begin(), results.end());
+
+  if(aliases.empty())
+    return;
+
+  // reserve up front so that appending doesn't invalidate the sorted range we search
+  const size_t numResults = results.size();
+  results.reserve(numResults + aliases.size() * counters.size());
+
+  for(const std::pair<uint32_t, uint32_t> &alias : aliases)
+  {
+    for(GPUCounter counter : counters)
+    {
+      CounterResult search;
+      search.eventId = alias.first;
+      search.counter = counter;
+
+      // find the result we're aliasing
+      auto end = results.begin() + numResults;
+      auto it = std::lower_bound(results.begin(), end, search);
+      if(it != end && *it == search)
+      {
+        // duplicate the result and append
+        CounterResult aliased = *it;
+        aliased.eventId = alias.second;
+        results.push_back(aliased);
+      }
+      else
+      {
+        RDCERR("Expected to find alias-target result for EID %u counter %u, but didn't",
+               search.eventId, search.counter);
+      }
+    }
+  }
+
+  // sort so that the alias results appear in the right places
+  std::sort(results.begin(), results.end());
+}
+
+// don't split sections into ranges much smaller than this, as each range needs its own driver
+static const uint64_t MinExportRangeSize = 8 * 1024 * 1024;
+
+// buffers are referenced by index, so once a range's buffers are appended after earlier ranges' the
+// references need to be offset to match.
+static void RebaseBufferIndices(SDObject *obj, uint64_t base)
+{
+  if(obj->type.basetype == SDBasic::Buffer)
+    obj->data.basic.u += base;
+
+  for(SDObject *child : obj->data.children)
+    RebaseBufferIndices(child, base);
+}
+
+ReplayStatus ExportStructuredParallel(RDCFile *rdc, int sectionIdx,
+                                      const std::function<ChunkRangeExporter()> &createExporter,
+                                      SDFile &output)
+{
+  bytebuf data;
+
+  {
+    StreamReader *reader = rdc->ReadSection(sectionIdx);
+
+    if(!reader->IsErrored())
+    {
+      data.resize((size_t)reader->GetSize());
+      reader->Read(data.data(), data.size());
+    }
+
+    bool errored = reader->IsErrored();
+
+    delete reader;
+
+    if(errored)
+      return ReplayStatus::FileIOFailed;
+  }
+
+  // walk the chunk headers to find where to split. Each chunk's length lets us skip over its
+  // contents without understanding them.
+  std::vector<uint64_t> splits = {0};
+
+  {
+    size_t numRanges = (size_t)RDCCLAMP(data.size() / MinExportRangeSize, (uint64_t)1,
+                                        (uint64_t)Threading::GetCoreCount());
+    uint64_t rangeSize = data.size() / numRanges;
+
+    ReadSerialiser ser(new StreamReader(data.data(), data.size()), Ownership::Stream);
+
+    StreamReader *reader = ser.GetReader();
+
+    while(splits.size() < numRanges && !reader->AtEnd())
+    {
+      ser.ReadChunk<uint32_t>();
+
+      // chunks written in streaming mode don't record their length so we can't skip past them.
+      // Everything from here on goes in the current range.
+      if(ser.ChunkMetadata().length == 0)
+        break;
+
+      ser.EndChunk();
+
+      if(reader->IsErrored())
+        return ReplayStatus::FileCorrupted;
+
+      if(!reader->AtEnd() && reader->GetOffset() >= splits.back() + rangeSize)
+        splits.push_back(reader->GetOffset());
+    }
+  }
+
+  splits.push_back(data.size());
+
+  const size_t numRanges = splits.size() - 1;
+
+  std::vector<ChunkRangeExporter> exporters;
+  for(size_t i = 0; i < numRanges; i++)
+    exporters.push_back(createExporter());
+
+  std::vector<SDFile> results(numRanges);
+  std::vector<ReplayStatus> statuses(numRanges, ReplayStatus::Succeeded);
+
+  volatile int32_t rangesDone = 0;
+
+  Threading::RunParallelJobs((uint32_t)numRanges, [&](uint32_t i) {
+    StreamReader reader(data.data() + splits[i], splits[i + 1] - splits[i]);
+    statuses[i] = exporters[i](&reader, results[i]);
+
+    int32_t done = Atomic::Inc32(&rangesDone);
+
+    // job 0 runs on the calling thread, so only report progress from there. Any ranges that
+    // finished before it are counted when it does.
+    if(i == 0)
+      RenderDoc::Inst().SetProgress(LoadProgress::FileInitialRead,
+                                    float(done) / float(numRanges));
+  });
+
+  RenderDoc::Inst().SetProgress(LoadProgress::FileInitialRead, 1.0f);
+
+  for(ReplayStatus status : statuses)
+    if(status != ReplayStatus::Succeeded)
+      return status;
+
+  for(SDFile &result : results)
+  {
+    uint64_t bufferBase = output.buffers.size();
+
+    for(SDChunk *chunk : result.chunks)
+    {
+      if(bufferBase > 0)
+        RebaseBufferIndices(chunk, bufferBase);
+
+      output.chunks.push_back(chunk);
+    }
+
+    output.buffers.insert(output.buffers.size(), result.buffers);
+
+    // ownership has moved to output
+    result.chunks.clear();
+    result.buffers.clear();
+  }
+
+  return ReplayStatus::Succeeded;
+}
+
+// from chrome_json_codec.cpp
+ReplayStatus exportChrome(const char *filename, const RDCFile &rdc, const SDFile &structData,
+                          RENDERDOC_ProgressCallback progress);
+
+// attribute a chunk to the last resource among its parameters - for creation functions that's the
+// resource being created, and for initial contents it's the only one.
+static ResourceId GetChunkResource(const SDChunk *chunk)
+{
+  ResourceId ret;
+
+  for(const SDObject *param : chunk->data.children)
+    if(param->type.basetype == SDBasic::Resource)
+      ret = param->data.basic.id;
+
+  return ret;
+}
+
+LoadStatistics ChunkLoadProfiler::Finish(const SDFile &file)
+{
+  LoadStatistics ret;
+  ret.recorded = true;
+  ret.totalTime = m_Timer.GetMilliseconds() / 1000.0;
+
+  std::map<uint32_t, ChunkLoadStats> chunkStats;
+  std::map<uint32_t, std::vector<double> > chunkTimes;
+  std::map<ResourceId, ResourceLoadStats> resourceStats;
+
+  for(const Sample &sample : m_Samples)
+  {
+    const double time = sample.durationMicro / 1000000.0;
+    const SDChunk *chunk =
+        sample.structuredIndex < file.chunks.size() ? file.chunks[sample.structuredIndex] : NULL;
+
+    ChunkLoadStats &stats = chunkStats[sample.chunkID];
+    if(stats.count == 0)
+    {
+      stats.chunkID = sample.chunkID;
+      stats.name = chunk ? std::string(chunk->name) : StringFormat::Fmt("Chunk %u", sample.chunkID);
+    }
+    stats.count++;
+    stats.totalBytes += sample.byteSize;
+    stats.totalTime += time;
+    chunkTimes[sample.chunkID].push_back(time);
+
+    ResourceId id = chunk ? GetChunkResource(chunk) : ResourceId();
+    if(id != ResourceId())
+    {
+      ResourceLoadStats &res = resourceStats[id];
+      res.resourceId = id;
+      res.count++;
+      res.totalTime += time;
+    }
+  }
+
+  ret.chunks.reserve(chunkStats.size());
+  for(auto it = chunkStats.begin(); it != chunkStats.end(); ++it)
+  {
+    std::vector<double> &times = chunkTimes[it->first];
+    std::sort(times.begin(), times.end());
+
+    // nearest-rank percentiles
+    auto percentile = [&times](double p) {
+      size_t rank = (size_t)ceil(p * times.size());
+      return times[rank > 0 ? rank - 1 : 0];
+    };
+
+    it->second.medianTime = percentile(0.5);
+    it->second.p90Time = percentile(0.9);
+    it->second.p99Time = percentile(0.99);
+    it->second.maxTime = times.back();
+
+    ret.chunks.push_back(it->second);
+  }
+
+  ret.resources.reserve(resourceStats.size());
+  for(auto it = resourceStats.begin(); it != resourceStats.end(); ++it)
+    ret.resources.push_back(it->second);
+
+  // log the most expensive chunk types so that slow loads can be diagnosed from any build
+  std::vector<ChunkLoadStats> sorted(ret.chunks.begin(), ret.chunks.end());
+  std::sort(sorted.begin(), sorted.end(), [](const ChunkLoadStats &a, const ChunkLoadStats &b) {
+    return a.totalTime > b.totalTime;
+  });
+
+  RDCLOG("Loaded %zu chunks in %.3fs", m_Samples.size(), ret.totalTime);
+
+  for(size_t i = 0; i < sorted.size() && i < 10; i++)
+  {
+    const ChunkLoadStats &c = sorted[i];
+    RDCLOG("% 7u x %s - %9.3fms total, %7.3fms median, %7.3fms p99, %7.3fms max, %8.3fMB", c.count,
+           c.name.c_str(), c.totalTime * 1000.0, c.medianTime * 1000.0, c.p99Time * 1000.0,
+           c.maxTime * 1000.0, double(c.totalBytes) / (1024.0 * 1024.0));
+  }
+
+  std::string tracePath = RenderDoc::Inst().GetConfigSetting("Replay_LoadProfileTrace");
+  if(!tracePath.empty())
+  {
+    // build a shallow structured file with the load timings in place of the capture timings, so we
+    // can go through the same chrome export as captures do
+    SDFile trace;
+    trace.chunks.reserve(m_Samples.size());
+
+    for(const Sample &sample : m_Samples)
+    {
+      const SDChunk *chunk =
+          sample.structuredIndex < file.chunks.size() ? file.chunks[sample.structuredIndex] : NULL;
+
+      std::string name = chunk ? std::string(chunk->name)
+                               : StringFormat::Fmt("Chunk %u", sample.chunkID);
+
+      SDChunk *traceChunk = new SDChunk(name.c_str());
+      traceChunk->metadata.chunkID = sample.chunkID;
+      traceChunk->metadata.timestampMicro = (uint64_t)sample.startMicro;
+      traceChunk->metadata.durationMicro = RDCMAX((int64_t)1, (int64_t)sample.durationMicro);
+
+      trace.chunks.push_back(traceChunk);
+    }
+
+    RDCFile rdc;
+    ReplayStatus status = exportChrome(tracePath.c_str(), rdc, trace, NULL);
+
+    if(status == ReplayStatus::Succeeded)
+      RDCLOG("Wrote load profile trace to %s", tracePath.c_str());
+    else
+      RDCERR("Couldn't write load profile trace to %s: %s", tracePath.c_str(),
+             ToStr(status).c_str());
+  }
+
+  m_Samples.clear();
+
+  return ret;
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+#include "common/timing.h"
+#include "core/resource_manager.h"
+
+TEST_CASE("Unique index extraction", "[replay]")
+{
+  std::vector<uint32_t> unique;
+
+  SECTION("Empty input")
+  {
+    unique.push_back(5);
+    GetUniqueIndices(NULL, 0, unique);
+    CHECK(unique.empty());
+  };
+
+  SECTION("Dense indices with duplicates")
+  {
+    const uint32_t indices[] = {502, 500, 501, 502, 501, 503, 500, 533, 502};
+
+    GetUniqueIndices(indices, ARRAY_COUNT(indices), unique);
+
+    REQUIRE(unique.size() == 5);
+    CHECK(unique[0] == 500);
+    CHECK(unique[1] == 501);
+    CHECK(unique[2] == 502);
+    CHECK(unique[3] == 503);
+    CHECK(unique[4] == 533);
+
+    UniqueIndexRemap remap(unique);
+
+    CHECK(remap.Remap(500) == 0);
+    CHECK(remap.Remap(502) == 2);
+    CHECK(remap.Remap(533) == 4);
+    CHECK(remap.Remap(510) == 0);
+    CHECK(remap.Remap(0) == 0);
+    CHECK(remap.Remap(0xffffffff) == 0);
+  };
+
+  SECTION("Sparse indices")
+  {
+    const uint32_t indices[] = {0xcccccccc, 3, 0xffffffff, 1, 3, 0xcccccccc, 0x10000, 0};
+
+    GetUniqueIndices(indices, ARRAY_COUNT(indices), unique);
+
+    REQUIRE(unique.size() == 6);
+    CHECK(unique[0] == 0);
+    CHECK(unique[1] == 1);
+    CHECK(unique[2] == 3);
+    CHECK(unique[3] == 0x10000);
+    CHECK(unique[4] == 0xcccccccc);
+    CHECK(unique[5] == 0xffffffff);
+
+    UniqueIndexRemap remap(unique);
+
+    CHECK(remap.Remap(3) == 2);
+    CHECK(remap.Remap(0x10000) == 3);
+    CHECK(remap.Remap(0xcccccccc) == 4);
+    CHECK(remap.Remap(0xffffffff) == 5);
+    CHECK(remap.Remap(2) == 0);
+  };
+
+  SECTION("Matches a sort for random data")
+  {
+    std::vector<uint32_t> indices;
+
+    // mostly small indices with the occasional huge outlier, to hit the radix sort path
+    uint32_t seed = 12345;
+    for(int i = 0; i < 10000; i++)
+    {
+      seed = seed * 1664525 + 1013904223;
+      indices.push_back((i % 97) == 0 ? seed : (seed >> 20));
+    }
+
+    GetUniqueIndices(indices.data(), indices.size(), unique);
+
+    std::vector<uint32_t> expected = indices;
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+    CHECK((unique == expected));
+
+    UniqueIndexRemap remap(unique);
+
+    bool remapped = true;
+    for(size_t i = 0; i < indices.size(); i++)
+      remapped &= (unique[remap.Remap(indices[i])] == indices[i]);
+
+    CHECK(remapped);
+  };
+};
+
+static void BenchmarkUniqueIndices(const char *name, const std::vector<uint32_t> &indices)
+{
+  std::vector<uint32_t> unique;
+
+  PerformanceTimer timer;
+
+  GetUniqueIndices(indices.data(), indices.size(), unique);
+
+  double ms = timer.GetMilliseconds();
+
+  timer.Restart();
+
+  UniqueIndexRemap remap(unique);
+
+  uint32_t sum = 0;
+  for(size_t i = 0; i < indices.size(); i++)
+    sum += remap.Remap(indices[i]);
+
+  double remapMs = timer.GetMilliseconds();
+
+  CHECK(!unique.empty());
+  CHECK(sum > 0);
+
+  RDCLOG("%s: %u indices -> %u unique in %.2f ms, remapped in %.2f ms", name,
+         (uint32_t)indices.size(), (uint32_t)unique.size(), ms, remapMs);
+}
+
+TEST_CASE("Aliased counter results", "[replay]")
+{
+  std::vector<GPUCounter> counters = {GPUCounter::EventGPUDuration, GPUCounter::SamplesWritten};
+
+  std::vector<CounterResult> results;
+  for(uint32_t eid : {10U, 5U})
+  {
+    for(GPUCounter c : counters)
+    {
+      CounterResult r;
+      r.eventId = eid;
+      r.counter = c;
+      r.value.u64 = eid * 100 + (uint32_t)c;
+      results.push_back(r);
+    }
+  }
+
+  SECTION("No aliases just sorts")
+  {
+    AddAliasedCounterResults(results, {}, counters);
+
+    REQUIRE(results.size() == 4);
+    CHECK(results[0].eventId == 5);
+    CHECK(results[1].eventId == 5);
+    CHECK(results[2].eventId == 10);
+    CHECK(results[3].eventId == 10);
+  };
+
+  SECTION("Aliases are duplicated in place")
+  {
+    AddAliasedCounterResults(results, {{5, 7}, {10, 20}, {5, 30}}, counters);
+
+    REQUIRE(results.size() == 10);
+
+    uint32_t expectedEIDs[] = {5, 5, 7, 7, 10, 10, 20, 20, 30, 30};
+    uint32_t sourceEIDs[] = {5, 5, 5, 5, 10, 10, 10, 10, 5, 5};
+    for(size_t i = 0; i < results.size(); i++)
+    {
+      CHECK(results[i].eventId == expectedEIDs[i]);
+      CHECK(results[i].counter == counters[i % 2]);
+      CHECK(results[i].value.u64 == sourceEIDs[i] * 100 + (uint32_t)counters[i % 2]);
+    }
+  };
+
+  SECTION("Missing alias targets are skipped")
+  {
+    AddAliasedCounterResults(results, {{6, 7}}, counters);
+
+    CHECK(results.size() == 4);
+  };
+};
+
+TEST_CASE("Event index lookup", "[replay]")
+{
+  std::vector<APIEvent> events;
+  for(uint32_t eid : {1U, 2U, 5U, 5U, 9U})
+  {
+    APIEvent ev;
+    ev.eventId = eid;
+    ev.fileOffset = eid * 16;
+    events.push_back(ev);
+  }
+
+  EventIndex index;
+  index.Build(events);
+
+  SECTION("Exact matches")
+  {
+    CHECK(index.Find(1) == 0);
+    CHECK(index.Find(2) == 1);
+    CHECK(index.Find(5) == 2);
+    CHECK(index.Find(9) == 4);
+  };
+
+  SECTION("Gaps find the next event")
+  {
+    CHECK(index.Find(0) == 0);
+    CHECK(index.Find(3) == 2);
+    CHECK(index.Find(6) == 4);
+  };
+
+  SECTION("Past the end finds the last event")
+  {
+    CHECK(index.Find(10) == 4);
+    CHECK(index.Find(~0U) == 4);
+  };
+};
+
+TEST_CASE("Chunk load statistics", "[replay]")
+{
+  ResourceId texId = ResourceIDGen::GetNewUniqueID();
+  ResourceId bufId = ResourceIDGen::GetNewUniqueID();
+
+  SDFile file;
+
+  // chunks 0-99 are initial contents of the texture, 100-101 create the buffer
+  for(size_t i = 0; i < 102; i++)
+  {
+    SDChunk *chunk = new SDChunk(i < 100 ? "InitialContents" : "CreateBuffer");
+    chunk->data.children.push_back(makeSDObject("id", i < 100 ? texId : bufId));
+    file.chunks.push_back(chunk);
+  }
+
+  ChunkLoadProfiler profiler;
+  profiler.Begin();
+
+  // durations of 1ms to 100ms, added out of order
+  for(size_t i = 0; i < 100; i++)
+  {
+    size_t ms = (i * 37) % 100 + 1;
+    profiler.AddSample(i, 5, 10, 0.0, ms * 1000.0);
+  }
+
+  profiler.AddSample(100, 7, 1000, 0.0, 2000.0);
+  profiler.AddSample(101, 7, 3000, 0.0, 4000.0);
+
+  // not in the structured file, so it gets a generated name and no resource
+  profiler.AddSample(500, 9, 1, 0.0, 500.0);
+
+  LoadStatistics stats = profiler.Finish(file);
+
+  CHECK(stats.recorded);
+  REQUIRE(stats.chunks.size() == 3);
+
+  SECTION("Per chunk type aggregation")
+  {
+    const ChunkLoadStats &init = stats.chunks[0];
+    CHECK(init.chunkID == 5);
+    CHECK(init.name == "InitialContents");
+    CHECK(init.count == 100);
+    CHECK(init.totalBytes == 1000);
+    CHECK(init.totalTime == Approx(5.05));
+
+    const ChunkLoadStats &create = stats.chunks[1];
+    CHECK(create.chunkID == 7);
+    CHECK(create.name == "CreateBuffer");
+    CHECK(create.count == 2);
+    CHECK(create.totalBytes == 4000);
+    CHECK(create.totalTime == Approx(0.006));
+
+    const ChunkLoadStats &unknown = stats.chunks[2];
+    CHECK(unknown.chunkID == 9);
+    CHECK(unknown.name == "Chunk 9");
+    CHECK(unknown.count == 1);
+  };
+
+  SECTION("Nearest-rank percentiles")
+  {
+    const ChunkLoadStats &init = stats.chunks[0];
+    CHECK(init.medianTime == Approx(0.050));
+    CHECK(init.p90Time == Approx(0.090));
+    CHECK(init.p99Time == Approx(0.099));
+    CHECK(init.maxTime == Approx(0.100));
+
+    // with two samples the median is the lower one
+    const ChunkLoadStats &create = stats.chunks[1];
+    CHECK(create.medianTime == Approx(0.002));
+    CHECK(create.p90Time == Approx(0.004));
+    CHECK(create.maxTime == Approx(0.004));
+
+    const ChunkLoadStats &unknown = stats.chunks[2];
+    CHECK(unknown.medianTime == Approx(0.0005));
+    CHECK(unknown.maxTime == Approx(0.0005));
+  };
+
+  SECTION("Per resource aggregation")
+  {
+    REQUIRE(stats.resources.size() == 2);
+
+    const ResourceLoadStats &tex = stats.resources[0].resourceId == texId ? stats.resources[0]
+                                                                          : stats.resources[1];
+    const ResourceLoadStats &buf = stats.resources[0].resourceId == texId ? stats.resources[1]
+                                                                          : stats.resources[0];
+
+    CHECK(tex.resourceId == texId);
+    CHECK(tex.count == 100);
+    CHECK(tex.totalTime == Approx(5.05));
+
+    CHECK(buf.resourceId == bufId);
+    CHECK(buf.count == 2);
+    CHECK(buf.totalTime == Approx(0.006));
+  };
+};
+
+TEST_CASE("Parallel structured export", "[replay]")
+{
+  std::string path = FileIO::GetTempFolderFilename() + "renderdoc_parallel_export.rdc";
+
+  // enough data that the section is split into several ranges
+  const uint32_t numChunks = 64;
+  const size_t chunkDataSize = 512 * 1024;
+
+  {
+    RDCFile rdc;
+    rdc.SetData(RDCDriver::Vulkan, "Vulkan", 0, NULL);
+    rdc.Create(path.c_str());
+
+    REQUIRE((int)rdc.ErrorCode() == (int)ContainerError::NoError);
+
+    SectionProperties props;
+    props.flags = SectionFlags::LZ4Compressed;
+    props.type = SectionType::FrameCapture;
+
+    WriteSerialiser ser(rdc.WriteSection(props), Ownership::Stream);
+
+    bytebuf data;
+    data.resize(chunkDataSize);
+
+    for(uint32_t index = 0; index < numChunks; index++)
+    {
+      memset(data.data(), index & 0xff, data.size());
+
+      SCOPED_SERIALISE_CHUNK(index + 1, chunkDataSize + 128);
+      SERIALISE_ELEMENT(index);
+      SERIALISE_ELEMENT(data);
+    }
+
+    REQUIRE_FALSE(ser.IsErrored());
+  }
+
+  RDCFile rdc;
+  rdc.Open(path.c_str());
+
+  REQUIRE((int)rdc.ErrorCode() == (int)ContainerError::NoError);
+
+  size_t numRanges = 0;
+
+  SDFile output;
+  ReplayStatus status = ExportStructuredParallel(
+      &rdc, rdc.SectionIndex(SectionType::FrameCapture),
+      [&numRanges]() -> ChunkRangeExporter {
+        numRanges++;
+
+        return [](StreamReader *reader, SDFile &out) {
+          ReadSerialiser ser(reader, Ownership::Nothing);
+
+          ser.ConfigureStructuredExport([](uint32_t) -> std::string { return "TestChunk"; }, true);
+
+          while(!reader->AtEnd())
+          {
+            ser.ReadChunk<uint32_t>();
+
+            uint32_t index;
+            bytebuf data;
+            SERIALISE_ELEMENT(index);
+            SERIALISE_ELEMENT(data);
+
+            ser.EndChunk();
+
+            if(ser.IsErrored())
+              return ReplayStatus::APIDataCorrupted;
+          }
+
+          ser.GetStructuredFile().Swap(out);
+
+          return ReplayStatus::Succeeded;
+        };
+      },
+      output);
+
+  CHECK(status == ReplayStatus::Succeeded);
+  if(Threading::GetCoreCount() > 1)
+    CHECK(numRanges > 1);
+
+  REQUIRE(output.chunks.size() == numChunks);
+  REQUIRE(output.buffers.size() == numChunks);
+
+  for(uint32_t i = 0; i < numChunks; i++)
+  {
+    const SDChunk *chunk = output.chunks[i];
+
+    CHECK(chunk->metadata.chunkID == i + 1);
+    REQUIRE(chunk->data.children.size() == 2);
+    CHECK(chunk->data.children[0]->data.basic.u == i);
+
+    uint64_t buf = chunk->data.children[1]->data.basic.u;
+    REQUIRE(buf < output.buffers.size());
+    CHECK(output.buffers[buf]->size() == chunkDataSize);
+    CHECK(output.buffers[buf]->front() == (i & 0xff));
+  }
+
+  FileIO::Delete(path.c_str());
+};
+
+TEST_CASE("Benchmark unique index extraction", "[.][benchmark][replay]")
+{
+  const uint32_t counts[] = {1000000, 10000000};
+
+  for(uint32_t count : counts)
+  {
+    std::vector<uint32_t> indices(count);
+
+    // a typical triangle list, each vertex referenced by ~6 triangles in a locally coherent order
+    for(uint32_t i = 0; i < count; i++)
+      indices[i] = (i / 3) / 2 + (i % 3);
+
+    BenchmarkUniqueIndices("Dense", indices);
+
+    // the same with a sprinkling of garbage indices, spreading the range over the full 32-bits
+    uint32_t seed = 12345;
+    for(uint32_t i = 0; i < count; i += 1000)
+    {
+      seed = seed * 1664525 + 1013904223;
+      indices[i] = seed;
+    }
+
+    BenchmarkUniqueIndices("Sparse", indices);
+  }
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
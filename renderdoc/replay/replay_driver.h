@@ -25,9 +25,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include "api/replay/renderdoc_replay.h"
+#include "common/timing.h"
 #include "core/core.h"
 #include "maths/vec.h"
+#include "mesh_pick.h"
 
 struct FrameRecord
 {
@@ -233,6 +236,130 @@ DrawcallDescription *SetupDrawcallPointers(std::vector<DrawcallDescription *> *d
 void PatchLineStripIndexBuffer(const DrawcallDescription *draw, uint8_t *idx8, uint16_t *idx16,
                                uint32_t *idx32, std::vector<uint32_t> &patchedIndices);
 
+// fills uniqueIndices with the sorted set of distinct values in indices. This runs in linear time,
+// using a bitmap when the indices span a small enough range and a radix sort otherwise, so it's
+// suitable for draws with many millions of indices.
+void GetUniqueIndices(const uint32_t *indices, size_t count, std::vector<uint32_t> &uniqueIndices);
+
+// maps indices to their position in a sorted unique index list from GetUniqueIndices, e.g. to
+// repoint an index buffer at tightly packed post-transform data. Uses a flat table when the index
+// range is small enough and a binary search otherwise. Indices not in the list map to 0.
+class UniqueIndexRemap
+{
+public:
+  UniqueIndexRemap(const std::vector<uint32_t> &uniqueIndices);
+
+  uint32_t Remap(uint32_t idx) const
+  {
+    if(!m_Table.empty())
+    {
+      uint32_t offs = idx - m_Base;
+      return offs < m_Table.size() ? m_Table[offs] : 0;
+    }
+
+    auto it = std::lower_bound(m_Unique.begin(), m_Unique.end(), idx);
+    return it != m_Unique.end() && *it == idx ? uint32_t(it - m_Unique.begin()) : 0;
+  }
+
+private:
+  const std::vector<uint32_t> &m_Unique;
+  uint32_t m_Base = 0;
+  std::vector<uint32_t> m_Table;
+};
+
+// events that are executed again later in the frame (e.g. from a command buffer submitted more than
+// once) only get counter results recorded against the first execution. This duplicates the results
+// of each {primary, alias} pair onto the alias and leaves results sorted.
+void AddAliasedCounterResults(std::vector<CounterResult> &results,
+                              const std::vector<std::pair<uint32_t, uint32_t> > &aliases,
+                              const std::vector<GPUCounter> &counters);
+
+// dense lookup from an event ID to the first event at or after it in a driver's list of events,
+// sorted by event ID. Partial replays seek to the chunk offset of each event they replay, so this
+// replaces a linear search of the event list per chunk with a single array read.
+class EventIndex
+{
+public:
+  void Build(const std::vector<APIEvent> &events);
+
+  // returns the position in the list passed to Build(). The list must not be empty.
+  size_t Find(uint32_t eventId) const
+  {
+    if(eventId >= m_Index.size())
+      return m_Count - 1;
+    return m_Index[eventId];
+  }
+
+private:
+  std::vector<uint32_t> m_Index;
+  size_t m_Count = 0;
+};
+
+// records the CPU time taken to process each chunk while a capture is loaded, to fill out
+// FrameDescription::loadStats. If the Replay_LoadProfileTrace config setting is set to a path, a
+// chrome trace of the load is written there as well.
+class ChunkLoadProfiler
+{
+public:
+  void Begin()
+  {
+    m_Samples.clear();
+    m_Timer.Restart();
+  }
+
+  // called around each chunk. structuredIndex is the index the chunk will have in the structured
+  // file passed to Finish(), which is where names and referenced resources are looked up.
+  void BeginChunk(size_t structuredIndex)
+  {
+    m_CurIndex = structuredIndex;
+    m_CurStart = m_Timer.GetMicroseconds();
+  }
+  void EndChunk(uint32_t chunkID, uint64_t byteSize)
+  {
+    AddSample(m_CurIndex, chunkID, byteSize, m_CurStart, m_Timer.GetMicroseconds() - m_CurStart);
+  }
+
+  // records a chunk with an explicit timing, for EndChunk() and for tests
+  void AddSample(size_t structuredIndex, uint32_t chunkID, uint64_t byteSize, double startMicro,
+                 double durationMicro)
+  {
+    m_Samples.push_back({structuredIndex, chunkID, byteSize, startMicro, durationMicro});
+  }
+
+  LoadStatistics Finish(const SDFile &file);
+
+private:
+  struct Sample
+  {
+    size_t structuredIndex;
+    uint32_t chunkID;
+    uint64_t byteSize;
+    double startMicro;
+    double durationMicro;
+  };
+
+  PerformanceTimer m_Timer;
+  size_t m_CurIndex = 0;
+  double m_CurStart = 0.0;
+  std::vector<Sample> m_Samples;
+};
+
+// exports one contiguous range of a section's chunks into structured data. The reader starts at a
+// chunk boundary and ends after the range's last chunk.
+typedef std::function<ReplayStatus(StreamReader *reader, SDFile &output)> ChunkRangeExporter;
+
+// exports the structured data of a capture section by splitting its chunks into contiguous ranges
+// of similar size, exporting the ranges concurrently and then stitching the chunks and buffers back
+// together in order. This relies on a chunk's structured data depending only on its own bytes.
+// createExporter is called on this thread once per range before any exporting starts, so it can
+// set up per-range state that isn't safe to create concurrently.
+// The whole uncompressed section is held in memory while the ranges export, so peak memory is
+// roughly the section size plus the structured data and its buffers - about double a sequential
+// export that streams the section.
+ReplayStatus ExportStructuredParallel(RDCFile *rdc, int sectionIdx,
+                                      const std::function<ChunkRangeExporter()> &createExporter,
+                                      SDFile &output);
+
 // simple cache for when we need buffer data for highlighting
 // vertices, typical use will be lots of vertices in the same
 // mesh, not jumping back and forth much between meshes.
@@ -247,8 +374,18 @@ struct HighlightCache
   bytebuf vertexData;
   std::vector<uint32_t> indices;
 
+  // lazily built from the cached data the first time it's needed for picking
+  uint64_t pickKey = 0;
+  MeshPickBVH pickBVH;
+
   void CacheHighlightingData(uint32_t eventId, const MeshDisplay &cfg);
 
+  // picks a vertex on the CPU from the data cached by CacheHighlightingData, which must be called
+  // first. Unprojected positions are flipped in Y before picking if flipUnprojectedY is set, for
+  // APIs where clip space Y points down.
+  uint32_t PickVertex(int32_t width, int32_t height, const MeshDisplay &cfg, uint32_t x, uint32_t y,
+                      bool flipUnprojectedY);
+
   bool FetchHighlightPositions(const MeshDisplay &cfg, FloatVector &activeVertex,
                                vector<FloatVector> &activePrim,
                                vector<FloatVector> &adjacentPrimVertices,
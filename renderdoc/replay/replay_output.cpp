@@ -155,14 +155,22 @@ void ReplayOutput::SetFrameEvent(int eventId)
   m_OverlayDirty = true;
   m_MainOutput.dirty = true;
 
+  // thumbnails only need to be re-rendered if their texture has been written to in between
   for(size_t i = 0; i < m_Thumbnails.size(); i++)
-    m_Thumbnails[i].dirty = true;
+  {
+    uint32_t writeEventId = m_pRenderer->GetTextureWriteEvent(m_Thumbnails[i].texture);
+
+    if(writeEventId == ~0U || writeEventId != m_Thumbnails[i].writeEventId)
+      m_Thumbnails[i].dirty = true;
+  }
 
   RefreshOverlay();
 }
 
 void ReplayOutput::RefreshOverlay()
 {
+  m_pRenderer->RestoreReplayPosition();
+
   DrawcallDescription *draw = m_pRenderer->GetDrawcallByEID(m_EventID);
 
   passEvents = m_pDevice->GetPassEvents(m_EventID);
@@ -258,14 +266,18 @@ bool ReplayOutput::AddThumbnail(WindowingData window, ResourceId texID, CompType
   {
     if(m_Thumbnails[i].wndHandle == GetHandle(window))
     {
+      // the thumbnail strip re-adds the same textures on every event change, so keep what was
+      // rendered last if it's still valid
+      if(m_Thumbnails[i].texture != texID || m_Thumbnails[i].depthMode != depthMode ||
+         m_Thumbnails[i].typeHint != typeHint)
+        m_Thumbnails[i].dirty = true;
+
       m_Thumbnails[i].texture = texID;
 
       m_Thumbnails[i].depthMode = depthMode;
 
       m_Thumbnails[i].typeHint = typeHint;
 
-      m_Thumbnails[i].dirty = true;
-
       return true;
     }
   }
@@ -275,6 +287,7 @@ bool ReplayOutput::AddThumbnail(WindowingData window, ResourceId texID, CompType
   p.texture = texID;
   p.depthMode = depthMode;
   p.typeHint = typeHint;
+  p.writeEventId = ~0U;
   p.dirty = true;
 
   RDCASSERT(p.outputID > 0);
@@ -296,6 +309,9 @@ rdcpair<PixelValue, PixelValue> ReplayOutput::GetMinMax()
   uint32_t mip = m_RenderData.texDisplay.mip;
   uint32_t sample = m_RenderData.texDisplay.sampleIdx;
 
+  ReplayController::TextureCacheKey key;
+  bool cacheable = false;
+
   if(m_RenderData.texDisplay.customShaderId != ResourceId() &&
      m_CustomShaderResourceId != ResourceId())
   {
@@ -304,10 +320,35 @@ rdcpair<PixelValue, PixelValue> ReplayOutput::GetMinMax()
     slice = 0;
     sample = 0;
   }
+  else
+  {
+    cacheable = m_pRenderer->MakeTextureCacheKey(ReplayController::TextureQuery::MinMax,
+                                                 m_RenderData.texDisplay.resourceId, slice, mip,
+                                                 sample, typeHint, key);
+  }
+
+  bytebuf data;
+
+  if(cacheable && m_pRenderer->FindCachedTextureData(key, data))
+  {
+    memcpy(&minval, data.data(), sizeof(PixelValue));
+    memcpy(&maxval, data.data() + sizeof(PixelValue), sizeof(PixelValue));
+    return make_rdcpair(minval, maxval);
+  }
+
+  m_pRenderer->RestoreReplayPosition();
 
   m_pDevice->GetMinMax(tex, slice, mip, sample, typeHint, &minval.floatValue[0],
                        &maxval.floatValue[0]);
 
+  if(cacheable)
+  {
+    data.resize(sizeof(PixelValue) * 2);
+    memcpy(data.data(), &minval, sizeof(PixelValue));
+    memcpy(data.data() + sizeof(PixelValue), &maxval, sizeof(PixelValue));
+    m_pRenderer->CacheTextureData(key, data);
+  }
+
   return make_rdcpair(minval, maxval);
 }
 
@@ -322,6 +363,9 @@ rdcarray<uint32_t> ReplayOutput::GetHistogram(float minval, float maxval, bool c
   uint32_t mip = m_RenderData.texDisplay.mip;
   uint32_t sample = m_RenderData.texDisplay.sampleIdx;
 
+  ReplayController::TextureCacheKey key;
+  bool cacheable = false;
+
   if(m_RenderData.texDisplay.customShaderId != ResourceId() &&
      m_CustomShaderResourceId != ResourceId())
   {
@@ -330,9 +374,37 @@ rdcarray<uint32_t> ReplayOutput::GetHistogram(float minval, float maxval, bool c
     slice = 0;
     sample = 0;
   }
+  else
+  {
+    cacheable = m_pRenderer->MakeTextureCacheKey(ReplayController::TextureQuery::Histogram,
+                                                 m_RenderData.texDisplay.resourceId, slice, mip,
+                                                 sample, typeHint, key);
+
+    memcpy(&key.params[0], &minval, sizeof(float));
+    memcpy(&key.params[1], &maxval, sizeof(float));
+    for(uint32_t c = 0; c < 4; c++)
+      key.params[2] |= channels[c] ? (1U << c) : 0U;
+  }
+
+  bytebuf data;
+
+  if(cacheable && m_pRenderer->FindCachedTextureData(key, data))
+  {
+    hist.resize(data.size() / sizeof(uint32_t));
+    memcpy(hist.data(), data.data(), hist.size() * sizeof(uint32_t));
+    return hist;
+  }
+
+  m_pRenderer->RestoreReplayPosition();
 
   m_pDevice->GetHistogram(tex, slice, mip, sample, typeHint, minval, maxval, channels, hist);
 
+  if(cacheable)
+  {
+    data.assign((const byte *)hist.data(), hist.size() * sizeof(uint32_t));
+    m_pRenderer->CacheTextureData(key, data);
+  }
+
   return hist;
 }
 
@@ -347,6 +419,7 @@ PixelValue ReplayOutput::PickPixel(ResourceId tex, bool customShader, uint32_t x
     return ret;
 
   bool decodeRamp = false;
+  bool substituted = false;
 
   CompType typeHint = m_RenderData.texDisplay.typeHint;
 
@@ -355,6 +428,7 @@ PixelValue ReplayOutput::PickPixel(ResourceId tex, bool customShader, uint32_t x
   {
     tex = m_CustomShaderResourceId;
     typeHint = CompType::Typeless;
+    substituted = true;
   }
   if((m_RenderData.texDisplay.overlay == DebugOverlay::QuadOverdrawDraw ||
       m_RenderData.texDisplay.overlay == DebugOverlay::QuadOverdrawPass ||
@@ -365,11 +439,39 @@ PixelValue ReplayOutput::PickPixel(ResourceId tex, bool customShader, uint32_t x
     decodeRamp = true;
     tex = m_OverlayResourceId;
     typeHint = CompType::Typeless;
+    substituted = true;
+  }
+
+  ReplayController::TextureCacheKey key;
+  bool cacheable = false;
+
+  if(!substituted)
+  {
+    cacheable = m_pRenderer->MakeTextureCacheKey(ReplayController::TextureQuery::Pixel, tex,
+                                                 sliceFace, mip, sample, typeHint, key);
+    key.params[0] = x;
+    key.params[1] = y;
+  }
+
+  bytebuf data;
+
+  if(cacheable && m_pRenderer->FindCachedTextureData(key, data))
+  {
+    memcpy(&ret, data.data(), sizeof(PixelValue));
+    return ret;
   }
 
+  m_pRenderer->RestoreReplayPosition();
+
   m_pDevice->PickPixel(m_pDevice->GetLiveID(tex), x, y, sliceFace, mip, sample, typeHint,
                        ret.floatValue);
 
+  if(cacheable)
+  {
+    data.assign((const byte *)&ret, sizeof(PixelValue));
+    m_pRenderer->CacheTextureData(key, data);
+  }
+
   if(decodeRamp)
   {
     for(size_t c = 0; c < ARRAY_COUNT(overdrawRamp); c++)
@@ -407,6 +509,8 @@ PixelValue ReplayOutput::PickPixel(ResourceId tex, bool customShader, uint32_t x
 
 rdcpair<uint32_t, uint32_t> ReplayOutput::PickVertex(uint32_t eventId, uint32_t x, uint32_t y)
 {
+  m_pRenderer->RestoreReplayPosition();
+
   DrawcallDescription *draw = m_pRenderer->GetDrawcallByEID(eventId);
 
   const rdcpair<uint32_t, uint32_t> errorReturn = make_rdcpair(~0U, ~0U);
@@ -507,6 +611,9 @@ void ReplayOutput::DisplayContext()
 {
   if(m_PixelContext.outputID == 0)
     return;
+
+  m_pRenderer->RestoreReplayPosition();
+
   m_pDevice->BindOutputWindow(m_PixelContext.outputID, false);
   ClearBackground(m_PixelContext.outputID, m_RenderData.texDisplay.backgroundColor);
 
@@ -567,6 +674,8 @@ void ReplayOutput::DisplayContext()
 
 void ReplayOutput::Display()
 {
+  m_pRenderer->RestoreReplayPosition();
+
   if(m_pDevice->CheckResizeOutputWindow(m_MainOutput.outputID))
   {
     m_pDevice->GetOutputWindowDimensions(m_MainOutput.outputID, m_Width, m_Height);
@@ -668,6 +777,7 @@ void ReplayOutput::Display()
 
     m_pDevice->FlipOutputWindow(m_Thumbnails[i].outputID);
 
+    m_Thumbnails[i].writeEventId = m_pRenderer->GetTextureWriteEvent(m_Thumbnails[i].texture);
     m_Thumbnails[i].dirty = false;
   }
 }
@@ -1215,8 +1215,6 @@ public:
       m_InternalElement = false;
     }
 
-    size_t byteSize = (size_t)totalSize;
-
     byte *structBuf = NULL;
 
     if(ExportStructure())
@@ -1254,19 +1252,22 @@ public:
     // ensure byte alignment
     m_Read->AlignTo<ChunkAlignment>();
 
-    if(totalSize > 0)
+    if(totalSize > 0 && structBuf == NULL)
+    {
+      StreamTransfer(&stream, m_Read, totalSize, progress);
+    }
+    else if(totalSize > 0)
     {
       // copy 1MB at a time
       const uint64_t StreamIOChunkSize = 1024 * 1024;
 
-      // copy 1MB at a time
       const uint64_t bufSize = RDCMIN(StreamIOChunkSize, totalSize);
       uint64_t numBufs = totalSize / bufSize;
       // last remaining partial buffer
       if(totalSize % (uint64_t)bufSize > 0)
         numBufs++;
 
-      byte *buf = new byte[byteSize];
+      byte *buf = new byte[(size_t)bufSize];
 
       if(progress)
         progress(0.0001f);
@@ -1278,11 +1279,8 @@ public:
         m_Read->Read(buf, payloadLength);
         stream.Write(buf, payloadLength);
 
-        if(structBuf)
-        {
-          memcpy(structBuf, buf, (size_t)payloadLength);
-          structBuf += payloadLength;
-        }
+        memcpy(structBuf, buf, (size_t)payloadLength);
+        structBuf += payloadLength;
 
         totalSize -= payloadLength;
         if(progress)
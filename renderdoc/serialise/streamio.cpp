@@ -490,11 +490,105 @@ void StreamWriter::HandleError()
 
 void StreamTransfer(StreamWriter *writer, StreamReader *reader, RENDERDOC_ProgressCallback progress)
 {
-  uint64_t totalSize = reader->GetSize();
+  StreamTransfer(writer, reader, reader->GetSize(), progress);
+}
 
-  // copy 1MB at a time
-  const uint64_t StreamIOChunkSize = 1024 * 1024;
+void StreamTransfer(StreamWriter *writer, StreamReader *reader, uint64_t numBytes,
+                    RENDERDOC_ProgressCallback progress)
+{
+  uint64_t totalSize = numBytes;
+
+  if(progress)
+    progress(0.0001f);
+
+  if(totalSize == 0)
+  {
+    if(progress)
+      progress(1.0f);
+    return;
+  }
+
+  // between a file and a socket, let the OS move the data directly if it can
+  Network::Socket *sock = NULL;
+  FILE *file = NULL;
+
+  if(reader->m_File && writer->m_Sock)
+  {
+    file = reader->m_File;
+    sock = writer->m_Sock;
+  }
+  else if(reader->m_Sock && writer->m_File)
+  {
+    file = writer->m_File;
+    sock = reader->m_Sock;
+  }
+
+  if(sock && sock->CanTransferFiles())
+  {
+    // whatever the reader has already buffered goes through the normal path first, so it stays in
+    // order with anything the writer has buffered.
+    uint64_t buffered = RDCMIN(reader->Available(), totalSize);
+    if(reader->m_File)
+      buffered = RDCMIN(buffered, reader->GetSize() - reader->GetOffset());
+
+    writer->Write(reader->m_BufferHead, buffered);
+    reader->Read(NULL, buffered);
+
+    totalSize -= buffered;
+
+    // flush the writer so the file or socket is up to date before we go around it
+    writer->Flush();
 
+    uint64_t offset = FileIO::ftell64(file);
+    uint64_t transferred = 0;
+
+    // transfer in pieces so we can report progress
+    const uint64_t StreamIOChunkSize = 32 * 1024 * 1024;
+
+    while(totalSize > 0 && !writer->IsErrored() && !reader->IsErrored())
+    {
+      uint64_t payloadLength = RDCMIN(StreamIOChunkSize, totalSize);
+
+      bool success = false;
+      if(reader->m_File)
+        success = sock->SendFileBlocking(file, offset, payloadLength);
+      else
+        success = sock->RecvFileBlocking(file, offset, payloadLength);
+
+      if(!success)
+      {
+        if(reader->m_File)
+          writer->HandleError();
+        else
+          reader->m_HasError = true;
+        break;
+      }
+
+      offset += payloadLength;
+      transferred += payloadLength;
+      totalSize -= payloadLength;
+
+      if(progress)
+        progress(float(numBytes - totalSize) / float(numBytes));
+    }
+
+    // keep the streams' positions consistent with the data that went around them
+    if(!writer->IsErrored() && writer->m_File)
+      FileIO::fseek64(file, offset, SEEK_SET);
+    if(!reader->IsErrored() && reader->m_File)
+      FileIO::fseek64(file, offset, SEEK_SET);
+
+    writer->m_WriteSize += transferred;
+    reader->m_ReadOffset += transferred;
+
+    if(progress)
+      progress(1.0f);
+
+    return;
+  }
+
+  // otherwise copy 1MB at a time
+  const uint64_t StreamIOChunkSize = 1024 * 1024;
   const uint64_t bufSize = RDCMIN(StreamIOChunkSize, totalSize);
   uint64_t numBufs = totalSize / bufSize;
   // last remaining partial buffer
@@ -503,9 +597,6 @@ void StreamTransfer(StreamWriter *writer, StreamReader *reader, RENDERDOC_Progre
 
   byte *buf = new byte[(size_t)bufSize];
 
-  if(progress)
-    progress(0.0001f);
-
   for(uint64_t i = 0; i < numBufs; i++)
   {
     uint64_t payloadLength = RDCMIN(bufSize, totalSize);
@@ -191,6 +191,9 @@ public:
 
   void AddCloseCallback(StreamCloseCallback callback) { m_Callbacks.push_back(callback); }
 private:
+  friend void StreamTransfer(StreamWriter *writer, StreamReader *reader, uint64_t numBytes,
+                             RENDERDOC_ProgressCallback progress);
+
   inline uint64_t Available()
   {
     if(m_Sock)
@@ -420,6 +423,9 @@ public:
 
   void AddCloseCallback(StreamCloseCallback callback) { m_Callbacks.push_back(callback); }
 private:
+  friend void StreamTransfer(StreamWriter *writer, StreamReader *reader, uint64_t numBytes,
+                             RENDERDOC_ProgressCallback progress);
+
   inline void EnsureSized(const uint64_t numBytes)
   {
     uint64_t bufferSize = m_BufferEnd - m_BufferBase;
@@ -488,4 +494,6 @@ private:
   std::vector<StreamCloseCallback> m_Callbacks;
 };
 
-void StreamTransfer(StreamWriter *writer, StreamReader *reader, RENDERDOC_ProgressCallback progress);
\ No newline at end of file
+void StreamTransfer(StreamWriter *writer, StreamReader *reader, RENDERDOC_ProgressCallback progress);
+void StreamTransfer(StreamWriter *writer, StreamReader *reader, uint64_t numBytes,
+                    RENDERDOC_ProgressCallback progress);
\ No newline at end of file
@@ -303,6 +303,93 @@ TEST_CASE("Test stream I/O operations over the network", "[streamio][network]")
     CHECK(writer.IsErrored());
   };
 
+  SECTION("Transfer a file")
+  {
+    std::string srcPath = FileIO::GetTempFolderFilename() + "renderdoc_streamio_src.bin";
+    std::string dstPath = FileIO::GetTempFolderFilename() + "renderdoc_streamio_dst.bin";
+
+    // large enough to go past the readers' buffering, and not a multiple of any chunk size
+    std::vector<byte> contents(5 * 1024 * 1024 + 123);
+    for(size_t i = 0; i < contents.size(); i++)
+      contents[i] = byte((i * 7) ^ (i >> 10));
+
+    FILE *f = FileIO::fopen(srcPath.c_str(), "wb");
+    REQUIRE(f);
+    FileIO::fwrite(contents.data(), 1, contents.size(), f);
+    FileIO::fclose(f);
+
+    StreamWriter writer(sender, Ownership::Nothing);
+    StreamReader reader(receiver, Ownership::Nothing);
+
+    // values either side of the file check the framing is kept
+    uint32_t header = 0, footer = 0;
+
+    volatile int32_t threadA = 0, threadB = 0;
+
+    Threading::ThreadHandle sendThread =
+        Threading::CreateThread([&threadA, &writer, &srcPath]() {
+          StreamReader fileReader(FileIO::fopen(srcPath.c_str(), "rb"));
+
+          writer.Write<uint32_t>(0x1234);
+          StreamTransfer(&writer, &fileReader, NULL);
+          writer.Write<uint32_t>(0x5678);
+          writer.Flush();
+
+          Atomic::Inc32(&threadA);
+        });
+
+    Threading::ThreadHandle recvThread = Threading::CreateThread(
+        [&threadB, &reader, &dstPath, &header, &footer, &contents]() {
+          StreamWriter fileWriter(FileIO::fopen(dstPath.c_str(), "wb"), Ownership::Stream);
+
+          reader.Read(header);
+          StreamTransfer(&fileWriter, &reader, contents.size(), NULL);
+          reader.Read(footer);
+
+          Atomic::Inc32(&threadB);
+        });
+
+    // wait up to 5 seconds for the threads to exit
+    for(int i = 0; i < 5000 / 50; i++)
+    {
+      Threading::Sleep(50);
+      if(threadA && threadB)
+        break;
+    }
+
+    REQUIRE(threadA);
+    REQUIRE(threadB);
+
+    Threading::JoinThread(sendThread);
+    Threading::CloseThread(sendThread);
+
+    Threading::JoinThread(recvThread);
+    Threading::CloseThread(recvThread);
+
+    CHECK_FALSE(writer.IsErrored());
+    CHECK_FALSE(reader.IsErrored());
+
+    CHECK(header == 0x1234);
+    CHECK(footer == 0x5678);
+    CHECK(writer.GetOffset() == contents.size() + sizeof(uint32_t) * 2);
+    CHECK(reader.GetOffset() == contents.size() + sizeof(uint32_t) * 2);
+
+    std::vector<byte> received(contents.size());
+
+    f = FileIO::fopen(dstPath.c_str(), "rb");
+    REQUIRE(f);
+    FileIO::fseek64(f, 0, SEEK_END);
+    CHECK(FileIO::ftell64(f) == contents.size());
+    FileIO::fseek64(f, 0, SEEK_SET);
+    FileIO::fread(received.data(), 1, received.size(), f);
+    FileIO::fclose(f);
+
+    CHECK(received == contents);
+
+    FileIO::Delete(srcPath.c_str());
+    FileIO::Delete(dstPath.c_str());
+  };
+
   delete sender;
   delete receiver;
   delete server;
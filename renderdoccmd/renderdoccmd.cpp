@@ -464,6 +464,8 @@ struct RemoteServerCommand : public Command
     parser.add<uint32_t>("port", 'p', "The port to listen on.", false,
                          RENDERDOC_GetDefaultRemoteServerPort());
     parser.add("preview", 'v', "Display a preview window when a replay is active.");
+    parser.add("worker", 0,
+               "Internal: serve a single client redirected by a dispatching server, then exit.");
   }
   virtual const char *Description()
   {
@@ -476,7 +478,11 @@ struct RemoteServerCommand : public Command
     string host = parser.get<string>("host");
     uint32_t port = parser.get<uint32_t>("port");
 
-    RENDERDOC_InitGlobalEnv(m_Env, convertArgs(parser.rest()));
+    std::vector<std::string> args = parser.rest();
+    if(parser.exist("worker"))
+      args.push_back("--remote-server-worker");
+
+    RENDERDOC_InitGlobalEnv(m_Env, convertArgs(args));
 
     std::cerr << "Spawning a replay host listening on " << (host.empty() ? "*" : host) << ":"
               << port << "..." << std::endl;
@@ -1254,6 +1260,8 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
               "Capturing Option: Save all initial resource contents at frame start.");
       cmd.add("opt-capture-all-cmd-lists", 0,
               "Capturing Option: In D3D11, record all command lists from application start.");
+      cmd.add("opt-defer-descriptor-tracking", 0,
+              "Capturing Option: Only track descriptor contents when a capture begins.");
     }
 
     cmd.parse_check(argv, true);
@@ -1285,6 +1293,8 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
         opts.saveAllInitials = true;
       if(cmd.exist("opt-capture-all-cmd-lists"))
         opts.captureAllCmdLists = true;
+      if(cmd.exist("opt-defer-descriptor-tracking"))
+        opts.deferDescriptorTracking = true;
 
       opts.delayForDebugger = (uint32_t)cmd.get<int>("opt-delay-for-debugger");
     }